@@ -0,0 +1,369 @@
+// DO-NOT-DELETE revisionify.begin() 
+/*
+Copyright (c) 2007-2008 Lawrence Livermore National Security LLC
+
+This file is part of the mdef package (version 0.1) and is free software: 
+you can redistribute it and/or modify it under the terms of the GNU
+Lesser General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+                              DISCLAIMER
+
+This work was prepared as an account of work sponsored by an agency of
+the United States Government. Neither the United States Government nor
+Lawrence Livermore National Security, LLC nor any of their employees,
+makes any warranty, express or implied, or assumes any liability or
+responsibility for the accuracy, completeness, or usefulness of any
+information, apparatus, product, or process disclosed, or represents
+that its use would not infringe privately-owned rights. Reference
+herein to any specific commercial products, process, or service by
+trade name, trademark, manufacturer or otherwise does not necessarily
+constitute or imply its endorsement, recommendation, or favoring by
+the United States Government or Lawrence Livermore National Security,
+LLC. The views and opinions of authors expressed herein do not
+necessarily state or reflect those of the United States Government or
+Lawrence Livermore National Security, LLC, and shall not be used for
+advertising or product endorsement purposes.
+*/
+// DO-NOT-DELETE revisionify.end() 
+
+//
+// File:        mtree_knn_benchmark.cc
+// Package:     MPTCOUPLER MTree database
+// 
+// Description: Measure k-nearest-neighbor search throughput of metric
+//              index structures for randomly placed objects.
+//
+// Usage:       ./mtree_knn_benchmark [numberObjects [pointDimension
+//                                    [numberQueries [numberNeighbors
+//                                    [bulkLoad [indexType
+//                                    [pointFile]]]]]]]
+//
+//              Defaults are 100000 objects, 6 dimensions, 10000 queries 
+//              and 4 neighbors (the default maxNumberSearchModels of the
+//              kriging database).  A nonzero bulkLoad builds the tree 
+//              with bulkLoad() instead of one insertion per object.
+//              indexType is mtree (default) or vptree.  If pointFile
+//              (e.g. point_data.txt) is given, objects and queries are
+//              randomly jittered copies of the points it holds and
+//              pointDimension is taken from the file.
+//
+
+#ifndef included_config
+#include <asf_config.h>
+#endif
+
+#include <base/ResponsePoint.h>
+
+#include <mtreedb/MTree.h>
+#include <mtreedb/VPTree.h>
+#include <mtreedb/MTreeObject.h>
+#include <mtreedb/MTreeObjectFactory.h>
+#include <mtreedb/MTreeSearchResult.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace MPTCOUPLER;
+using namespace MPTCOUPLER::krigcpl;
+
+namespace {
+
+  //
+  // data object carrying no data; only the index is exercised
+  //
+
+  class BenchmarkObject : public mtreedb::MTreeObject {
+
+  public:
+    BenchmarkObject() {}
+    virtual ~BenchmarkObject() {}
+
+    mtreedb::MTreeObjectPtr makeCopy() const
+    {
+      return mtreedb::MTreeObjectPtr(new BenchmarkObject);
+    }
+
+    void putToDatabase(toolbox::Database & db) const
+    {
+      return;
+    }
+
+  };
+
+  class BenchmarkObjectFactory : public mtreedb::MTreeObjectFactory {
+
+  public:
+    BenchmarkObjectFactory() {}
+    virtual ~BenchmarkObjectFactory() {}
+
+    mtreedb::MTreeObjectPtr allocateObject(toolbox::Database & db) const
+    {
+      return mtreedb::MTreeObjectPtr(new BenchmarkObject);
+    }
+
+  };
+
+  //
+  // relative size of the perturbation applied to sample points
+  //
+
+  const double sampleJitter = 1.0e-3;
+
+  //
+  // read sample points, one per line; lines whose length differs
+  // from that of the first point are skipped
+  //
+
+  std::vector<std::vector<double> >
+  readSamplePoints(const std::string & fileName)
+  {
+
+    std::vector<std::vector<double> > samples;
+
+    std::ifstream inputFile(fileName.c_str());
+
+    if (!inputFile) {
+      std::cerr << "Error opening " << fileName << std::endl;
+      std::exit(1);
+    }
+
+    std::string line;
+
+    while (std::getline(inputFile, line)) {
+
+      std::istringstream lineStream(line);
+      std::vector<double> sample;
+      double value;
+
+      while (lineStream >> value)
+        sample.push_back(value);
+
+      if (sample.empty() == false && 
+          (samples.empty() == true || 
+           sample.size() == samples.front().size()))
+        samples.push_back(sample);
+
+    }
+
+    if (samples.empty() == true) {
+      std::cerr << "No points in " << fileName << std::endl;
+      std::exit(1);
+    }
+
+    return samples;
+
+  }
+
+  //
+  // uniform random point in the unit cube or, if samples are given,
+  // a randomly chosen sample with each coordinate perturbed by a
+  // relative amount of at most sampleJitter
+  //
+
+  void
+  randomPoint(ResponsePoint                             & point,
+              const std::vector<std::vector<double> > & samples)
+  {
+
+    if (samples.empty() == true) {
+
+      for (unsigned int i = 0; i < point.size(); ++i)
+        point[i] = drand48();
+
+      return;
+
+    }
+
+    const std::vector<double> & sample = 
+      samples[static_cast<int>(drand48()*samples.size())];
+
+    for (unsigned int i = 0; i < point.size(); ++i)
+      point[i] = sample[i]*(1.0 + sampleJitter*(2.0*drand48() - 1.0));
+
+    return;
+
+  }
+
+  typedef std::chrono::steady_clock Clock;
+
+  double
+  secondsSince(const Clock::time_point & start)
+  {
+
+    return std::chrono::duration<double>(Clock::now() - start).count();
+
+  }
+
+}
+
+int
+main(int    argc,
+     char * argv[])
+{
+
+  const int numberObjects   = (argc > 1) ? std::atoi(argv[1]) : 100000;
+  int pointDimension        = (argc > 2) ? std::atoi(argv[2]) : 6;
+  const int numberQueries   = (argc > 3) ? std::atoi(argv[3]) : 10000;
+  const int numberNeighbors = (argc > 4) ? std::atoi(argv[4]) : 4;
+  const bool bulkLoad       = (argc > 5) ? (std::atoi(argv[5]) != 0) : false;
+  const std::string indexType = (argc > 6) ? argv[6] : "mtree";
+
+  std::vector<std::vector<double> > samples;
+
+  if (argc > 7) {
+    samples = readSamplePoints(argv[7]);
+    pointDimension = samples.front().size();
+  }
+
+  srand48(1);
+
+  //
+  // build index; use the same node size for the M-tree as the kriging
+  // database
+  //
+
+  BenchmarkObjectFactory objectFactory;
+
+  mtreedb::MetricIndexPtr index;
+  mtreedb::MTree * tree = NULL;
+
+  if (indexType == "vptree") {
+
+    index = mtreedb::MetricIndexPtr(new mtreedb::VPTree("benchmark"));
+
+  } else if (indexType == "mtree") {
+
+    tree = new mtreedb::MTree("benchmark");
+    index = mtreedb::MetricIndexPtr(tree);
+
+    tree->initializeCreate("mtree_knn_benchmark", 
+                           "benchmark",
+                           objectFactory);
+    tree->setMaxNodeEntries(12);
+
+  } else {
+
+    std::cerr << "Unknown index type " << indexType << std::endl;
+    return 1;
+
+  }
+
+  ResponsePoint point(pointDimension);
+
+  //
+  // draw all points before building; the index structures draw from
+  // the same generator, so that otherwise each index would be built
+  // from different points
+  //
+
+  std::vector<mtreedb::MTreeObjectPtr> objects;
+  std::vector<mtreedb::MTreePointPtr> points;
+
+  for (int iObject = 0; iObject < numberObjects; ++iObject) {
+
+    randomPoint(point, samples);
+
+    objects.push_back(mtreedb::MTreeObjectPtr(new BenchmarkObject));
+    points.push_back(point.makeCopy());
+
+  }
+
+  const Clock::time_point insertStart = Clock::now();
+
+  if (bulkLoad == true) {
+
+    index->bulkLoad(objects,
+                    points,
+                    std::vector<double>(numberObjects, 0.0));
+
+  } else {
+
+    for (int iObject = 0; iObject < numberObjects; ++iObject)
+      index->insertObject(*objects[iObject],
+                          *points[iObject],
+                          0.0);
+
+  }
+
+  const double insertTime = secondsSince(insertStart);
+
+  //
+  // search
+  //
+
+  std::vector<mtreedb::MTreeSearchResult> results;
+  long numberResults = 0;
+
+  //
+  // restart the generator so all index structures and build methods
+  // are searched with the same queries
+  //
+
+  srand48(2);
+
+  const Clock::time_point searchStart = Clock::now();
+
+  for (int iQuery = 0; iQuery < numberQueries; ++iQuery) {
+
+    randomPoint(point, samples);
+
+    index->searchKNN(results,
+                     point,
+                     numberNeighbors);
+
+    numberResults += results.size();
+
+  }
+
+  const double searchTime = secondsSince(searchStart);
+
+  //
+  // report
+  //
+
+  std::cout << "index                  " << indexType << std::endl
+            << "points                 " 
+            << ((argc > 7) ? argv[7] : "uniform") << std::endl
+            << "objects                " << numberObjects << std::endl
+            << "dimension              " << pointDimension << std::endl
+            << "neighbors              " << numberNeighbors << std::endl;
+
+  if (tree != NULL)
+    std::cout << "tree levels            " << tree->getNumberLevels() 
+              << std::endl;
+
+  std::cout << "build                  " 
+            << ((bulkLoad == true) ? "bulk load" : "insert") << std::endl
+            << "insert time [s]        " << insertTime << std::endl
+            << "insert distances       " 
+            << index->getTotalInsertDistanceCount() << std::endl
+            << "queries                " << numberQueries << std::endl
+            << "results                " << numberResults << std::endl
+            << "search time [s]        " << searchTime << std::endl
+            << "queries per second     " << numberQueries/searchTime 
+            << std::endl
+            << "distances per query    " 
+            << static_cast<double>(index->getTotalKNNSearchDistanceCount())/
+               numberQueries
+            << std::endl;
+
+  return 0;
+
+}
@@ -60,6 +60,12 @@ advertising or product endorsement purposes.
 using namespace std;
 #endif
 
+#ifndef included_algorithm
+#define included_algorithm
+#include <algorithm>
+using namespace std;
+#endif
+
 #include "toolbox/base/Utilities.h"
 #include "toolbox/base/MathUtilities.h"
 
@@ -73,6 +79,16 @@ using namespace std;
 namespace MPTCOUPLER {
     namespace mtreedb {
 
+/*
+*************************************************************************
+*                                                                       *
+* Source of unique tree serial numbers; see getThreadSearchStatistics().*
+*                                                                       *
+*************************************************************************
+*/
+
+static std::atomic<int> s_tree_serial_counter(0);
+
 /*
 *************************************************************************
 *                                                                       *
@@ -91,7 +107,8 @@ MTree::MTree(const string& tree_name,
   d_root_node_promotion_method(MTreeNode::MIN_OVERLAP_PROMOTION),
   d_node_promotion_method(MTreeNode::MAX_SPREAD_DISTANCE_PROMOTION),
   d_node_partition_method(MTreeNode::HYPERPLANE_PARTITION),
-  d_min_node_utilization(0.5)
+  d_min_node_utilization(0.5),
+  d_tree_serial(s_tree_serial_counter++)
 {
 #ifdef DEBUG_CHECK_ASSERTIONS
    assert(!tree_name.empty());
@@ -133,7 +150,8 @@ MTree::~MTree()
 
 void MTree::initializeCreate(const string& directory_name,
                              const string& file_prefix,
-                             const MTreeObjectFactory& obj_factory)
+                             const MTreeObjectFactory& obj_factory,
+                             MTreeDataStore::ObjectStoreType object_store_type)
 {
 #ifdef DEBUG_CHECK_ASSERTIONS
    assert(!directory_name.empty());
@@ -144,7 +162,8 @@ void MTree::initializeCreate(const string& directory_name,
       d_data_store.create(this,
                           &obj_factory,
                           directory_name,
-                          file_prefix);
+                          file_prefix,
+                          object_store_type);
    } else {
       TBOX_WARNING("MTree::initializeCreate() warning"
                    << " for tree named = " << d_tree_name
@@ -197,6 +216,67 @@ void MTree::finalize()
    d_data_store.close();
 }
 
+/*
+*************************************************************************
+*                                                                       *
+* Background I/O of data objects is handled by the data store.          *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTree::startBackgroundIO()
+{
+   return( d_data_store.startBackgroundIO() );
+}
+
+void MTree::stopBackgroundIO()
+{
+   d_data_store.stopBackgroundIO();
+}
+
+void MTree::prefetchObject(int object_id)
+{
+   d_data_store.prefetchObject(object_id);
+}
+
+int MTree::getBackgroundIOQueueDepth() const
+{
+   return( d_data_store.getBackgroundIOQueueDepth() );
+}
+
+size_t MTree::getTotalBackgroundIOBytes() const
+{
+   return( d_data_store.getTotalBackgroundIOBytes() );
+}
+
+double MTree::getTotalBackgroundIOStallTime() const
+{
+   return( d_data_store.getTotalBackgroundIOStallTime() );
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Memory and page-ins of data objects are accounted by the data store.  *
+*                                                                       *
+*************************************************************************
+*/
+
+size_t MTree::getResidentObjectBytes() const
+{
+   return( d_data_store.getResidentObjectBytes() );
+}
+
+size_t MTree::getObjectMemorySize(int object_id) const
+{
+   return( d_data_store.getObjectMemorySize(object_id) );
+}
+
+int MTree::getTotalObjectPageInCount() const
+{
+   return( d_data_store.getTotalObjectPageInCount() );
+}
+
 /*
 *************************************************************************
 *                                                                       *
@@ -251,10 +331,6 @@ void MTree::insertObject(MTreeObject& object,
      d_current_distance_type = DISTANCE_INSERT;
      d_num_inserts++;
 
-     if (!d_root_node) {
-        createRootNode();
-     }
-
      d_data_store.addObject(object);  
 
      MTreeKey key(point.makeCopy(), radius);
@@ -262,47 +338,105 @@ void MTree::insertObject(MTreeObject& object,
      MTreeEntryPtr entry( new MTreeEntry(key) );
      entry->setDataObjectId( object.getObjectId() );
 
-     MTreeNodePtr node( pickNode(d_root_node, entry) );
+     insertDataEntry(entry);
 
-     MTreeNode::insertEntry(entry, node);
+     d_current_distance_type = DISTANCE_UNDEFINED;
 
-     clearLevelStatistics();
- 
-     if (node->isOverfull()) {
+   }
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Routine for loading a collection of objects into an empty tree.  The  *
+* tree is built bottom-up one level at a time: the entries of a level   *
+* are partitioned into groups, each group becomes a node, and the       *
+* parent entries of the new nodes form the entries of the next level.   *
+* The remaining entries go into the root node once they fit in a node.  *
+* Note: deep copies of objects and points are made for insertion.       *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::bulkLoad(const vector<MTreeObjectPtr>& objects,
+                     const vector<MTreePointPtr>& points,
+                     const vector<double>& radii)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(objects.size() == points.size());
+   assert(objects.size() == radii.size());
+#endif
+
+   const int num_objects = objects.size();
+
+   if (!d_data_store.isInitialized()) {
+      TBOX_ERROR("MTree object error: " << d_tree_name
+                 << "\n   an initialize method must be called"
+                 << " before calling MTree::bulkLoad()" << endl);
+   } else if ( d_root_node ) {
 
-        split(node);
+      for (int io = 0; io < num_objects; ++io) {
+         insertObject(*objects[io], *points[io], radii[io]);
+      }
 
-        if (node->isOverfull()) {  // just to be anal....
-           TBOX_ERROR("MTree::insertObject() error"
-                      << " for tree named = " << d_tree_name
-                      << "\nSplit of overfull node id " 
-                      << node->getNodeId()
-                      << "\nfailed for object id " 
-                      << entry->getDataObjectId()
-                      << endl);
-        }
+   } else if (num_objects > 0) {
 
-     } else {
+      clearLevelStatistics();
 
-        mapDataObjectsToNode(node);
+      d_num_distance_comps_in_last_insert = 0;
+      d_current_distance_type = DISTANCE_INSERT;
+      d_num_inserts += num_objects;
 
-        node->resetRadiiUpToRoot();
+      vector<MTreeEntryPtr> entries;
+      entries.reserve(num_objects);
 
-     }
- 
-     if (d_do_error_checking) {
-        *d_error_log_stream 
-        << "Checking correctness from insert node up to root"
-        << "\nafter inserting object # " << object.getObjectId()
-        << " ..." << endl;
-        if ( node->checkConsistencyUpToRoot(*d_error_log_stream) ) {
-           *d_error_log_stream << "      Everything looks good!" << endl; 
-        } else {
-           *d_error_log_stream << "      Problems found!" << endl; 
-        }
-     }
+      for (int io = 0; io < num_objects; ++io) {
+#ifdef DEBUG_CHECK_ASSERTIONS
+         assert(radii[io] >= 0.0);
+#endif
+         d_data_store.addObject(*objects[io]);
 
-     d_current_distance_type = DISTANCE_UNDEFINED;
+         MTreeKey key(points[io]->makeCopy(), radii[io]);
+
+         MTreeEntryPtr entry( new MTreeEntry(key) );
+         entry->setDataObjectId( objects[io]->getObjectId() );
+
+         entries.push_back(entry);
+      }
+
+      int level = 0;
+      while ( static_cast<int>(entries.size()) > d_max_node_entries ) {
+         vector< vector<MTreeEntryPtr> > groups;
+         partitionBulkLoadEntries(groups, entries);
+         buildBulkLoadLevel(entries, groups, level);
+         level++;
+      }
+
+      createRootNode();
+      d_root_node->setLevelInTree(level);
+
+      const int num_entries = entries.size();
+      for (int ie = 0; ie < num_entries; ++ie) {
+         MTreeNode::insertEntry(entries[ie], d_root_node);
+      }
+
+      if ( d_root_node->isLeaf() ) {
+         mapDataObjectsToNode(d_root_node);
+      }
+
+      d_current_distance_type = DISTANCE_UNDEFINED;
+
+      if (d_do_error_checking) {
+         *d_error_log_stream 
+         << "Checking correctness of tree after bulk loading " 
+         << num_objects << " objects ..." << endl;
+         if ( checkConsistency(*d_error_log_stream) ) {
+            *d_error_log_stream << "      Everything looks good!" << endl; 
+         } else {
+            *d_error_log_stream << "      Problems found!" << endl; 
+         }
+      }
 
    }
 
@@ -317,9 +451,12 @@ void MTree::insertObject(MTreeObject& object,
 *************************************************************************
 */
 
-MTreeObjectPtr MTree::getObject(int object_id) const
+MTreeObjectPtr MTree::getObject(int object_id,
+                                bool make_safe) const
 {
-   MTreeObjectPtr ret_object( d_data_store.getObjectCopy(object_id) );
+   MTreeObjectPtr ret_object( make_safe ? 
+                              d_data_store.getObjectCopy(object_id) :
+                              d_data_store.getObjectPtr(object_id) );
    return(ret_object);
 }
 
@@ -346,132 +483,106 @@ void MTree::deleteObject(int object_id)
 
       if ( node.get() && node->isLeaf() ) {
 
-         MTreeEntryPtr entry;
-
-         const int num_entries = node->getNumberEntries();
-         bool found = false;
-         int ie = 0;
-         while ( !found && (ie < num_entries) ) {
-            entry = node->getEntry(ie);
-            if ( object_id == entry->getDataObjectId() ) {
-               found = true;
-            }  
-            ie++;
-         }
+         MTreeEntryPtr entry( findDataEntry(node, object_id) );
 
-         if ( found ) {
+         if ( entry.get() ) {
 
             MTreeNode::deleteEntry(entry, node);
             d_data_store.removeObject(object_id);
             mapDataObjectsToNode(node);
 
-            /* 
-             * If the node is now empty but is not the root in the tree, 
-             * we delete the node from the tree.
-             * 
-             * If the parent node contains only one other child node 
-             * apart from the empty node, we attempt to move some entries 
-             * from the other child to the empty node.  This helps to 
-             * maintain some fanout in the tree.  If the other 
-             * child node doesn't have enough entries to share (i.e.,
-             * it has one or zero entries) then we cannot do this and
-             * so the parent will have only one child node.
-             *
-             * If the parent node is now empty, we recurse and apply
-             * the same algorithm to the parent.  We stop at the root
-             * or the first non-empty parent node.
-             */
-
-            while ( !node->isRoot() &&
-                    (node->getNumberEntries() == 0) ) {
-
-               MTreeNodePtr  parent_node( node->getParentNode() );
-               MTreeEntryPtr parent_entry( node->getParentEntry() );
-
-               if ( parent_node->getNumberEntries() == 1 ) {
-
-                  if ( node->isLeaf() ) {
-                     d_data_store.removeLeafNode(node);
-                     removeNodeFromLevelCount( node->getLevelInTree() );
-                  }
-                  MTreeNode::deleteEntry(parent_entry, parent_node);
+            pruneEmptyNodes(node);
 
-               } else {
+         } // object's entry found in tree
+
+                 
+      } else { // object not assigned to node in store, 
+               // so just attempt to remove object from data store.
+         d_data_store.removeObject(object_id);
+      }
 
-                  if ( parent_node->getNumberEntries() == 2 ) {  
+      d_current_distance_type = DISTANCE_UNDEFINED;
+      
+   }  // if valid object id in data store
 
-                     MTreeNodePtr neighbor_node;
-                     if ( parent_entry->getPositionInNode() == 0 ) {
-                        neighbor_node = 
-                           parent_node->getEntry(1)->getSubtreeNode();
-                     } else {
-                        neighbor_node = 
-                           parent_node->getEntry(0)->getSubtreeNode();
-                     }
+}
 
-                     if ( node->isLeaf() ) {
-                        d_data_store.removeLeafNode(node);
-                        removeNodeFromLevelCount( node->getLevelInTree() );
-                     }
-                     MTreeNode::deleteEntry(parent_entry, parent_node);
+/*
+*************************************************************************
+*                                                                       *
+* Routine for moving the center point and resetting the radius of an    *
+* object indexed by tree.                                               *
+* If the region of the object stays inside the region of the parent     *
+* entry of its leaf node, the entry is only repositioned within the     *
+* node; otherwise, it is removed from the tree structure and inserted   *
+* again.  The object id and the object in the data store are unchanged. *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::updateObjectPoint(int object_id,
+                              const MTreePoint& point,
+                              double radius)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(radius >= 0.0);
+#endif
 
-                     if ( neighbor_node->getNumberEntries() >= 2) {
+   if ( d_data_store.isValidObjectId(object_id) ) {
 
-                        parent_node->resetRadius();
+      MTreeNodePtr node( d_data_store.getNodeOwningObject(object_id) );
 
-                        bool use_root_promotion = false;
-                        bool special_delete_split = true;
-                        MTreeNodePtr new_node(
-                           neighbor_node->split( use_root_promotion,
-                                                 special_delete_split ) );
+      MTreeEntryPtr entry;
+      if ( node.get() && node->isLeaf() ) {
+         entry = findDataEntry(node, object_id);
+      }
 
-                        if (neighbor_node->isLeaf()) {
-                           mapDataObjectsToNode(neighbor_node);
-                           mapDataObjectsToNode(new_node);
-                        } else {
-                           new_node->
-                              setLevelInTree( neighbor_node->getLevelInTree() );
-                        }
+      if ( entry.get() ) {
 
-                     } // if neighbor node can be split
+         d_num_distance_comps_in_last_insert = 0;
+         d_current_distance_type = DISTANCE_INSERT;
 
-                  } else { // parent node has more than 2 entries;
-                           // simply remove empty child node
+         MTreeKey key( point.makeCopy(), radius );
 
-                     if ( node->isLeaf() ) { 
-                        d_data_store.removeLeafNode(node);
-                        removeNodeFromLevelCount( node->getLevelInTree() );
-                     }
-                     MTreeNode::deleteEntry(parent_entry, parent_node);
+         MTreeEntryPtr new_entry( new MTreeEntry(key) );
+         new_entry->setDataObjectId(object_id);
 
-                  }
+         bool stays_in_node = node->isRoot();
+         if ( !stays_in_node ) {
+            MTreeEntryPtr parent_entry( node->getParentEntry() );
+            const double dist2par = parent_entry->computeDistanceTo(new_entry);
+            incrementDistanceComputeCount();
+            new_entry->setDistanceToParent(dist2par);
+            stays_in_node = 
+               ( dist2par + new_entry->getRadius() <= 
+                 parent_entry->getRadius() );
+         }
 
-               }  // else parent node has at least two entries
+         MTreeNode::deleteEntry(entry, node);
 
-               parent_node->resetRadius(); 
+         if ( stays_in_node ) {
 
-               if ( parent_node->getNumberEntries() == 0 ) {
-                  parent_node->
-                     setLevelInTree( parent_node->getLevelInTree() - 1 );
-               }
+            MTreeNode::insertEntry(new_entry, node);
+            mapDataObjectsToNode(node);
+            node->resetRadiiUpToRoot();
 
-               node = parent_node;
+         } else {
 
-            } // while node to prune is empty but is not root node 
+            clearLevelStatistics();
 
-            if ( !node->isRoot() ) {
-               node->resetRadiiUpToRoot();
-            } 
+            mapDataObjectsToNode(node);
+            pruneEmptyNodes(node);
 
-         } // object's entry found in tree
-                 
-      } else { // object not assigned to node in store, 
-               // so just attempt to remove object from data store.
-         d_data_store.removeObject(object_id);
-      }
+            insertDataEntry(new_entry);
+
+         }
+
+         d_current_distance_type = DISTANCE_UNDEFINED;
+
+      } // object's entry found in tree
+
+      d_data_store.updateObjectMemorySize(object_id);
 
-      d_current_distance_type = DISTANCE_UNDEFINED;
-      
    }  // if valid object id in data store
 
 }
@@ -487,13 +598,89 @@ void MTree::deleteObject(int object_id)
 void MTree::searchKNN(vector<MTreeSearchResult>& results,
                       const MTreePoint& query_point,
                       int k_neighbors,
-                      bool make_safe)
+                      bool make_safe,
+                      bool share_points)
+{
+   searchNearest(results, query_point, k_neighbors, make_safe, 
+                 share_points, false, 1.0, 0);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Search tree and return up to "K" objects whose regions are nearest    *
+* to query point.                                                       *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::searchKNNSupport(vector<MTreeSearchResult>& results,
+                             const MTreePoint& query_point,
+                             int k_neighbors,
+                             bool make_safe,
+                             bool share_points)
+{
+   searchNearest(results, query_point, k_neighbors, make_safe, 
+                 share_points, true, 1.0, 0);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Search tree and return up to "K" near neighbors to query point with   *
+* bounded error factor and number of distance computations.             *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::searchKNNApproximate(vector<MTreeSearchResult>& results,
+                                 const MTreePoint& query_point,
+                                 int k_neighbors,
+                                 double error_factor,
+                                 int max_distance_comps,
+                                 bool make_safe,
+                                 bool share_points)
+{
+   searchNearest(results, query_point, k_neighbors, make_safe, 
+                 share_points, false,
+                 toolbox::MathUtilities<double>::Max( 1.0, error_factor ),
+                 max_distance_comps);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine implementing "K" nearest neighbor searches.  Data     *
+* entries are ranked by distance to their points or, if rank_by_support *
+* is true, by distance to their regions.  In the latter case the        *
+* pruning below remains exact: an entry is consistent with the query    *
+* when its point distance is within the current K-th distance plus its  *
+* radius, which is the same as its support distance being within the    *
+* K-th distance.                                                        *
+*                                                                       *
+* For approximate searches the K-th distance is divided by the error    *
+* factor wherever it is used for pruning, so that every entry or        *
+* subtree skipped holds only objects farther than the K-th result       *
+* divided by the factor, and the search ends after the node during      *
+* which the maximum number of distance computations is reached.         *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::searchNearest(vector<MTreeSearchResult>& results,
+                          const MTreePoint& query_point,
+                          int k_neighbors,
+                          bool make_safe,
+                          bool share_points,
+                          bool rank_by_support,
+                          double error_factor,
+                          int max_distance_comps)
 {
    if (k_neighbors > 0) {
 
-      d_num_distance_comps_in_last_knn_query = 0;
-      d_current_distance_type = DISTANCE_KNN_QUERY;
-      d_num_knn_queries++;
+      SearchStatistics& stats = getThreadSearchStatistics();
+      int num_distance_comps = 0;
+      SearchStatistics::add(stats.d_num_knn_queries, 1);
 
       /*
        * Set up query to compare neighbors, results vector,
@@ -503,7 +690,9 @@ void MTree::searchKNN(vector<MTreeSearchResult>& results,
       const double max_dist = MTreePoint::getMaxDistance();
       const int    klast    = k_neighbors - 1;
 
-      MTreeQuery query( query_point.makeCopy(), max_dist, this );
+      MTreeQuery query( getQueryPointPtr(query_point, 
+                                         share_points && !make_safe), 
+                        max_dist, &num_distance_comps );
 
       results.clear();
       results.reserve(k_neighbors);
@@ -514,218 +703,991 @@ void MTree::searchKNN(vector<MTreeSearchResult>& results,
          results.push_back(result); 
       }
 
-      MTreeSearchQueue queue;
+      /*
+       * Queue storage comes from the thread's scratch arena and is
+       * released when the scope ends, after the queue is destroyed.
+       */
+      toolbox::ScratchArena::Scope 
+         scratch_scope( toolbox::ScratchArena::getThreadArena() );
+
+      MTreeSearchQueue queue;
+
+      /*
+       * Start at root node and search for nearest neighbors.
+       */
+
+      MTreeNodePtr node( d_root_node );
+      while ( node.get() ) {
+
+         double old_dist = query.getGrade();
+
+         /*
+          * Use the flat entry block of the node when it matches the 
+          * query point; entry objects are then only touched for entries 
+          * consistent with the query.
+          */
+         const int block_dim = node->getEntryBlockDimension();
+         const bool use_block = 
+            ( (block_dim > 0) && (block_dim == query.getNumberCoordinates()) );
+         const double* block_coords = node->getEntryCoordinates();
+         const double* block_radii  = node->getEntryRadii();
+         const double* block_dists  = node->getEntryDistancesToParent();
+
+         const int num_entries = node->getNumberEntries();
+         for (int ie = 0; ie < num_entries; ++ie) {
+
+            query.setGrade(old_dist);
+
+            const bool is_consistent = use_block ?
+               query.isConsistent(block_coords + ie*block_dim,
+                                  block_radii[ie],
+                                  block_dists[ie]) :
+               query.isConsistent(node->getEntry(ie));
+
+            if ( is_consistent ) {
+
+               MTreeEntryPtr entry(node->getEntry(ie));
+
+               if ( entry->isDataEntry() ) {
+
+                  const double distance = rank_by_support ?
+                     toolbox::MathUtilities<double>::Max( 0.0,
+                        query.getGrade() - entry->getRadius() ) :
+                     query.getGrade();
+
+                  if ( distance < 
+                       results[klast].getDistanceToQueryPoint() ) {
+
+                     int id = 0;
+                     while ( distance > 
+                             results[id].getDistanceToQueryPoint() ) {
+                        id++;
+                     }
+
+                     for (int ir = klast; ir > id; ir--) {
+                        results[ir] = results[ir-1];
+                     }
+
+                     MTreeSearchResult result( query.getPoint(), entry );
+                     result.setDistanceToQueryPoint( distance );
+                     results[id] = result;
+
+                  }
+
+                  query.setRadius( results[klast].getDistanceToQueryPoint() /
+                                   error_factor );
+
+               } else {  // routing entry; insert child node into search queue  
+                  double dmin = 
+                     toolbox::MathUtilities<double>::Max( 0.0,
+                        query.getGrade() - entry->getRadius() );
+              
+                  MTreeSearchNode search_node( entry->getSubtreeNode(),
+                                               dmin,
+                                               query.getGrade() );
+
+                  queue.insert(search_node);
+
+               } // else
+
+            }  // if entry is consistent with query
+
+         }  // iterate over entries in node
+
+         /*
+          * If queue is not empty, pull off the next node 
+          * to search from the front of the queue.  If the
+          * queue is empty, we are done and we terminate the 
+          * search. 
+          * 
+          * The node we pull off the queue will be the subtree 
+          * whose root is next closest to query point.  If this node 
+          * is farther from the query point than the last item in  
+          * the vector of results, we are done and we terminate the 
+          * search.  Otherwise, we continue to search for data objects 
+          * closer than the ones we have collected so far.
+          */
+
+         if ( queue.empty() ||
+              ( (max_distance_comps > 0) && 
+                (num_distance_comps >= max_distance_comps) ) ) { 
+            queue.clear();
+            node.reset();
+         } else {
+            MTreeSearchNode next_node = queue.getFirst();
+            queue.removeFirst();
+ 
+            if ( next_node.getBound()*error_factor >= 
+                 results[klast].getDistanceToQueryPoint() ) {
+               queue.clear();
+               node.reset();
+            } else {
+               node = next_node.getSearchNode();
+               query.setGrade(next_node.getDistance());
+            }
+         } // else queue not empty
+
+      }  // while still searching nodes
+
+      /*
+       * Search complete, finalize results to return.  With background
+       * I/O, objects on disk are prefetched so that all but the first
+       * one finalized are read in the background.
+       */
+      if ( d_data_store.isBackgroundIOEnabled() ) {
+         for (int iresult = klast - 1; iresult >= 0; iresult--) {
+            if ( results[iresult].isValidResult() ) {
+               d_data_store.prefetchObject(results[iresult].d_data_object_id);
+            }
+         }
+      }
+
+      for (int iresult = klast; iresult >= 0; iresult--) {
+         if ( results[iresult].isValidResult() ) {
+            results[iresult].finalizeSearchResult(d_data_store,
+                                                  make_safe,
+                                                  share_points);
+         } else {
+            results.pop_back();
+         }
+      }
+
+      SearchStatistics::add(stats.d_total_distance_comps_in_knn_queries,
+                            num_distance_comps);
+      stats.d_num_distance_comps_in_last_knn_query.store(
+         num_distance_comps, std::memory_order_relaxed);
+
+   } // if number of neighbors to find is > 0
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Search tree and return all data entries whose regions have non-empty  *
+* intersection with region given by query point and radius.             *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::searchRange(list<MTreeSearchResult>& results,
+                        const MTreePoint& query_point,
+                        double radius,
+                        bool make_safe,
+                        bool share_points)
+{
+   if (radius >= 0.0) {
+
+      SearchStatistics& stats = getThreadSearchStatistics();
+      int num_distance_comps = 0;
+      SearchStatistics::add(stats.d_num_range_queries, 1);
+
+      list<MTreeSearchResult> tmp_results;
+
+      //
+      // check if there exists a root node
+      //
+
+      if (d_root_node == NULL)
+	return;
+
+      //
+      //
+      //
+
+      MTreeQuery query( getQueryPointPtr(query_point, 
+                                         share_points && !make_safe), 
+                        radius, &num_distance_comps );
+
+      searchRangeRecursive(tmp_results, query, d_root_node);
+
+      /*
+       * Search complete, finalize results to return; with background
+       * I/O, objects on disk other than the first are prefetched.
+       */
+      if ( d_data_store.isBackgroundIOEnabled() &&
+           (tmp_results.size() > 1) ) {
+         list<MTreeSearchResult>::const_iterator ir = tmp_results.begin();
+         for (++ir; ir != tmp_results.end(); ++ir) {
+            if ( ir->isValidResult() ) {
+               d_data_store.prefetchObject(ir->d_data_object_id);
+            }
+         }
+      }
+
+      results.clear();
+      while ( !tmp_results.empty() ) {
+          MTreeSearchResult result(tmp_results.front());
+          tmp_results.pop_front();
+
+          if ( result.isValidResult() ) {
+             result.finalizeSearchResult(d_data_store,
+                                         make_safe,
+                                         share_points);
+             results.push_back(result);
+          }
+
+      }
+
+      results.sort();
+
+      SearchStatistics::add(stats.d_total_distance_comps_in_range_queries,
+                            num_distance_comps);
+      stats.d_num_distance_comps_in_last_range_query.store(
+         num_distance_comps, std::memory_order_relaxed);
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private recursive member function used in rage search.                *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::searchRangeRecursive(list<MTreeSearchResult>& results,
+                                 const MTreeQuery& query,
+                                 MTreeNodePtr node) const
+{
+
+   const int block_dim = node->getEntryBlockDimension();
+   const bool use_block = 
+      ( (block_dim > 0) && (block_dim == query.getNumberCoordinates()) );
+   const double* block_coords = node->getEntryCoordinates();
+   const double* block_radii  = node->getEntryRadii();
+   const double* block_dists  = node->getEntryDistancesToParent();
+
+   if ( node->isLeaf() ) {
+
+      const int num_entries = node->getNumberEntries();
+      for (int ie = 0; ie < num_entries; ++ie) {
+         MTreeQuery q_tmp(query); 
+         const bool is_consistent = use_block ?
+            q_tmp.isConsistent(block_coords + ie*block_dim,
+                               block_radii[ie],
+                               block_dists[ie]) :
+            q_tmp.isConsistent(node->getEntry(ie));
+         if ( is_consistent ) {
+            MTreeEntryPtr entry(node->getEntry(ie));
+            MTreeSearchResult result( q_tmp.getPoint(), entry );
+            result.setDistanceToQueryPoint(q_tmp.getGrade());
+            results.push_back(result);
+         }
+      }
+
+   } else {
+
+      const int num_entries = node->getNumberEntries();
+      for (int ie = 0; ie < num_entries; ++ie) {
+         MTreeQuery q_tmp(query);
+         const bool is_consistent = use_block ?
+            q_tmp.isConsistent(block_coords + ie*block_dim,
+                               block_radii[ie],
+                               block_dists[ie]) :
+            q_tmp.isConsistent(node->getEntry(ie));
+         if ( is_consistent ) {
+            MTreeEntryPtr entry(node->getEntry(ie));
+            list<MTreeSearchResult> e_results;
+            searchRangeRecursive(e_results,
+                                 query,
+                                 entry->getSubtreeNode()); 
+            if (!e_results.empty()) {
+               results.insert(results.end(), e_results.begin(), e_results.end()); 
+               e_results.clear();
+            }
+         }
+      }
+
+   }
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to insert data entry into tree structure, splitting   *
+* nodes as needed.  Object associated with entry must be in data store. *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::insertDataEntry(MTreeEntryPtr entry)
+{
+   if (!d_root_node) {
+      createRootNode();
+   }
+
+   MTreeNodePtr node( pickNode(d_root_node, entry) );
+
+   MTreeNode::insertEntry(entry, node);
+
+   clearLevelStatistics();
+ 
+   if (node->isOverfull()) {
+
+      split(node);
+
+      if (node->isOverfull()) {  // just to be anal....
+         TBOX_ERROR("MTree::insertDataEntry() error"
+                    << " for tree named = " << d_tree_name
+                    << "\nSplit of overfull node id " 
+                    << node->getNodeId()
+                    << "\nfailed for object id " 
+                    << entry->getDataObjectId()
+                    << endl);
+      }
+
+   } else {
+
+      mapDataObjectsToNode(node);
+
+      node->resetRadiiUpToRoot();
+
+   }
+ 
+   if (d_do_error_checking) {
+      *d_error_log_stream 
+      << "Checking correctness from insert node up to root"
+      << "\nafter inserting object # " << entry->getDataObjectId()
+      << " ..." << endl;
+      if ( node->checkConsistencyUpToRoot(*d_error_log_stream) ) {
+         *d_error_log_stream << "      Everything looks good!" << endl; 
+      } else {
+         *d_error_log_stream << "      Problems found!" << endl; 
+      }
+   }
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to find data entry for object in given leaf node.     *
+*                                                                       *
+*************************************************************************
+*/
+
+MTreeEntryPtr MTree::findDataEntry(MTreeNodePtr node,
+                                   int object_id) const
+{
+   MTreeEntryPtr entry;
+
+   const int num_entries = node->getNumberEntries();
+   for (int ie = 0; ie < num_entries; ++ie) {
+      if ( object_id == node->getEntry(ie)->getDataObjectId() ) {
+         entry = node->getEntry(ie);
+         break;
+      }
+   }
+
+   return(entry);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to restructure tree after an entry has been removed   *
+* from given node.                                                      *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::pruneEmptyNodes(MTreeNodePtr node)
+{
+   /* 
+    * If the node is now empty but is not the root in the tree, 
+    * we delete the node from the tree.
+    * 
+    * If the parent node contains only one other child node 
+    * apart from the empty node, we attempt to move some entries 
+    * from the other child to the empty node.  This helps to 
+    * maintain some fanout in the tree.  If the other 
+    * child node doesn't have enough entries to share (i.e.,
+    * it has one or zero entries) then we cannot do this and
+    * so the parent will have only one child node.
+    *
+    * If the parent node is now empty, we recurse and apply
+    * the same algorithm to the parent.  We stop at the root
+    * or the first non-empty parent node.
+    */
+
+   while ( !node->isRoot() &&
+           (node->getNumberEntries() == 0) ) {
+
+      MTreeNodePtr  parent_node( node->getParentNode() );
+      MTreeEntryPtr parent_entry( node->getParentEntry() );
+
+      if ( parent_node->getNumberEntries() == 1 ) {
+
+         if ( node->isLeaf() ) {
+            d_data_store.removeLeafNode(node);
+            removeNodeFromLevelCount( node->getLevelInTree() );
+         }
+         MTreeNode::deleteEntry(parent_entry, parent_node);
+
+      } else {
+
+         if ( parent_node->getNumberEntries() == 2 ) {  
+
+            MTreeNodePtr neighbor_node;
+            if ( parent_entry->getPositionInNode() == 0 ) {
+               neighbor_node = 
+                  parent_node->getEntry(1)->getSubtreeNode();
+            } else {
+               neighbor_node = 
+                  parent_node->getEntry(0)->getSubtreeNode();
+            }
+
+            if ( node->isLeaf() ) {
+               d_data_store.removeLeafNode(node);
+               removeNodeFromLevelCount( node->getLevelInTree() );
+            }
+            MTreeNode::deleteEntry(parent_entry, parent_node);
+
+            if ( neighbor_node->getNumberEntries() >= 2) {
+
+               parent_node->resetRadius();
+
+               bool use_root_promotion = false;
+               bool special_delete_split = true;
+               MTreeNodePtr new_node(
+                  neighbor_node->split( use_root_promotion,
+                                        special_delete_split ) );
+
+               if (neighbor_node->isLeaf()) {
+                  mapDataObjectsToNode(neighbor_node);
+                  mapDataObjectsToNode(new_node);
+               } else {
+                  new_node->
+                     setLevelInTree( neighbor_node->getLevelInTree() );
+               }
+
+            } // if neighbor node can be split
+
+         } else { // parent node has more than 2 entries;
+                  // simply remove empty child node
+
+            if ( node->isLeaf() ) { 
+               d_data_store.removeLeafNode(node);
+               removeNodeFromLevelCount( node->getLevelInTree() );
+            }
+            MTreeNode::deleteEntry(parent_entry, parent_node);
+
+         }
+
+      }  // else parent node has at least two entries
+
+      parent_node->resetRadius(); 
+
+      if ( parent_node->getNumberEntries() == 0 ) {
+         parent_node->
+            setLevelInTree( parent_node->getLevelInTree() - 1 );
+      }
+
+      node = parent_node;
+
+   } // while node to prune is empty but is not root node 
+
+   if ( !node->isRoot() ) {
+      node->resetRadiiUpToRoot();
+   }
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to partition entries for bulk loading.  The entries   *
+* are partitioned recursively by partitionBulkLoadCluster(); the seeds  *
+* of the enclosing partition steps of a cluster serve as pivots, whose  *
+* distances to the entries of the cluster are known from those steps.   *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::partitionBulkLoadEntries(vector< vector<MTreeEntryPtr> >& groups,
+                                     const vector<MTreeEntryPtr>& entries)
+{
+   const int num_entries = entries.size();
+
+   vector<int> cluster(num_entries);
+   for (int ie = 0; ie < num_entries; ++ie) {
+      cluster[ie] = ie;
+   }
+
+   vector< vector<double> > pivot_distances;
+
+   partitionBulkLoadCluster(groups, entries, cluster, pivot_distances, 0);
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to partition a cluster of entries for bulk loading.   *
+* At most BULK_LOAD_MAX_SEEDS seeds are sampled at random and every     *
+* other entry is assigned to its closest seed.  The triangle inequality *
+* is used to skip seeds that cannot be closer than the best one found   *
+* so far: the seed-to-seed distances bound the distance to a seed from  *
+* that to the best seed, and the distances of the entry and the seed to *
+* each pivot bound it from below.  A seed coinciding with an earlier    *
+* seed is treated as a regular entry.                                   *
+*                                                                       *
+* Clusters holding fewer than the minimum node utilization fraction of  *
+* the max node entries are dissolved into the remaining clusters,       *
+* smallest first, while more than two clusters remain.  If one of two   *
+* remaining clusters is still underfull, the entries of the other       *
+* cluster closest to its seed are moved to it.  Clusters that are       *
+* still too large are partitioned again, with their seed as a further  *
+* pivot.  If all entries end up with one seed (e.g., coincident         *
+* points), the entries are split into consecutive chunks instead so the *
+* recursion finishes.                                                   *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTree::partitionBulkLoadCluster(
+   vector< vector<MTreeEntryPtr> >& groups,
+   const vector<MTreeEntryPtr>& entries,
+   const vector<int>& cluster,
+   vector< vector<double> >& pivot_distances,
+   int num_pivots)
+{
+   const int cluster_size = cluster.size();
+
+   if (cluster_size <= d_max_node_entries) {
 
       /*
-       * Start at root node and search for nearest neighbors.
+       * The seed is the first entry of the cluster and the last pivot.
        */
+      vector<MTreeEntryPtr> group(cluster_size);
+      for (int ic = 0; ic < cluster_size; ++ic) {
+         group[ic] = entries[cluster[ic]];
+         group[ic]->setDistanceToParent( (num_pivots > 0) ?
+            pivot_distances[num_pivots-1][cluster[ic]] : 0.0 );
+      }
+      groups.push_back(group);
 
-      MTreeNodePtr node( d_root_node );
-      while ( node.get() ) {
+   } else {
 
-         double old_dist = query.getGrade();
+      const int num_entries = entries.size();
 
-         const int num_entries = node->getNumberEntries();
-         for (int ie = 0; ie < num_entries; ++ie) {
-            MTreeEntryPtr entry(node->getEntry(ie));
+      const int num_seeds = 
+         toolbox::MathUtilities<int>::Min( 
+            toolbox::MathUtilities<int>::Min( d_max_node_entries, 
+                                              BULK_LOAD_MAX_SEEDS ),
+            (cluster_size + d_max_node_entries - 1) / d_max_node_entries );
 
-            query.setGrade(old_dist);
+      const int min_entries = 
+         toolbox::MathUtilities<int>::Max( 1,
+            static_cast<int>(d_min_node_utilization * d_max_node_entries) );
 
-            if ( query.isConsistent(entry) ) {
+      /*
+       * Move randomly chosen seeds to the front of the entry order.
+       * Below the top of a level, the seed of the cluster, which is its
+       * first entry and the last pivot, is kept as the first seed.
+       */
+      const bool keep_seed = (num_pivots > 0);
+
+      vector<int> order(cluster);
+      for (int is = (keep_seed ? 1 : 0); is < num_seeds; ++is) {
+         const int js = 
+            toolbox::MathUtilities<int>::Rand(is, cluster_size - is);
+         const int tmp = order[is];
+         order[is] = order[js];
+         order[js] = tmp;
+      }
 
-               if ( entry->isDataEntry() ) {
+      vector<int> seeds(order.begin(), order.begin() + num_seeds);
 
-                  if ( query.getGrade() < 
-                       results[klast].getDistanceToQueryPoint() ) {
+      vector<double> seed_distances(num_seeds * num_seeds, 0.0);
+      vector<bool> active_seeds(num_seeds, true);
+      for (int is = 0; is < num_seeds; ++is) {
+         for (int js = is + 1; js < num_seeds; ++js) {
+            double dist = 0.0;
+            if (keep_seed && (is == 0)) {
+               dist = pivot_distances[num_pivots-1][seeds[js]];
+            } else {
+               dist = 
+                  entries[seeds[is]]->computeDistanceTo(entries[seeds[js]]);
+               incrementDistanceComputeCount();
+            }
+            seed_distances[is*num_seeds + js] = dist;
+            seed_distances[js*num_seeds + is] = dist;
+            if (dist == 0.0) {
+               active_seeds[js] = false;
+            }
+         }
+      }
 
-                     int id = 0;
-                     while ( query.getGrade() > 
-                             results[id].getDistanceToQueryPoint() ) {
-                        id++;
-                     }
+      /*
+       * The distances to the seed of the cluster of each entry go to
+       * the pivot distances of the next level of recursion.
+       */
+      if (static_cast<int>(pivot_distances.size()) == num_pivots) {
+         pivot_distances.push_back( vector<double>(num_entries, 0.0) );
+      }
+      vector<double>& distances = pivot_distances[num_pivots];
+
+      vector< vector<int> > clusters(num_seeds);
+      int num_clusters = 0;
+      for (int is = 0; is < num_seeds; ++is) {
+         if ( active_seeds[is] ) {
+            clusters[is].push_back(seeds[is]);
+            distances[seeds[is]] = 0.0;
+            num_clusters++;
+         }
+      }
 
-                     for (int ir = klast; ir > id; ir--) {
-                        results[ir] = results[ir-1];
-                     }
+      for (int ic = 0; ic < cluster_size; ++ic) {
+         if ( (ic < num_seeds) && active_seeds[ic] ) {
+            continue;
+         }
+         const int ie = order[ic];
+         const int is = findBulkLoadSeed(entries,
+                                         ie,
+                                         seeds,
+                                         seed_distances,
+                                         active_seeds,
+                                         keep_seed,
+                                         pivot_distances,
+                                         num_pivots);
+         clusters[is].push_back(ie);
+      }
 
-                     MTreeSearchResult result( query.getPoint(), entry );
-                     result.setDistanceToQueryPoint( query.getGrade() );
-                     results[id] = result;
+      while (num_clusters > 2) {
 
-                  }
+         int smallest = -1;
+         for (int is = 0; is < num_seeds; ++is) {
+            if ( active_seeds[is] && 
+                 ( (smallest < 0) || 
+                   (clusters[is].size() < clusters[smallest].size()) ) ) {
+               smallest = is;
+            }
+         }
 
-                  query.setRadius( results[klast].getDistanceToQueryPoint() );
+         if (static_cast<int>(clusters[smallest].size()) >= min_entries) {
+            break;
+         }
 
-               } else {  // routing entry; insert child node into search queue  
-                  double dmin = 
-                     toolbox::MathUtilities<double>::Max( 0.0,
-                        query.getGrade() - entry->getRadius() );
-              
-                  MTreeSearchNode search_node( entry->getSubtreeNode(),
-                                               dmin,
-                                               query.getGrade() );
+         active_seeds[smallest] = false;
+         num_clusters--;
+
+         const int num_moved = clusters[smallest].size();
+         for (int im = 0; im < num_moved; ++im) {
+            const int ie = clusters[smallest][im];
+            const int is = findBulkLoadSeed(entries,
+                                            ie,
+                                            seeds,
+                                            seed_distances,
+                                            active_seeds,
+                                            keep_seed,
+                                            pivot_distances,
+                                            num_pivots);
+            clusters[is].push_back(ie);
+         }
+         clusters[smallest].clear();
 
-                  queue.insert(search_node);
+      }
 
-               } // else
+      if (num_clusters == 2) {
 
-            }  // if entry is consistent with query
+         int small_cluster = -1;
+         int large_cluster = -1;
+         for (int is = 0; is < num_seeds; ++is) {
+            if ( active_seeds[is] ) {
+               if (small_cluster < 0) {
+                  small_cluster = is;
+               } else {
+                  large_cluster = is;
+               }
+            }
+         }
+         if (clusters[small_cluster].size() > clusters[large_cluster].size()) {
+            const int tmp = small_cluster;
+            small_cluster = large_cluster;
+            large_cluster = tmp;
+         }
 
-         }  // iterate over entries in node
+         const int num_missing = 
+            min_entries - static_cast<int>(clusters[small_cluster].size());
+
+         if (num_missing > 0) {
+            moveBulkLoadEntries(clusters[small_cluster],
+                                clusters[large_cluster],
+                                num_missing,
+                                entries,
+                                seed_distances[small_cluster*num_seeds + 
+                                               large_cluster],
+                                pivot_distances,
+                                num_pivots);
+         }
 
-         /*
-          * If queue is not empty, pull off the next node 
-          * to search from the front of the queue.  If the
-          * queue is empty, we are done and we terminate the 
-          * search. 
-          * 
-          * The node we pull off the queue will be the subtree 
-          * whose root is next closest to query point.  If this node 
-          * is farther from the query point than the last item in  
-          * the vector of results, we are done and we terminate the 
-          * search.  Otherwise, we continue to search for data objects 
-          * closer than the ones we have collected so far.
-          */
+      }
 
-         if ( queue.empty() ) { 
-            node.reset();
-         } else {
-            MTreeSearchNode next_node = queue.getFirst();
-            queue.removeFirst();
- 
-            if ( next_node.getBound() >= 
-                 results[klast].getDistanceToQueryPoint() ) {
-               queue.clear();
-               node.reset();
-            } else {
-               node = next_node.getSearchNode();
-               query.setGrade(next_node.getDistance());
+      if (num_clusters == 1) {
+
+         const int chunk_size = (cluster_size + num_seeds - 1) / num_seeds;
+         for (int is = 0; is < num_seeds; ++is) {
+            clusters[is].clear();
+            const int first = is * chunk_size;
+            const int last = 
+               toolbox::MathUtilities<int>::Min( cluster_size, 
+                                                 first + chunk_size );
+            for (int ic = first; ic < last; ++ic) {
+               const int ie = cluster[ic];
+               if (ic == first) {
+                  distances[ie] = 0.0;
+               } else {
+                  distances[ie] = 
+                     entries[ie]->computeDistanceTo(entries[cluster[first]]);
+                  incrementDistanceComputeCount();
+               }
+               clusters[is].push_back(ie);
             }
-         } // else queue not empty
+         }
 
-      }  // while still searching nodes
+      }
 
-      /*
-       * Search complete, finalize results to return.
-       */
-      for (int iresult = klast; iresult >= 0; iresult--) {
-         if ( results[iresult].isValidResult() ) {
-            results[iresult].finalizeSearchResult(d_data_store,
-                                                  make_safe);
-         } else {
-            results.pop_back();
+      for (int is = 0; is < num_seeds; ++is) {
+         if ( !clusters[is].empty() ) {
+            partitionBulkLoadCluster(groups,
+                                     entries,
+                                     clusters[is],
+                                     pivot_distances,
+                                     num_pivots + 1);
          }
       }
 
-      d_current_distance_type = DISTANCE_UNDEFINED;
+   }
 
-   } // if number of neighbors to find is > 0
 }
 
 /*
 *************************************************************************
 *                                                                       *
-* Search tree and return all data entries whose regions have non-empty  *
-* intersection with region given by query point and radius.             *
+* Private routine to find the closest active seed to an entry for bulk  *
+* loading and to set the pivot distance of the entry for the seeds to   *
+* the distance to it.  The seed with the smallest lower bound on its    *
+* distance to the entry is tried first, and seeds whose lower bound is  *
+* no less than the best distance found so far are skipped.              *
 *                                                                       *
 *************************************************************************
 */
 
-void MTree::searchRange(list<MTreeSearchResult>& results,
-                        const MTreePoint& query_point,
-                        double radius,
-                        bool make_safe)
+int MTree::findBulkLoadSeed(const vector<MTreeEntryPtr>& entries,
+                            int entry,
+                            const vector<int>& seeds,
+                            const vector<double>& seed_distances,
+                            const vector<bool>& active_seeds,
+                            bool first_seed_is_pivot,
+                            vector< vector<double> >& pivot_distances,
+                            int num_pivots)
 {
-   if (radius >= 0.0) {
+   const int num_seeds = seeds.size();
+
+   double bounds[BULK_LOAD_MAX_SEEDS];
+   int best_seed = -1;
+   for (int is = 0; is < num_seeds; ++is) {
+      if ( active_seeds[is] ) {
+         bounds[is] = getBulkLoadDistanceBound(pivot_distances,
+                                               num_pivots,
+                                               entry,
+                                               seeds[is]);
+         if ( (best_seed < 0) || (bounds[is] < bounds[best_seed]) ) {
+            best_seed = is;
+         }
+      }
+   }
 
-      d_num_distance_comps_in_last_range_query = 0;
-      d_current_distance_type = DISTANCE_RANGE_QUERY;
-      d_num_range_queries++;
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(best_seed >= 0);
+#endif
 
-      list<MTreeSearchResult> tmp_results;
+   double distance = 0.0;
+   if (first_seed_is_pivot && active_seeds[0]) {
+      best_seed = 0;
+      distance = pivot_distances[num_pivots-1][entry];
+   } else {
+      distance = entries[entry]->computeDistanceTo(entries[seeds[best_seed]]);
+      incrementDistanceComputeCount();
+   }
+   const int first_seed = best_seed;
 
-      //
-      // check if there exists a root node
-      //
+   for (int is = 0; is < num_seeds; ++is) {
+      if ( !active_seeds[is] || (is == first_seed) ||
+           (bounds[is] >= distance) ||
+           (seed_distances[best_seed*num_seeds + is] >= 2.0*distance) ) {
+         continue;
+      }
+      const double dist = 
+         entries[entry]->computeDistanceTo(entries[seeds[is]]);
+      incrementDistanceComputeCount();
+      if (dist < distance) {
+         best_seed = is;
+         distance = dist;
+      }
+   }
 
-      if (d_root_node == NULL)
-	return;
+   pivot_distances[num_pivots][entry] = distance;
 
-      //
-      //
-      //
+   return(best_seed);
 
-      MTreeQuery query( query_point.makeCopy(), radius, this );
+}
 
-      searchRangeRecursive(tmp_results, query, d_root_node);
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to move to a cluster the given number of entries of   *
+* another cluster closest to its seed for bulk loading.  Candidates are *
+* visited in order of the lower bound on their distance to the seed and *
+* the closest ones found are kept in a max-heap; the search stops once  *
+* no remaining candidate can be closer than the farthest one kept.  The *
+* seed of the other cluster is never moved.                             *
+*                                                                       *
+*************************************************************************
+*/
 
-      /*
-       * Search complete, finalize results to return.
-       */
-      results.clear();
-      while ( !tmp_results.empty() ) {
-          MTreeSearchResult result(tmp_results.front());
-          tmp_results.pop_front();
+void MTree::moveBulkLoadEntries(vector<int>& to_cluster,
+                                vector<int>& from_cluster,
+                                int num_moved,
+                                const vector<MTreeEntryPtr>& entries,
+                                double seed_distance,
+                                vector< vector<double> >& pivot_distances,
+                                int num_pivots)
+{
+   vector<double>& distances = pivot_distances[num_pivots];
+
+   const int to_seed = to_cluster[0];
+   const int num_from = from_cluster.size();
+
+   vector< pair<double, int> > candidates;
+   candidates.reserve(num_from - 1);
+   for (int ic = 1; ic < num_from; ++ic) {
+      const int ie = from_cluster[ic];
+      candidates.push_back( make_pair(
+         toolbox::MathUtilities<double>::Max( 
+            toolbox::MathUtilities<double>::Abs(distances[ie] - 
+                                                seed_distance),
+            getBulkLoadDistanceBound(pivot_distances,
+                                     num_pivots,
+                                     ie,
+                                     to_seed) ),
+         ie) );
+   }
+   sort(candidates.begin(), candidates.end());
+
+   vector< pair<double, int> > closest;
+   closest.reserve(num_moved);
+   const int num_candidates = candidates.size();
+   for (int ic = 0; ic < num_candidates; ++ic) {
+      if ( (static_cast<int>(closest.size()) == num_moved) &&
+           (candidates[ic].first >= closest.front().first) ) {
+         break;
+      }
+      const int ie = candidates[ic].second;
+      const double dist = entries[ie]->computeDistanceTo(entries[to_seed]);
+      incrementDistanceComputeCount();
+      if (static_cast<int>(closest.size()) < num_moved) {
+         closest.push_back( make_pair(dist, ie) );
+         push_heap(closest.begin(), closest.end());
+      } else if (dist < closest.front().first) {
+         pop_heap(closest.begin(), closest.end());
+         closest.back() = make_pair(dist, ie);
+         push_heap(closest.begin(), closest.end());
+      }
+   }
 
-          if ( result.isValidResult() ) {
-             result.finalizeSearchResult(d_data_store,
-                                         make_safe);
-             results.push_back(result);
-          }
+   vector<int> moved(num_moved);
+   for (int im = 0; im < num_moved; ++im) {
+      const int ie = closest[im].second;
+      distances[ie] = closest[im].first;
+      to_cluster.push_back(ie);
+      moved[im] = ie;
+   }
+   sort(moved.begin(), moved.end());
 
+   vector<int> kept;
+   kept.reserve(num_from - num_moved);
+   for (int ic = 0; ic < num_from; ++ic) {
+      if ( !binary_search(moved.begin(), moved.end(), from_cluster[ic]) ) {
+         kept.push_back(from_cluster[ic]);
       }
+   }
+   from_cluster.swap(kept);
 
-      results.sort();
+}
 
-      d_current_distance_type = DISTANCE_UNDEFINED;
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to compute the lower bound on the distance between    *
+* two entries for bulk loading given by their distances to the pivots.  *
+*                                                                       *
+*************************************************************************
+*/
 
+double MTree::getBulkLoadDistanceBound(
+   const vector< vector<double> >& pivot_distances,
+   int num_pivots,
+   int entry,
+   int other_entry)
+{
+   double bound = 0.0;
+   for (int ip = 0; ip < num_pivots; ++ip) {
+      const vector<double>& distances = pivot_distances[ip];
+      bound = toolbox::MathUtilities<double>::Max( bound,
+         toolbox::MathUtilities<double>::Abs( distances[entry] - 
+                                              distances[other_entry] ) );
    }
+   return(bound);
 }
 
 /*
 *************************************************************************
 *                                                                       *
-* Private recursive member function used in rage search.                *
+* Private routine to create nodes at given level for bulk loading.      *
+* Each group becomes a node whose parent entry is a copy of the first   *
+* entry of the group; the covering radius of the parent entry is set    *
+* from the entries placed in the node.                                  *
 *                                                                       *
 *************************************************************************
 */
 
-void MTree::searchRangeRecursive(list<MTreeSearchResult>& results,
-                                 const MTreeQuery& query,
-                                 MTreeNodePtr node) const
+void MTree::buildBulkLoadLevel(vector<MTreeEntryPtr>& parent_entries,
+                               const vector< vector<MTreeEntryPtr> >& groups,
+                               int level)
 {
+   const int num_groups = groups.size();
 
-   if ( node->isLeaf() ) {
+   parent_entries.clear();
+   parent_entries.reserve(num_groups);
 
-      const int num_entries = node->getNumberEntries();
+   for (int ig = 0; ig < num_groups; ++ig) {
+
+      const vector<MTreeEntryPtr>& group = groups[ig];
+
+      MTreeNodePtr node( new MTreeNode(this, d_max_node_entries) );
+      node->setLevelInTree(level);
+
+      MTreeEntryPtr parent_entry( new MTreeEntry(group[0]->getKey()) );
+      parent_entry->setSubtreeNode(node);
+      node->setParentEntry(parent_entry);
+
+      const int num_entries = group.size();
       for (int ie = 0; ie < num_entries; ++ie) {
-         MTreeEntryPtr entry(node->getEntry(ie));
-         MTreeQuery q_tmp(query); 
-         if ( q_tmp.isConsistent(entry) ) {
-            MTreeSearchResult result( q_tmp.getPoint(), entry );
-            result.setDistanceToQueryPoint(q_tmp.getGrade());
-            results.push_back(result);
-         }
+         MTreeNode::insertEntry(group[ie], node);
       }
 
-   } else {
+      node->resetRadius();
 
-      const int num_entries = node->getNumberEntries();
-      for (int ie = 0; ie < num_entries; ++ie) {
-         MTreeEntryPtr entry(node->getEntry(ie));
-         MTreeQuery q_tmp(query);
-         if ( q_tmp.isConsistent(entry) ) {
-            list<MTreeSearchResult> e_results;
-            searchRangeRecursive(e_results,
-                                 query,
-                                 entry->getSubtreeNode()); 
-            if (!e_results.empty()) {
-               results.insert(results.end(), e_results.begin(), e_results.end()); 
-               e_results.clear();
-            }
-         }
+      if ( node->isLeaf() ) {
+         mapDataObjectsToNode(node);
       }
 
+      parent_entries.push_back(parent_entry);
+
    }
 
 }
@@ -1326,22 +2288,22 @@ void MTree::printAllTreeOperationStatistics(ostream& stream) const
 {
    stream << "\nMTree::printAllTreeOperationStatistics()\n";
    stream << "------------------------------------------\n";
-   stream << "d_num_range_queries = " << d_num_range_queries << endl;
-   stream << "d_num_knn_queries = " << d_num_knn_queries << endl;
+   stream << "d_num_range_queries = " << getTotalRangeSearchCount() << endl;
+   stream << "d_num_knn_queries = " << getTotalKNNSearchCount() << endl;
    stream << "d_num_inserts = " << d_num_inserts << endl;
    stream << "d_num_deletes = " << d_num_deletes << endl;
    stream << "d_total_distance_comps_in_range_queries = " 
-          << d_total_distance_comps_in_range_queries << endl;
+          << getTotalRangeSearchDistanceCount() << endl;
    stream << "d_total_distance_comps_in_knn_queries = " 
-          << d_total_distance_comps_in_knn_queries << endl;
+          << getTotalKNNSearchDistanceCount() << endl;
    stream << "d_total_distance_comps_in_inserts = " 
           << d_total_distance_comps_in_inserts << endl;
    stream << "d_total_distance_comps_in_deletes = " 
           << d_total_distance_comps_in_deletes << endl;
    stream << "d_num_distance_comps_in_last_range_query = " 
-          << d_num_distance_comps_in_last_range_query << endl;
+          << getLastRangeSearchDistanceCount() << endl;
    stream << "d_num_distance_comps_in_last_knn_query = " 
-          << d_num_distance_comps_in_last_knn_query << endl;
+          << getLastKNNSearchDistanceCount() << endl;
    stream << "d_num_distance_comps_in_last_insert = " 
           << d_num_distance_comps_in_last_insert << endl;
    stream << "d_num_distance_comps_in_last_delete = " 
@@ -1360,18 +2322,6 @@ void MTree::incrementDistanceComputeCount()
 {
    switch(d_current_distance_type) {
 
-      case DISTANCE_RANGE_QUERY: {
-         d_total_distance_comps_in_range_queries++;
-         d_num_distance_comps_in_last_range_query++;
-         break;
-      }
-
-      case DISTANCE_KNN_QUERY: {
-         d_total_distance_comps_in_knn_queries++;
-         d_num_distance_comps_in_last_knn_query++;
-         break;
-      }
-
       case DISTANCE_INSERT: {
          d_total_distance_comps_in_inserts++;
          d_num_distance_comps_in_last_insert++;
@@ -1392,19 +2342,143 @@ void MTree::incrementDistanceComputeCount()
 void MTree::clearOperationCountStatistics()
 {
   d_current_distance_type = DISTANCE_UNDEFINED;
-  d_num_range_queries = 0; 
-  d_num_knn_queries = 0; 
   d_num_inserts = 0; 
   d_num_deletes = 0; 
-  d_total_distance_comps_in_range_queries = 0; 
-  d_total_distance_comps_in_knn_queries = 0; 
   d_total_distance_comps_in_inserts = 0; 
   d_total_distance_comps_in_deletes = 0; 
-  d_num_distance_comps_in_last_range_query = 0; 
-  d_num_distance_comps_in_last_knn_query = 0; 
   d_num_distance_comps_in_last_insert = 0; 
   d_num_distance_comps_in_last_delete = 0;
 
+  /*
+   * Per-thread records are cleared in place rather than erased since
+   * threads cache pointers to them.
+   */
+  std::lock_guard<std::mutex> lock(d_search_statistics_mutex);
+  map<std::thread::id, SearchStatistics>::iterator it;
+  for (it = d_search_statistics.begin(); 
+       it != d_search_statistics.end(); ++it) {
+     it->second.clear();
+  }
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private methods to access per-thread search statistics.  Each thread  *
+* caches a pointer to its record for the most recently searched tree    *
+* so that the map (and its mutex) is only touched when a thread first   *
+* searches a given tree.                                                *
+*                                                                       *
+*************************************************************************
+*/
+
+MTree::SearchStatistics::SearchStatistics()
+{
+   clear();
+}
+
+void MTree::SearchStatistics::clear()
+{
+   d_num_range_queries.store(0, std::memory_order_relaxed);
+   d_num_knn_queries.store(0, std::memory_order_relaxed);
+   d_total_distance_comps_in_range_queries.store(0, std::memory_order_relaxed);
+   d_total_distance_comps_in_knn_queries.store(0, std::memory_order_relaxed);
+   d_num_distance_comps_in_last_range_query.store(0, std::memory_order_relaxed);
+   d_num_distance_comps_in_last_knn_query.store(0, std::memory_order_relaxed);
+}
+
+/*
+ * Counters have a single writer, so a relaxed load and store suffices 
+ * (no locked read-modify-write needed).
+ */
+void MTree::SearchStatistics::add(std::atomic<int>& counter, int count)
+{
+   counter.store(counter.load(std::memory_order_relaxed) + count,
+                 std::memory_order_relaxed);
+}
+
+MTree::SearchStatistics& MTree::getThreadSearchStatistics() const
+{
+   static thread_local int t_cached_tree_serial = -1;
+   static thread_local SearchStatistics* t_cached_stats = NULL;
+
+   if (t_cached_tree_serial != d_tree_serial) {
+      std::lock_guard<std::mutex> lock(d_search_statistics_mutex);
+      t_cached_stats = &d_search_statistics[std::this_thread::get_id()];
+      t_cached_tree_serial = d_tree_serial;
+   }
+
+   return( *t_cached_stats );
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Methods to get search operation count information; totals are summed  *
+* over all threads, last-search counts are those of the calling thread. *
+*                                                                       *
+*************************************************************************
+*/
+
+int MTree::getTotalKNNSearchCount() const
+{
+   std::lock_guard<std::mutex> lock(d_search_statistics_mutex);
+   int count = 0;
+   map<std::thread::id, SearchStatistics>::const_iterator it;
+   for (it = d_search_statistics.begin(); 
+        it != d_search_statistics.end(); ++it) {
+      count += it->second.d_num_knn_queries.load(std::memory_order_relaxed);
+   }
+   return(count);
+}
+
+int MTree::getTotalKNNSearchDistanceCount() const
+{
+   std::lock_guard<std::mutex> lock(d_search_statistics_mutex);
+   int count = 0;
+   map<std::thread::id, SearchStatistics>::const_iterator it;
+   for (it = d_search_statistics.begin(); 
+        it != d_search_statistics.end(); ++it) {
+      count += it->second.d_total_distance_comps_in_knn_queries.load(std::memory_order_relaxed);
+   }
+   return(count);
+}
+
+int MTree::getLastKNNSearchDistanceCount() const
+{
+   return(getThreadSearchStatistics().
+          d_num_distance_comps_in_last_knn_query.load(std::memory_order_relaxed));
+}
+
+int MTree::getTotalRangeSearchCount() const
+{
+   std::lock_guard<std::mutex> lock(d_search_statistics_mutex);
+   int count = 0;
+   map<std::thread::id, SearchStatistics>::const_iterator it;
+   for (it = d_search_statistics.begin(); 
+        it != d_search_statistics.end(); ++it) {
+      count += it->second.d_num_range_queries.load(std::memory_order_relaxed);
+   }
+   return(count);
+}
+
+int MTree::getTotalRangeSearchDistanceCount() const
+{
+   std::lock_guard<std::mutex> lock(d_search_statistics_mutex);
+   int count = 0;
+   map<std::thread::id, SearchStatistics>::const_iterator it;
+   for (it = d_search_statistics.begin(); 
+        it != d_search_statistics.end(); ++it) {
+      count += it->second.d_total_distance_comps_in_range_queries.load(std::memory_order_relaxed);
+   }
+   return(count);
+}
+
+int MTree::getLastRangeSearchDistanceCount() const
+{
+   return(getThreadSearchStatistics().
+          d_num_distance_comps_in_last_range_query.load(std::memory_order_relaxed));
 }
 
 }
@@ -32,6 +32,27 @@ using namespace std;
 using namespace std;
 #endif
 
+#ifndef included_map
+#define included_map
+#include <map>
+using namespace std;
+#endif
+
+#ifndef included_atomic
+#define included_atomic
+#include <atomic>
+#endif
+
+#ifndef included_mutex
+#define included_mutex
+#include <mutex>
+#endif
+
+#ifndef included_thread
+#define included_thread
+#include <thread>
+#endif
+
 #ifndef included_mtreedb_MTreeDataStore
 #include <mtreedb/MTreeDataStore.h>
 #endif
@@ -59,6 +80,9 @@ using namespace std;
 #ifndef included_mtreedb_MTreeLevelStatistic
 #include <mtreedb/MTreeLevelStatistic.h>
 #endif
+#ifndef included_mtreedb_MetricIndex
+#include <mtreedb/MetricIndex.h>
+#endif
 
 #ifndef NULL
 #define NULL (0)
@@ -94,11 +118,17 @@ class MTreeSearchResult;
  *               may be zero if the user desires to index points in the
  *               metric space rather than spherical regions.  However,
  *               each object must be specified by a unique point.
+ *               A large collection of objects may be loaded into an
+ *               empty tree at once using the bulkLoad() method.
  * 
  * -# Query data. The data in the tree can be searched in two ways. 
  *               The searchKNN() method returns the k-nearest neighbors 
  *               of a given point, and the searchRange() method returns 
  *               all data objects within a given distance of a given point.
+ *               Searches may be performed concurrently by several 
+ *               threads provided no thread modifies the tree (insert, 
+ *               delete, write objects) at the same time; callers are 
+ *               responsible for this exclusion.
  *
  * -# Finalize the tree structure by calling the finalize() method.  
  *               This will write all MTree index structure state and
@@ -106,18 +136,22 @@ class MTreeSearchResult;
  * 
  * -# Destroy the tree by calling the dtor explicitly or letting the
  *               tree go out of scope.
+ *
+ * MTree implements the MetricIndex interface; code that only inserts,
+ * retrieves and searches data objects may use that interface instead
+ * so that another index structure can be substituted.
  * 
  * @see mtreedb::MTreeObject
  * @see mtreedb::MTreePoint
  * @see mtreedb::MTreeNode
  * @see mtreedb::MTreeDataStore
+ * @see mtreedb::MetricIndex
  */
 
-class MTree
+class MTree : public MetricIndex
 {
 public:
    friend class MTreeNode;
-   friend class MTreeQuery;
 
    /*!
     * Ctor for MTree object sets tree name and default node size and
@@ -158,10 +192,15 @@ public:
     *                     this tree.
     * @param obj_factory  Const reference to factory that creates 
     *                     concrete data objects to be indexed by tree.
+    * @param object_store_type Optional store of data objects written 
+    *                     out of memory (see MTreeDataStore); HDF5 
+    *                     files by default.
     */
    void initializeCreate(const string& directory_name,
                          const string& file_prefix,
-                         const MTreeObjectFactory& obj_factory);
+                         const MTreeObjectFactory& obj_factory,
+                         MTreeDataStore::ObjectStoreType object_store_type =
+                            MTreeDataStore::HDF_FILE_OBJECT_STORE);
 
    /*!
     * Initialize MTree to state contained in existing data files.
@@ -195,6 +234,61 @@ public:
     */
    void finalize(); 
 
+   //@}
+
+   //@{
+   //! @name Methods for background I/O of data objects.
+
+   /*!
+    * Start and stop background thread writing data objects paged out 
+    * of memory and prefetching data objects from disk; see 
+    * MTreeDataStore::startBackgroundIO().  While background I/O is 
+    * enabled, searches prefetch the objects of their results that are
+    * on disk, so that they are read in parallel.  Both methods should 
+    * be called while no other thread accesses the tree.
+    *
+    * @return Boolean true if background I/O is enabled; otherwise 
+    *         false (i.e., if the object store does not support it).
+    */
+   bool startBackgroundIO();
+   void stopBackgroundIO();
+
+   /*!
+    * Queue background read of data object with given identifier if 
+    * background I/O is enabled and the object is on disk; otherwise 
+    * do nothing.
+    */
+   void prefetchObject(int object_id);
+
+   /*!
+    * Get number of queued background I/O requests, total number of 
+    * bytes moved by background I/O, and total time in seconds spent 
+    * waiting for background I/O to finish.
+    */
+   int getBackgroundIOQueueDepth() const;
+   size_t getTotalBackgroundIOBytes() const;
+   double getTotalBackgroundIOStallTime() const;
+
+   //@}
+
+   //@{
+   //! @name Methods for accounting memory of data objects.
+
+   /*!
+    * Get total number of bytes held by data objects in memory, and 
+    * number of bytes held by data object with given identifier if it 
+    * is in memory (zero otherwise); see 
+    * MTreeDataStore::getResidentObjectBytes().
+    */
+   size_t getResidentObjectBytes() const;
+   size_t getObjectMemorySize(int object_id) const;
+
+   /*!
+    * Get total number of data objects paged in from disk; see 
+    * MTreeDataStore::getTotalObjectPageInCount().
+    */
+   int getTotalObjectPageInCount() const;
+
    //@}
   
    //@{
@@ -260,7 +354,8 @@ public:
     * @param method enum type MTree::MTreeNodePartitionMethod value.
     * @param min_utilization Optional double value indicating the minimum 
     *        node utilization fraction.  This value is used only for 
-    *        unbalanced partition strategies. When partitioning, entries 
+    *        unbalanced partition strategies and as the fill target of
+    *        bulkLoad(). When partitioning, entries 
     *        will be moved to a new node until the fraction of total 
     *        entries in the new node is greater than or equal to this value.
     *        The default value is 0.5 which will result in a balanced 
@@ -296,9 +391,44 @@ public:
     *                assertion checking is on, assertion will result if 
     *                value is less than 0.
     */
-   void insertObject(MTreeObject& object,
-                     const MTreePoint& point,
-                     double radius);
+   virtual void insertObject(MTreeObject& object,
+                             const MTreePoint& point,
+                             double radius);
+
+   /*!
+    * Insert collection of objects into an empty tree and set the 
+    * identifiers of the objects.
+    *
+    * Rather than descending the tree and splitting nodes for each 
+    * object as insertObject() does, the tree is built bottom-up.  The 
+    * entries of each level are partitioned recursively about randomly
+    * sampled seed entries into groups holding no more than the maximum
+    * number of node entries, and each group becomes a node whose parent
+    * entry is a copy of its seed.  Where possible, groups hold at least
+    * the minimum node utilization fraction (see setNodePartitionMethod())
+    * of the maximum number of node entries.  The resulting tree is 
+    * balanced and is built with O(n log n) distance computations, which
+    * are counted as insert distance computations.
+    *
+    * If the tree already has a root node, the objects are simply 
+    * inserted one at a time using insertObject().
+    *
+    * To avoid external tampering with database contents, this method 
+    * produces internal deep copies of the given points and data objects.
+    *
+    * @param objects Const reference to vector of pointers to data 
+    *                objects.  The identifier of each object is set to 
+    *                match the identifier of its database copy.
+    * @param points  Const reference to vector of center points of 
+    *                objects; must have same length as objects vector.
+    * @param radii   Const reference to vector of object radii; must have
+    *                same length as objects vector.  When assertion 
+    *                checking is on, assertion will result if any value 
+    *                is less than 0.
+    */
+   virtual void bulkLoad(const vector<MTreeObjectPtr>& objects,
+                         const vector<MTreePointPtr>& points,
+                         const vector<double>& radii);
    
    /*!
     * Get copy of object indexed by tree given object identifier.
@@ -306,8 +436,13 @@ public:
     * @param object_id  Integer identifier of object to delete from tree.
     *                If this is not a valid id for an object indexed by
     *                the tree, the method will return a null pointer.
+    * @param make_safe  Optional boolean indicating whether to return a
+    *                copy of the object (true) or the actual object in 
+    *                the database (false), which must not be modified.  
+    *                The default value is true.
     */ 
-   MTreeObjectPtr getObject(int object_id) const;
+   virtual MTreeObjectPtr getObject(int object_id,
+                                    bool make_safe = true) const;
 
    /*!
     * Delete object from tree. 
@@ -325,7 +460,33 @@ public:
     *                If this is not a valid id for an object indexed by
     *                the tree, the method will do nothing. 
     */
-   void deleteObject(int object_id);
+   virtual void deleteObject(int object_id);
+
+   /*!
+    * Move the center point of an object indexed by the tree and reset
+    * the radius of the object region.
+    *
+    * If the region of the object about the new point stays inside the
+    * region covered by the parent entry of its leaf node, the entry is 
+    * repositioned within that node and covering radii are reset along 
+    * the path to the root.  Otherwise, the entry is removed from the 
+    * tree structure and inserted again as in insertObject().  In either 
+    * case, the object keeps its identifier and the object held in the 
+    * data store is not touched; since objects are typically moved after
+    * being modified in place, the memory held by the object is measured
+    * again (see MTreeDataStore::updateObjectMemorySize()).  Distance 
+    * computations are counted as insert distance computations.
+    *
+    * @param object_id  Integer identifier of object to move.  If this is
+    *                not a valid id for an object indexed by the tree, 
+    *                the method will do nothing.
+    * @param point   Const reference to new center point of object; a deep
+    *                copy is made.
+    * @param radius  Double new radius of object region; must be >= 0.
+    */
+   virtual void updateObjectPoint(int object_id,
+                                  const MTreePoint& point,
+                                  double radius);
 
    //@}
   
@@ -355,11 +516,70 @@ public:
     *                case, if the user casts away the const-ness of 
     *                any data object in a search result, future database
     *                operations may produce unexpected behavior.
+    * @param share_points  Optional boolean indicating whether the search
+    *                results refer to the given query point and to the
+    *                points held by the tree (true) rather than to copies
+    *                of them (false), so that no points are allocated.
+    *                The default value is false.  If true, the results 
+    *                must not be used once the query point has been 
+    *                destroyed.  The value is ignored if make_safe is 
+    *                true.
+    */
+   virtual void searchKNN(vector<MTreeSearchResult>& results,
+                          const MTreePoint& query_point,
+                          int k_neighbors,
+                          bool make_safe = false,
+                          bool share_points = false);
+
+   /*!
+    * Search tree for "k" data objects whose regions are nearest to 
+    * given query point.
+    *
+    * This method is identical to searchKNN() except that objects are 
+    * ranked by the distance from the query point to the support of 
+    * the object; i.e., the distance to the object point less the
+    * object radius, or zero if the query point lies inside the object
+    * region.  The distance stored in each search result is this 
+    * support distance.  When all objects have zero radius, the results
+    * are the same as those of searchKNN().
+    *
+    * See searchKNN() for a description of the arguments.
     */
-   void searchKNN(vector<MTreeSearchResult>& results,
-                  const MTreePoint& query_point,
-                  int k_neighbors,
-                  bool make_safe = false);
+   virtual void searchKNNSupport(vector<MTreeSearchResult>& results,
+                                 const MTreePoint& query_point,
+                                 int k_neighbors,
+                                 bool make_safe = false,
+                                 bool share_points = false);
+
+   /*!
+    * Search tree for "k" data objects near given query point, trading
+    * exactness of the results for fewer distance computations.
+    *
+    * This method is identical to searchKNN() except that subtrees and
+    * data objects are pruned as if the distance of the current "k"-th 
+    * result were divided by the error factor.  Each returned distance 
+    * is then at most error_factor times the distance of the exact 
+    * neighbor of the same rank.  In addition, if max_distance_comps 
+    * is positive, the search stops after the first node whose search 
+    * brings the number of distance computations to that value and the 
+    * nearest data objects found so far are returned.
+    *
+    * @param error_factor  Double factor >= 1 by which results may be 
+    *                farther than the exact neighbors.  A value of 1 
+    *                gives the exact search; smaller values are treated 
+    *                as 1.
+    * @param max_distance_comps  Integer maximum number of distance 
+    *                computations; no limit applies if <= 0.
+    *
+    * See searchKNN() for a description of the other arguments.
+    */
+   virtual void searchKNNApproximate(vector<MTreeSearchResult>& results,
+                                     const MTreePoint& query_point,
+                                     int k_neighbors,
+                                     double error_factor,
+                                     int max_distance_comps,
+                                     bool make_safe = false,
+                                     bool share_points = false);
 
    /*!
     * Search tree for all data objects within given distance of given 
@@ -394,11 +614,20 @@ public:
     *                case, if the user casts away the const-ness of 
     *                any data object in a search result, future database
     *                operations may produce unexpected behavior.
+    * @param share_points  Optional boolean indicating whether the search
+    *                results refer to the given query point and to the
+    *                points held by the tree (true) rather than to copies
+    *                of them (false), so that no points are allocated.
+    *                The default value is false.  If true, the results 
+    *                must not be used once the query point has been 
+    *                destroyed.  The value is ignored if make_safe is 
+    *                true.
     */
-   void searchRange(list<MTreeSearchResult>& results,
-                    const MTreePoint& query_point,
-                    double radius,
-                    bool make_safe = false);
+   virtual void searchRange(list<MTreeSearchResult>& results,
+                            const MTreePoint& query_point,
+                            double radius,
+                            bool make_safe = false,
+                            bool share_points = false);
 
    //@}
   
@@ -442,13 +671,13 @@ public:
     * Get total number of object insertions performed by this tree;
     *     i.e., number of times insertObject() function was called.
     */
-   int getTotalInsertCount() const;
+   virtual int getTotalInsertCount() const;
 
    /*!
     * Get total number of computations of distance between objects
     *     during all object insertions performed by this tree.
     */
-   int getTotalInsertDistanceCount() const;
+   virtual int getTotalInsertDistanceCount() const;
 
    /*!
     * Get number of computations of distance between objects
@@ -486,19 +715,22 @@ public:
 
    /*!
     * Get total number of nearest neighbor searches performed by this tree;
-    *     i.e., number of times searchKNN() function was called.
+    *     i.e., number of times searchKNN() function was called.  
+    *     Search counts are kept per thread and summed over all
+    *     threads here.
     */
-   int getTotalKNNSearchCount() const;
+   virtual int getTotalKNNSearchCount() const;
 
    /*!
     * Get total number of computations of distance between objects
     *     during all nearest neighbor searches performed by this tree.
     */
-   int getTotalKNNSearchDistanceCount() const;
+   virtual int getTotalKNNSearchDistanceCount() const;
 
    /*!
     * Get number of computations of distance between objects
-    *     during last nearest neighbor search performed by this tree.
+    *     during last nearest neighbor search performed by the calling
+    *     thread.
     */
    int getLastKNNSearchDistanceCount() const;
 
@@ -510,18 +742,20 @@ public:
    /*!
     * Get total number of range searches performed by this tree;
     *     i.e., number of times searchRange() function was called.
+    *     Search counts are kept per thread and summed over all
+    *     threads here.
     */
-   int getTotalRangeSearchCount() const;
+   virtual int getTotalRangeSearchCount() const;
 
    /*!
     * Get total number of computations of distance between objects
     *     during all range searches performed by this tree.
     */
-   int getTotalRangeSearchDistanceCount() const;
+   virtual int getTotalRangeSearchDistanceCount() const;
 
    /*!
     * Get number of computations of distance between objects
-    *     during last range search performed by this tree.
+    *     during last range search performed by the calling thread.
     */
    int getLastRangeSearchDistanceCount() const;
 
@@ -645,6 +879,22 @@ private:
    MTreeNode::MTreeNodePartitionMethod getNodePartitionMethod() const;
    double getMinNodeUtilization() const;
 
+   /*
+    * Private method implementing "k" nearest neighbor searches.  If 
+    * rank_by_support is true, data objects are ranked by distance to 
+    * their regions rather than to their points.  The error factor and
+    * maximum number of distance computations are those of 
+    * searchKNNApproximate(); exact searches pass 1 and 0.
+    */
+   void searchNearest(vector<MTreeSearchResult>& results,
+                      const MTreePoint& query_point,
+                      int k_neighbors,
+                      bool make_safe,
+                      bool share_points,
+                      bool rank_by_support,
+                      double error_factor,
+                      int max_distance_comps);
+
    /*
     * Private method to recurse to child nodes used in range search.
     */
@@ -660,6 +910,82 @@ private:
    MTreeNodePtr pickNode(MTreeNodePtr start_node,
                          MTreeEntryPtr entry) const;
 
+   /*
+    * Private method to insert a data entry, whose object is already in 
+    * the data store, into the tree structure.
+    */
+   void insertDataEntry(MTreeEntryPtr entry);
+
+   /*
+    * Private method to find the data entry for given object in given
+    * leaf node; returns null pointer if not found.
+    */
+   MTreeEntryPtr findDataEntry(MTreeNodePtr node,
+                               int object_id) const;
+
+   /*
+    * Private method to remove empty nodes from the tree, starting at 
+    * given node from which an entry has been removed, and reset radii
+    * up to the root.
+    */
+   void pruneEmptyNodes(MTreeNodePtr node);
+
+   /*
+    * Private methods used in bulk loading.  The first partitions the 
+    * given entries recursively into groups of at most the maximum 
+    * number of node entries; the first entry of each group is its seed
+    * and the distance-to-parent of each entry is set to its distance 
+    * from the seed.  The second creates a node at the given level for
+    * each group and returns the parent entries of the new nodes.
+    */
+   void partitionBulkLoadEntries(vector< vector<MTreeEntryPtr> >& groups,
+                                 const vector<MTreeEntryPtr>& entries);
+
+   void buildBulkLoadLevel(vector<MTreeEntryPtr>& parent_entries,
+                           const vector< vector<MTreeEntryPtr> >& groups,
+                           int level);
+
+   /*
+    * Private helpers of partitionBulkLoadEntries(), which work on 
+    * indices into the entries being partitioned.  pivot_distances 
+    * holds, for each of the first num_pivots seeds of the enclosing
+    * partition steps of a cluster, the distances of the entries to it;
+    * the row after them receives the distances to the seeds of the
+    * current step.  The first partitions a cluster recursively; the
+    * second returns the closest active seed to an entry; the third 
+    * moves the given number of entries of one cluster closest to the 
+    * seed (first entry) of another to it; the fourth returns the lower 
+    * bound on the distance of two entries from their pivot distances.
+    */
+   void partitionBulkLoadCluster(vector< vector<MTreeEntryPtr> >& groups,
+                                 const vector<MTreeEntryPtr>& entries,
+                                 const vector<int>& cluster,
+                                 vector< vector<double> >& pivot_distances,
+                                 int num_pivots);
+
+   int findBulkLoadSeed(const vector<MTreeEntryPtr>& entries,
+                        int entry,
+                        const vector<int>& seeds,
+                        const vector<double>& seed_distances,
+                        const vector<bool>& active_seeds,
+                        bool first_seed_is_pivot,
+                        vector< vector<double> >& pivot_distances,
+                        int num_pivots);
+
+   void moveBulkLoadEntries(vector<int>& to_cluster,
+                            vector<int>& from_cluster,
+                            int num_moved,
+                            const vector<MTreeEntryPtr>& entries,
+                            double seed_distance,
+                            vector< vector<double> >& pivot_distances,
+                            int num_pivots);
+
+   static double getBulkLoadDistanceBound(
+      const vector< vector<double> >& pivot_distances,
+      int num_pivots,
+      int entry,
+      int other_entry);
+
    /*
     * Private method to split given node, if over-full, and continue to
     * split nodes nodes up to the root node as needed.
@@ -693,6 +1019,15 @@ private:
     */
    enum { DEFAULT_MAX_NODE_ENTRIES = 7 };
 
+   /*
+    * Max number of seeds per partition step in bulk loading.  Fewer 
+    * seeds make more, cheaper steps: below the top of a level, one of
+    * the seeds is the seed of the cluster, whose distances to the 
+    * entries are known, and the closest seed of an entry costs up to 
+    * one distance computation per other seed.
+    */
+   enum { BULK_LOAD_MAX_SEEDS = 3 };
+
    /*
     * String name of tree used mainly in printing and error reporting
     */
@@ -743,29 +1078,54 @@ private:
    void incrementDistanceComputeCount();
    void clearOperationCountStatistics();
 
-   enum MTreeDistanceType { DISTANCE_RANGE_QUERY = 0,
-                            DISTANCE_KNN_QUERY = 1,
-                            DISTANCE_INSERT = 2, 
+   enum MTreeDistanceType { DISTANCE_INSERT = 2, 
                             DISTANCE_DELETE = 3,
                             DISTANCE_UNDEFINED = 5 };
 
    MTreeDistanceType d_current_distance_type;
 
-   int d_num_range_queries;
-   int d_num_knn_queries;
    int d_num_inserts;
    int d_num_deletes;
 
-   int d_total_distance_comps_in_range_queries;
-   int d_total_distance_comps_in_knn_queries;
    int d_total_distance_comps_in_inserts;
    int d_total_distance_comps_in_deletes;
 
-   int d_num_distance_comps_in_last_range_query;
-   int d_num_distance_comps_in_last_knn_query;
    int d_num_distance_comps_in_last_insert;
    int d_num_distance_comps_in_last_delete;
 
+   /*
+    * Search operation counts.  Searches only read the tree index, so
+    * several threads may search concurrently as long as no thread 
+    * inserts or deletes objects at the same time.  To avoid writing
+    * to shared counters, each thread accumulates its search counts 
+    * in its own SearchStatistics record; the records are summed when 
+    * statistics are requested.  Counters are written only by the owning
+    * thread and use relaxed atomics so they may be read at any time.
+    */
+   struct SearchStatistics {
+      SearchStatistics();
+      void clear();
+      static void add(std::atomic<int>& counter, int count);
+
+      std::atomic<int> d_num_range_queries;
+      std::atomic<int> d_num_knn_queries;
+      std::atomic<int> d_total_distance_comps_in_range_queries;
+      std::atomic<int> d_total_distance_comps_in_knn_queries;
+      std::atomic<int> d_num_distance_comps_in_last_range_query;
+      std::atomic<int> d_num_distance_comps_in_last_knn_query;
+   };
+
+   SearchStatistics& getThreadSearchStatistics() const;
+
+   /*
+    * Unique serial number of this tree, used to validate the per-thread
+    * cache of the search statistics record.
+    */
+   int d_tree_serial;
+
+   mutable std::mutex d_search_statistics_mutex;
+   mutable map<std::thread::id, SearchStatistics> d_search_statistics;
+
    vector<int> d_number_nodes_in_level;
    vector<MTreeLevelStatistic*> d_level_statistics;
 
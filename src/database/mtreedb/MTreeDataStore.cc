@@ -62,6 +62,10 @@ advertising or product endorsement purposes.
 #include "toolbox/base/Utilities.h"
 #endif 
 
+#ifndef included_toolbox_MemoryDatabase
+#include "toolbox/database/MemoryDatabase.h"
+#endif 
+
 //#ifdef DEBUG_CHECK_ASSERTIONS
 //#ifndef included_cassert
 //#define included_cassert
@@ -139,7 +143,13 @@ MTreeDataStore::MTreeDataStore()
   d_num_leaf_nodes(0),
   d_num_objects(0),
   d_object_file_capacity(MTREE_DATA_STORE_OBJECT_FILE_CAPACITY),
-  d_num_objects_in_files(0)
+  d_num_objects_in_files(0),
+  d_object_store_type(HDF_FILE_OBJECT_STORE),
+  d_segment_store((MTreeSegmentStore*)NULL),
+  d_io_worker((MTreeIOWorker*)NULL),
+  d_background_io_enabled(false),
+  d_resident_object_bytes(0),
+  d_num_objects_paged_in(0)
 {
 }
 
@@ -149,6 +159,16 @@ MTreeDataStore::~MTreeDataStore()
    d_mtree = (MTree*)NULL;
    d_object_factory = (const MTreeObjectFactory*)NULL;
 
+   if ( d_io_worker ) {
+      delete d_io_worker;
+      d_io_worker = (MTreeIOWorker*)NULL;
+   }
+
+   if ( d_segment_store ) {
+      delete d_segment_store;
+      d_segment_store = (MTreeSegmentStore*)NULL;
+   }
+
    const int num_files = d_object_file_info.size();
    for (int file_index = 0; file_index < num_files; ++file_index) {
       if ( d_object_file_info[file_index] ) {
@@ -186,7 +206,8 @@ MTreeDataStore::~MTreeDataStore()
 void MTreeDataStore::create(MTree* mtree,
                             const MTreeObjectFactory* obj_factory,
                             const string& directory_name,
-                            const string& file_prefix)
+                            const string& file_prefix,
+                            ObjectStoreType object_store_type)
 {
 #ifdef DEBUG_CHECK_ASSERTIONS
    assert(mtree != (MTree*)NULL);
@@ -221,6 +242,14 @@ void MTreeDataStore::create(MTree* mtree,
 					 S_IRWXU|S_IRWXG,
 					 false);
 
+      d_object_store_type = object_store_type;
+
+      if ( d_object_store_type == SEGMENT_FILE_OBJECT_STORE ) {
+         d_segment_store = 
+            new MTreeSegmentStore(d_object_file_prefix + d_file_prefix);
+         d_segment_store->startCompaction();
+      }
+
       d_is_initialized = true;
       d_is_open        = true;
 
@@ -261,6 +290,8 @@ void MTreeDataStore::open(MTree* mtree,
       d_mtree = mtree;
       d_object_factory = obj_factory;
 
+      d_object_store_type = HDF_FILE_OBJECT_STORE;
+
 #ifdef HAVE_PKG_hdf5
       d_directory_name = directory_name + "_" + 
 	getStringMPIRankRepresentation();
@@ -348,7 +379,18 @@ void MTreeDataStore::open(MTree* mtree,
 
 void MTreeDataStore::close()
 {
-   if (d_is_open) {
+   if ( d_segment_store ) {
+
+      if ( d_io_worker ) {
+         delete d_io_worker;
+         d_io_worker = (MTreeIOWorker*)NULL;
+      }
+      d_background_io_enabled = false;
+
+      delete d_segment_store;
+      d_segment_store = (MTreeSegmentStore*)NULL;
+
+   } else if (d_is_open) {
 
 #ifdef HAVE_PKG_hdf5
       bool write_successful = writeAllDataObjects();
@@ -408,6 +450,75 @@ void MTreeDataStore::close()
    d_is_open        = false;
 }
 
+/*
+*************************************************************************
+*                                                                       *
+* Start and stop background object I/O, and queue prefetches.           *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeDataStore::startBackgroundIO()
+{
+   if ( d_is_open && d_segment_store && !d_background_io_enabled ) {
+
+      if ( !d_io_worker ) {
+         d_io_worker = new MTreeIOWorker(d_segment_store, d_object_factory);
+      }
+
+      d_io_worker->start();
+      d_background_io_enabled = true;
+
+   }
+
+   return(d_background_io_enabled);
+}
+
+void MTreeDataStore::stopBackgroundIO()
+{
+   if ( d_background_io_enabled ) {
+
+      d_io_worker->stop();
+
+      std::lock_guard<std::mutex> lock(d_object_access_mutex);
+      applyCompletedIO();
+      d_background_io_enabled = false;
+
+   }
+}
+
+void MTreeDataStore::prefetchObject(int object_id)
+{
+   if ( d_background_io_enabled ) {
+
+      std::lock_guard<std::mutex> lock(d_object_access_mutex);
+
+      if ( isValidObjectId(object_id) &&
+           !(d_object_info[object_id]->getInMemory()) ) {
+         d_io_worker->queueRead(object_id, 
+                                getObjectDatabaseName(object_id));
+      }
+
+   }
+}
+
+int MTreeDataStore::getBackgroundIOQueueDepth() const
+{
+   return( d_io_worker ? d_io_worker->getQueueDepth() : 0 );
+}
+
+size_t MTreeDataStore::getTotalBackgroundIOBytes() const
+{
+   return( d_io_worker ? 
+           d_io_worker->getTotalBytesWritten() + 
+           d_io_worker->getTotalBytesRead() : 0 );
+}
+
+double MTreeDataStore::getTotalBackgroundIOStallTime() const
+{
+   return( d_io_worker ? d_io_worker->getTotalStallTime() : 0.0 );
+}
+
 /*
 *************************************************************************
 *                                                                       *
@@ -599,6 +710,7 @@ void MTreeDataStore::addObject(MTreeObject& object)
    }
 
    d_object_info[ object.getObjectId() ]->setInMemory(true);
+   accountObjectMemory( object.getObjectId() );
 
    d_num_objects++;
 
@@ -625,6 +737,13 @@ void MTreeDataStore::removeObject(int object_id)
         d_object_info[object_id] &&
         !d_object_info[object_id]->getInFile() ) {
 
+      if ( d_background_io_enabled ) {
+         d_io_worker->cancelRequest(object_id);
+      }
+
+      d_object_info[object_id]->resetObjectPtr();
+      accountObjectMemory(object_id);
+
       delete d_object_info[object_id];
       d_object_info[object_id] = (ObjectInfo*)NULL;
       d_recycled_object_indices.push_front(object_id);
@@ -674,10 +793,25 @@ bool MTreeDataStore::isValidObjectId(int object_id) const
 
 MTreeObjectPtr MTreeDataStore::getObjectCopy(int object_id)
 {
+   std::lock_guard<std::mutex> lock(d_object_access_mutex);
+
    MTreeObjectPtr ret_object;
 
    if ( d_is_open ) { 
 
+   //
+   // the copy made by an object may share data with it, so as in 
+   // getObjectPtr() a pending write of the object is withdrawn
+   //
+
+   if ( d_background_io_enabled ) {
+      if ( isValidObjectId(object_id) &&
+           d_object_info[object_id]->getInMemory() ) {
+         d_io_worker->cancelRequest(object_id);
+      }
+      applyCompletedIO();
+   }
+
    const int object_info_size = d_object_info.size(); 
    if ( (object_id >= 0) &&
         (object_id < object_info_size) &&
@@ -713,10 +847,25 @@ MTreeObjectPtr MTreeDataStore::getObjectCopy(int object_id)
 
 MTreeObjectPtr MTreeDataStore::getObjectPtr(int object_id)
 {
+   std::lock_guard<std::mutex> lock(d_object_access_mutex);
+
    MTreeObjectPtr ret_object;
 
    if ( d_is_open ) { 
 
+   //
+   // the caller may modify the object, so a pending write of it is
+   // withdrawn before other completed requests are applied
+   //
+
+   if ( d_background_io_enabled ) {
+      if ( isValidObjectId(object_id) &&
+           d_object_info[object_id]->getInMemory() ) {
+         d_io_worker->cancelRequest(object_id);
+      }
+      applyCompletedIO();
+   }
+
    const int object_info_size = d_object_info.size(); 
    if ( (object_id >= 0) &&
         (object_id < object_info_size) &&
@@ -878,6 +1027,36 @@ bool MTreeDataStore::writeAllDataObjects()
 {
    bool write_successful = false;
 
+   if ( d_segment_store ) {
+
+      if ( d_is_open ) {
+
+         write_successful = true;
+
+         const int object_info_size = d_object_info.size();
+         for (int object_id = 0; object_id < object_info_size; ++object_id) {
+            if ( isValidObjectId(object_id) ) {
+               write_successful &= writeSegmentDataObject(object_id);
+            }
+         }
+
+         if (write_successful) {
+            const int leaf_node_info_size = d_leaf_node_info.size();
+            for (int leaf_node_id = 0; leaf_node_id < leaf_node_info_size; 
+                 ++leaf_node_id) {
+               if ( isValidLeafNodeId(leaf_node_id) ) {
+                  d_leaf_node_info[leaf_node_id]->setInFile(true);
+                  d_leaf_node_info[leaf_node_id]->setInMemory(false);
+               }
+            }
+         }
+
+      }
+
+      return(write_successful);
+
+   }
+
 #ifdef HAVE_PKG_hdf5
    if ( d_is_open ) {
 
@@ -974,6 +1153,35 @@ bool MTreeDataStore::readAllDataObjects(
 {
    bool read_successful = false;
 
+   if ( d_segment_store ) {
+
+      if ( d_is_open ) {
+
+         read_successful = true;
+
+         const int object_info_size = d_object_info.size();
+         for (int object_id = 0; object_id < object_info_size; ++object_id) {
+            if ( isValidObjectId(object_id) ) {
+               read_successful &= readSegmentDataObject(object_id);
+            }
+         }
+
+         if (read_successful) {
+            const int leaf_node_info_size = d_leaf_node_info.size();
+            for (int leaf_node_id = 0; leaf_node_id < leaf_node_info_size; 
+                 ++leaf_node_id) {
+               if ( isValidLeafNodeId(leaf_node_id) ) {
+                  d_leaf_node_info[leaf_node_id]->setInMemory(true);
+               }
+            }
+         }
+
+      }
+
+      return(read_successful);
+
+   }
+
 #ifdef HAVE_PKG_hdf5
    if ( d_is_open ) {   
 
@@ -1060,6 +1268,34 @@ bool MTreeDataStore::writeNodeDataObjects(MTreeNodePtr node)
 
    bool write_successful = false;
 
+   if ( d_segment_store ) {
+
+      const int leaf_node_id = node->getLeafNodeId(); 
+
+      if ( d_is_open && isValidLeafNodeId(leaf_node_id) ) {
+
+         write_successful = true;
+
+         const vector<int>& object_ids =
+             d_leaf_node_info[leaf_node_id]->getObjectIds();
+
+         for (unsigned int i = 0; i < object_ids.size(); ++i) {
+            if ( isValidObjectId(object_ids[i]) ) {
+               write_successful &= writeSegmentDataObject(object_ids[i]);
+            }
+         }
+
+         if (write_successful) {
+            d_leaf_node_info[leaf_node_id]->setInFile(true); 
+            d_leaf_node_info[leaf_node_id]->setInMemory(false); 
+         }
+
+      }
+
+      return(write_successful);
+
+   }
+
 #ifdef HAVE_PKG_hdf5
    if ( d_is_open ) {   
 
@@ -1159,6 +1395,33 @@ bool MTreeDataStore::readNodeDataObjects(MTreeNodePtr node)
 
    bool read_successful = false;
 
+   if ( d_segment_store ) {
+
+      const int leaf_node_id = node->getLeafNodeId(); 
+
+      if ( d_is_open && isValidLeafNodeId(leaf_node_id) ) {
+
+         read_successful = true;
+
+         const vector<int>& object_ids =
+             d_leaf_node_info[leaf_node_id]->getObjectIds();
+
+         for (unsigned int i = 0; i < object_ids.size(); ++i) {
+            if ( isValidObjectId(object_ids[i]) ) {
+               read_successful &= readSegmentDataObject(object_ids[i]);
+            }
+         }
+
+         if (read_successful) {
+            d_leaf_node_info[leaf_node_id]->setInMemory(true); 
+         }
+
+      }
+
+      return(read_successful);
+
+   }
+
 #ifdef HAVE_PKG_hdf5
    if ( d_is_open ) {   
 
@@ -1248,7 +1511,9 @@ bool MTreeDataStore::writeDataObject(int object_id)
 {
    bool write_successful = false;
 
-   if ( d_is_open ) {   
+   if ( d_is_open && d_segment_store ) {   
+      write_successful = writeSegmentDataObject(object_id);
+   } else if ( d_is_open ) {   
 #ifdef HAVE_PKG_hdf5
 //      std::cout << "[@" << toolbox::MPI::getRank() << "] " 
 // 	       << "writing out object: " << object_id << std::endl;
@@ -1279,7 +1544,9 @@ bool MTreeDataStore::readDataObject(int object_id)
 {
    bool read_successful = false;
 
-   if ( d_is_open ) {   
+   if ( d_is_open && d_segment_store ) {   
+      read_successful = readSegmentDataObject(object_id);
+   } else if ( d_is_open ) {   
 #ifdef HAVE_PKG_hdf5
      //     std::cout  << "[@" << toolbox::MPI::getRank() << "] " 
      //		<< "reading in object: " << object_id << std::endl;
@@ -1360,6 +1627,7 @@ bool MTreeDataStore::writeDataObjectHelper(
             d_object_info[ object_id ]->setFileIndex( file_index );
             d_object_info[ object_id ]->resetObjectPtr();
             d_object_info[ object_id ]->setInMemory(false);
+            accountObjectMemory(object_id);
 
             d_object_file_info[file_index]->addObjectId(object_id);
 
@@ -1425,7 +1693,9 @@ bool MTreeDataStore::readDataObjectHelper(
             data_object->setObjectId(object_id);
             d_object_info[ object_id ]->setObjectPtr(data_object);
             d_object_info[ object_id ]->setInMemory(true);
+            accountObjectMemory(object_id);
             d_object_info[ object_id ]->setInFile(false);
+            d_num_objects_paged_in.fetch_add(1, std::memory_order_relaxed);
 
 	    --d_num_objects_in_files;
 
@@ -1445,6 +1715,240 @@ bool MTreeDataStore::readDataObjectHelper(
 
 #endif
 
+/*
+*************************************************************************
+*                                                                       *
+* Private methods to write single data object to and read single data   *
+* object from segment store.  Objects are serialized through a memory   *
+* database; the record of an object read back into memory is dropped,  *
+* since the object may change before it is written again.               *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeDataStore::writeSegmentDataObject(int object_id)
+{
+   bool write_successful = false;
+
+   if ( isValidObjectId(object_id) ) {
+
+      if ( d_background_io_enabled ) {
+
+         //
+         // the object stays in memory until the write completes 
+         //
+
+         if ( !(d_object_info[object_id]->getInFile()) ) {
+            d_io_worker->queueWrite(object_id,
+                                    getObjectDatabaseName(object_id),
+                                    d_object_info[object_id]->getObject());
+         }
+         write_successful = true;
+
+      } else if ( !(d_object_info[object_id]->getInFile()) ) {
+
+         toolbox::MemoryDatabase obj_db( getObjectDatabaseName(object_id) );
+
+         d_object_info[object_id]->getObject()->writeToDatabase(obj_db);
+
+         vector<char> record;
+         obj_db.serialize(record);
+
+         write_successful = d_segment_store->writeRecord(object_id, record);
+
+         if ( write_successful ) {
+
+            d_object_info[ object_id ]->setInFile(true);
+            d_object_info[ object_id ]->resetObjectPtr();
+            d_object_info[ object_id ]->setInMemory(false);
+            accountObjectMemory(object_id);
+
+            d_num_objects_in_files++;
+
+         }
+
+      } else {
+         write_successful = true;
+      }
+
+   }
+
+   return(write_successful);
+}
+
+bool MTreeDataStore::readSegmentDataObject(int object_id)
+{
+   bool read_successful = false;
+
+   if ( isValidObjectId(object_id) && d_background_io_enabled &&
+        !(d_object_info[object_id]->getInMemory()) ) {
+
+      //
+      // finish a prefetch of the object that is under way
+      //
+
+      if ( d_io_worker->waitForRequest(object_id) ) {
+         applyCompletedIO();
+      }
+
+   }
+
+   if ( isValidObjectId(object_id) ) {
+
+      if ( !(d_object_info[object_id]->getInMemory()) ) {
+
+         //
+         // read object directly from the mapped segment file; the 
+         // view keeps the mapping alive until the object is built
+         //
+
+         MTreeSegmentStore::RecordView record;
+         toolbox::MemoryDatabase obj_db( getObjectDatabaseName(object_id) );
+
+         read_successful = 
+            d_segment_store->mapRecord(object_id, record) &&
+            obj_db.attach(record.getData(), record.getSize());
+
+         if ( read_successful ) {
+
+            MTreeObjectPtr data_object = 
+               d_object_factory->allocateObject(obj_db);
+
+            data_object->setObjectId(object_id);
+            d_object_info[ object_id ]->setObjectPtr(data_object);
+            d_object_info[ object_id ]->setInMemory(true);
+            accountObjectMemory(object_id);
+            d_object_info[ object_id ]->setInFile(false);
+            d_num_objects_paged_in.fetch_add(1, std::memory_order_relaxed);
+
+            --d_num_objects_in_files;
+
+            d_segment_store->removeRecord(object_id);
+
+         }
+
+      } else {
+         read_successful = true;
+      }
+
+   }
+
+   return(read_successful);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private method to apply results of completed background I/O           *
+* requests.  A written object is removed from memory only if the        *
+* object written is still the one in memory; otherwise its record is    *
+* dead.  A read object is installed only if the object is still on      *
+* disk.                                                                 *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeDataStore::applyCompletedIO()
+{
+   vector<MTreeIOWorker::CompletedRequest> completed;
+   d_io_worker->takeCompletedRequests(completed);
+
+   const int num_completed = completed.size();
+   for (int i = 0; i < num_completed; ++i) {
+
+      const int object_id = completed[i].d_object_id;
+      ObjectInfo* object_info = isValidObjectId(object_id) ?
+         d_object_info[object_id] : (ObjectInfo*)NULL;
+
+      if ( completed[i].d_is_write ) {
+
+         if ( object_info && 
+              object_info->getInMemory() &&
+              (object_info->getObject() == completed[i].d_object) ) {
+
+            object_info->setInFile(true);
+            object_info->resetObjectPtr();
+            object_info->setInMemory(false);
+            accountObjectMemory(object_id);
+
+            d_num_objects_in_files++;
+
+         } else {
+            d_segment_store->removeRecord(object_id);
+         }
+
+      } else if ( object_info && !(object_info->getInMemory()) ) {
+
+         object_info->setObjectPtr(completed[i].d_object);
+         object_info->setInMemory(true);
+         accountObjectMemory(object_id);
+         object_info->setInFile(false);
+         d_num_objects_paged_in.fetch_add(1, std::memory_order_relaxed);
+
+         --d_num_objects_in_files;
+
+         d_segment_store->removeRecord(object_id);
+
+      }
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Return number of bytes held by data object in memory, measure it      *
+* again, and private method to account for memory of data object after  *
+* its pointer changed.                                                  *
+*                                                                       *
+*************************************************************************
+*/
+
+size_t MTreeDataStore::getObjectMemorySize(int object_id) const
+{
+   std::lock_guard<std::mutex> lock(d_object_access_mutex);
+
+   return( isValidObjectId(object_id) ? 
+           d_object_info[object_id]->getMemorySize() : 0 );
+}
+
+void MTreeDataStore::updateObjectMemorySize(int object_id)
+{
+   std::lock_guard<std::mutex> lock(d_object_access_mutex);
+
+   if ( isValidObjectId(object_id) ) {
+      accountObjectMemory(object_id);
+   }
+}
+
+void MTreeDataStore::accountObjectMemory(int object_id)
+{
+   ObjectInfo* object_info = d_object_info[object_id];
+
+   const MTreeObjectPtr object = object_info->getObject();
+   const size_t memory_size = object.get() ? object->getMemorySize() : 0;
+
+   d_resident_object_bytes.fetch_sub(object_info->getMemorySize(),
+                                     std::memory_order_relaxed);
+   d_resident_object_bytes.fetch_add(memory_size,
+                                     std::memory_order_relaxed);
+
+   object_info->setMemorySize(memory_size);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private method to check for pending background I/O of object.         *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeDataStore::isObjectIOPending(int object_id) const
+{
+   return( d_background_io_enabled && d_io_worker->hasRequest(object_id) );
+}
+
 /*
 *************************************************************************
 *                                                                       *
@@ -1780,6 +2284,7 @@ void MTreeDataStore::ObjectInfo::printClassData(ostream& stream) const
    stream << "d_in_file = " << d_in_file << endl;
    stream << "d_in_memory = " << d_in_memory << endl;
    stream << "d_object_file_index = " << d_object_file_index << endl;
+   stream << "d_memory_size = " << d_memory_size << endl;
 }
 
 /*
@@ -1825,6 +2330,18 @@ void MTreeDataStore::printClassData(ostream& stream) const
    stream << "d_object_file_prefix = " << d_object_file_prefix << endl;
    stream << "d_object_file_capacity = " << d_object_file_capacity << endl;
    stream << "d_num_objects_in_files = " << d_num_objects_in_files << endl;
+   stream << "d_object_store_type = " << d_object_store_type << endl;
+   if ( d_segment_store ) {
+      d_segment_store->printClassData(stream);
+   }
+   stream << "d_background_io_enabled = " << d_background_io_enabled << endl;
+   if ( d_io_worker ) {
+      d_io_worker->printClassData(stream);
+   }
+   stream << "d_resident_object_bytes = " 
+          << getResidentObjectBytes() << endl;
+   stream << "d_num_objects_paged_in = " 
+          << getTotalObjectPageInCount() << endl;
 
    stream << "\n\n" << endl;
    stream << "d_num_leaf_nodes = " << d_num_leaf_nodes << endl;
@@ -29,6 +29,15 @@ using namespace std;
 #include <list>
 using namespace std;
 #endif
+#ifndef included_mutex
+#define included_mutex
+#include <mutex>
+#endif
+#ifndef included_atomic
+#define included_atomic
+#include <atomic>
+#endif
+
 #ifndef included_vector
 #define included_vector
 #include <vector>
@@ -48,6 +57,12 @@ using namespace std;
 #ifndef included_mtreedb_MTreeObjectFactory
 #include "MTreeObjectFactory.h"
 #endif
+#ifndef included_mtreedb_MTreeSegmentStore
+#include "MTreeSegmentStore.h"
+#endif
+#ifndef included_mtreedb_MTreeIOWorker
+#include "MTreeIOWorker.h"
+#endif
 
 #ifndef NULL
 #define NULL (0)
@@ -92,6 +107,40 @@ typedef std::shared_ptr<MTreeEntry> MTreeEntryPtr;
  * -# Finish.    Call the close() method when done with the data store 
  *               to write all unwritten data as well as the associated
  *               MTree index structure to files.
+ *
+ * Data objects paged out of memory are kept in one of two object 
+ * stores, chosen when the data store is created:
+ *
+ * - HDF_FILE_OBJECT_STORE (the default) writes each object as a group
+ *   of an HDF5 file holding a small number of objects.  The files are 
+ *   persistent and are read back by open().
+ *
+ * - SEGMENT_FILE_OBJECT_STORE serializes objects (see 
+ *   toolbox::MemoryDatabase) into a few large, append-only segment
+ *   files managed by an MTreeSegmentStore, which reclaims the space of
+ *   objects read back into memory by background compaction.  Objects 
+ *   are read back in place from read-only mappings of the segment 
+ *   files (see toolbox::MemoryDatabase::attach()), so their data are
+ *   copied once, from the page cache into the new object.  The store 
+ *   does not need HDF5 and avoids opening a file per object write or 
+ *   read, but its files are scratch space: they are deleted by close(), 
+ *   which writes no files for this store, and cannot be opened again.
+ *
+ * With the SEGMENT_FILE_OBJECT_STORE, object I/O may be moved off the
+ * calling thread (see startBackgroundIO()).  Writes of objects paged 
+ * out are then queued to an MTreeIOWorker, and the objects stay in 
+ * memory and readable until their records are written; an object
+ * accessed through getObjectPtr() or getObjectCopy() before that is 
+ * kept in memory, since the caller may modify it or a copy sharing its
+ * data.  Objects on disk may be prefetched with 
+ * prefetchObject(); the MTree does so for the results of its searches.
+ * Completed writes and reads are applied at the next object access.
+ *
+ * The data store accounts for the memory held by data objects in 
+ * memory, as reported by MTreeObject::getMemorySize() when an object
+ * is added or paged in; see getResidentObjectBytes().  An object 
+ * modified in place is measured again by updateObjectMemorySize().
+ * Objects paged in are also counted; see getTotalObjectPageInCount(). 
  * 
  * @see mtreedb::MTree
  * @see mtreedb::MTreeNode
@@ -102,6 +151,13 @@ typedef std::shared_ptr<MTreeEntry> MTreeEntryPtr;
 class MTreeDataStore
 {
 public:
+   /*!
+    * Enumerated type for the store of data objects paged out of 
+    * memory.  See the class description.
+    */
+   enum ObjectStoreType { HDF_FILE_OBJECT_STORE = 0,
+                          SEGMENT_FILE_OBJECT_STORE = 1 };
+
    /*!
     * Default ctor for MTreeDataStore object.
     */
@@ -139,6 +195,8 @@ public:
     * @param file_prefix  Const reference to string indicating the
     *                     prefix for all data files associated with
     *                     this data store.
+    * @param object_store_type Optional store of data objects paged 
+    *                     out of memory; HDF_FILE_OBJECT_STORE by default.
     *
     * When assertion checking is on, passing an empty string or a null
     * pointer will throw an assertion.
@@ -146,7 +204,8 @@ public:
    void create(MTree* mtree,
                const MTreeObjectFactory* obj_factory,
                const string& directory_name,
-               const string& file_prefix);
+               const string& file_prefix,
+               ObjectStoreType object_store_type = HDF_FILE_OBJECT_STORE);
 
    /*!
     * Initialize data store to contents of data files associated
@@ -171,7 +230,8 @@ public:
     * pointer will throw an assertion.
     *
     * If either the data files or the directory do not exist, the 
-    * an unrecoverable error will result.
+    * an unrecoverable error will result.  The opened data store uses
+    * the HDF_FILE_OBJECT_STORE.
     */ 
    void open(MTree* mtree,
              const MTreeObjectFactory* obj_factory,
@@ -184,9 +244,104 @@ public:
     * It is important to note that after calling this method, no
     * other methods will do anything until the data store open()
     * or create method is called.
+    *
+    * With the SEGMENT_FILE_OBJECT_STORE nothing is written; the 
+    * segment files are deleted.
     */
    void close();
 
+   /*!
+    * Return store of data objects paged out of memory.
+    */
+   ObjectStoreType getObjectStoreType() const;
+
+   //@{
+   //! @name Methods for background object I/O.
+
+   /*!
+    * Start background thread writing data objects paged out of memory 
+    * and reading prefetched objects; see the class description.  Only 
+    * the SEGMENT_FILE_OBJECT_STORE supports background I/O.  The 
+    * method should be called while no other thread accesses the data 
+    * store.
+    *
+    * @return Boolean true if background I/O is enabled; otherwise false.
+    */
+   bool startBackgroundIO();
+
+   /*!
+    * Run all queued background I/O requests, apply their results and 
+    * stop background thread.  Does nothing if background I/O is not 
+    * enabled.  The method should be called while no other thread 
+    * accesses the data store.
+    */
+   void stopBackgroundIO();
+
+   /*!
+    * Return true if background I/O is enabled; otherwise false.
+    */
+   bool isBackgroundIOEnabled() const;
+
+   /*!
+    * Queue background read of data object with given identifier if 
+    * background I/O is enabled and the object is not in memory; 
+    * otherwise do nothing.
+    *
+    * @param  object_id  Integer identifier of data object.
+    */
+   void prefetchObject(int object_id);
+
+   /*!
+    * Get number of queued background I/O requests, total number of 
+    * bytes written and read by background I/O, and total time in 
+    * seconds callers waited for background I/O to finish.  Totals 
+    * accumulate over all periods background I/O was enabled; all 
+    * values are zero if it never was.
+    */
+   int getBackgroundIOQueueDepth() const;
+   size_t getTotalBackgroundIOBytes() const;
+   double getTotalBackgroundIOStallTime() const;
+
+   //@}
+
+   //@{
+   //! @name Methods for accounting memory of data objects.
+
+   /*!
+    * Return total number of bytes held by data objects in memory.  Objects
+    * with pending background writes are included until the writes are
+    * applied.  The value may be read while other threads access the
+    * data store.
+    */
+   size_t getResidentObjectBytes() const;
+
+   /*!
+    * Return total number of data objects paged in from disk, including
+    * objects read in the background.  The value may be read while 
+    * other threads access the data store; a change shows that the 
+    * memory held by data objects may have grown.
+    */
+   int getTotalObjectPageInCount() const;
+
+   /*!
+    * Return number of bytes held by data object with given identifier 
+    * if it is in memory; otherwise zero.
+    *
+    * @param  object_id  Integer identifier of data object.
+    */
+   size_t getObjectMemorySize(int object_id) const;
+
+   /*!
+    * Measure again memory held by data object with given identifier, 
+    * e.g., after the object was modified in place.  Does nothing if 
+    * the identifier is not valid or the object is not in memory.
+    *
+    * @param  object_id  Integer identifier of data object.
+    */
+   void updateObjectMemorySize(int object_id);
+
+   //@}
+
    /*!
     * Add leaf node information to data store and set its 
     * leaf node identifier.
@@ -473,6 +628,39 @@ private:
       bool force_read = false);
 #endif
 
+   /*
+    * Private methods to write object with given integer identifier
+    * to the segment store if it does not currently exist in a file,
+    * and to read it from the segment store if it does not currently 
+    * exist in memory.  The record of an object read is removed from
+    * the segment store.  Return boolean true if operation succeeded; 
+    * otherwise false.
+    */
+   bool writeSegmentDataObject(int object_id);
+   bool readSegmentDataObject(int object_id);
+
+   /*
+    * Private method to apply results of completed background I/O
+    * requests: objects written are removed from memory and objects
+    * read are installed in memory, unless the object has since been
+    * removed or paged in or out otherwise, in which case the result is
+    * discarded.  Must be called with object access serialized.
+    */
+   void applyCompletedIO();
+
+   /*
+    * Private method returning true if background I/O is enabled and a
+    * request for object with given identifier is pending.
+    */
+   bool isObjectIOPending(int object_id) const;
+
+   /*
+    * Private method to account for memory held by object with given 
+    * identifier after its object pointer was set or reset.  Must be 
+    * called with object access serialized.
+    */
+   void accountObjectMemory(int object_id);
+
    /*
     * Private method to generate file name and file index 
     * for next object write.  Returns boolean true if name
@@ -592,6 +780,9 @@ private:
          void setFileIndex(int index);
          int getFileIndex() const;
 
+         void setMemorySize(size_t memory_size);
+         size_t getMemorySize() const;
+
          void printClassData(ostream& stream) const;
 
       private:
@@ -604,6 +795,7 @@ private:
          bool   d_in_file;
          bool   d_in_memory;
          int    d_object_file_index;
+         size_t d_memory_size;
    };
 
    /*
@@ -690,6 +882,38 @@ private:
    int                      d_num_objects_in_files;
    vector<ObjectFileInfo*>  d_object_file_info;
 
+   /*
+    * Store of data objects paged out of memory; the segment store is
+    * null unless the SEGMENT_FILE_OBJECT_STORE is used.
+    */
+   ObjectStoreType          d_object_store_type;
+   MTreeSegmentStore*       d_segment_store;
+
+   /*
+    * Background I/O worker, created when background I/O is first 
+    * started and kept for its statistics after it is stopped.
+    */
+   MTreeIOWorker*           d_io_worker;
+   bool                     d_background_io_enabled;
+
+   /*
+    * Number of bytes held by data objects in memory; updated with 
+    * object access serialized and read with relaxed loads.
+    */
+   std::atomic<size_t>      d_resident_object_bytes;
+
+   /*
+    * Number of data objects paged in from disk; updated with object
+    * access serialized and read with relaxed loads.
+    */
+   std::atomic<int>         d_num_objects_paged_in;
+
+   /*
+    * Serializes object access from concurrent tree searches, which may
+    * page data objects in from disk.
+    */
+   mutable std::mutex       d_object_access_mutex;
+
 };
 
 }
@@ -21,6 +21,16 @@ namespace MPTCOUPLER {
 
       bool write_successful = false;
 
+      //
+      // apply completed background I/O so that objects whose writes
+      // are done are not considered again
+      //
+
+      if ( d_background_io_enabled ) {
+	std::lock_guard<std::mutex> lock(d_object_access_mutex);
+	applyCompletedIO();
+      }
+
       //
       // iterate through all leaf nodes
       //
@@ -32,10 +42,12 @@ namespace MPTCOUPLER {
 	
 	if ( isValidObjectId(object_id) ) {
 	  
-	  if ( !(d_object_info[object_id]->getInFile()) ) {
+	  if ( !(d_object_info[object_id]->getInFile()) &&
+	       !isObjectIOPending(object_id) ) {
 	
 	    //
-	    // get object pointer
+	    // get object pointer; objects with pending background I/O
+	    // are skipped, since accessing them withdraws their writes
 	    //
 
 	    MTreeObjectPtr objectPointer = getObjectPtr(object_id);
@@ -144,6 +144,31 @@ void MTreeEntry::setDataObjectId(int object_id)
    d_subtree_node_id = MTreeNode::getUndefinedId();
 }
 
+/*
+*************************************************************************
+*                                                                       *
+* Routines to set radius and distance-to-parent of entry key; the       *
+* flat entry block of the node holding the entry is kept current.       *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeEntry::setDistanceToParent(double distance)
+{
+   d_key.setDistanceToParent(distance);
+   if ( d_my_node.get() ) {
+      d_my_node->updateEntryBlock(this);
+   }
+}
+
+void MTreeEntry::setRadius(double radius)
+{
+   d_key.setRadius(radius);
+   if ( d_my_node.get() ) {
+      d_my_node->updateEntryBlock(this);
+   }
+}
+
 /*
 *************************************************************************
 *                                                                       *
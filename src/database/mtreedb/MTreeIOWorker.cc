@@ -0,0 +1,521 @@
+// DO-NOT-DELETE revisionify.begin() 
+/*
+Copyright (c) 2007-2008 Lawrence Livermore National Security LLC
+
+This file is part of the mdef package (version 0.1) and is free software: 
+you can redistribute it and/or modify it under the terms of the GNU
+Lesser General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+                              DISCLAIMER
+
+This work was prepared as an account of work sponsored by an agency of
+the United States Government. Neither the United States Government nor
+Lawrence Livermore National Security, LLC nor any of their employees,
+makes any warranty, express or implied, or assumes any liability or
+responsibility for the accuracy, completeness, or usefulness of any
+information, apparatus, product, or process disclosed, or represents
+that its use would not infringe privately-owned rights. Reference
+herein to any specific commercial products, process, or service by
+trade name, trademark, manufacturer or otherwise does not necessarily
+constitute or imply its endorsement, recommendation, or favoring by
+the United States Government or Lawrence Livermore National Security,
+LLC. The views and opinions of authors expressed herein do not
+necessarily state or reflect those of the United States Government or
+Lawrence Livermore National Security, LLC, and shall not be used for
+advertising or product endorsement purposes.
+*/
+// DO-NOT-DELETE revisionify.end() 
+//
+// File:        MTreeIOWorker.cc
+// Package:     MPTCOUPLER MTree database
+// Description: Background thread moving data objects to and from a segment store.
+//
+
+#ifndef included_mtreedb_MTreeIOWorker_C
+#define included_mtreedb_MTreeIOWorker_C
+
+#include "MTreeIOWorker.h"
+
+#ifndef included_toolbox_MemoryDatabase
+#include "toolbox/database/MemoryDatabase.h"
+#endif
+
+#ifdef DEBUG_CHECK_ASSERTIONS
+#ifndef included_cassert
+#define included_cassert
+#include <cassert>
+#endif
+#endif
+
+#include <algorithm>
+#include <chrono>
+
+namespace MPTCOUPLER {
+    namespace mtreedb {
+
+/*
+*************************************************************************
+*                                                                       *
+* Ctor and dtor.                                                        *
+*                                                                       *
+*************************************************************************
+*/
+
+MTreeIOWorker::MTreeIOWorker(MTreeSegmentStore* segment_store,
+                             const MTreeObjectFactory* object_factory)
+: d_segment_store(segment_store),
+  d_object_factory(object_factory),
+  d_max_queue_depth(0),
+  d_num_writes(0),
+  d_num_reads(0),
+  d_num_cancels(0),
+  d_bytes_written(0),
+  d_bytes_read(0),
+  d_num_stalls(0),
+  d_stall_time(0.0),
+  d_stop(false)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(segment_store != (MTreeSegmentStore*)NULL);
+   assert(object_factory != (const MTreeObjectFactory*)NULL);
+#endif
+}
+
+MTreeIOWorker::~MTreeIOWorker()
+{
+   {
+      std::lock_guard<std::mutex> lock(d_mutex);
+      d_read_queue.clear();
+      d_write_queue.clear();
+   }
+
+   stop();
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Start and stop thread.                                                *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeIOWorker::start()
+{
+   if ( !d_thread.joinable() ) {
+      d_stop = false;
+      d_thread = std::thread(&MTreeIOWorker::run, this);
+   }
+}
+
+void MTreeIOWorker::stop()
+{
+   if ( d_thread.joinable() ) {
+      {
+         std::lock_guard<std::mutex> lock(d_mutex);
+         d_stop = true;
+      }
+      d_work_condition.notify_one();
+      d_thread.join();
+      d_stop = false;
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Queue requests.                                                       *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeIOWorker::queueWrite(int object_id,
+                               const string& database_name,
+                               MTreeObjectPtr object)
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   return( queueRequest(object_id, true, database_name, object) );
+}
+
+bool MTreeIOWorker::queueRead(int object_id,
+                              const string& database_name)
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   return( queueRequest(object_id, false, database_name, MTreeObjectPtr()) );
+}
+
+bool MTreeIOWorker::hasRequest(int object_id) const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   return( d_requests.find(object_id) != d_requests.end() );
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Wait for, withdraw and collect requests.                              *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeIOWorker::waitForRequest(int object_id)
+{
+   std::unique_lock<std::mutex> lock(d_mutex);
+
+   RequestMap::iterator ir = d_requests.find(object_id);
+
+   if ( (ir != d_requests.end()) &&
+        (ir->second.d_state == QUEUED_REQUEST) ) {
+      unqueueRequest(object_id, ir->second.d_is_write);
+      d_requests.erase(ir);
+      ++d_num_cancels;
+      return(false);
+   }
+
+   ir = waitWhileRunning(lock, object_id);
+
+   return( ir != d_requests.end() );
+}
+
+void MTreeIOWorker::cancelRequest(int object_id)
+{
+   std::unique_lock<std::mutex> lock(d_mutex);
+
+   RequestMap::iterator ir = d_requests.find(object_id);
+
+   if ( (ir != d_requests.end()) &&
+        (ir->second.d_state == QUEUED_REQUEST) ) {
+      unqueueRequest(object_id, ir->second.d_is_write);
+   } else {
+      ir = waitWhileRunning(lock, object_id);
+      if ( (ir != d_requests.end()) && ir->second.d_is_write ) {
+         d_segment_store->removeRecord(object_id);
+      }
+   }
+
+   if ( ir != d_requests.end() ) {
+      d_requests.erase(ir);
+      ++d_num_cancels;
+   }
+}
+
+void MTreeIOWorker::takeCompletedRequests(vector<CompletedRequest>& completed)
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   completed.clear();
+
+   while ( !d_completed_requests.empty() ) {
+
+      const int object_id = d_completed_requests.front();
+      d_completed_requests.pop_front();
+
+      RequestMap::iterator ir = d_requests.find(object_id);
+      if ( (ir != d_requests.end()) &&
+           (ir->second.d_state == COMPLETED_REQUEST) ) {
+         CompletedRequest request;
+         request.d_object_id = object_id;
+         request.d_is_write = ir->second.d_is_write;
+         request.d_object = ir->second.d_object;
+         completed.push_back(request);
+         d_requests.erase(ir);
+      }
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Thread: run queued requests, reads first, until stopped with empty    *
+* queues.  A failed request is dropped, leaving the object where it     *
+* was; its object is then written or read again on demand.              *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeIOWorker::run()
+{
+   std::unique_lock<std::mutex> lock(d_mutex);
+
+   while (true) {
+
+      if ( d_read_queue.empty() && d_write_queue.empty() ) {
+         if ( d_stop ) {
+            break;
+         }
+         d_work_condition.wait(lock);
+         continue;
+      }
+
+      list<int>& queue = d_read_queue.empty() ? d_write_queue : d_read_queue;
+      const int object_id = queue.front();
+      queue.pop_front();
+
+      Request& request = d_requests[object_id];
+      request.d_state = RUNNING_REQUEST;
+
+      const bool is_write = request.d_is_write;
+      const string database_name = request.d_database_name;
+      MTreeObjectPtr object = request.d_object;
+
+      lock.unlock();
+
+      size_t num_bytes = 0;
+      bool successful = is_write ?
+         writeObject(object_id, database_name, *object, num_bytes) :
+         readObject(object_id, database_name, object, num_bytes);
+
+      lock.lock();
+
+      RequestMap::iterator ir = d_requests.find(object_id);
+
+      if ( successful ) {
+         ir->second.d_state = COMPLETED_REQUEST;
+         ir->second.d_object = object;
+         d_completed_requests.push_back(object_id);
+         if ( is_write ) {
+            ++d_num_writes;
+            d_bytes_written += num_bytes;
+         } else {
+            ++d_num_reads;
+            d_bytes_read += num_bytes;
+         }
+      } else {
+         d_requests.erase(ir);
+      }
+
+      d_done_condition.notify_all();
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private methods called by thread without lock held to serialize       *
+* and write object, and to build object from its mapped record.         *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeIOWorker::writeObject(int object_id,
+                                const string& database_name,
+                                const MTreeObject& object,
+                                size_t& num_bytes)
+{
+   toolbox::MemoryDatabase obj_db(database_name);
+
+   object.writeToDatabase(obj_db);
+
+   vector<char> record;
+   obj_db.serialize(record);
+
+   num_bytes = record.size();
+
+   return( d_segment_store->writeRecord(object_id, record) );
+}
+
+bool MTreeIOWorker::readObject(int object_id,
+                               const string& database_name,
+                               MTreeObjectPtr& object,
+                               size_t& num_bytes)
+{
+   MTreeSegmentStore::RecordView record;
+   toolbox::MemoryDatabase obj_db(database_name);
+
+   bool read_successful = 
+      d_segment_store->mapRecord(object_id, record) &&
+      obj_db.attach(record.getData(), record.getSize());
+
+   if ( read_successful ) {
+      object = d_object_factory->allocateObject(obj_db);
+      object->setObjectId(object_id);
+      num_bytes = record.getSize();
+   }
+
+   return(read_successful);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private methods called with lock held: queue request, remove queued   *
+* request from its queue, and wait while request is running.           *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeIOWorker::queueRequest(int object_id,
+                                 bool is_write,
+                                 const string& database_name,
+                                 MTreeObjectPtr object)
+{
+   if ( d_requests.find(object_id) != d_requests.end() ) {
+      return(false);
+   }
+
+   Request& request = d_requests[object_id];
+   request.d_is_write = is_write;
+   request.d_state = QUEUED_REQUEST;
+   request.d_database_name = database_name;
+   request.d_object = object;
+
+   if ( is_write ) {
+      d_write_queue.push_back(object_id);
+   } else {
+      d_read_queue.push_back(object_id);
+   }
+
+   d_max_queue_depth = 
+      std::max(d_max_queue_depth,
+               static_cast<int>(d_read_queue.size() + d_write_queue.size()));
+
+   d_work_condition.notify_one();
+
+   return(true);
+}
+
+void MTreeIOWorker::unqueueRequest(int object_id,
+                                   bool is_write)
+{
+   if ( is_write ) {
+      d_write_queue.remove(object_id);
+   } else {
+      d_read_queue.remove(object_id);
+   }
+}
+
+MTreeIOWorker::RequestMap::iterator 
+MTreeIOWorker::waitWhileRunning(std::unique_lock<std::mutex>& lock,
+                                int object_id)
+{
+   RequestMap::iterator ir = d_requests.find(object_id);
+
+   if ( (ir != d_requests.end()) &&
+        (ir->second.d_state == RUNNING_REQUEST) ) {
+
+      const std::chrono::steady_clock::time_point stall_start =
+         std::chrono::steady_clock::now();
+
+      do {
+         d_done_condition.wait(lock);
+         ir = d_requests.find(object_id);
+      } while ( (ir != d_requests.end()) &&
+                (ir->second.d_state == RUNNING_REQUEST) );
+
+      ++d_num_stalls;
+      d_stall_time += std::chrono::duration<double>(
+         std::chrono::steady_clock::now() - stall_start).count();
+
+   }
+
+   return(ir);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Statistics.                                                           *
+*                                                                       *
+*************************************************************************
+*/
+
+int MTreeIOWorker::getQueueDepth() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return( d_read_queue.size() + d_write_queue.size() );
+}
+
+int MTreeIOWorker::getMaxQueueDepth() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_max_queue_depth);
+}
+
+int MTreeIOWorker::getTotalWriteCount() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_writes);
+}
+
+int MTreeIOWorker::getTotalReadCount() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_reads);
+}
+
+int MTreeIOWorker::getTotalCancelCount() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_cancels);
+}
+
+size_t MTreeIOWorker::getTotalBytesWritten() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_bytes_written);
+}
+
+size_t MTreeIOWorker::getTotalBytesRead() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_bytes_read);
+}
+
+int MTreeIOWorker::getTotalStallCount() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_stalls);
+}
+
+double MTreeIOWorker::getTotalStallTime() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_stall_time);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Write worker state and statistics to given output stream.             *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeIOWorker::printClassData(ostream& stream) const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   stream << "MTreeIOWorker::printClassData()\n";
+   stream << "--------------------------------------\n";
+   stream << "d_requests size = " << d_requests.size() << endl;
+   stream << "d_read_queue size = " << d_read_queue.size() << endl;
+   stream << "d_write_queue size = " << d_write_queue.size() << endl;
+   stream << "d_max_queue_depth = " << d_max_queue_depth << endl;
+   stream << "d_num_writes = " << d_num_writes << endl;
+   stream << "d_num_reads = " << d_num_reads << endl;
+   stream << "d_num_cancels = " << d_num_cancels << endl;
+   stream << "d_bytes_written = " << d_bytes_written << endl;
+   stream << "d_bytes_read = " << d_bytes_read << endl;
+   stream << "d_num_stalls = " << d_num_stalls << endl;
+   stream << "d_stall_time = " << d_stall_time << endl;
+}
+
+}
+}
+#endif
@@ -0,0 +1,324 @@
+//
+// File:        MTreeIOWorker.h
+// Package:     MPTCOUPLER MTree database
+//
+//
+//
+// Description: Background thread moving data objects to and from a segment store.
+//
+
+#ifndef included_mtreedb_MTreeIOWorker
+#define included_mtreedb_MTreeIOWorker
+
+#ifndef included_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_iostream
+#define included_iostream
+#include <iostream>
+using namespace std;
+#endif
+#ifndef included_String
+#include <string>
+using namespace std;
+#define included_String
+#endif
+#ifndef included_list
+#define included_list
+#include <list>
+using namespace std;
+#endif
+#ifndef included_map
+#define included_map
+#include <map>
+using namespace std;
+#endif
+#ifndef included_vector
+#define included_vector
+#include <vector>
+using namespace std;
+#endif
+#ifndef included_mutex
+#define included_mutex
+#include <mutex>
+#endif
+
+#include <condition_variable>
+#include <thread>
+
+#ifndef included_mtreedb_MTreeObject
+#include "MTreeObject.h"
+#endif
+#ifndef included_mtreedb_MTreeObjectFactory
+#include "MTreeObjectFactory.h"
+#endif
+#ifndef included_mtreedb_MTreeSegmentStore
+#include "MTreeSegmentStore.h"
+#endif
+
+namespace MPTCOUPLER {
+    namespace mtreedb {
+
+/*!
+ * @brief MTreeIOWorker moves data objects between memory and an
+ *        MTreeSegmentStore on a background thread on behalf of an
+ *        MTreeDataStore.
+ *
+ * Two kinds of requests are queued, at most one per data object: a
+ * write serializes an object and appends its record to the segment
+ * store, and a read (prefetch) builds a new object from its record.
+ * Reads are served before writes since a thread may soon wait for
+ * them.  The worker moves data only; the data store applies the result
+ * of a request when it collects completed requests, so that an object
+ * being written stays in memory and readable until then, and an object
+ * being read stays on disk.  A request may be withdrawn at any time;
+ * if the worker is running it, the caller waits for it to finish and
+ * the time is accounted as stall time.
+ *
+ * The worker never accesses data store state and all public methods
+ * are thread-safe.  Data objects are serialized while other threads may
+ * read them, so their writeToDatabase() method must be safe to call
+ * concurrently with const accesses to the object.
+ *
+ * @see mtreedb::MTreeDataStore
+ * @see mtreedb::MTreeSegmentStore
+ */
+
+class MTreeIOWorker
+{
+public:
+   /*!
+    * Result of a completed request.  The object is the one written or
+    * the one built from its record.
+    */
+   struct CompletedRequest {
+      int            d_object_id;
+      bool           d_is_write;
+      MTreeObjectPtr d_object;
+   };
+
+   /*!
+    * Ctor for MTreeIOWorker object.  The thread is not started.
+    *
+    * @param segment_store  Bare pointer to segment store the worker
+    *                       writes records to and reads records from.
+    * @param object_factory Const bare pointer to factory used to build
+    *                       data objects from their records.
+    */
+   MTreeIOWorker(MTreeSegmentStore* segment_store,
+                 const MTreeObjectFactory* object_factory);
+
+   /*!
+    * Dtor for MTreeIOWorker objects discards queued requests and stops
+    * the thread after the request it is running.  Results of completed
+    * requests are discarded without being applied; in particular, the
+    * records of objects written remain in the segment store.
+    */
+   ~MTreeIOWorker();
+
+   /*!
+    * Start thread.  Does nothing if the thread is running.
+    */
+   void start();
+
+   /*!
+    * Run all queued requests and stop thread.  Results of the requests
+    * remain to be collected.  Does nothing if no thread is running.
+    */
+   void stop();
+
+   /*!
+    * Queue write of given object.
+    *
+    * @return Boolean true if request was queued; false if a request for
+    *         the object is pending.
+    *
+    * @param object_id     Integer identifier of data object.
+    * @param database_name Const reference to name of database the object
+    *                      is serialized into.
+    * @param object        Pointer to data object.
+    */
+   bool queueWrite(int object_id,
+                   const string& database_name,
+                   MTreeObjectPtr object);
+
+   /*!
+    * Queue read of object with given identifier.
+    *
+    * @return Boolean true if request was queued; false if a request for
+    *         the object is pending.
+    *
+    * @param object_id     Integer identifier of data object.
+    * @param database_name Const reference to name of database the object
+    *                      is read from.
+    */
+   bool queueRead(int object_id,
+                  const string& database_name);
+
+   /*!
+    * Return true if a request for object with given identifier is
+    * queued, running or completed but not collected; otherwise false.
+    */
+   bool hasRequest(int object_id) const;
+
+   /*!
+    * Wait for request for object with given identifier to complete.  A
+    * request not yet started is withdrawn instead, since the caller can
+    * carry it out sooner itself.
+    *
+    * @return Boolean true if a request for the object has completed and
+    *         its result remains to be collected; otherwise false.
+    *
+    * @param object_id Integer identifier of data object.
+    */
+   bool waitForRequest(int object_id);
+
+   /*!
+    * Withdraw request for object with given identifier and discard its
+    * result, waiting for it to finish if it is running.  The record
+    * written by a completed write request is removed from the segment
+    * store.  Does nothing if there is no request for the object.
+    *
+    * @param object_id Integer identifier of data object.
+    */
+   void cancelRequest(int object_id);
+
+   /*!
+    * Move results of completed requests to given vector, replacing its
+    * contents.
+    */
+   void takeCompletedRequests(vector<CompletedRequest>& completed);
+
+   //@{
+   //! @name Methods for obtaining worker statistics.
+
+   /*!
+    * Get number of queued requests and maximum number of queued
+    * requests over the lifetime of the worker.
+    */
+   int getQueueDepth() const;
+   int getMaxQueueDepth() const;
+
+   /*!
+    * Get total number of objects written and read, and total number
+    * of requests withdrawn.
+    */
+   int getTotalWriteCount() const;
+   int getTotalReadCount() const;
+   int getTotalCancelCount() const;
+
+   /*!
+    * Get total number of record bytes written and read.
+    */
+   size_t getTotalBytesWritten() const;
+   size_t getTotalBytesRead() const;
+
+   /*!
+    * Get total number of times callers waited for a running request,
+    * and total time in seconds they waited.
+    */
+   int getTotalStallCount() const;
+   double getTotalStallTime() const;
+
+   //@}
+
+   /*!
+    * Print worker state and statistics to given output stream.
+    */
+   void printClassData(ostream& stream) const;
+
+private:
+   // The following are not implemented
+   MTreeIOWorker(const MTreeIOWorker&);
+   void operator=(const MTreeIOWorker&);
+
+   /*
+    * Pending request.  d_object is the object to write, or the object
+    * built by a completed read.
+    */
+   enum RequestState { QUEUED_REQUEST = 0,
+                       RUNNING_REQUEST = 1,
+                       COMPLETED_REQUEST = 2 };
+
+   struct Request {
+      bool           d_is_write;
+      RequestState   d_state;
+      string         d_database_name;
+      MTreeObjectPtr d_object;
+   };
+
+   typedef map<int, Request> RequestMap;
+
+   /*
+    * Private methods, called with d_mutex held, to queue request, to
+    * remove queued request from its queue and to wait until request
+    * is no longer running.  waitWhileRunning() returns iterator to the
+    * request, or end iterator if it failed and was dropped.
+    */
+   bool queueRequest(int object_id,
+                     bool is_write,
+                     const string& database_name,
+                     MTreeObjectPtr object);
+   void unqueueRequest(int object_id,
+                       bool is_write);
+   RequestMap::iterator waitWhileRunning(std::unique_lock<std::mutex>& lock,
+                                         int object_id);
+
+   /*
+    * Private methods, called without d_mutex held by the thread, to
+    * write object and to read object, setting number of bytes moved.
+    * Return boolean true if operation succeeded; otherwise false.
+    */
+   bool writeObject(int object_id,
+                    const string& database_name,
+                    const MTreeObject& object,
+                    size_t& num_bytes);
+   bool readObject(int object_id,
+                   const string& database_name,
+                   MTreeObjectPtr& object,
+                   size_t& num_bytes);
+
+   /*
+    * Private method run by thread.
+    */
+   void run();
+
+   MTreeSegmentStore*        d_segment_store;
+   const MTreeObjectFactory* d_object_factory;
+
+   /*
+    * Requests by object identifier, identifiers of queued requests and
+    * identifiers of requests completed since results were last
+    * collected (which may have been withdrawn since).
+    */
+   RequestMap d_requests;
+   list<int>  d_read_queue;
+   list<int>  d_write_queue;
+   list<int>  d_completed_requests;
+
+   int    d_max_queue_depth;
+   int    d_num_writes;
+   int    d_num_reads;
+   int    d_num_cancels;
+   size_t d_bytes_written;
+   size_t d_bytes_read;
+   int    d_num_stalls;
+   double d_stall_time;
+
+   /*
+    * Lock protecting all data above, and state of thread;
+    * d_work_condition is signaled when a request is queued or the
+    * thread is to stop, d_done_condition when a request finishes.
+    */
+   mutable std::mutex      d_mutex;
+   std::condition_variable d_work_condition;
+   std::condition_variable d_done_condition;
+   std::thread             d_thread;
+   bool                    d_stop;
+
+};
+
+}
+}
+#endif
@@ -95,9 +95,12 @@ MTreeNode::MTreeNode(MTree* tree,
    d_node_id( s_node_instance_counter++ ),
    d_leaf_node_id( MTreeNode::getUndefinedId() ),
    d_level_in_tree(0),
-   d_max_entries(max_entries)
+   d_max_entries(max_entries),
+   d_entry_block_dimension(0)
 {
    d_entries.reserve(max_entries+1);
+   d_entry_radii.reserve(max_entries+1);
+   d_entry_distances_to_parent.reserve(max_entries+1);
    d_my_tree->addNodeToLevelCount(d_level_in_tree);
 }
 
@@ -411,6 +414,7 @@ void MTreeNode::insertEntry(MTreeEntryPtr entry,
       entry->setNode( node );
       entry->setPositionInNode( node->getNumberEntries() );
       node.get()->d_entries.push_back(entry);
+      node->rebuildEntryBlock();
 
    } else {
 
@@ -503,6 +507,7 @@ void MTreeNode::insertEntryAtPosition(MTreeEntryPtr entry,
       entry->setNode( node );
       entry->setPositionInNode(position);
       node.get()->d_entries[position] = entry;
+      node->rebuildEntryBlock();
 
    } else {
       MTreeNode::insertEntry(entry, node);
@@ -542,6 +547,7 @@ void MTreeNode::deleteEntry(MTreeEntryPtr entry,
       }
 
       node.get()->d_entries.pop_back();
+      node->rebuildEntryBlock();
    }
 
 }
@@ -574,6 +580,75 @@ void MTreeNode::transferEntries(MTreeNodePtr node)
       node->getEntry(ie)->setNode(node);
    }
 
+   rebuildEntryBlock();
+   node->rebuildEntryBlock();
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Rebuild flat entry block from current entries.  The block is only     *
+* available when all entry points provide coordinates of a common       *
+* dimension.                                                            *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeNode::rebuildEntryBlock()
+{
+   const int num_entries = d_entries.size();
+
+   int dimension = 0;
+   if (num_entries > 0) {
+      dimension = d_entries[0]->getPoint()->getNumberCoordinates();
+   }
+   for (int ie = 1; (ie < num_entries) && (dimension > 0); ++ie) {
+      if ( d_entries[ie]->getPoint()->getNumberCoordinates() != dimension ) {
+         dimension = 0;
+      }
+   }
+
+   d_entry_block_dimension = dimension;
+   d_entry_coordinates.clear();
+   d_entry_radii.clear();
+   d_entry_distances_to_parent.clear();
+
+   if (dimension > 0) {
+
+      d_entry_coordinates.reserve( (d_max_entries+1) * dimension );
+
+      for (int ie = 0; ie < num_entries; ++ie) {
+         const MTreeEntry& entry = *d_entries[ie];
+         const double* coordinates = entry.getPoint()->getCoordinates();
+         d_entry_coordinates.insert(d_entry_coordinates.end(),
+                                    coordinates,
+                                    coordinates + dimension);
+         d_entry_radii.push_back( entry.getRadius() );
+         d_entry_distances_to_parent.push_back( entry.getDistanceToParent() );
+      }
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Copy radius and distance-to-parent of entry into flat entry block.    *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeNode::updateEntryBlock(const MTreeEntry* entry)
+{
+   const int position = entry->getPositionInNode();
+   const int num_block_entries = d_entry_radii.size();
+
+   if ( (position >= 0) && (position < num_block_entries) &&
+        (d_entries[position].get() == entry) ) {
+      d_entry_radii[position] = entry->getRadius();
+      d_entry_distances_to_parent[position] = entry->getDistanceToParent();
+   }
 }
 
 /*
@@ -1223,6 +1298,7 @@ void MTreeNode::partitionEntries(MTreeEntryPtr entry1,
       for (ie = 0; ie < num_entries; ++ie) {
          d_entries.pop_back();
       }
+      rebuildEntryBlock();
 
       for (ie = 0; ie < num_entries; ++ie) {
          if (assignment[ie] == 1) {
@@ -1329,6 +1405,27 @@ bool MTreeNode::checkConsistency(ostream& stream) const
       }
    }
 
+   if ( d_entry_block_dimension > 0 ) {
+      for (ie = 0; ie < getNumberEntries(); ++ie) {
+         const MTreeEntry& entry = *d_entries[ie];
+         bool block_entry_ok = 
+            ( (d_entry_radii[ie] == entry.getRadius()) &&
+              (d_entry_distances_to_parent[ie] == 
+               entry.getDistanceToParent()) );
+         const double* coordinates = entry.getPoint()->getCoordinates();
+         for (int i = 0; i < d_entry_block_dimension; ++i) {
+            block_entry_ok &= 
+               ( d_entry_coordinates[ie*d_entry_block_dimension + i] ==
+                 coordinates[i] );
+         }
+         if ( !block_entry_ok ) {
+            stream << "MTREE NODE ERROR: Flat entry block out of date "
+                   << "for entry " << ie << endl;
+            node_is_consistent = false;
+         }
+      }
+   }
+
    if ( !node_is_consistent ) {
       printClassData(stream);
    }
@@ -62,6 +62,7 @@ class MTreeNode
 {
 public:
    friend class MTreeDataStore;
+   friend class MTreeEntry;
 
    /*!
     * Static function to get integer identifier for undefined node
@@ -248,6 +249,42 @@ public:
     */ 
    MTreeEntryPtr getEntry(int position) const;
 
+   //@{
+   //! @name Flat entry block.
+   //
+   // When the points of all entries in the node provide flat coordinates
+   // of a common dimension (see MTreePoint::getNumberCoordinates()), the
+   // node keeps copies of the entry coordinates, radii and 
+   // distance-to-parent values in contiguous arrays ordered like the 
+   // entries.  Searches stream through these arrays instead of going 
+   // through entry, key and point objects.  The block is maintained as
+   // entries are added, removed, and as their radii and 
+   // distance-to-parent values change.
+
+   /*!
+    * Return number of coordinates per entry in the flat entry block, 
+    * or zero if the block is not available for this node.
+    */
+   int getEntryBlockDimension() const;
+
+   /*!
+    * Return pointer to the entry coordinates; the coordinates of the 
+    * entry at position ie start at ie*getEntryBlockDimension().
+    */
+   const double* getEntryCoordinates() const;
+
+   /*!
+    * Return pointer to the radii of the entries.
+    */
+   const double* getEntryRadii() const;
+
+   /*!
+    * Return pointer to the distance-to-parent values of the entries.
+    */
+   const double* getEntryDistancesToParent() const;
+
+   //@}
+
    /*!
     * Search entries of this node for one best suited for
     * insertion of entry.  
@@ -475,6 +512,18 @@ private:
     */
    void setLeafNodeId(int id);
 
+   /*
+    * Rebuild the flat entry block from the current entries. Called
+    * whenever the set or order of entries in the node changes.
+    */
+   void rebuildEntryBlock();
+
+   /*
+    * Copy radius and distance-to-parent value of given entry into the 
+    * flat entry block if the entry is held by this node.
+    */
+   void updateEntryBlock(const MTreeEntry* entry);
+
    /*
     * Get smart pointer to myself.
     */
@@ -536,6 +585,15 @@ private:
    int    d_max_entries;            
    vector<MTreeEntryPtr> d_entries;  
 
+   /*
+    * Flat entry block (see getEntryBlockDimension()); the dimension is 
+    * zero when the block is not available.
+    */
+   int            d_entry_block_dimension;
+   vector<double> d_entry_coordinates;
+   vector<double> d_entry_radii;
+   vector<double> d_entry_distances_to_parent;
+
 };
 
 }
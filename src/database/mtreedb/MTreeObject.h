@@ -41,7 +41,8 @@ typedef std::shared_ptr<MTreeObject> MTreeObjectPtr;
  *
  * By default, an object has an undefined object id.  For safety, and 
  * to preserve the uniqueness of object ids, an object id should only 
- * be set by the data store class.  Typically, this is done when an object 
+ * be set by the data store class (or by an index structure, such as VPTree,
+ * that keeps its own objects).  Typically, this is done when an object 
  * is added to the data store.  The setObjectId() method is declared private.
  */
 
@@ -49,7 +50,9 @@ class MTreeObject
 {
 public:
    friend class MTreeDataStore;
+   friend class MTreeIOWorker;
    friend class MTreeSearchResult;
+   friend class VPTree;
 
    /*!
     * Static function to get common undefined integer identifier for object.
@@ -83,6 +86,14 @@ public:
     */
    virtual ostream& print(ostream& stream) const;
 
+   /*!
+    * Virtual method to return number of bytes of memory held by the
+    * object, used by the data store to account for objects in memory.
+    * The default returns the size of the MTreeObject base; derived
+    * classes holding data on the heap should override it.
+    */
+   virtual size_t getMemorySize() const;
+
    /*!
     * Return integer identifier of object.
     */
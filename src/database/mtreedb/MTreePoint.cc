@@ -87,6 +87,25 @@ void MTreePoint::setMaxDistance(double max_dist)
    s_max_distance = max_dist;
 }
 
+/*
+*************************************************************************
+*                                                                       *
+* Default coordinate access; points have no flat coordinates unless     *
+* a concrete point class says otherwise.                                *
+*                                                                       *
+*************************************************************************
+*/
+
+int MTreePoint::getNumberCoordinates() const
+{
+   return(0);
+}
+
+const double* MTreePoint::getCoordinates() const
+{
+   return( (const double*)NULL );
+}
+
 }
 }
 #endif
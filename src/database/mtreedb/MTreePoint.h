@@ -112,6 +112,24 @@ public:
     */ 
    double computeDistanceTo(MTreePointPtr other) const;
 
+   /*!
+    * Virtual method to return the number of coordinates of a point that 
+    * is a fixed-dimension coordinate vector whose distance function is 
+    * the Euclidean distance between coordinate vectors.  Nodes of the 
+    * tree keep copies of such coordinates in contiguous storage so that 
+    * searches need not call computeDistanceTo() through the point objects.
+    * The default returns zero, indicating that the point has no such 
+    * coordinate representation.
+    */
+   virtual int getNumberCoordinates() const;
+
+   /*!
+    * Virtual method to return pointer to the getNumberCoordinates() 
+    * contiguous coordinates of the point.  The default returns a null
+    * pointer.
+    */
+   virtual const double* getCoordinates() const;
+
    /*!
     * Vitual method to print concrete point object data to the specified 
     * output stream.   This is optional; a default no-op is supplied here.
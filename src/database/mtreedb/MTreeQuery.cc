@@ -50,9 +50,13 @@ advertising or product endorsement purposes.
 
 #include "MTreeQuery.h"
 
-#include "MTree.h"
 #include "toolbox/base/MathUtilities.h"
 
+#ifndef included_cmath
+#define included_cmath
+#include <cmath>
+#endif
+
 #ifdef DEBUG_NO_INLINE
 #include "MTreeQuery.I"
 #endif
@@ -82,7 +86,7 @@ bool MTreeQuery::isConsistent(MTreeEntryPtr entry)
           <= d_radius + entry->getRadius() ) ) {
 
       d_grade = d_query_point->computeDistanceTo( entry->getPoint() );
-      d_tree->incrementDistanceComputeCount();
+      ++(*d_distance_count);
       ret_val = (d_grade <= d_radius + entry->getRadius() );
       
    }
@@ -90,6 +94,32 @@ bool MTreeQuery::isConsistent(MTreeEntryPtr entry)
    return( ret_val );
 }
 
+bool MTreeQuery::isConsistent(const double* entry_coordinates,
+                              double entry_radius,
+                              double entry_distance_to_parent)
+{
+   bool ret_val = false;
+  
+   if ( (d_grade == 0) ||
+        ( toolbox::MathUtilities<double>::Abs(
+             d_grade - entry_distance_to_parent ) 
+          <= d_radius + entry_radius ) ) {
+
+      double distance_sqr = 0.0;
+      for (int i = 0; i < d_number_coordinates; ++i) {
+         const double diff = d_query_coordinates[i] - entry_coordinates[i];
+         distance_sqr += diff*diff;
+      }
+
+      d_grade = sqrt(distance_sqr);
+      ++(*d_distance_count);
+      ret_val = (d_grade <= d_radius + entry_radius );
+      
+   }
+
+   return( ret_val );
+}
+
 }
 }
 #endif
@@ -24,8 +24,6 @@
 namespace MPTCOUPLER {
     namespace mtreedb {
 
-class MTree;
-
 /*!
  * @brief MTreeQuery is a simple utility class used in MTree
  * range searches and nearest-neighbor searches.  
@@ -40,11 +38,13 @@ public:
    /*!
     * Ctor for MTreeQuery sets query point and radius 
     * (no error checking), sets grade to zero, and caches
-    * pointer to MTree (for statistics gathering).
+    * pointer to distance computation counter (for statistics 
+    * gathering).  The counter is owned by the search operation,
+    * so concurrent searches do not share it.
     */
    MTreeQuery(MTreePointPtr query_point,
               double query_radius,
-              MTree* tree);
+              int* distance_count);
 
    /*!
     * Copy ctor for MTreeQuery.
@@ -87,15 +87,34 @@ public:
     */
    bool isConsistent(MTreeEntryPtr entry);
 
+   /*!
+    * Return number of flat coordinates of query point (see 
+    * MTreePoint::getNumberCoordinates()).
+    */
+   int getNumberCoordinates() const;
+
+   /*!
+    * Same as isConsistent(MTreeEntryPtr) for an entry given by its
+    * coordinates, radius and distance-to-parent as held in the flat 
+    * entry block of a node (see MTreeNode::getEntryBlockDimension()).
+    * The coordinates are assumed to have getNumberCoordinates() 
+    * components.
+    */
+   bool isConsistent(const double* entry_coordinates,
+                     double entry_radius,
+                     double entry_distance_to_parent);
+
 private:
    // The following are not implemented
    MTreeQuery();
    void operator=(const MTreeQuery&);
    
    MTreePointPtr   d_query_point;
+   const double*   d_query_coordinates;
+   int             d_number_coordinates;
    double          d_radius;
    double          d_grade;
-   MTree*          d_tree;
+   int*            d_distance_count;
 };
 
 }
@@ -50,6 +50,11 @@ advertising or product endorsement purposes.
 
 #include "MTreeSearchQueue.h"
 
+#ifndef included_algorithm
+#define included_algorithm
+#include <algorithm>
+#endif
+
 #ifdef DEBUG_NO_INLINE
 #include "MTreeSearchQueue.I"
 #endif
@@ -68,24 +73,24 @@ namespace MPTCOUPLER {
 MTreeSearchQueue::~MTreeSearchQueue()
 {
    d_queue.clear();
+   d_nodes.clear();
+}
+
+void MTreeSearchQueue::removeFirst()
+{
+   pop_heap(d_queue.begin(), d_queue.end(), HeapEntryAfter());
+   d_queue.pop_back(); 
 }
 
 void MTreeSearchQueue::insert(MTreeSearchNode& node)
 {
-   if ( d_queue.empty() ) {
-      d_queue.push_front(node);
-   } else {
-      list<MTreeSearchNode>::iterator it(d_queue.begin());
-      while ( (it != d_queue.end()) && 
-              ((*it).d_bound < node.d_bound) ) {
-         ++it;
-      }
-      if ( it == d_queue.end() ) {
-         d_queue.push_back(node);
-      } else {
-         d_queue.insert(it, node); 
-      }
-   }  
+   HeapEntry entry;
+   entry.d_bound = node.d_bound;
+   entry.d_index = d_nodes.size();
+
+   d_nodes.push_back(node);
+   d_queue.push_back(entry);
+   push_heap(d_queue.begin(), d_queue.end(), HeapEntryAfter());
 }
 
 }
@@ -14,9 +14,9 @@
 #include "asf_config.h"
 #endif
 
-#ifndef included_list
-#define included_list
-#include <list>
+#ifndef included_vector
+#define included_vector
+#include <vector>
 using namespace std;
 #endif
 
@@ -24,15 +24,27 @@ using namespace std;
 #include "MTreeSearchNode.h"
 #endif
 
+#include "toolbox/base/ScratchArena.h"
+
 namespace MPTCOUPLER {
     namespace mtreedb {
 
 /*!
- * @brief MTreeSearchQueue implements a simple ordered list 
- * of MTreeSearchNode objects used in MTree nearest-neighbor searches.
+ * @brief MTreeSearchQueue implements a priority queue of 
+ * MTreeSearchNode objects, ordered by increasing bound, used in MTree 
+ * nearest-neighbor searches.
  * 
+ * The queue is a binary heap of (bound, node index) pairs over an 
+ * append-only array of the inserted nodes, so insertion and removal of 
+ * the first node cost O(log n) and only plain pairs are moved around.
+ * Among nodes with equal bounds the most recently inserted one is
+ * first.
+ *
  * This class is used in MTree search operations and should not
- * be used for other stuff.
+ * be used for other stuff.  The storage is drawn from the scratch 
+ * arena of the calling thread, so a queue must be destroyed within 
+ * the toolbox::ScratchArena::Scope it was created in.  Nodes removed
+ * from the queue are released when the queue is cleared or destroyed.
  */
  
 class MTreeSearchQueue
@@ -63,16 +75,6 @@ public:
     */
    void removeFirst();
  
-   /*!
-    * Return last MTreeSearchNode object in queue.
-    */
-   MTreeSearchNode getLast() const;
-
-   /*!
-    * Remove last MTreeSearchNode object in queue.
-    */
-   void removeLast();
- 
    /*!
     * Insert MTreeSearchNode object in queue in proper location.
     */
@@ -88,7 +90,33 @@ private:
    MTreeSearchQueue(const MTreeSearchQueue&);
    void operator=(const MTreeSearchQueue&);
 
-   list<MTreeSearchNode> d_queue;
+   /*
+    * Heap element holding bound and index of node in d_nodes; the 
+    * index also orders nodes with equal bounds.
+    */
+   struct HeapEntry {
+      double d_bound;
+      int    d_index;
+   };
+
+   /*
+    * Heap ordering; the first node in the queue is at the top of 
+    * the heap.
+    */
+   struct HeapEntryAfter {
+      bool operator()(const HeapEntry& a, const HeapEntry& b) const {
+         return( (a.d_bound > b.d_bound) ||
+                 ( (a.d_bound == b.d_bound) && (a.d_index < b.d_index) ) );
+      }
+   };
+
+   typedef vector<HeapEntry, 
+                  toolbox::ScratchAllocator<HeapEntry> > EntryHeap;
+   typedef vector<MTreeSearchNode, 
+                  toolbox::ScratchAllocator<MTreeSearchNode> > NodeArray;
+
+   EntryHeap d_queue;
+   NodeArray d_nodes;
  
 };
 
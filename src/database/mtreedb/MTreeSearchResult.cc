@@ -72,14 +72,17 @@ MTreeSearchResult::~MTreeSearchResult()
 /*
 *************************************************************************
 *                                                                       *
-* Private function to finalize search result with deep copies.          * 
+* Private function to finalize search result with deep copies; the     *
+* data object is copied only if results are made safe, and the point    *
+* is copied unless points are shared.                                   *
 *                                                                       *
 *************************************************************************
 */
 
 void MTreeSearchResult::finalizeSearchResult(
    MTreeDataStore& data_store,
-   bool make_safe)
+   bool make_safe,
+   bool share_points)
 {
    if (d_is_valid_result) { 
       if (make_safe) {
@@ -87,7 +90,9 @@ void MTreeSearchResult::finalizeSearchResult(
       } else {
          d_data_object = data_store.getObjectPtr(d_data_object_id);
       }
-      d_data_object_point = d_data_object_point->makeCopy();
+      if (make_safe || !share_points) {
+         d_data_object_point = d_data_object_point->makeCopy();
+      }
    }
 }
 
@@ -41,6 +41,7 @@ class MTreeSearchResult
 {
 public:
    friend class MTree;
+   friend class VPTree;
 
    /*!
     * Default ctor for MTree search result sets result
@@ -110,6 +111,18 @@ private:
    MTreeSearchResult(MTreePointPtr query_point,
                      MTreeEntryPtr entry);
 
+   /*
+    * Private ctor for search result class (called by index structures
+    * that keep data objects outside of an MTreeDataStore, such as VPTree)
+    * sets query point and data object information directly.  Distance 
+    * from data object to query point is not set.  The given object and 
+    * point are stored as is; the caller makes any copies needed.
+    */
+   MTreeSearchResult(MTreePointPtr query_point,
+                     MTreeObjectPtr data_object,
+                     MTreePointPtr data_object_point,
+                     double data_object_radius);
+
    /*!
     * Private function to set query point (called by MTree).
     */
@@ -135,11 +148,13 @@ private:
    /*
     * Private function to finalize search result (called by MTree)
     * replaces data object and point with deep copies, if
-    * the boolean argument is true.
+    * make_safe is true, and the point alone unless share_points
+    * is true.
     * This ensures integrity of data in MTree.  
     */
    void finalizeSearchResult(MTreeDataStore& data_store,
-                             bool make_safe);
+                             bool make_safe,
+                             bool share_points);
 
    MTreePointPtr   d_query_point;
    double          d_distance_to_query_point;
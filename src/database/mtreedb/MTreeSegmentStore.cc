@@ -0,0 +1,806 @@
+// DO-NOT-DELETE revisionify.begin() 
+/*
+Copyright (c) 2007-2008 Lawrence Livermore National Security LLC
+
+This file is part of the mdef package (version 0.1) and is free software: 
+you can redistribute it and/or modify it under the terms of the GNU
+Lesser General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+                              DISCLAIMER
+
+This work was prepared as an account of work sponsored by an agency of
+the United States Government. Neither the United States Government nor
+Lawrence Livermore National Security, LLC nor any of their employees,
+makes any warranty, express or implied, or assumes any liability or
+responsibility for the accuracy, completeness, or usefulness of any
+information, apparatus, product, or process disclosed, or represents
+that its use would not infringe privately-owned rights. Reference
+herein to any specific commercial products, process, or service by
+trade name, trademark, manufacturer or otherwise does not necessarily
+constitute or imply its endorsement, recommendation, or favoring by
+the United States Government or Lawrence Livermore National Security,
+LLC. The views and opinions of authors expressed herein do not
+necessarily state or reflect those of the United States Government or
+Lawrence Livermore National Security, LLC, and shall not be used for
+advertising or product endorsement purposes.
+*/
+// DO-NOT-DELETE revisionify.end() 
+//
+// File:        MTreeSegmentStore.cc
+// Package:     MPTCOUPLER MTree database
+// Description: Log-structured file store for serialized data objects.
+//
+
+#ifndef included_mtreedb_MTreeSegmentStore_C
+#define included_mtreedb_MTreeSegmentStore_C
+
+#include "MTreeSegmentStore.h"
+
+#ifndef included_toolbox_Utilities
+#include "toolbox/base/Utilities.h"
+#endif
+
+#ifdef DEBUG_CHECK_ASSERTIONS
+#ifndef included_cassert
+#define included_cassert
+#include <cassert>
+#endif
+#endif
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace MPTCOUPLER {
+    namespace mtreedb {
+
+/*
+*************************************************************************
+*                                                                       *
+* Deleter unmapping a segment mapping once the store and all record     *
+* views have released it.                                               *
+*                                                                       *
+*************************************************************************
+*/
+
+namespace {
+
+class MappingDeleter
+{
+public:
+   explicit MappingDeleter(size_t length)
+   : d_length(length)
+   {
+   }
+
+   void operator()(const char* address) const
+   {
+      munmap(const_cast<char*>(address), d_length);
+   }
+
+private:
+   size_t d_length;
+};
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Record views.                                                         *
+*                                                                       *
+*************************************************************************
+*/
+
+MTreeSegmentStore::RecordView::RecordView()
+: d_data(NULL),
+  d_size(0)
+{
+}
+
+const char* MTreeSegmentStore::RecordView::getData() const
+{
+   return(d_data);
+}
+
+size_t MTreeSegmentStore::RecordView::getSize() const
+{
+   return(d_size);
+}
+
+void MTreeSegmentStore::RecordView::release()
+{
+   d_mapping.reset();
+   d_data = NULL;
+   d_size = 0;
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Ctor and dtor.                                                        *
+*                                                                       *
+*************************************************************************
+*/
+
+MTreeSegmentStore::MTreeSegmentStore(const string& file_prefix,
+                                     size_t segment_capacity)
+: d_file_prefix(file_prefix),
+  d_segment_capacity(segment_capacity),
+  d_compaction_threshold(DEFAULT_COMPACTION_THRESHOLD_PERCENT / 100.0),
+  d_active_segment(-1),
+  d_num_records(0),
+  d_num_segments_on_disk(0),
+  d_live_bytes(0),
+  d_dead_bytes(0),
+  d_num_compactions(0),
+  d_compaction_bytes(0),
+  d_num_mapped_records(0),
+  d_num_mappings(0),
+  d_stop_compaction(false)
+{
+}
+
+MTreeSegmentStore::~MTreeSegmentStore()
+{
+   stopCompaction();
+
+   const int num_segments = d_segments.size();
+   for (int segment = 0; segment < num_segments; ++segment) {
+      if ( d_segments[segment].d_file_descriptor >= 0 ) {
+         deleteSegment(segment);
+      }
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Write, read and remove records.                                       *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeSegmentStore::writeRecord(int object_id,
+                                    const vector<char>& record)
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   return( appendRecord(object_id,
+                        record.empty() ? (const char*)NULL : &record[0],
+                        record.size()) );
+}
+
+bool MTreeSegmentStore::readRecord(int object_id,
+                                   vector<char>& record)
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   const int num_locations = d_locations.size();
+   if ( (object_id < 0) ||
+        (object_id >= num_locations) ||
+        (d_locations[object_id].d_segment < 0) ) {
+      return(false);
+   }
+
+   const RecordLocation& location = d_locations[object_id];
+   const Segment& segment = d_segments[location.d_segment];
+
+   RecordHeader header;
+   record.resize(location.d_size - sizeof(RecordHeader));
+
+   struct iovec buffers[2];
+   buffers[0].iov_base = &header;
+   buffers[0].iov_len  = sizeof(RecordHeader);
+   buffers[1].iov_base = record.empty() ? NULL : &record[0];
+   buffers[1].iov_len  = record.size();
+
+   const ssize_t num_read = preadv(segment.d_file_descriptor, 
+                                   buffers, 
+                                   2,
+                                   location.d_offset);
+
+   bool read_successful = 
+      (num_read == static_cast<ssize_t>(location.d_size)) &&
+      (header.d_object_id == object_id) &&
+      (header.d_size == static_cast<int>(record.size()));
+
+   if ( !read_successful ) {
+      TBOX_WARNING("MTreeSegmentStore::readRecord() warning"
+                   << "\nCannot read record of object " << object_id
+                   << " from segment file " << segment.d_file_name
+                   << endl);
+   }
+
+   return(read_successful);
+}
+
+bool MTreeSegmentStore::mapRecord(int object_id,
+                                  RecordView& view)
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   view.release();
+
+   const int num_locations = d_locations.size();
+   if ( (object_id < 0) ||
+        (object_id >= num_locations) ||
+        (d_locations[object_id].d_segment < 0) ) {
+      return(false);
+   }
+
+   const RecordLocation& location = d_locations[object_id];
+
+   if ( !mapSegment(location.d_segment, 
+                    location.d_offset + location.d_size) ) {
+      return(false);
+   }
+
+   const Segment& segment = d_segments[location.d_segment];
+   const char* record_start = segment.d_mapping.get() + location.d_offset;
+
+   RecordHeader header;
+   memcpy(&header, record_start, sizeof(RecordHeader));
+
+   if ( (header.d_object_id != object_id) ||
+        (sizeof(RecordHeader) + header.d_size != location.d_size) ) {
+      TBOX_WARNING("MTreeSegmentStore::mapRecord() warning"
+                   << "\nCorrupt record of object " << object_id
+                   << " in segment file " << segment.d_file_name
+                   << endl);
+      return(false);
+   }
+
+   view.d_mapping = segment.d_mapping;
+   view.d_data = record_start + sizeof(RecordHeader);
+   view.d_size = header.d_size;
+
+   ++d_num_mapped_records;
+
+   return(true);
+}
+
+void MTreeSegmentStore::removeRecord(int object_id)
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   killRecord(object_id);
+}
+
+bool MTreeSegmentStore::hasRecord(int object_id) const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   const int num_locations = d_locations.size();
+   return( (object_id >= 0) &&
+           (object_id < num_locations) &&
+           (d_locations[object_id].d_segment >= 0) );
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Compaction.                                                           *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeSegmentStore::setCompactionThreshold(double dead_fraction)
+{
+   if ( (dead_fraction > 0.0) && (dead_fraction <= 1.0) ) {
+      std::lock_guard<std::mutex> lock(d_mutex);
+      d_compaction_threshold = dead_fraction;
+      d_compaction_condition.notify_one();
+   }
+}
+
+void MTreeSegmentStore::compact()
+{
+   bool compaction_successful = true;
+
+   while (compaction_successful) {
+
+      int segment;
+      {
+         std::lock_guard<std::mutex> lock(d_mutex);
+         segment = findCompactionSegment();
+      }
+
+      if (segment < 0) {
+         break;
+      }
+
+      compaction_successful = compactSegment(segment);
+
+   }
+}
+
+void MTreeSegmentStore::startCompaction()
+{
+   if ( !d_compaction_thread.joinable() ) {
+      d_stop_compaction = false;
+      d_compaction_thread = 
+         std::thread(&MTreeSegmentStore::runCompaction, this);
+   }
+}
+
+void MTreeSegmentStore::stopCompaction()
+{
+   if ( d_compaction_thread.joinable() ) {
+      {
+         std::lock_guard<std::mutex> lock(d_mutex);
+         d_stop_compaction = true;
+      }
+      d_compaction_condition.notify_one();
+      d_compaction_thread.join();
+      d_stop_compaction = false;
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Background compaction thread; sleeps until some sealed segment        *
+* exceeds the compaction threshold.  An I/O error ends the thread.      *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeSegmentStore::runCompaction()
+{
+   std::unique_lock<std::mutex> lock(d_mutex);
+
+   while ( !d_stop_compaction ) {
+
+      const int segment = findCompactionSegment();
+
+      if (segment < 0) {
+         d_compaction_condition.wait(lock);
+      } else {
+         lock.unlock();
+         const bool compaction_successful = compactSegment(segment);
+         lock.lock();
+         if ( !compaction_successful ) {
+            break;
+         }
+      }
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Compact segment: scan its records in order and append those still     *
+* referenced by the index to the active segment.  The lock is taken     *
+* per record so that readers and writers are not held up for the       *
+* whole segment.  Moving the last live record deletes the segment.      *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeSegmentStore::compactSegment(int segment)
+{
+   bool compaction_successful = true;
+
+   {
+      std::lock_guard<std::mutex> lock(d_mutex);
+      ++d_num_compactions;
+   }
+
+   vector<char> record;
+   off_t offset = 0;
+
+   while (compaction_successful) {
+
+      std::lock_guard<std::mutex> lock(d_mutex);
+
+      const int file_descriptor = d_segments[segment].d_file_descriptor;
+      const off_t segment_size = d_segments[segment].d_size;
+
+      if ( (file_descriptor < 0) || (offset >= segment_size) ) {
+         break;
+      }
+
+      RecordHeader header;
+      compaction_successful =
+         ( pread(file_descriptor, &header, sizeof(RecordHeader), offset) ==
+           static_cast<ssize_t>(sizeof(RecordHeader)) ) &&
+         (header.d_size >= 0);
+
+      if ( !compaction_successful ) {
+         break;
+      }
+
+      const int object_id = header.d_object_id;
+      const size_t record_size = sizeof(RecordHeader) + header.d_size;
+      const int num_locations = d_locations.size();
+
+      if ( (object_id >= 0) &&
+           (object_id < num_locations) &&
+           (d_locations[object_id].d_segment == segment) &&
+           (d_locations[object_id].d_offset == offset) ) {
+
+         record.resize(header.d_size);
+         compaction_successful =
+            ( pread(file_descriptor, 
+                    record.empty() ? NULL : &record[0], 
+                    record.size(), 
+                    offset + sizeof(RecordHeader)) ==
+              static_cast<ssize_t>(record.size()) ) &&
+            appendRecord(object_id, 
+                         record.empty() ? (const char*)NULL : &record[0], 
+                         record.size());
+
+         if (compaction_successful) {
+            d_compaction_bytes += record_size;
+         }
+
+      }
+
+      offset += record_size;
+
+   }
+
+   if ( !compaction_successful ) {
+      TBOX_WARNING("MTreeSegmentStore::compactSegment() warning"
+                   << "\nCannot compact segment file "
+                   << d_segments[segment].d_file_name << endl);
+   }
+
+   return(compaction_successful);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private methods called with lock held: append record to active        *
+* segment, mark record dead, delete segment, and select segment to      *
+* compact.                                                              *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeSegmentStore::appendRecord(int object_id,
+                                     const char* data,
+                                     size_t size)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(object_id >= 0);
+#endif
+
+   const size_t record_size = sizeof(RecordHeader) + size;
+
+   //
+   // seal full active segment and start new one
+   //
+
+   if ( (d_active_segment < 0) ||
+        ( (d_segments[d_active_segment].d_size > 0) &&
+          (d_segments[d_active_segment].d_size + record_size > 
+           d_segment_capacity) ) ) {
+
+      Segment new_segment;
+      new_segment.d_file_name = getSegmentFileName(d_segments.size());
+      new_segment.d_file_descriptor = 
+         open(new_segment.d_file_name.c_str(), 
+              O_RDWR | O_CREAT | O_TRUNC,
+              S_IRUSR | S_IWUSR);
+      new_segment.d_size = 0;
+      new_segment.d_live_bytes = 0;
+      new_segment.d_mapped_size = 0;
+
+      if ( new_segment.d_file_descriptor < 0 ) {
+         TBOX_WARNING("MTreeSegmentStore::appendRecord() warning"
+                      << "\nCannot create segment file " 
+                      << new_segment.d_file_name << endl);
+         return(false);
+      }
+
+      const int sealed_segment = d_active_segment;
+
+      d_segments.push_back(new_segment);
+      d_active_segment = d_segments.size() - 1;
+      ++d_num_segments_on_disk;
+
+      if ( sealed_segment >= 0 ) {
+         if ( d_segments[sealed_segment].d_live_bytes == 0 ) {
+            deleteSegment(sealed_segment);
+         } else if ( needsCompaction(sealed_segment) ) {
+            d_compaction_condition.notify_one();
+         }
+      }
+
+   }
+
+   //
+   // append header and record with a single write
+   //
+
+   Segment& active_segment = d_segments[d_active_segment];
+
+   RecordHeader header;
+   header.d_object_id = object_id;
+   header.d_size = size;
+
+   struct iovec buffers[2];
+   buffers[0].iov_base = &header;
+   buffers[0].iov_len  = sizeof(RecordHeader);
+   buffers[1].iov_base = const_cast<char*>(data);
+   buffers[1].iov_len  = size;
+
+   const ssize_t num_written = pwritev(active_segment.d_file_descriptor,
+                                       buffers,
+                                       2,
+                                       active_segment.d_size);
+
+   if ( num_written != static_cast<ssize_t>(record_size) ) {
+      TBOX_WARNING("MTreeSegmentStore::appendRecord() warning"
+                   << "\nCannot write record of object " << object_id
+                   << " to segment file " << active_segment.d_file_name
+                   << endl);
+      return(false);
+   }
+
+   //
+   // supersede previous record and index new one
+   //
+
+   killRecord(object_id);
+
+   if ( object_id >= static_cast<int>(d_locations.size()) ) {
+      RecordLocation no_location;
+      no_location.d_segment = -1;
+      no_location.d_offset = 0;
+      no_location.d_size = 0;
+      d_locations.resize(object_id + 1, no_location);
+   }
+
+   RecordLocation& location = d_locations[object_id];
+   location.d_segment = d_active_segment;
+   location.d_offset = active_segment.d_size;
+   location.d_size = record_size;
+
+   active_segment.d_size += record_size;
+   active_segment.d_live_bytes += record_size;
+   d_live_bytes += record_size;
+   ++d_num_records;
+
+   return(true);
+}
+
+void MTreeSegmentStore::killRecord(int object_id)
+{
+   const int num_locations = d_locations.size();
+   if ( (object_id < 0) ||
+        (object_id >= num_locations) ||
+        (d_locations[object_id].d_segment < 0) ) {
+      return;
+   }
+
+   RecordLocation& location = d_locations[object_id];
+   const int segment = location.d_segment;
+
+   d_segments[segment].d_live_bytes -= location.d_size;
+   d_live_bytes -= location.d_size;
+   d_dead_bytes += location.d_size;
+   --d_num_records;
+
+   location.d_segment = -1;
+
+   if ( segment != d_active_segment ) {
+      if ( d_segments[segment].d_live_bytes == 0 ) {
+         deleteSegment(segment);
+      } else if ( needsCompaction(segment) ) {
+         d_compaction_condition.notify_one();
+      }
+   }
+}
+
+void MTreeSegmentStore::deleteSegment(int segment)
+{
+   Segment& doomed_segment = d_segments[segment];
+
+   close(doomed_segment.d_file_descriptor);
+   unlink(doomed_segment.d_file_name.c_str());
+
+   d_dead_bytes -= doomed_segment.d_size - doomed_segment.d_live_bytes;
+   d_live_bytes -= doomed_segment.d_live_bytes;
+
+   doomed_segment.d_file_descriptor = -1;
+   doomed_segment.d_size = 0;
+   doomed_segment.d_live_bytes = 0;
+   doomed_segment.d_mapping.reset();
+   doomed_segment.d_mapped_size = 0;
+
+   --d_num_segments_on_disk;
+}
+
+bool MTreeSegmentStore::needsCompaction(int segment) const
+{
+   const Segment& candidate = d_segments[segment];
+
+   return( (segment != d_active_segment) &&
+           (candidate.d_file_descriptor >= 0) &&
+           (candidate.d_size - candidate.d_live_bytes > 
+            d_compaction_threshold * candidate.d_size) );
+}
+
+int MTreeSegmentStore::findCompactionSegment() const
+{
+   const int num_segments = d_segments.size();
+   for (int segment = 0; segment < num_segments; ++segment) {
+      if ( needsCompaction(segment) ) {
+         return(segment);
+      }
+   }
+   return(-1);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private method called with lock held to map segment file.  The        *
+* active segment is mapped to its full capacity so that records         *
+* appended later are covered by the same mapping; pages past the end    *
+* of the file become accessible as the file grows and are never         *
+* touched before.  Older mappings stay alive as long as record views    *
+* hold them.                                                            *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MTreeSegmentStore::mapSegment(int segment,
+                                   size_t size)
+{
+   Segment& mapped_segment = d_segments[segment];
+
+   if ( mapped_segment.d_mapping && (mapped_segment.d_mapped_size >= size) ) {
+      return(true);
+   }
+
+   size_t length = std::max(size, mapped_segment.d_size);
+   if ( segment == d_active_segment ) {
+      length = std::max(length, d_segment_capacity);
+   }
+
+   void* address = mmap(NULL, 
+                        length, 
+                        PROT_READ, 
+                        MAP_SHARED, 
+                        mapped_segment.d_file_descriptor, 
+                        0);
+
+   if ( address == MAP_FAILED ) {
+      TBOX_WARNING("MTreeSegmentStore::mapSegment() warning"
+                   << "\nCannot map segment file " 
+                   << mapped_segment.d_file_name << endl);
+      return(false);
+   }
+
+   mapped_segment.d_mapping.reset(static_cast<const char*>(address), 
+                                  MappingDeleter(length));
+   mapped_segment.d_mapped_size = length;
+
+   ++d_num_mappings;
+
+   return(true);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private method to generate segment file name.                         *
+*                                                                       *
+*************************************************************************
+*/
+
+string MTreeSegmentStore::getSegmentFileName(int segment) const
+{
+   return( d_file_prefix + "__data_segment." +
+           toolbox::Utilities::intToString(segment, 8) );
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Statistics.                                                           *
+*                                                                       *
+*************************************************************************
+*/
+
+int MTreeSegmentStore::getNumberRecords() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_records);
+}
+
+int MTreeSegmentStore::getNumberSegments() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_segments_on_disk);
+}
+
+size_t MTreeSegmentStore::getLiveBytes() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_live_bytes);
+}
+
+size_t MTreeSegmentStore::getDeadBytes() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_dead_bytes);
+}
+
+int MTreeSegmentStore::getTotalCompactionCount() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_compactions);
+}
+
+size_t MTreeSegmentStore::getTotalCompactionBytes() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_compaction_bytes);
+}
+
+int MTreeSegmentStore::getTotalMappedRecordCount() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_mapped_records);
+}
+
+int MTreeSegmentStore::getTotalMappingCount() const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+   return(d_num_mappings);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Write store configuration and statistics to given output stream.      *
+*                                                                       *
+*************************************************************************
+*/
+
+void MTreeSegmentStore::printClassData(ostream& stream) const
+{
+   std::lock_guard<std::mutex> lock(d_mutex);
+
+   stream << "MTreeSegmentStore::printClassData()\n";
+   stream << "--------------------------------------\n";
+   stream << "d_file_prefix = " << d_file_prefix << endl;
+   stream << "d_segment_capacity = " << d_segment_capacity << endl;
+   stream << "d_compaction_threshold = " << d_compaction_threshold << endl;
+   stream << "d_active_segment = " << d_active_segment << endl;
+   stream << "d_num_records = " << d_num_records << endl;
+   stream << "d_num_segments_on_disk = " << d_num_segments_on_disk << endl;
+   stream << "d_live_bytes = " << d_live_bytes << endl;
+   stream << "d_dead_bytes = " << d_dead_bytes << endl;
+   stream << "d_num_compactions = " << d_num_compactions << endl;
+   stream << "d_compaction_bytes = " << d_compaction_bytes << endl;
+   stream << "d_num_mapped_records = " << d_num_mapped_records << endl;
+   stream << "d_num_mappings = " << d_num_mappings << endl;
+}
+
+}
+}
+#endif
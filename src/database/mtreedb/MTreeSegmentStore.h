@@ -0,0 +1,383 @@
+//
+// File:        MTreeSegmentStore.h
+// Package:     MPTCOUPLER MTree database
+//
+//
+//
+// Description: Log-structured file store for serialized data objects.
+//
+
+#ifndef included_mtreedb_MTreeSegmentStore
+#define included_mtreedb_MTreeSegmentStore
+
+#ifndef included_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_iostream
+#define included_iostream
+#include <iostream>
+using namespace std;
+#endif
+#ifndef included_String
+#include <string>
+using namespace std;
+#define included_String
+#endif
+#ifndef included_vector
+#define included_vector
+#include <vector>
+using namespace std;
+#endif
+#ifndef included_mutex
+#define included_mutex
+#include <mutex>
+#endif
+#ifndef included_memory
+#define included_memory
+#include <memory>
+#endif
+
+#include <condition_variable>
+#include <thread>
+
+#include <sys/types.h>
+
+namespace MPTCOUPLER {
+    namespace mtreedb {
+
+/*!
+ * @brief MTreeSegmentStore holds serialized data objects (records) in a
+ *        small number of large, append-only segment files.  It is used
+ *        by MTreeDataStore as the backing store of data objects that are
+ *        paged out of memory.
+ *
+ * Each record is identified by the integer identifier of its data object.
+ * Writing a record appends it to the active segment file; when the
+ * active segment reaches its capacity it is sealed and a new segment
+ * file is started.  An in-memory index maps each object identifier to
+ * the segment, offset and size of its current record, so reading a
+ * record is a single positioned read from an open file.  Rewriting or
+ * removing a record leaves the old copy in its segment as dead space.
+ *
+ * Records may also be accessed in place with mapRecord(), which maps 
+ * the segment file read-only into memory and returns a view of the 
+ * record in the mapping.  The record is then read from the page cache 
+ * without a system call or copy; a segment is mapped once and remapped
+ * only if it outgrows its mapping.  A view keeps the mapping alive, so
+ * it stays valid even if the record is removed or moved, or its segment
+ * is compacted or deleted, while the view is held.
+ *
+ * Dead space is reclaimed by compaction: the live records of a sealed
+ * segment whose fraction of dead bytes exceeds a threshold are appended
+ * to the active segment and the old segment file is deleted.  Segments
+ * whose records are all dead are deleted immediately.  Compaction may
+ * be run by the caller (compact()) or by a background thread
+ * (startCompaction()); the thread moves one record at a time while
+ * holding the store lock, so reads and writes are delayed by at most
+ * the copy of a single record.  All public methods are thread-safe.
+ *
+ * The segment files are scratch space: they are deleted when the store
+ * is destroyed and cannot be reopened.
+ *
+ * @see mtreedb::MTreeDataStore
+ */
+
+class MTreeSegmentStore
+{
+public:
+   /*!
+    * @brief RecordView is a read-only view of a record in a memory-mapped
+    *        segment file, filled by MTreeSegmentStore::mapRecord().  The
+    *        mapping is released when the last view of it is destroyed
+    *        or released and its segment is deleted.
+    */
+   class RecordView
+   {
+   public:
+      /*!
+       * Ctor for empty RecordView object.
+       */
+      RecordView();
+
+      /*!
+       * Return const pointer to first byte of record; null if the view
+       * is empty.
+       */
+      const char* getData() const;
+
+      /*!
+       * Return number of bytes in record.
+       */
+      size_t getSize() const;
+
+      /*!
+       * Release mapping and make view empty.
+       */
+      void release();
+
+   private:
+      friend class MTreeSegmentStore;
+
+      std::shared_ptr<const char> d_mapping;
+      const char*                 d_data;
+      size_t                      d_size;
+   };
+
+   /*!
+    * Ctor for MTreeSegmentStore object.  No file is created until the
+    * first record is written.
+    *
+    * @param file_prefix Const reference to string with full path prefix
+    *                    of segment file names.
+    * @param segment_capacity Size in bytes beyond which the active
+    *                    segment is sealed.  A single record larger than
+    *                    the capacity gets a segment of its own.
+    */
+   MTreeSegmentStore(const string& file_prefix,
+                     size_t segment_capacity = DEFAULT_SEGMENT_CAPACITY);
+
+   /*!
+    * Dtor for MTreeSegmentStore objects stops background compaction and
+    * deletes all segment files.
+    */
+   ~MTreeSegmentStore();
+
+   /*!
+    * Append record for object with given identifier, superseding any
+    * record previously written for the object.
+    *
+    * @return Boolean true if write operation succeeded; otherwise false.
+    *
+    * @param object_id  Non-negative integer identifier of data object.
+    * @param record     Const reference to bytes of record.
+    */
+   bool writeRecord(int object_id,
+                    const vector<char>& record);
+
+   /*!
+    * Read record of object with given identifier.
+    *
+    * @return Boolean true if read operation succeeded; otherwise false
+    *         (e.g., if the store holds no record for the object).
+    *
+    * @param object_id  Integer identifier of data object.
+    * @param record     Reference to vector resized to and filled with
+    *                   the bytes of the record.
+    */
+   bool readRecord(int object_id,
+                   vector<char>& record);
+
+   /*!
+    * Map record of object with given identifier into memory.
+    *
+    * @return Boolean true if map operation succeeded; otherwise false
+    *         (e.g., if the store holds no record for the object), in 
+    *         which case the view is left empty.
+    *
+    * @param object_id  Integer identifier of data object.
+    * @param view       Reference to view set to the record.
+    */
+   bool mapRecord(int object_id,
+                  RecordView& view);
+
+   /*!
+    * Remove record of object with given identifier; its space becomes
+    * dead and is reclaimed by compaction.  If the store holds no record
+    * for the object, the method does nothing.
+    *
+    * @param object_id  Integer identifier of data object.
+    */
+   void removeRecord(int object_id);
+
+   /*!
+    * Return true if the store holds a record for object with given
+    * identifier; otherwise false.
+    */
+   bool hasRecord(int object_id) const;
+
+   /*!
+    * Set fraction of dead bytes in a sealed segment above which the
+    * segment is compacted.  Values outside of (0, 1] are ignored.  The
+    * default is given by DEFAULT_COMPACTION_THRESHOLD_PERCENT.
+    */
+   void setCompactionThreshold(double dead_fraction);
+
+   /*!
+    * Compact all sealed segments whose fraction of dead bytes exceeds
+    * the compaction threshold.
+    */
+   void compact();
+
+   /*!
+    * Start background thread compacting segments as soon as they exceed
+    * the compaction threshold.  Does nothing if the thread is running.
+    */
+   void startCompaction();
+
+   /*!
+    * Stop background compaction thread, waiting for it to finish the
+    * segment it is compacting.  Does nothing if no thread is running.
+    */
+   void stopCompaction();
+
+   //@{
+   //! @name Methods for obtaining store statistics.
+
+   /*!
+    * Get number of records held by the store.
+    */
+   int getNumberRecords() const;
+
+   /*!
+    * Get number of segment files currently on disk.
+    */
+   int getNumberSegments() const;
+
+   /*!
+    * Get number of bytes in segment files held by live and by dead
+    * records, respectively.
+    */
+   size_t getLiveBytes() const;
+   size_t getDeadBytes() const;
+
+   /*!
+    * Get total number of segments compacted and total number of bytes
+    * copied by compaction.
+    */
+   int getTotalCompactionCount() const;
+   size_t getTotalCompactionBytes() const;
+
+   /*!
+    * Get total number of records mapped and total number of segment 
+    * mappings created.
+    */
+   int getTotalMappedRecordCount() const;
+   int getTotalMappingCount() const;
+
+   //@}
+
+   /*!
+    * Print store configuration and statistics to given output stream.
+    */
+   void printClassData(ostream& stream) const;
+
+   /*!
+    * Default capacity of a segment file in bytes and default compaction
+    * threshold in percent of dead bytes.
+    */
+   enum { DEFAULT_SEGMENT_CAPACITY = 64 * 1024 * 1024,
+          DEFAULT_COMPACTION_THRESHOLD_PERCENT = 50 };
+
+private:
+   // The following are not implemented
+   MTreeSegmentStore(const MTreeSegmentStore&);
+   void operator=(const MTreeSegmentStore&);
+
+   /*
+    * Header preceding each record in a segment file.  Compaction scans
+    * segments by header and detects live records through the index.
+    */
+   struct RecordHeader {
+      int d_object_id;
+      int d_size;
+   };
+
+   /*
+    * Location of the current record of an object; d_segment is -1 if
+    * the store holds no record for the object.  The size includes the
+    * record header.
+    */
+   struct RecordLocation {
+      int    d_segment;
+      off_t  d_offset;
+      size_t d_size;
+   };
+
+   /*
+    * Segment file.  d_file_descriptor is -1 once the file is deleted;
+    * d_size is the number of bytes written to it and d_live_bytes the
+    * number of those held by live records.  d_mapping is the read-only
+    * mapping of the first d_mapped_size bytes of the file, or null if
+    * the file has not been mapped.
+    */
+   struct Segment {
+      string d_file_name;
+      int    d_file_descriptor;
+      size_t d_size;
+      size_t d_live_bytes;
+      std::shared_ptr<const char> d_mapping;
+      size_t d_mapped_size;
+   };
+
+   /*
+    * Private methods, called with d_mutex held, to append record to
+    * active segment (starting a new one if needed), to mark record
+    * dead, to delete segment file, to test whether segment should be
+    * compacted and to find such a segment (-1 if there is none).
+    */
+   bool appendRecord(int object_id,
+                     const char* data,
+                     size_t size);
+   void killRecord(int object_id);
+   void deleteSegment(int segment);
+   bool needsCompaction(int segment) const;
+   int findCompactionSegment() const;
+
+   /*
+    * Private method, called with d_mutex held, to map segment file so
+    * that the mapping covers at least given number of bytes.  Return
+    * boolean true if mapping succeeded; otherwise false.
+    */
+   bool mapSegment(int segment,
+                   size_t size);
+
+   /*
+    * Private method to compact given segment, locking d_mutex for each
+    * record moved.  Return boolean true if compaction succeeded;
+    * otherwise (i.e., on an I/O error) false.
+    */
+   bool compactSegment(int segment);
+
+   /*
+    * Private method run by background compaction thread.
+    */
+   void runCompaction();
+
+   /*
+    * Private method to generate file name for given segment.
+    */
+   string getSegmentFileName(int segment) const;
+
+   string d_file_prefix;
+   size_t d_segment_capacity;
+   double d_compaction_threshold;
+
+   vector<Segment>        d_segments;
+   int                    d_active_segment;
+   vector<RecordLocation> d_locations;
+
+   int    d_num_records;
+   int    d_num_segments_on_disk;
+   size_t d_live_bytes;
+   size_t d_dead_bytes;
+   int    d_num_compactions;
+   size_t d_compaction_bytes;
+   int    d_num_mapped_records;
+   int    d_num_mappings;
+
+   /*
+    * Lock protecting all data above, and state of background compaction
+    * thread; d_compaction_condition is signaled when a segment may need
+    * compaction or the thread is to stop.
+    */
+   mutable std::mutex      d_mutex;
+   std::condition_variable d_compaction_condition;
+   std::thread             d_compaction_thread;
+   bool                    d_stop_compaction;
+
+};
+
+}
+}
+#endif
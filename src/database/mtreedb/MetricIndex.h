@@ -0,0 +1,239 @@
+//
+// File:        MetricIndex.h
+// Package:     MPTCOUPLER MTree database
+//
+//
+//
+// Description: Abstract base class for metric space index structures.
+//
+
+#ifndef included_mtreedb_MetricIndex
+#define included_mtreedb_MetricIndex
+
+#ifndef included_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_list
+#define included_list
+#include <list>
+using namespace std;
+#endif
+
+#ifndef included_vector
+#define included_vector
+#include <vector>
+using namespace std;
+#endif
+
+#ifndef included_mtreedb_MTreeObject
+#include <mtreedb/MTreeObject.h>
+#endif
+#ifndef included_mtreedb_MTreePoint
+#include <mtreedb/MTreePoint.h>
+#endif
+
+namespace MPTCOUPLER {
+    namespace mtreedb {
+
+class MTreeSearchResult;
+
+class MetricIndex;
+typedef std::shared_ptr<MetricIndex> MetricIndexPtr;
+
+/*!
+ * @brief MetricIndex is an abstract base class declaring the operations
+ *        common to all index structures of data objects described by
+ *        regions (a center point and a radius) in a metric space.
+ *
+ * The operations are insertion, deletion, relocation and retrieval of
+ * data objects by identifier, "k" nearest neighbor searches and range
+ * searches.  Code using only these operations should access an index
+ * through this interface so that the index structure may be chosen at
+ * run time.  The index structure determines how objects are stored;
+ * e.g., MTree pages objects to and from disk through its data store
+ * while VPTree keeps all objects in memory.  See MTree for a detailed
+ * description of each operation.
+ *
+ * @see mtreedb::MTree
+ * @see mtreedb::VPTree
+ */
+
+class MetricIndex
+{
+public:
+   /*!
+    * Dtor for MetricIndex objects.
+    */
+   virtual ~MetricIndex() {}
+
+   //@{
+   //! @name Methods for inserting, deleting and retrieving objects.
+
+   /*!
+    * Insert deep copy of object with given center point and radius into
+    * index and set the identifier of the object to that of the copy.
+    */
+   virtual void insertObject(MTreeObject& object,
+                             const MTreePoint& point,
+                             double radius) = 0;
+
+   /*!
+    * Insert deep copies of collection of objects with given center
+    * points and radii into index and set the identifiers of the objects.
+    * The vectors must have the same length.
+    */
+   virtual void bulkLoad(const vector<MTreeObjectPtr>& objects,
+                         const vector<MTreePointPtr>& points,
+                         const vector<double>& radii) = 0;
+
+   /*!
+    * Get copy of object with given identifier; return null pointer if
+    * the identifier is not valid.  If make_safe is false, the object 
+    * held by the index is returned instead of a copy; it must not be
+    * modified.
+    */
+   virtual MTreeObjectPtr getObject(int object_id,
+                                    bool make_safe = true) const = 0;
+
+   /*!
+    * Delete object with given identifier; do nothing if the identifier
+    * is not valid.
+    */
+   virtual void deleteObject(int object_id) = 0;
+
+   /*!
+    * Move center point of object with given identifier and reset its
+    * radius; the object keeps its identifier.  Do nothing if the
+    * identifier is not valid.
+    */
+   virtual void updateObjectPoint(int object_id,
+                                  const MTreePoint& point,
+                                  double radius) = 0;
+
+   //@}
+
+   //@{
+   //! @name Methods for searching the index.
+
+   /*!
+    * Return up to "k" objects nearest to query point, sorted by
+    * increasing distance from the query point to their center points.
+    *
+    * Unless make_safe is true, passing share_points true makes the
+    * results refer to the given query point and to the points held by
+    * the index instead of to copies of them, so that the search
+    * allocates no points; the results must then not be used once the
+    * query point has been destroyed.  The same holds for the other
+    * searches.
+    */
+   virtual void searchKNN(vector<MTreeSearchResult>& results,
+                          const MTreePoint& query_point,
+                          int k_neighbors,
+                          bool make_safe = false,
+                          bool share_points = false) = 0;
+
+   /*!
+    * Return up to "k" objects whose regions are nearest to query point,
+    * sorted by increasing support distance; i.e., the distance to the
+    * center point less the object radius, or zero if the query point
+    * lies inside the object region.
+    */
+   virtual void searchKNNSupport(vector<MTreeSearchResult>& results,
+                                 const MTreePoint& query_point,
+                                 int k_neighbors,
+                                 bool make_safe = false,
+                                 bool share_points = false) = 0;
+
+   /*!
+    * Return up to "k" objects near query point, sorted by increasing
+    * distance from the query point to their center points, trading
+    * exactness for fewer distance computations.  Each returned distance
+    * exceeds that of the exact neighbor of the same rank by at most the
+    * given error factor (>= 1; 1 gives the exact search) unless the
+    * search is cut short: if max_distance_comps is positive, the search
+    * stops once it has computed that many distances and returns the
+    * nearest objects found so far.
+    */
+   virtual void searchKNNApproximate(vector<MTreeSearchResult>& results,
+                                     const MTreePoint& query_point,
+                                     int k_neighbors,
+                                     double error_factor,
+                                     int max_distance_comps,
+                                     bool make_safe = false,
+                                     bool share_points = false) = 0;
+
+   /*!
+    * Return all objects whose regions intersect the region given by the
+    * query point and radius, sorted by increasing distance from the
+    * query point to their center points.
+    */
+   virtual void searchRange(list<MTreeSearchResult>& results,
+                            const MTreePoint& query_point,
+                            double radius,
+                            bool make_safe = false,
+                            bool share_points = false) = 0;
+
+   //@}
+
+   //@{
+   //! @name Methods for obtaining operation statistics.
+
+   /*!
+    * Get total number of object insertions.
+    */
+   virtual int getTotalInsertCount() const = 0;
+
+   /*!
+    * Get total number of computations of distance between objects
+    * during all object insertions (including any restructuring of the
+    * index they cause).
+    */
+   virtual int getTotalInsertDistanceCount() const = 0;
+
+   /*!
+    * Get total number of nearest neighbor searches.
+    */
+   virtual int getTotalKNNSearchCount() const = 0;
+
+   /*!
+    * Get total number of computations of distance between objects
+    * during all nearest neighbor searches.
+    */
+   virtual int getTotalKNNSearchDistanceCount() const = 0;
+
+   /*!
+    * Get total number of range searches.
+    */
+   virtual int getTotalRangeSearchCount() const = 0;
+
+   /*!
+    * Get total number of computations of distance between objects
+    * during all range searches.
+    */
+   virtual int getTotalRangeSearchDistanceCount() const = 0;
+
+   //@}
+
+protected:
+   /*
+    * Return pointer to the query point of a search held by the search
+    * results: a copy of the point unless points are shared, and
+    * otherwise a pointer to the point itself that does not own it, so
+    * that no memory is allocated.
+    */
+   static MTreePointPtr getQueryPointPtr(const MTreePoint& query_point,
+                                         bool share_points)
+   {
+      if (!share_points) {
+         return( query_point.makeCopy() );
+      }
+      return( MTreePointPtr( MTreePointPtr(), 
+                             const_cast<MTreePoint*>(&query_point) ) );
+   }
+
+};
+
+}
+}
+#endif
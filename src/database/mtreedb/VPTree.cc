@@ -0,0 +1,936 @@
+// DO-NOT-DELETE revisionify.begin() 
+/*
+Copyright (c) 2007-2008 Lawrence Livermore National Security LLC
+
+This file is part of the mdef package (version 0.1) and is free software: 
+you can redistribute it and/or modify it under the terms of the GNU
+Lesser General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+                              DISCLAIMER
+
+This work was prepared as an account of work sponsored by an agency of
+the United States Government. Neither the United States Government nor
+Lawrence Livermore National Security, LLC nor any of their employees,
+makes any warranty, express or implied, or assumes any liability or
+responsibility for the accuracy, completeness, or usefulness of any
+information, apparatus, product, or process disclosed, or represents
+that its use would not infringe privately-owned rights. Reference
+herein to any specific commercial products, process, or service by
+trade name, trademark, manufacturer or otherwise does not necessarily
+constitute or imply its endorsement, recommendation, or favoring by
+the United States Government or Lawrence Livermore National Security,
+LLC. The views and opinions of authors expressed herein do not
+necessarily state or reflect those of the United States Government or
+Lawrence Livermore National Security, LLC, and shall not be used for
+advertising or product endorsement purposes.
+*/
+// DO-NOT-DELETE revisionify.end() 
+//
+// File:        VPTree.cc
+// Package:     MPTCOUPLER MTree database
+// Description: In-memory vantage-point tree index structure class.
+//
+
+#ifndef included_mtreedb_VPTree_C
+#define included_mtreedb_VPTree_C
+
+#include "VPTree.h"
+
+#ifdef DEBUG_CHECK_ASSERTIONS
+#ifndef included_cassert
+#define included_cassert
+#include <cassert>
+#endif
+#endif
+
+#ifndef included_algorithm
+#define included_algorithm
+#include <algorithm>
+#endif
+
+#include "toolbox/base/MathUtilities.h"
+
+namespace MPTCOUPLER {
+    namespace mtreedb {
+
+/*
+*************************************************************************
+*                                                                       *
+* VPTree ctor and dtor.                                                 *
+*                                                                       *
+*************************************************************************
+*/
+
+VPTree::VPTree(const string& tree_name)
+: d_tree_name(tree_name),
+  d_max_leaf_entries(DEFAULT_MAX_LEAF_ENTRIES),
+  d_num_objects(0),
+  d_num_stale_objects(0),
+  d_num_tree_objects(0),
+  d_root_node(-1),
+  d_num_inserts(0),
+  d_num_rebuilds(0),
+  d_total_distance_comps_in_inserts(0),
+  d_num_knn_queries(0),
+  d_total_distance_comps_in_knn_queries(0),
+  d_num_range_queries(0),
+  d_total_distance_comps_in_range_queries(0)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(!tree_name.empty());
+#endif
+}
+
+VPTree::~VPTree()
+{
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Accessory functions for tree name and parameters.                     *
+*                                                                       *
+*************************************************************************
+*/
+
+string VPTree::getName() const
+{
+   return(d_tree_name);
+}
+
+void VPTree::setMaxLeafEntries(int max_entries)
+{
+   if (max_entries >= 1) {
+      d_max_leaf_entries = max_entries;
+   }
+}
+
+int VPTree::getNumberObjects() const
+{
+   return(d_num_objects);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Insert object into index; the object waits in the pending list until  *
+* the next rebuild of the tree.                                         *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::insertObject(MTreeObject& object,
+                          const MTreePoint& point,
+                          double radius)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(radius >= 0.0);
+#endif
+
+   addObject(object, point, radius);
+
+   checkRebuild();
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Insert collection of objects and rebuild the tree over all objects.   *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::bulkLoad(const vector<MTreeObjectPtr>& objects,
+                      const vector<MTreePointPtr>& points,
+                      const vector<double>& radii)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(objects.size() == points.size());
+   assert(objects.size() == radii.size());
+#endif
+
+   const int num_objects = objects.size();
+
+   if (num_objects > 0) {
+
+      for (int io = 0; io < num_objects; ++io) {
+#ifdef DEBUG_CHECK_ASSERTIONS
+         assert(radii[io] >= 0.0);
+#endif
+         addObject(*objects[io], *points[io], radii[io]);
+      }
+
+      rebuild();
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Return copy of object with given identifier, or the object itself.    *
+*                                                                       *
+*************************************************************************
+*/
+
+MTreeObjectPtr VPTree::getObject(int object_id,
+                                 bool make_safe) const
+{
+   MTreeObjectPtr ret_object;
+
+   const int num_ids = d_objects.size();
+   if ( (object_id >= 0) &&
+        (object_id < num_ids) &&
+        d_objects[object_id].d_object ) {
+      if (make_safe) {
+         ret_object = d_objects[object_id].d_object->makeCopy();
+         ret_object->setObjectId(object_id);
+      } else {
+         ret_object = d_objects[object_id].d_object;
+      }
+   }
+
+   return(ret_object);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Delete object from index.  An object in the tree is only marked stale *
+* since the bounds stored in the tree remain valid for the rest.        *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::deleteObject(int object_id)
+{
+   const int num_ids = d_objects.size();
+   if ( (object_id >= 0) &&
+        (object_id < num_ids) &&
+        d_objects[object_id].d_object ) {
+
+      ObjectRecord& record = d_objects[object_id];
+
+      if (record.d_in_tree) {
+         d_num_stale_objects++;
+      } else {
+         removePendingObject(object_id);
+      }
+
+      record.d_object.reset();
+      record.d_point.reset();
+      record.d_in_tree = false;
+
+      d_free_object_ids.push_back(object_id);
+      d_num_objects--;
+
+      checkRebuild();
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Move object to new point.  The old point of an object in the tree is  *
+* still referenced by the node if the object is a vantage object, so a  *
+* new point is allocated rather than changing the old one.              *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::updateObjectPoint(int object_id,
+                               const MTreePoint& point,
+                               double radius)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(radius >= 0.0);
+#endif
+
+   const int num_ids = d_objects.size();
+   if ( (object_id >= 0) &&
+        (object_id < num_ids) &&
+        d_objects[object_id].d_object ) {
+
+      ObjectRecord& record = d_objects[object_id];
+
+      record.d_point  = point.makeCopy();
+      record.d_radius = radius;
+
+      if (record.d_in_tree) {
+         record.d_in_tree = false;
+         d_num_stale_objects++;
+         d_pending_object_ids.push_back(object_id);
+      }
+
+      checkRebuild();
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Search for "K" nearest neighbors by point or by support distance.     *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::searchKNN(vector<MTreeSearchResult>& results,
+                       const MTreePoint& query_point,
+                       int k_neighbors,
+                       bool make_safe,
+                       bool share_points)
+{
+   searchNearest(results, query_point, k_neighbors, make_safe, 
+                 share_points, false, 1.0, 0);
+}
+
+void VPTree::searchKNNSupport(vector<MTreeSearchResult>& results,
+                              const MTreePoint& query_point,
+                              int k_neighbors,
+                              bool make_safe,
+                              bool share_points)
+{
+   searchNearest(results, query_point, k_neighbors, make_safe, 
+                 share_points, true, 1.0, 0);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Search for "K" near neighbors with bounded error factor and number    *
+* of distance computations.                                             *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::searchKNNApproximate(vector<MTreeSearchResult>& results,
+                                  const MTreePoint& query_point,
+                                  int k_neighbors,
+                                  double error_factor,
+                                  int max_distance_comps,
+                                  bool make_safe,
+                                  bool share_points)
+{
+   searchNearest(results, query_point, k_neighbors, make_safe, 
+                 share_points, false,
+                 toolbox::MathUtilities<double>::Max( 1.0, error_factor ),
+                 max_distance_comps);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine implementing "K" nearest neighbor searches.  The      *
+* pending objects are scanned and the tree is searched depth-first,     *
+* visiting the child with the smaller distance bound first and pruning  *
+* children whose bound, times the error factor, is not below the        *
+* current K-th distance.                                                *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::searchNearest(vector<MTreeSearchResult>& results,
+                           const MTreePoint& query_point,
+                           int k_neighbors,
+                           bool make_safe,
+                           bool share_points,
+                           bool rank_by_support,
+                           double error_factor,
+                           int max_distance_comps)
+{
+   results.clear();
+
+   if (k_neighbors > 0) {
+
+      int num_distance_comps = 0;
+      d_num_knn_queries.fetch_add(1, std::memory_order_relaxed);
+
+      toolbox::ScratchArena::Scope 
+         scratch_scope( toolbox::ScratchArena::getThreadArena() );
+
+      CandidateVector candidates(k_neighbors, 
+                                 Candidate(MTreePoint::getMaxDistance(),
+                                           MTreeObject::getUndefinedId()));
+
+      const int num_pending = d_pending_object_ids.size();
+      for (int ip = 0; ip < num_pending; ++ip) {
+         const int id = d_pending_object_ids[ip];
+         const ObjectRecord& record = d_objects[id];
+         double distance = query_point.computeDistanceTo(*record.d_point);
+         num_distance_comps++;
+         if (rank_by_support) {
+            distance = toolbox::MathUtilities<double>::Max( 0.0,
+                          distance - record.d_radius );
+         }
+         offerCandidate(candidates, distance, id);
+      }
+
+      if (d_root_node >= 0) {
+         searchNearestRecursive(candidates, query_point, d_root_node,
+                                rank_by_support, error_factor,
+                                max_distance_comps, num_distance_comps);
+      }
+
+      /*
+       * Search complete, turn candidates into results.
+       */
+      MTreePointPtr query( getQueryPointPtr(query_point, 
+                                            share_points && !make_safe) );
+      for (int ic = 0; ic < k_neighbors; ++ic) {
+         if (candidates[ic].second != MTreeObject::getUndefinedId()) {
+            results.push_back( makeSearchResult(query, candidates[ic],
+                                                make_safe, 
+                                                share_points) );
+         }
+      }
+
+      d_total_distance_comps_in_knn_queries.fetch_add(
+         num_distance_comps, std::memory_order_relaxed);
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private recursive routine used in nearest neighbor search.  The       *
+* distance from the query point to any object in a child is at least    *
+* the distance of the query point from the shell of distances about the *
+* vantage point recorded for the child; for support distances the       *
+* largest object radius in the child is subtracted as well.  Children   *
+* are not entered once the maximum number of distance computations, if  *
+* positive, has been reached.                                           *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::searchNearestRecursive(CandidateVector& candidates,
+                                    const MTreePoint& query_point,
+                                    int node_index,
+                                    bool rank_by_support,
+                                    double error_factor,
+                                    int max_distance_comps,
+                                    int& num_distance_comps) const
+{
+   const TreeNode& node = d_nodes[node_index];
+
+   if (node.d_vantage_id < 0) {
+
+      for (int i = node.d_begin; i < node.d_end; ++i) {
+         const int id = d_object_ids[i];
+         const ObjectRecord& record = d_objects[id];
+         if (record.d_in_tree) {
+            double distance = query_point.computeDistanceTo(*record.d_point);
+            num_distance_comps++;
+            if (rank_by_support) {
+               distance = toolbox::MathUtilities<double>::Max( 0.0,
+                             distance - record.d_radius );
+            }
+            offerCandidate(candidates, distance, id);
+         }
+      }
+
+   } else {
+
+      const double dist_vantage = 
+         query_point.computeDistanceTo(*node.d_vantage_point);
+      num_distance_comps++;
+
+      if (d_objects[node.d_vantage_id].d_in_tree) {
+         const double distance = rank_by_support ?
+            toolbox::MathUtilities<double>::Max( 0.0,
+               dist_vantage - node.d_vantage_radius ) :
+            dist_vantage;
+         offerCandidate(candidates, distance, node.d_vantage_id);
+      }
+
+      double bound[2];
+      for (int ic = 0; ic < 2; ++ic) {
+         double lower_bound = 
+            toolbox::MathUtilities<double>::Max( node.d_lower[ic] - dist_vantage,
+                                                 dist_vantage - node.d_upper[ic] );
+         if (rank_by_support) {
+            lower_bound -= node.d_max_radius[ic];
+         }
+         bound[ic] = toolbox::MathUtilities<double>::Max( 0.0, lower_bound );
+      }
+
+      const int first = (bound[1] < bound[0]) ? 1 : 0;
+      for (int ic = 0; ic < 2; ++ic) {
+         const int child = (ic == 0) ? first : 1 - first;
+         if ( (max_distance_comps > 0) &&
+              (num_distance_comps >= max_distance_comps) ) {
+            break;
+         }
+         if ( (node.d_child[child] >= 0) &&
+              (bound[child]*error_factor < candidates.back().first) ) {
+            searchNearestRecursive(candidates, query_point, 
+                                   node.d_child[child],
+                                   rank_by_support, error_factor,
+                                   max_distance_comps, num_distance_comps);
+         }
+      }
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Search for all objects whose regions intersect the query region.      *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::searchRange(list<MTreeSearchResult>& results,
+                         const MTreePoint& query_point,
+                         double radius,
+                         bool make_safe,
+                         bool share_points)
+{
+   results.clear();
+
+   if (radius >= 0.0) {
+
+      int num_distance_comps = 0;
+      d_num_range_queries.fetch_add(1, std::memory_order_relaxed);
+
+      toolbox::ScratchArena::Scope 
+         scratch_scope( toolbox::ScratchArena::getThreadArena() );
+
+      CandidateVector candidates;
+
+      const int num_pending = d_pending_object_ids.size();
+      for (int ip = 0; ip < num_pending; ++ip) {
+         const int id = d_pending_object_ids[ip];
+         const ObjectRecord& record = d_objects[id];
+         const double distance = 
+            query_point.computeDistanceTo(*record.d_point);
+         num_distance_comps++;
+         if (distance <= radius + record.d_radius) {
+            candidates.push_back( Candidate(distance, id) );
+         }
+      }
+
+      if (d_root_node >= 0) {
+         searchRangeRecursive(candidates, query_point, radius, 
+                              d_root_node, num_distance_comps);
+      }
+
+      std::sort(candidates.begin(), candidates.end());
+
+      MTreePointPtr query( getQueryPointPtr(query_point, 
+                                            share_points && !make_safe) );
+      const int num_candidates = candidates.size();
+      for (int ic = 0; ic < num_candidates; ++ic) {
+         results.push_back( makeSearchResult(query, candidates[ic], 
+                                             make_safe, share_points) );
+      }
+
+      d_total_distance_comps_in_range_queries.fetch_add(
+         num_distance_comps, std::memory_order_relaxed);
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private recursive routine used in range search.                       *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::searchRangeRecursive(CandidateVector& candidates,
+                                  const MTreePoint& query_point,
+                                  double radius,
+                                  int node_index,
+                                  int& num_distance_comps) const
+{
+   const TreeNode& node = d_nodes[node_index];
+
+   if (node.d_vantage_id < 0) {
+
+      for (int i = node.d_begin; i < node.d_end; ++i) {
+         const int id = d_object_ids[i];
+         const ObjectRecord& record = d_objects[id];
+         if (record.d_in_tree) {
+            const double distance = 
+               query_point.computeDistanceTo(*record.d_point);
+            num_distance_comps++;
+            if (distance <= radius + record.d_radius) {
+               candidates.push_back( Candidate(distance, id) );
+            }
+         }
+      }
+
+   } else {
+
+      const double dist_vantage = 
+         query_point.computeDistanceTo(*node.d_vantage_point);
+      num_distance_comps++;
+
+      if ( d_objects[node.d_vantage_id].d_in_tree &&
+           (dist_vantage <= radius + node.d_vantage_radius) ) {
+         candidates.push_back( Candidate(dist_vantage, node.d_vantage_id) );
+      }
+
+      for (int ic = 0; ic < 2; ++ic) {
+         const double lower_bound = 
+            toolbox::MathUtilities<double>::Max( node.d_lower[ic] - dist_vantage,
+                                                 dist_vantage - node.d_upper[ic] );
+         if ( (node.d_child[ic] >= 0) &&
+              (lower_bound <= radius + node.d_max_radius[ic]) ) {
+            searchRangeRecursive(candidates, query_point, radius,
+                                 node.d_child[ic], num_distance_comps);
+         }
+      }
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to insert candidate into sorted vector of "K" nearest *
+* candidates if it is nearer than the last one.                         *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::offerCandidate(CandidateVector& candidates,
+                            double distance,
+                            int object_id)
+{
+   const int klast = candidates.size() - 1;
+
+   if ( distance < candidates[klast].first ) {
+
+      int id = 0;
+      while ( distance > candidates[id].first ) {
+         id++;
+      }
+
+      for (int ic = klast; ic > id; ic--) {
+         candidates[ic] = candidates[ic-1];
+      }
+
+      candidates[id] = Candidate(distance, object_id);
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to create search result for candidate; as in MTree,   *
+* the object of the result is a copy if it is made safe, and its point  *
+* is a copy unless points are shared.                                   *
+*                                                                       *
+*************************************************************************
+*/
+
+MTreeSearchResult VPTree::makeSearchResult(MTreePointPtr query_point,
+                                           const Candidate& candidate,
+                                           bool make_safe,
+                                           bool share_points) const
+{
+   const ObjectRecord& record = d_objects[candidate.second];
+
+   MTreeObjectPtr object( record.d_object );
+   if (make_safe) {
+      object = record.d_object->makeCopy();
+      object->setObjectId(candidate.second);
+   }
+
+   MTreeSearchResult result( query_point,
+                             object,
+                             (make_safe || !share_points) ? 
+                                record.d_point->makeCopy() : 
+                                record.d_point,
+                             record.d_radius );
+   result.setDistanceToQueryPoint(candidate.first);
+
+   return(result);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routines to add object to index and pending list and to       *
+* remove object from pending list.                                      *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::addObject(MTreeObject& object,
+                       const MTreePoint& point,
+                       double radius)
+{
+   int object_id;
+   if (d_free_object_ids.empty()) {
+      object_id = d_objects.size();
+      d_objects.push_back( ObjectRecord() );
+   } else {
+      object_id = d_free_object_ids.back();
+      d_free_object_ids.pop_back();
+   }
+
+   ObjectRecord& record = d_objects[object_id];
+
+   record.d_object = object.makeCopy();
+   record.d_object->setObjectId(object_id);
+   object.setObjectId(object_id);
+
+   record.d_point    = point.makeCopy();
+   record.d_radius   = radius;
+   record.d_in_tree  = false;
+
+   d_pending_object_ids.push_back(object_id);
+
+   d_num_objects++;
+   d_num_inserts++;
+}
+
+void VPTree::removePendingObject(int object_id)
+{
+   vector<int>::iterator pending = 
+      std::find(d_pending_object_ids.begin(),
+                d_pending_object_ids.end(),
+                object_id);
+
+   if (pending != d_pending_object_ids.end()) {
+      *pending = d_pending_object_ids.back();
+      d_pending_object_ids.pop_back();
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to rebuild the tree once the pending objects, which   *
+* every search scans, and the stale objects, which occupy the tree      *
+* without being found, exceed a fraction of the objects in the tree.    *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::checkRebuild()
+{
+   const int num_changed = 
+      d_pending_object_ids.size() + d_num_stale_objects;
+
+   const int max_changed = 
+      toolbox::MathUtilities<int>::Max( MIN_REBUILD_COUNT,
+         d_num_tree_objects / REBUILD_FRACTION_INVERSE );
+
+   if (num_changed >= max_changed) {
+      rebuild();
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private routine to rebuild the tree from all objects in the index.    *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::rebuild()
+{
+   d_nodes.clear();
+   d_object_ids.clear();
+   d_object_ids.reserve(d_num_objects);
+
+   const int num_ids = d_objects.size();
+   for (int id = 0; id < num_ids; ++id) {
+      if (d_objects[id].d_object) {
+         d_objects[id].d_in_tree = true;
+         d_object_ids.push_back(id);
+      }
+   }
+
+   d_pending_object_ids.clear();
+   d_num_stale_objects = 0;
+   d_num_tree_objects = d_object_ids.size();
+
+   d_root_node = (d_num_tree_objects > 0) ? 
+                 buildSubtree(0, d_num_tree_objects) : -1;
+
+   d_num_rebuilds++;
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private recursive routine to build subtree over given range of object *
+* identifiers.  A randomly chosen vantage object splits the others into *
+* an inner and an outer half at the median distance to its point.       *
+*                                                                       *
+*************************************************************************
+*/
+
+int VPTree::buildSubtree(int begin,
+                         int end)
+{
+   const int node_index = d_nodes.size();
+   d_nodes.push_back( TreeNode() );
+
+   TreeNode node;
+   node.d_begin          = begin;
+   node.d_end            = end;
+   node.d_vantage_id     = MTreeObject::getUndefinedId();
+   node.d_vantage_radius = 0.0;
+   for (int ic = 0; ic < 2; ++ic) {
+      node.d_child[ic]      = -1;
+      node.d_lower[ic]      = 0.0;
+      node.d_upper[ic]      = 0.0;
+      node.d_max_radius[ic] = 0.0;
+   }
+
+   if (end - begin > d_max_leaf_entries) {
+
+      const int iv = 
+         toolbox::MathUtilities<int>::Rand(begin, end - begin);
+      std::swap(d_object_ids[begin], d_object_ids[iv]);
+
+      const ObjectRecord& vantage = d_objects[d_object_ids[begin]];
+      node.d_vantage_id     = d_object_ids[begin];
+      node.d_vantage_point  = vantage.d_point;
+      node.d_vantage_radius = vantage.d_radius;
+
+      /*
+       * Split the other objects at the median distance.
+       */
+      const int num_others = end - begin - 1;
+      vector<Candidate> distances;
+      distances.reserve(num_others);
+      for (int i = begin + 1; i < end; ++i) {
+         const int id = d_object_ids[i];
+         distances.push_back( 
+            Candidate(vantage.d_point->computeDistanceTo(*d_objects[id].d_point),
+                      id) );
+      }
+      d_total_distance_comps_in_inserts += num_others;
+
+      const int num_inner = num_others / 2;
+      std::nth_element(distances.begin(),
+                       distances.begin() + num_inner,
+                       distances.end());
+
+      const int split[3] = { 0, num_inner, num_others };
+      for (int ic = 0; ic < 2; ++ic) {
+         if (split[ic] < split[ic+1]) {
+            node.d_lower[ic] = MTreePoint::getMaxDistance();
+            for (int i = split[ic]; i < split[ic+1]; ++i) {
+               const double distance = distances[i].first;
+               const int id = distances[i].second;
+               d_object_ids[begin + 1 + i] = id;
+               node.d_lower[ic] = 
+                  toolbox::MathUtilities<double>::Min( node.d_lower[ic], 
+                                                       distance );
+               node.d_upper[ic] = 
+                  toolbox::MathUtilities<double>::Max( node.d_upper[ic], 
+                                                       distance );
+               node.d_max_radius[ic] = 
+                  toolbox::MathUtilities<double>::Max( node.d_max_radius[ic],
+                                                       d_objects[id].d_radius );
+            }
+            node.d_child[ic] = buildSubtree(begin + 1 + split[ic],
+                                            begin + 1 + split[ic+1]);
+         }
+      }
+
+   }
+
+   d_nodes[node_index] = node;
+
+   return(node_index);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Operation statistics.                                                 *
+*                                                                       *
+*************************************************************************
+*/
+
+int VPTree::getTotalInsertCount() const
+{
+   return(d_num_inserts);
+}
+
+int VPTree::getTotalInsertDistanceCount() const
+{
+   return(d_total_distance_comps_in_inserts);
+}
+
+int VPTree::getTotalKNNSearchCount() const
+{
+   return( d_num_knn_queries.load(std::memory_order_relaxed) );
+}
+
+int VPTree::getTotalKNNSearchDistanceCount() const
+{
+   return( d_total_distance_comps_in_knn_queries.load(
+              std::memory_order_relaxed) );
+}
+
+int VPTree::getTotalRangeSearchCount() const
+{
+   return( d_num_range_queries.load(std::memory_order_relaxed) );
+}
+
+int VPTree::getTotalRangeSearchDistanceCount() const
+{
+   return( d_total_distance_comps_in_range_queries.load(
+              std::memory_order_relaxed) );
+}
+
+int VPTree::getTotalRebuildCount() const
+{
+   return(d_num_rebuilds);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Print summary of tree configuration.                                  *
+*                                                                       *
+*************************************************************************
+*/
+
+void VPTree::printClassData(ostream& stream) const
+{
+   stream << "\nVPTree::printClassData()\n";
+   stream << "--------------------------------------\n";
+   stream << "this ptr = " << (VPTree*)this << endl;
+   stream << "d_tree_name = " << d_tree_name << endl;
+   stream << "d_max_leaf_entries = " << d_max_leaf_entries << endl;
+   stream << "d_num_objects = " << d_num_objects << endl;
+   stream << "d_num_tree_objects = " << d_num_tree_objects << endl;
+   stream << "number of pending objects = " 
+          << d_pending_object_ids.size() << endl;
+   stream << "d_num_stale_objects = " << d_num_stale_objects << endl;
+   stream << "number of tree nodes = " << d_nodes.size() << endl;
+   stream << "d_num_rebuilds = " << d_num_rebuilds << endl;
+}
+
+}
+}
+#endif
@@ -0,0 +1,366 @@
+//
+// File:        VPTree.h
+// Package:     MPTCOUPLER MTree database
+//
+//
+//
+// Description: In-memory vantage-point tree index structure class.
+//
+
+#ifndef included_mtreedb_VPTree
+#define included_mtreedb_VPTree
+
+#ifndef included_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_String
+#include <string>
+using namespace std;
+#define included_String
+#endif
+
+#ifndef included_iostream
+#define included_iostream
+#include <iostream>
+using namespace std;
+#endif
+
+#ifndef included_vector
+#define included_vector
+#include <vector>
+using namespace std;
+#endif
+
+#ifndef included_atomic
+#define included_atomic
+#include <atomic>
+#endif
+
+#ifndef included_mtreedb_MetricIndex
+#include <mtreedb/MetricIndex.h>
+#endif
+#ifndef included_mtreedb_MTreeSearchResult
+#include <mtreedb/MTreeSearchResult.h>
+#endif
+
+#include "toolbox/base/ScratchArena.h"
+
+namespace MPTCOUPLER {
+    namespace mtreedb {
+
+/*!
+ * @brief VPTree is an in-memory implementation of the MetricIndex
+ *        interface based on a vantage-point tree.
+ *
+ * Each interior node of the tree holds a vantage point chosen among the
+ * objects of its subtree and splits the remaining objects into two
+ * halves by the median of their distances to the vantage point.  For
+ * each half the node records the range of these distances and the
+ * largest object radius, which bounds the distance from any query point
+ * to the objects of the half by the triangle inequality.  Leaves hold
+ * small buckets of objects that are scanned.  Unlike the M-tree, whose
+ * covering radii of sibling nodes overlap, the halves of a node are
+ * disjoint shells about the vantage point; for strongly clustered data
+ * this usually prunes more of the tree per distance computation.
+ *
+ * The tree itself is static.  Objects inserted or moved after the last
+ * build are kept in a pending list that every search scans, and deleted
+ * or moved objects are skipped in the tree; once the pending and stale
+ * objects exceed a fraction of the indexed ones, the tree is rebuilt
+ * from all objects with O(n log n) distance computations.  Rebuilds
+ * happen only in methods that modify the index, so searches may run
+ * concurrently provided no thread modifies the index at the same time.
+ *
+ * All data objects are kept in memory; there is no data store and
+ * objects are never written to disk.
+ *
+ * @see mtreedb::MetricIndex
+ * @see mtreedb::MTree
+ */
+
+class VPTree : public MetricIndex
+{
+public:
+   /*!
+    * Ctor for VPTree object sets tree name and default leaf size.
+    */
+   VPTree(const string& tree_name);
+
+   /*!
+    * Dtor for VPTree objects.
+    */
+   virtual ~VPTree();
+
+   /*!
+    * Return tree name string passed to VPTree ctor.
+    */
+   string getName() const;
+
+   /*!
+    * Set maximum number of objects in a leaf of the tree.  The value
+    * takes effect at the next rebuild of the tree and must be at least
+    * one; if not, the leaf size is not changed.
+    * @param max_entries  Integer maximum number of leaf objects.
+    */
+   void setMaxLeafEntries(int max_entries);
+
+   /*!
+    * Return number of objects in the index.
+    */
+   int getNumberObjects() const;
+
+   //@{
+   //! @name Methods for inserting, deleting and retrieving objects.
+
+   /*!
+    * Insert object into index and set the identifier of the object.  The
+    * object is added to the pending list and the tree is rebuilt if the
+    * list has grown too long.  Deep copies of the point and object are
+    * made.
+    */
+   virtual void insertObject(MTreeObject& object,
+                             const MTreePoint& point,
+                             double radius);
+
+   /*!
+    * Insert collection of objects into index, set the identifiers of the
+    * objects and rebuild the tree.  Deep copies of the points and objects
+    * are made.
+    */
+   virtual void bulkLoad(const vector<MTreeObjectPtr>& objects,
+                         const vector<MTreePointPtr>& points,
+                         const vector<double>& radii);
+
+   /*!
+    * Get copy of object with given identifier, or the object itself if
+    * make_safe is false; return null pointer if the identifier is not 
+    * valid.
+    */
+   virtual MTreeObjectPtr getObject(int object_id,
+                                    bool make_safe = true) const;
+
+   /*!
+    * Delete object with given identifier; do nothing if the identifier
+    * is not valid.  The identifier may be reused by later insertions.
+    */
+   virtual void deleteObject(int object_id);
+
+   /*!
+    * Move center point of object with given identifier and reset its
+    * radius; the object is moved to the pending list.  Do nothing if the
+    * identifier is not valid.
+    */
+   virtual void updateObjectPoint(int object_id,
+                                  const MTreePoint& point,
+                                  double radius);
+
+   //@}
+
+   //@{
+   //! @name Methods for searching the index.
+
+   virtual void searchKNN(vector<MTreeSearchResult>& results,
+                          const MTreePoint& query_point,
+                          int k_neighbors,
+                          bool make_safe = false,
+                          bool share_points = false);
+
+   virtual void searchKNNSupport(vector<MTreeSearchResult>& results,
+                                 const MTreePoint& query_point,
+                                 int k_neighbors,
+                                 bool make_safe = false,
+                                 bool share_points = false);
+
+   virtual void searchKNNApproximate(vector<MTreeSearchResult>& results,
+                                     const MTreePoint& query_point,
+                                     int k_neighbors,
+                                     double error_factor,
+                                     int max_distance_comps,
+                                     bool make_safe = false,
+                                     bool share_points = false);
+
+   virtual void searchRange(list<MTreeSearchResult>& results,
+                            const MTreePoint& query_point,
+                            double radius,
+                            bool make_safe = false,
+                            bool share_points = false);
+
+   //@}
+
+   //@{
+   //! @name Methods for obtaining operation statistics.
+
+   virtual int getTotalInsertCount() const;
+   virtual int getTotalInsertDistanceCount() const;
+   virtual int getTotalKNNSearchCount() const;
+   virtual int getTotalKNNSearchDistanceCount() const;
+   virtual int getTotalRangeSearchCount() const;
+   virtual int getTotalRangeSearchDistanceCount() const;
+
+   /*!
+    * Get total number of rebuilds of the tree.
+    */
+   int getTotalRebuildCount() const;
+
+   //@}
+
+   /*!
+    * Print summary of tree configuration to given output stream.
+    */
+   void printClassData(ostream& stream) const;
+
+private:
+   // The following are not implemented
+   VPTree(const VPTree&);
+   void operator=(const VPTree&);
+
+   /*
+    * Object held by the index.  A null object pointer marks an unused
+    * identifier; d_in_tree is false for objects in the pending list.
+    */
+   struct ObjectRecord {
+      MTreeObjectPtr d_object;
+      MTreePointPtr  d_point;
+      double         d_radius;
+      bool           d_in_tree;
+   };
+
+   /*
+    * Tree node.  Leaves (d_child[0] < 0) hold the objects with
+    * identifiers d_object_ids[d_begin, d_end).  Interior nodes hold the
+    * vantage object, whose point is kept in the node so that the bounds
+    * stay valid when the object is moved or deleted, and for each child
+    * the range of distances from the vantage point and the maximum
+    * object radius.
+    */
+   struct TreeNode {
+      int           d_begin;
+      int           d_end;
+      int           d_vantage_id;
+      MTreePointPtr d_vantage_point;
+      double        d_vantage_radius;
+      int           d_child[2];
+      double        d_lower[2];
+      double        d_upper[2];
+      double        d_max_radius[2];
+   };
+
+   /*
+    * Candidate result of a search: distance and object identifier.
+    * Candidates of a search are kept in the scratch arena of the
+    * searching thread.
+    */
+   typedef std::pair<double, int> Candidate;
+   typedef vector<Candidate, toolbox::ScratchAllocator<Candidate> > 
+      CandidateVector;
+
+   /*
+    * Private method to add object to the index and the pending list.
+    */
+   void addObject(MTreeObject& object,
+                  const MTreePoint& point,
+                  double radius);
+
+   /*
+    * Private method to remove object from the pending list.
+    */
+   void removePendingObject(int object_id);
+
+   /*
+    * Private methods to rebuild the tree if the pending and stale
+    * objects have grown too many, to rebuild the tree from all objects,
+    * and to build the subtree over d_object_ids[begin, end), returning
+    * the index of its root node.
+    */
+   void checkRebuild();
+   void rebuild();
+   int buildSubtree(int begin, int end);
+
+   /*
+    * Private methods implementing "k" nearest neighbor searches, either
+    * by point or by support distance, and range searches.  The recursive
+    * methods search the subtree with given root node.  The error factor
+    * and maximum number of distance computations are those of
+    * searchKNNApproximate(); exact searches pass 1 and 0.
+    */
+   void searchNearest(vector<MTreeSearchResult>& results,
+                      const MTreePoint& query_point,
+                      int k_neighbors,
+                      bool make_safe,
+                      bool share_points,
+                      bool rank_by_support,
+                      double error_factor,
+                      int max_distance_comps);
+
+   void searchNearestRecursive(CandidateVector& candidates,
+                               const MTreePoint& query_point,
+                               int node_index,
+                               bool rank_by_support,
+                               double error_factor,
+                               int max_distance_comps,
+                               int& num_distance_comps) const;
+
+   void searchRangeRecursive(CandidateVector& candidates,
+                             const MTreePoint& query_point,
+                             double radius,
+                             int node_index,
+                             int& num_distance_comps) const;
+
+   /*
+    * Private methods to offer object at given distance to the sorted
+    * vector of "k" nearest candidates and to turn a candidate into a
+    * search result.
+    */
+   static void offerCandidate(CandidateVector& candidates,
+                              double distance,
+                              int object_id);
+
+   MTreeSearchResult makeSearchResult(MTreePointPtr query_point,
+                                      const Candidate& candidate,
+                                      bool make_safe,
+                                      bool share_points) const;
+
+   /*
+    * Default maximum number of objects in a leaf, minimum number of
+    * pending and stale objects that trigger a rebuild, and fraction of
+    * the indexed objects above which they trigger a rebuild.
+    */
+   enum { DEFAULT_MAX_LEAF_ENTRIES = 8,
+          MIN_REBUILD_COUNT = 32,
+          REBUILD_FRACTION_INVERSE = 8 };
+
+   string d_tree_name;
+
+   int d_max_leaf_entries;
+
+   vector<ObjectRecord> d_objects;
+   vector<int>          d_free_object_ids;
+   int                  d_num_objects;
+
+   vector<int>      d_pending_object_ids;
+   int              d_num_stale_objects;
+   int              d_num_tree_objects;
+
+   vector<TreeNode> d_nodes;
+   vector<int>      d_object_ids;
+   int              d_root_node;
+
+   /*
+    * Operation counts.  Search counts may be updated by concurrent
+    * searches and use relaxed atomics.
+    */
+   int d_num_inserts;
+   int d_num_rebuilds;
+   int d_total_distance_comps_in_inserts;
+
+   std::atomic<int> d_num_knn_queries;
+   std::atomic<int> d_total_distance_comps_in_knn_queries;
+   std::atomic<int> d_num_range_queries;
+   std::atomic<int> d_total_distance_comps_in_range_queries;
+
+};
+
+}
+}
+#endif
@@ -0,0 +1,164 @@
+//
+// File:        FixedPoint.h
+// Package:     MPTCOUPLER kriging algorithm
+//
+//
+//
+// Description: Point with dimension fixed at compile time.
+//
+
+#if !defined(included_krigalg_FixedPoint)
+#define included_krigalg_FixedPoint
+
+#ifndef included_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_krigalg_Point
+#include "Point.h"
+#endif
+
+#include <algorithm>
+#include <cassert>
+
+namespace MPTCOUPLER {
+    namespace krigalg {
+
+  //
+  // point with the coordinates held in place; unlike Point, which
+  // shares reference counted heap storage of run-time size, a
+  // FixedPoint lives on the stack and its loops have compile-time trip
+  // counts, which lets the kernels of the fixed-dimension fast path be
+  // unrolled and vectorized
+  //
+
+  template <int Dimension>
+  class FixedPoint {
+
+  public:
+    //
+    // construction/destruction
+    //
+    FixedPoint();
+    explicit FixedPoint(const double * coordinates);
+    explicit FixedPoint(const Point & point);
+
+    //
+    // get dimension
+    //
+
+    static int size();
+
+    //
+    // coordinate access
+    //
+
+    double       & operator[](int i);
+    const double & operator[](int i) const;
+
+    double       * data();
+    const double * data() const;
+
+  private:
+    double _coordinates[Dimension];
+
+  };
+
+  //
+  // construction
+  //
+
+  template <int Dimension>
+  inline
+  FixedPoint<Dimension>::FixedPoint()
+  {
+
+    return;
+
+  }
+
+  template <int Dimension>
+  inline
+  FixedPoint<Dimension>::FixedPoint(const double * coordinates)
+  {
+
+    std::copy(coordinates,
+	      coordinates + Dimension,
+	      _coordinates);
+
+    return;
+
+  }
+
+  template <int Dimension>
+  inline
+  FixedPoint<Dimension>::FixedPoint(const Point & point)
+  {
+
+    assert(point.size() == Dimension);
+
+    std::copy(&(point[0]),
+	      &(point[0]) + Dimension,
+	      _coordinates);
+
+    return;
+
+  }
+
+  //
+  // get dimension
+  //
+
+  template <int Dimension>
+  inline int
+  FixedPoint<Dimension>::size()
+  {
+
+    return Dimension;
+
+  }
+
+  //
+  // coordinate access
+  //
+
+  template <int Dimension>
+  inline double &
+  FixedPoint<Dimension>::operator[](int i)
+  {
+
+    return _coordinates[i];
+
+  }
+
+  template <int Dimension>
+  inline const double &
+  FixedPoint<Dimension>::operator[](int i) const
+  {
+
+    return _coordinates[i];
+
+  }
+
+  template <int Dimension>
+  inline double *
+  FixedPoint<Dimension>::data()
+  {
+
+    return _coordinates;
+
+  }
+
+  template <int Dimension>
+  inline const double *
+  FixedPoint<Dimension>::data() const
+  {
+
+    return _coordinates;
+
+  }
+
+}
+}
+
+#endif // included_krigalg_FixedPoint
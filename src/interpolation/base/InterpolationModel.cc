@@ -52,6 +52,8 @@ advertising or product endorsement purposes.
 
 #include "InterpolationModel.h"
 
+#include <algorithm>
+
 //
 //
 //
@@ -64,6 +66,8 @@ namespace MPTCOUPLER {
     //
 
     InterpolationModel::InterpolationModel()
+      : _numberCenterPoints(0),
+	_radiusSqr(0.0)
     {
       return;
     }
@@ -74,7 +78,89 @@ namespace MPTCOUPLER {
     }
 
     //
-    // Get time stored in TimeRecorder
+    // Interpolate all values at a point
+    //
+
+    std::vector<Value>
+    InterpolationModel::interpolateAll(const Point & point) const
+    {
+
+      const int numberValues = getNumberValues();
+
+      std::vector<Value> values;
+      values.reserve(numberValues);
+
+      for (int valueId = 0; valueId < numberValues; ++valueId)
+	values.push_back(interpolate(valueId,
+				     point));
+
+      return values;
+
+    }
+
+    //
+    // Estimate error of all values at a point
+    //
+
+    std::vector<Value>
+    InterpolationModel::getMeanSquaredErrorAll(const Point & point) const
+    {
+
+      const int numberValues = getNumberValues();
+
+      std::vector<Value> errors;
+      errors.reserve(numberValues);
+
+      for (int valueId = 0; valueId < numberValues; ++valueId)
+	errors.push_back(getMeanSquaredError(valueId,
+					     point));
+
+      return errors;
+
+    }
+
+    //
+    // Interpolate all values at a point into a buffer
+    //
+
+    void
+    InterpolationModel::interpolateAll(double      * values,
+				       const Point & point) const
+    {
+
+      const std::vector<Value> allValues = interpolateAll(point);
+
+      for (std::vector<Value>::size_type i = 0; i < allValues.size(); ++i)
+	std::copy(allValues[i].begin(),
+		  allValues[i].end(),
+		  values + i*allValues[i].size());
+
+      return;
+
+    }
+
+    //
+    // Estimate error of all values at a point into a buffer
+    //
+
+    void
+    InterpolationModel::getMeanSquaredErrorAll(double      * errors,
+					       const Point & point) const
+    {
+
+      const std::vector<Value> allErrors = getMeanSquaredErrorAll(point);
+
+      for (std::vector<Value>::size_type i = 0; i < allErrors.size(); ++i)
+	std::copy(allErrors[i].begin(),
+		  allErrors[i].end(),
+		  errors + i*allErrors[i].size());
+
+      return;
+
+    }
+
+    //
+    // Get epoch stored in TimeRecorder
     //
 
     TimeRecorder
@@ -85,6 +171,150 @@ namespace MPTCOUPLER {
 
     }
 
+    //
+    // Record access at current epoch
+    //
+
+    void
+    InterpolationModel::recordAccess() const
+    {
+
+      _timeRecorder.update();
+
+    }
+
+    //
+    // Get center of mass of model points
+    //
+
+    const Point &
+    InterpolationModel::getCenterMass() const
+    {
+
+      return _centerMass;
+
+    }
+
+    //
+    // Get squared radius of model points about the center of mass
+    //
+
+    double
+    InterpolationModel::getRadiusSqr() const
+    {
+
+      return _radiusSqr;
+
+    }
+
+    //
+    // Update center of mass and radius for an appended point
+    //
+
+    void
+    InterpolationModel::addCenterPoint(const Point & point)
+    {
+
+      accumulateCenterPoint(point);
+      updateRadius();
+
+      return;
+
+    }
+
+    //
+    // Recompute center of mass and radius from all model points
+    //
+
+    void
+    InterpolationModel::resetCenter()
+    {
+
+      _centerSum          = Vector();
+      _centerMass         = Point();
+      _numberCenterPoints = 0;
+
+      const std::vector<Point> & points = getPoints();
+
+      for (std::vector<Point>::size_type i = 0; i < points.size(); ++i)
+	accumulateCenterPoint(points[i]);
+
+      updateRadius();
+
+      return;
+
+    }
+
+    //
+    // Add point to the running sum of the points and update the
+    // center of mass; the sum is accumulated in the order the points
+    // were added
+    //
+
+    void
+    InterpolationModel::accumulateCenterPoint(const Point & point)
+    {
+
+      const int dimension = point.size();
+
+      Vector centerSum(dimension, 0.0);
+      Point  centerMass(dimension);
+
+      ++_numberCenterPoints;
+
+      const double scale = 1.0/_numberCenterPoints;
+
+      for (int i = 0; i < dimension; ++i) {
+	centerSum[i]  = ((_numberCenterPoints > 1) ? _centerSum[i] : 0.0) + 
+	  point[i];
+	centerMass[i] = centerSum[i]*scale;
+      }
+
+      _centerSum  = centerSum;
+      _centerMass = centerMass;
+
+      return;
+
+    }
+
+    //
+    // Recompute the largest squared distance from the center of mass
+    // to a model point
+    //
+
+    void
+    InterpolationModel::updateRadius()
+    {
+
+      const std::vector<Point> & points = getPoints();
+
+      const int dimension = _centerMass.size();
+
+      double maxDistanceSqr = 0.0;
+
+      for (std::vector<Point>::size_type iPoint = 0; 
+	   iPoint < points.size(); 
+	   ++iPoint) {
+
+	const Point & point = points[iPoint];
+
+	double distanceSqr = 0.0;
+
+	for (int i = 0; i < dimension; ++i) {
+	  const double diff = point[i] - _centerMass[i];
+	  distanceSqr += diff*diff;
+	}
+
+	maxDistanceSqr = std::max(maxDistanceSqr, distanceSqr);
+
+      }
+
+      _radiusSqr = maxDistanceSqr;
+
+      return;
+
+    }
+
     //
     // output operator
     //
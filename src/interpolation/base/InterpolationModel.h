@@ -201,6 +201,15 @@ namespace MPTCOUPLER {
     
     virtual bool isValid() const = 0;
 
+    /*!
+     * Estimate the memory held by the model, including its point and
+     * value data and the factorizations built from them.
+     *
+     * @return number of bytes.
+     */
+
+    virtual std::size_t getMemorySize() const = 0;
+
     /*!
      * Interpolate value at a point.
      *
@@ -224,15 +233,100 @@ namespace MPTCOUPLER {
 
     virtual Value getMeanSquaredError(int           valueId,
 				      const Point & point) const = 0;
+
+    /*!
+     * Interpolate all values at a point. The default implementation
+     * calls interpolate() for each value; derived classes may override
+     * it to share the work that does not depend on the value index.
+     *
+     * @param point reference to a point to interpolate at.
+     *
+     * @return STL-vector of getNumberValues() values at the point.
+     */
+
+    virtual std::vector<Value> interpolateAll(const Point & point) const;
+
+    /*!
+     * Estimate error of all values at a point. The default
+     * implementation calls getMeanSquaredError() for each value;
+     * derived classes may override it to share the work that does not
+     * depend on the value index.
+     *
+     * @param point reference to a point to interpolate at.
+     *
+     * @return STL-vector of getNumberValues() mean squared errors at
+     *         the point.
+     */
+
+    virtual std::vector<Value> getMeanSquaredErrorAll(const Point & point) const;
+
+    /*!
+     * Interpolate all values at a point into a caller-provided
+     * buffer. The default implementation copies the result of
+     * interpolateAll(); derived classes may override it to avoid
+     * allocating temporaries.
+     *
+     * @param values pointer to storage for getNumberValues() values
+     *               of getValueDimension() entries each; value i
+     *               starts at values[i*getValueDimension()].
+     * @param point reference to a point to interpolate at.
+     */
+
+    virtual void interpolateAll(double      * values,
+				const Point & point) const;
+
+    /*!
+     * Estimate error of all values at a point into a caller-provided
+     * buffer. The default implementation copies the result of
+     * getMeanSquaredErrorAll().
+     *
+     * @param errors pointer to storage laid out as the values
+     *               argument of interpolateAll().
+     * @param point reference to a point to interpolate at.
+     */
+
+    virtual void getMeanSquaredErrorAll(double      * errors,
+					const Point & point) const;
     
 
     /*!
-     * Get time recorded in TimeRecorder.
+     * Get the epoch of the last recorded access of the model; see
+     * TimeRecorder. The epoch of a model is set when the model is
+     * created or read back from a database.
      *
-     * @return TimeRecorder with the last recorded time.
+     * @return TimeRecorder with the last recorded epoch.
      */
 
     TimeRecorder getTime() const;
+
+    /*!
+     * Record an access of the model at the current epoch. Evaluating
+     * the model does not record accesses; users of the model that
+     * track them (e.g. for aging or eviction) call this once per use.
+     * Safe to call concurrently from several threads.
+     */
+
+    void recordAccess() const;
+
+    /*!
+     * Get center of mass of the model points. The center is kept up
+     * to date as points are added, so the call is cheap.
+     *
+     * @return const reference to the center of mass; a Point of size
+     *         zero if the model has no points.
+     */
+
+    const Point & getCenterMass() const;
+
+    /*!
+     * Get the largest squared distance from the center of mass to a
+     * model point; i.e., the squared radius of the smallest ball about
+     * the center that covers the model points.
+     *
+     * @return squared radius; zero if the model has no points.
+     */
+
+    double getRadiusSqr() const;
   
     /*!
      * InterpolationModel output.
@@ -266,6 +360,22 @@ namespace MPTCOUPLER {
      * @param outputStream the stream to use for output.
      */
     virtual void print(std::ostream & outputStream) const = 0;
+
+    /*!
+     * Update the center of mass and radius after a point has been
+     * appended to the model points. Derived classes call this
+     * whenever they append a point.
+     *
+     * @param point the point appended.
+     */
+    void addCenterPoint(const Point & point);
+
+    /*!
+     * Recompute the center of mass and radius from all model points.
+     * Derived classes call this whenever they replace or remove
+     * points.
+     */
+    void resetCenter();
     
 
   private:
@@ -285,13 +395,32 @@ namespace MPTCOUPLER {
   protected:
 
     //
-    // store last access time
+    // store epoch of last access
     //
     
     mutable TimeRecorder                                   _timeRecorder;
 
   private:
 
+    //
+    // center of mass of the model points, sum of the points and
+    // number of points summed, largest squared distance from the 
+    // center to a point; Point copies share their coordinates so 
+    // these are always replaced rather than modified in place
+    //
+
+    Point  _centerMass;
+    Vector _centerSum;
+    int    _numberCenterPoints;
+    double _radiusSqr;
+
+    //
+    // add point to _centerSum and update _centerMass; recompute
+    // _radiusSqr from all model points
+    //
+    void accumulateCenterPoint(const Point & point);
+    void updateRadius();
+
   };
 
   }
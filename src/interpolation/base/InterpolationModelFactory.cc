@@ -74,6 +74,18 @@ namespace MPTCOUPLER {
 
     }
     
+    //
+    // select kernels specialized for a point dimension
+    //
+
+    bool
+    InterpolationModelFactory::selectFixedDimensionKernels(int pointDimension)
+    {
+
+      return false;
+
+    }
+    
     //
     // return class key
     //
@@ -74,6 +74,21 @@ namespace MPTCOUPLER {
       
       virtual InterpolationModelPtr build() const = 0;
 
+      /*!
+       * @brief Select kernels specialized for a point dimension fixed
+       * at compile time for the models built. The default
+       * implementation selects none.
+       *
+       * @param pointDimension Dimension of the points of all models
+       *        built.
+       *
+       * @return true if specialized kernels are available for the
+       *         point dimension; otherwise the general kernels remain
+       *         in use.
+       */
+
+      virtual bool selectFixedDimensionKernels(int pointDimension);
+
       /*!
        * @brief Get the class key.
        *
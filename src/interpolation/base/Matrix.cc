@@ -54,6 +54,7 @@ advertising or product endorsement purposes.
 #include <mtl/mtl2lapack.h>
 
 #include <cassert>
+#include <vector>
 
 //
 //
@@ -153,6 +154,248 @@ namespace MPTCOUPLER {
       
   }
 
+  //
+  // compute Cholesky factor of R; second argument is true if R is
+  // positive definite.
+  //
+  // Matrix is stored by rows so LAPACK sees R^T = R and the upper
+  // triangle in the Fortran (column) order is the lower triangle here.
+  //
+
+  std::pair<Matrix, bool>
+  cholesky(const Matrix & R)
+  {
+
+    //
+    // firewalls
+    //
+
+    assert(R.nrows() == R.ncols());
+
+    //
+    // copy R as it gets overwritten by the factor
+    //
+
+    const int size = R.nrows();
+
+    Matrix L(size,
+	     size);
+
+    mtl::copy(R, L);
+
+    //
+    // call DPOTRF
+    //
+
+    const char uplo = 'U';
+    int        info = 0;
+
+    dpotrf_(uplo,
+	    size,
+	    L.data(),
+	    size,
+	    info);
+
+    if (info != 0)
+      return std::make_pair(L,
+			    false);
+
+    //
+    // DPOTRF does not reference the other triangle; clear it
+    //
+
+    for (int i = 0; i < size; ++i)
+      for (int j = i + 1; j < size; ++j)
+	L[i][j] = 0.0;
+
+    return std::make_pair(L,
+			  true);
+
+  }
+
+  //
+  // get the dimension of a packed triangle from its size
+  //
+
+  namespace {
+
+    int
+    getPackedTriangleDimension(const std::vector<double> & packedTriangle)
+    {
+
+      const int size = packedTriangle.size();
+
+      int dimension = 0;
+
+      while (dimension*(dimension + 1)/2 < size)
+	++dimension;
+
+      assert(dimension*(dimension + 1)/2 == size);
+
+      return dimension;
+
+    }
+
+  }
+
+  //
+  // pack the lower triangle of a matrix by rows.
+  //
+  // Matrix is stored by rows so in the Fortran (column) order this
+  // is the upper triangle of the transpose packed by columns, i.e.
+  // the 'U' packed storage of LAPACK.
+  //
+
+  std::vector<double>
+  packLowerTriangular(const Matrix & matrix)
+  {
+
+    //
+    // firewalls
+    //
+
+    assert(matrix.nrows() == matrix.ncols());
+
+    const int size = matrix.nrows();
+
+    std::vector<double> packedTriangle;
+    packedTriangle.reserve(size*(size + 1)/2);
+
+    for (int i = 0; i < size; ++i)
+      for (int j = 0; j <= i; ++j)
+	packedTriangle.push_back(matrix[i][j]);
+
+    return packedTriangle;
+
+  }
+
+  //
+  // solve L x = b or L^T x = b; b is overwritten with x. 
+  //
+  // In the Fortran order the packed L is seen as U = L^T.
+  //
+
+  void
+  solvePackedLowerTriangular(const std::vector<double> & L,
+			     Vector                    & b,
+			     bool                        transpose)
+  {
+
+    //
+    // firewalls
+    //
+
+    const int n = getPackedTriangleDimension(L);
+
+    assert(n == b.size());
+
+    const char uplo  = 'U';
+    const char trans = transpose ? 'n' : 't';
+    const char diag  = 'n';
+    const int  incx  = 1;
+
+    dtpsv_(&uplo,
+	   &trans,
+	   &diag,
+	   &n,
+	   &(L[0]),
+	   &(b[0]),
+	   &incx);
+
+    return;
+
+  }
+
+  //
+  // solve L x = b or L^T x = b for each row b of B; B is overwritten
+  // with the solutions.
+  //
+  // In the Fortran order B is seen as B^T, i.e. with the rows of B
+  // as columns, which are the right hand sides DTPTRS expects.
+  //
+
+  void
+  solvePackedLowerTriangular(const std::vector<double> & L,
+			     Matrix                    & B,
+			     bool                        transpose)
+  {
+
+    //
+    // firewalls
+    //
+
+    assert(getPackedTriangleDimension(L) == B.ncols());
+
+    solvePackedLowerTriangular(L,
+			       B.data(),
+			       B.nrows(),
+			       transpose);
+
+    return;
+
+  }
+
+  void
+  solvePackedLowerTriangular(const std::vector<double> & L,
+			     double                    * B,
+			     int                         numberRows,
+			     bool                        transpose)
+  {
+
+    const int  n     = getPackedTriangleDimension(L);
+    const char uplo  = 'U';
+    const char trans = transpose ? 'n' : 't';
+    const char diag  = 'n';
+    int        info  = 0;
+
+    dtptrs_(uplo,
+	    trans,
+	    diag,
+	    n,
+	    numberRows,
+	    &(L[0]),
+	    B,
+	    n,
+	    info);
+
+    assert(info == 0);
+
+    return;
+
+  }
+
+  //
+  // estimate reciprocal condition number of L L^T using DPPCON
+  //
+
+  double
+  choleskyReciprocalCondition(const std::vector<double> & L,
+			      double                      norm)
+  {
+
+    const char uplo  = 'U';
+    const int  size  = getPackedTriangleDimension(L);
+    double     rcond = 0.0;
+    int        info  = 0;
+
+    std::vector<double> work(3*size);
+    std::vector<int>    iwork(size);
+
+    dppcon_(uplo,
+	    size,
+	    &(L[0]),
+	    norm,
+	    rcond,
+	    &(work[0]),
+	    &(iwork[0]),
+	    info);
+
+    assert(info == 0);
+
+    return rcond;
+
+  }
+
 }
 }
 
@@ -24,6 +24,11 @@
 using namespace std;
 #endif
 
+#ifndef included_vector
+#define included_vector
+#include <vector>
+#endif
+
 #ifndef included_mtl_matrix
 #define included_mtl_matrix
 #include <mtl/matrix.h>
@@ -95,6 +100,57 @@ namespace MPTCOUPLER {
 
   std::pair<Matrix, bool> inverse(const Matrix & matrix);
 
+  //
+  // compute Cholesky factor L (lower triangular, matrix = L L^T) of
+  // a symmetric positive definite matrix; second argument is false
+  // if the matrix is not positive definite
+  //
+
+  std::pair<Matrix, bool> cholesky(const Matrix & matrix);
+
+  //
+  // pack the lower triangle of a square matrix by rows; the packed
+  // triangle of an n x n matrix holds n(n+1)/2 entries
+  //
+
+  std::vector<double> packLowerTriangular(const Matrix & matrix);
+
+  //
+  // solve L x = b (or L^T x = b if transpose is true) for lower
+  // triangular L packed by rows; the solution overwrites b
+  //
+
+  void solvePackedLowerTriangular(const std::vector<double> & L,
+				  Vector                    & b,
+				  bool                        transpose);
+
+  //
+  // same as above for each row of B, i.e. solve X L^T = B (or X L =
+  // B if transpose is true); the solution overwrites B
+  //
+
+  void solvePackedLowerTriangular(const std::vector<double> & L,
+				  Matrix                    & B,
+				  bool                        transpose);
+
+  //
+  // same as above for B given as a row-major array of numberRows
+  // rows of length equal to the order of L
+  //
+
+  void solvePackedLowerTriangular(const std::vector<double> & L,
+				  double                    * B,
+				  int                         numberRows,
+				  bool                        transpose);
+
+  //
+  // estimate the reciprocal of the 1-norm condition number of
+  // L L^T given its Cholesky factor L packed by rows and its 1-norm
+  //
+
+  double choleskyReciprocalCondition(const std::vector<double> & L,
+				     double                      norm);
+
   //
   // output
   //
@@ -56,4 +56,16 @@ advertising or product endorsement purposes.
 #include "TimeRecorder.I"
 #endif // DEBUG_NO_INLINE
 
+namespace MPTCOUPLER {
+  namespace krigalg {
+
+    //
+    // logical clock
+    //
+
+    std::atomic<unsigned long> TimeRecorder::_clock(0);
+
+  }
+}
+
 
@@ -14,15 +14,23 @@
 #include "asf_config.h"
 #endif // included_config
 
-#include <ctime>
+#include <atomic>
 
 namespace MPTCOUPLER {
   namespace krigalg {
+
+    //
+    // records the last access of a model in epochs of a logical clock
+    // shared by all recorders; the clock is advanced once per database
+    // operation rather than read from the system, so recording an
+    // access costs a relaxed load and, if the epoch has changed, a
+    // relaxed store
+    //
  
     class TimeRecorder {
     public:
       /*!
-       * Default constructor. Records the time upon creation.
+       * Default constructor. Records the current epoch upon creation.
        */
       TimeRecorder();
 
@@ -30,30 +38,46 @@ namespace MPTCOUPLER {
        * Default destructor.
        */
       ~TimeRecorder();
+
+      /*!
+       * Copy constructor.
+       */
+      TimeRecorder(const TimeRecorder & timeRecorder);
+
+      /*!
+       * Assignment.
+       */
+      const TimeRecorder & operator=(const TimeRecorder & timeRecorder);
       
       /*!
-       * Update time.
+       * Record the current epoch. Safe to call concurrently from
+       * several threads; the recorded epoch is only written when it
+       * changes.
        */
       void update();
 
       /*!
-       * Compute difference in seconds between this and other time.
+       * Compute difference in epochs between this and other recorded
+       * epoch.
        *
-       * @param timeRecorder Other recorded time.
+       * @param timeRecorder Other recorded epoch.
        *
-       * @return Time difference in seconds.
+       * @return Epoch difference.
        */
-      int diff(const TimeRecorder & timeRecorder) const;
+      long diff(const TimeRecorder & timeRecorder) const;
+
+      /*!
+       * Advance the logical clock. Safe to call concurrently from
+       * several threads.
+       *
+       * @param numberEpochs Number of epochs to advance the clock by.
+       */
+      static void advance(unsigned long numberEpochs = 1);
 
     private:
-      //
-      // copy construction/assignment
-      //
-      // TimeRecorder(const TimeRecorder &);
-      // const TimeRecorder & operator=(const TimeRecorder &);
-      
-    private:
-      time_t _time;
+      std::atomic<unsigned long> _epoch;
+
+      static std::atomic<unsigned long> _clock;
       
     };
 
@@ -82,6 +82,73 @@ namespace MPTCOUPLER {
 
   }
 
+  //
+  // write the value of the correlation into a buffer; generic
+  // implementation copying the result of getValue()
+  //
+
+  void
+  CorrelationModel::getValueBlock(double      * value,
+				  int           leadingDimension,
+				  const Point & firstPoint,
+				  const Point & secondPoint) const
+  {
+
+    const Matrix correlation = getValue(firstPoint,
+					secondPoint);
+
+    for (int i = 0; i < correlation.nrows(); ++i)
+      for (int j = 0; j < correlation.ncols(); ++j)
+	value[i*leadingDimension + j] = correlation[i][j];
+
+    return;
+
+  }
+
+  //
+  // write the values of the correlation between a collection of
+  // points and a point into a buffer
+  //
+
+  void
+  CorrelationModel::getValueBlocks(double                   * values,
+				   int                        leadingDimension,
+				   const std::vector<Point> & firstPoints,
+				   const Point              & secondPoint) const
+  {
+
+    std::vector<Point>::size_type numberPoints = firstPoints.size();
+
+    for (std::vector<Point>::size_type i = 0; i < numberPoints; ++i) {
+
+      const Matrix correlation = getValue(firstPoints[i],
+					  secondPoint);
+
+      double * value = values + i*correlation.nrows()*leadingDimension;
+
+      for (int k = 0; k < correlation.nrows(); ++k)
+	for (int l = 0; l < correlation.ncols(); ++l)
+	  value[k*leadingDimension + l] = correlation[k][l];
+
+    }
+
+    return;
+
+  }
+
+  //
+  // select kernels specialized for a point dimension; there are none
+  // in the generic implementation
+  //
+
+  bool
+  CorrelationModel::selectFixedDimensionKernels(int pointDimension)
+  {
+
+    return false;
+
+  }
+
   //
   // get thetas
   //
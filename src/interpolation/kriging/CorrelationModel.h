@@ -91,6 +91,38 @@ namespace MPTCOUPLER {
 
     virtual Matrix getValue(const Point & firstPoint,
 			    const Point & secondPoint) const = 0;
+
+    //
+    // write the value of the correlation between firstPoint and
+    // secondPoint into a caller-provided buffer; row i of the value
+    // starts at value[i*leadingDimension]
+    //
+
+    virtual void getValueBlock(double      * value,
+			       int           leadingDimension,
+			       const Point & firstPoint,
+			       const Point & secondPoint) const;
+
+    //
+    // batched form of getValueBlock() for the correlation between
+    // each of firstPoints and secondPoint; the values are stacked
+    // one below another, i.e. for a value with n rows the value for
+    // firstPoints[k] starts at values[k*n*leadingDimension]
+    //
+
+    virtual void getValueBlocks(double                   * values,
+				int                        leadingDimension,
+				const std::vector<Point> & firstPoints,
+				const Point              & secondPoint) const;
+
+    //
+    // select kernels specialized for points of the given dimension
+    // for getValueBlock() and getValueBlocks(); returns false, and the
+    // general kernels remain in use, if there are none
+    //
+
+    virtual bool selectFixedDimensionKernels(int pointDimension);
+
     void getThetas(std::vector<double> & thetas) const;
     void setThetas(const std::vector<double> & thetas);
 
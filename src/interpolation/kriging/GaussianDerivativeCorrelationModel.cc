@@ -54,6 +54,8 @@ advertising or product endorsement purposes.
 
 #include "GaussianDerivativeCorrelationModel.h"
 
+#include "base/FixedPoint.h"
+
 #include <mtl/mtl.h>
 
 #include <cassert>
@@ -65,13 +67,268 @@ advertising or product endorsement purposes.
 
 namespace MPTCOUPLER {
   namespace krigalg {
+
+    namespace {
+
+      //
+      // fill in the (n+1)x(n+1) covariance block of
+      // {Y, D_1 Y, ..., D_n Y} for a pair of points; for now the values
+      // are normalized wrt. the gaussian correlation.
+      //
+      // The first row of the block is used to hold the point distance
+      // while the remaining rows are computed so that the entire
+      // computation is done in place. The rows of the derivative part
+      // are scaled copies of the distance, i.e. an outer product, and
+      // are filled in with unit-stride loops.
+      //
+
+      inline void
+      computeCovarianceBlock(double      * covarianceArray,
+			     int           leadingDimension,
+			     const Point & firstPoint,
+			     const Point & secondPoint,
+			     double        theta)
+      {
+
+	const int      pointDimension = firstPoint.size();
+	const double   thetaSqr       = theta*theta;
+	const double * firstData      = &(firstPoint[0]);
+	const double * secondData     = &(secondPoint[0]);
+
+	//
+	// compute distance between firstPoint and secondPoint; distance
+	// component i is stored at distance[i + 1]
+	//
+
+	double * distance = covarianceArray;
+
+	double distanceNormSqr = 0.0;
+
+	for (int i = 1; i <= pointDimension; ++i) {
+	  distance[i] = firstData[i - 1] - secondData[i - 1];
+	  distanceNormSqr += distance[i]*distance[i];
+	}
+
+	const double covarianceScaling = exp(-theta*distanceNormSqr);
+
+	//
+	// correlation of derivatives and of function and derivative
+	//
+
+	for (int i = 1; i <= pointDimension; ++i) {
+
+	  double * covarianceRow = covarianceArray + i*leadingDimension;
+
+	  const double distanceI = distance[i];
+
+	  //
+	  // Cov[ Y(firstPoint), D_{i-1} Y(secondPoint) ]
+	  //
+
+	  covarianceRow[0] = -2.0*theta*distanceI*covarianceScaling;
+
+	  //
+	  // Cov[ D_{i-1} Y(firstPoint), D_{j-1} Y(secondPoint) ]
+	  //
+
+	  const double rowScaling = -4.0*thetaSqr*distanceI;
+
+	  for (int j = 1; j <= pointDimension; ++j)
+	    covarianceRow[j] = covarianceScaling*(rowScaling*distance[j]);
+
+	  //
+	  // self correlation
+	  //
+
+	  covarianceRow[i] = covarianceScaling*
+	    (2.0*theta + rowScaling*distanceI);
+
+	}
+
+	//
+	// correlation of function with itself and
+	// Cov[ D_{i-1}Y(firstPoint), Y(secondPoint) ]; this overwrites
+	// the distance
+	//
+
+	covarianceArray[0] = covarianceScaling;
+
+	for (int i = 1; i <= pointDimension; ++i)
+	  covarianceArray[i] = 2.0*theta*distance[i]*covarianceScaling;
+
+	return;
+
+      }
+
+      //
+      // fill in the covariance blocks for a collection of points and a
+      // point, stacked one below another
+      //
+
+      void
+      computeCovarianceBlocks(double                   * values,
+			      int                        leadingDimension,
+			      const std::vector<Point> & firstPoints,
+			      const Point              & secondPoint,
+			      double                     theta)
+      {
+
+	std::vector<Point>::size_type numberPoints = firstPoints.size();
+
+	for (std::vector<Point>::size_type i = 0; i < numberPoints; ++i) {
+
+	  const Point & firstPoint = firstPoints[i];
+
+	  computeCovarianceBlock(values + 
+				 i*(firstPoint.size() + 1)*leadingDimension,
+				 leadingDimension,
+				 firstPoint,
+				 secondPoint,
+				 theta);
+
+	}
+
+	return;
+
+      }
+
+      //
+      // same as computeCovarianceBlock() for points of dimension
+      // PointDimension; the distance is kept in a FixedPoint rather
+      // than in the first row of the block and all loops have
+      // compile-time trip counts. The arithmetic is carried out in
+      // the same order as in the general kernel so that both give
+      // identical results.
+      //
+
+      template <int PointDimension>
+      inline void
+      computeFixedCovarianceBlock(double                           * covarianceArray,
+				  int                                leadingDimension,
+				  const double                     * firstData,
+				  const FixedPoint<PointDimension> & secondPoint,
+				  double                             theta)
+      {
+
+	const double thetaSqr = theta*theta;
+
+	//
+	// compute distance between firstPoint and secondPoint
+	//
+
+	FixedPoint<PointDimension> distance;
+
+	double distanceNormSqr = 0.0;
+
+	for (int i = 0; i < PointDimension; ++i) {
+	  distance[i] = firstData[i] - secondPoint[i];
+	  distanceNormSqr += distance[i]*distance[i];
+	}
+
+	const double covarianceScaling = exp(-theta*distanceNormSqr);
+
+	//
+	// correlation of function with itself and
+	// Cov[ D_{i-1}Y(firstPoint), Y(secondPoint) ]
+	//
+
+	covarianceArray[0] = covarianceScaling;
+
+	for (int i = 0; i < PointDimension; ++i)
+	  covarianceArray[i + 1] = 2.0*theta*distance[i]*covarianceScaling;
+
+	//
+	// correlation of derivatives and of function and derivative
+	//
+
+	for (int i = 0; i < PointDimension; ++i) {
+
+	  double * covarianceRow = covarianceArray + (i + 1)*leadingDimension;
+
+	  const double distanceI  = distance[i];
+	  const double rowScaling = -4.0*thetaSqr*distanceI;
+
+	  covarianceRow[0] = -2.0*theta*distanceI*covarianceScaling;
+
+	  for (int j = 0; j < PointDimension; ++j)
+	    covarianceRow[j + 1] = covarianceScaling*(rowScaling*distance[j]);
+
+	  covarianceRow[i + 1] = covarianceScaling*
+	    (2.0*theta + rowScaling*distanceI);
+
+	}
+
+	return;
+
+      }
+
+      template <int PointDimension>
+      void
+      computeFixedCovarianceBlock(double      * covarianceArray,
+				  int           leadingDimension,
+				  const Point & firstPoint,
+				  const Point & secondPoint,
+				  double        theta)
+      {
+
+	assert(firstPoint.size() == PointDimension);
+
+	computeFixedCovarianceBlock(covarianceArray,
+				    leadingDimension,
+				    &(firstPoint[0]),
+				    FixedPoint<PointDimension>(secondPoint),
+				    theta);
+
+	return;
+
+      }
+
+      //
+      // same as computeCovarianceBlocks() for points of dimension
+      // PointDimension; secondPoint is copied once to the stack
+      //
+
+      template <int PointDimension>
+      void
+      computeFixedCovarianceBlocks(double                   * values,
+				   int                        leadingDimension,
+				   const std::vector<Point> & firstPoints,
+				   const Point              & secondPoint,
+				   double                     theta)
+      {
+
+	const FixedPoint<PointDimension> fixedSecondPoint(secondPoint);
+
+	const int blockSize = (PointDimension + 1)*leadingDimension;
+
+	std::vector<Point>::size_type numberPoints = firstPoints.size();
+
+	for (std::vector<Point>::size_type i = 0; i < numberPoints; ++i) {
+
+	  assert(firstPoints[i].size() == PointDimension);
+
+	  computeFixedCovarianceBlock(values + i*blockSize,
+				      leadingDimension,
+				      &(firstPoints[i][0]),
+				      fixedSecondPoint,
+				      theta);
+
+	}
+
+	return;
+
+      }
+
+    }
     
   //
   // construction/destruction
   //
     
     GaussianDerivativeCorrelationModel::GaussianDerivativeCorrelationModel(const std::vector<double> & thetas)
-      : DerivativeCorrelationModel(thetas)
+      : DerivativeCorrelationModel(thetas),
+	_valueBlockKernel(computeCovarianceBlock),
+	_valueBlocksKernel(computeCovarianceBlocks)
   {
 
     return;
@@ -96,19 +353,6 @@ namespace MPTCOUPLER {
 					       const Point & secondPoint) const
   {
 
-    //
-    // compute distance between firstPoint and secondPoint
-    //
-
-    const Vector distance = firstPoint - secondPoint;
-
-
-    //
-    // compute L2-norm of the firstPoint-secondPoint distance
-    //
-
-    const double distanceNorm = mtl::two_norm(distance);
-
     //
     // allocate array 
     //
@@ -119,72 +363,116 @@ namespace MPTCOUPLER {
 			   arrayDimension);
     
     //
-    // fill in values; for now the values are normalized wrt. the
-    // gaussian correlation
+    // fill in values
     //
 
-    const double theta    = _thetas.front();
-    const double thetaSqr = theta*theta;
-    const double covarianceScaling = exp(-theta*distanceNorm*
-					 distanceNorm);
+    computeCovarianceBlock(covarianceArray.data(),
+			   arrayDimension,
+			   firstPoint,
+			   secondPoint,
+			   _thetas.front());
 
     //
-    // correlation of function with itself
+    // return covarianceArray
     //
 
-    covarianceArray[0][0] = covarianceScaling;
+    return covarianceArray;
+    
+  }
 
-    //
-    // correlation of function and derivative
-    //
+  //
+  // write value of the correlation function between two points into a
+  // buffer
+  //
 
-    for (int i = 1; i < arrayDimension; ++i) {
+  void
+  GaussianDerivativeCorrelationModel::getValueBlock(double      * value,
+						    int           leadingDimension,
+						    const Point & firstPoint,
+						    const Point & secondPoint) const
+  {
 
-      //
-      // get covariance magnitude
-      //
+    _valueBlockKernel(value,
+		      leadingDimension,
+		      firstPoint,
+		      secondPoint,
+		      _thetas.front());
 
-      const double covarianceValue = -2.0*theta*distance[i - 1];
+    return;
 
-      //
-      // Cov[ D_{i-1}Y(firstPoint), Y(secondPoint) ]
-      //
-      
-      covarianceArray[0][i] = -covarianceValue*covarianceScaling;
+  }
 
-      //
-      // Cov[ Y(firstPoint), D_{i-1} Y(secondPoint) ]
-      //
+  //
+  // write values of the correlation function between a collection of
+  // points and a point into a buffer
+  //
 
-      covarianceArray[i][0] = covarianceValue*covarianceScaling;
+  void
+  GaussianDerivativeCorrelationModel::getValueBlocks(double                   * values,
+						     int                        leadingDimension,
+						     const std::vector<Point> & firstPoints,
+						     const Point              & secondPoint) const
+  {
 
-    }
+    _valueBlocksKernel(values,
+		       leadingDimension,
+		       firstPoints,
+		       secondPoint,
+		       _thetas.front());
 
-    //
-    // correlation of derivatives
-    //
+    return;
 
-    for (int i = 1; i < arrayDimension; ++i) 
-      for (int j = i; j < arrayDimension; ++j)
-	if (i == j)	  
-	  //
-	  // self correlation
-	  //
-	  covarianceArray[i][i] = covarianceScaling*
-	    (2.0*theta - 
-	     4.0*thetaSqr*distance[i - 1]*distance[i - 1]);
-	else
-	  covarianceArray[i][j] = covarianceArray[j][i] =
-	    covarianceScaling*(-4.0*thetaSqr*distance[i - 1]*distance[j - 1]);
+  }
 
-    //
-    // return covarianceArray
-    //
+  //
+  // select the kernels for a point dimension; the fixed-dimension
+  // kernels are instantiated for the point dimensions in common use
+  //
 
-    return covarianceArray;
-    
-  }
+  bool
+  GaussianDerivativeCorrelationModel::selectFixedDimensionKernels(int pointDimension)
+  {
+
+    switch (pointDimension) {
+
+    case 1:
+      _valueBlockKernel  = computeFixedCovarianceBlock<1>;
+      _valueBlocksKernel = computeFixedCovarianceBlocks<1>;
+      return true;
 
+    case 2:
+      _valueBlockKernel  = computeFixedCovarianceBlock<2>;
+      _valueBlocksKernel = computeFixedCovarianceBlocks<2>;
+      return true;
+
+    case 3:
+      _valueBlockKernel  = computeFixedCovarianceBlock<3>;
+      _valueBlocksKernel = computeFixedCovarianceBlocks<3>;
+      return true;
+
+    case 6:
+      _valueBlockKernel  = computeFixedCovarianceBlock<6>;
+      _valueBlocksKernel = computeFixedCovarianceBlocks<6>;
+      return true;
+
+    case 9:
+      _valueBlockKernel  = computeFixedCovarianceBlock<9>;
+      _valueBlocksKernel = computeFixedCovarianceBlocks<9>;
+      return true;
+
+    case 18:
+      _valueBlockKernel  = computeFixedCovarianceBlock<18>;
+      _valueBlocksKernel = computeFixedCovarianceBlocks<18>;
+      return true;
+
+    default:
+      _valueBlockKernel  = computeCovarianceBlock;
+      _valueBlocksKernel = computeCovarianceBlocks;
+      return false;
+
+    }
+
+  }
 
   //
   // get a string representation of the class name
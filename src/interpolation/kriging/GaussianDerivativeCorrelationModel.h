@@ -59,6 +59,15 @@ namespace MPTCOUPLER {
 
     virtual Matrix getValue(const Point & firstPoint,
 			    const Point & secondPoint) const;
+    virtual void getValueBlock(double      * value,
+			       int           leadingDimension,
+			       const Point & firstPoint,
+			       const Point & secondPoint) const;
+    virtual void getValueBlocks(double                   * values,
+				int                        leadingDimension,
+				const std::vector<Point> & firstPoints,
+				const Point              & secondPoint) const;
+    virtual bool selectFixedDimensionKernels(int pointDimension);
 
     //
     // Database input/output
@@ -76,6 +85,25 @@ namespace MPTCOUPLER {
     GaussianDerivativeCorrelationModel(const GaussianDerivativeCorrelationModel &);
     const GaussianDerivativeCorrelationModel & operator=(const GaussianDerivativeCorrelationModel &);
 
+    //
+    // kernels used by getValueBlock() and getValueBlocks(); the last
+    // argument is theta
+    //
+
+    typedef void (*ValueBlockKernel)(double      * value,
+				     int           leadingDimension,
+				     const Point & firstPoint,
+				     const Point & secondPoint,
+				     double        theta);
+    typedef void (*ValueBlocksKernel)(double                   * values,
+				      int                        leadingDimension,
+				      const std::vector<Point> & firstPoints,
+				      const Point              & secondPoint,
+				      double                     theta);
+
+    ValueBlockKernel  _valueBlockKernel;
+    ValueBlocksKernel _valueBlocksKernel;
+
   };
 
 }
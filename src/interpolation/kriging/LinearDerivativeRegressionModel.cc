@@ -51,14 +51,99 @@ advertising or product endorsement purposes.
 
 #include "LinearDerivativeRegressionModel.h"
 
+#include <cassert>
+
 namespace MPTCOUPLER {
   namespace krigalg {
 
+    namespace {
+
+      //
+      // fill in the values of the regression model for a point of
+      // dimension pointDimension
+      //
+
+      inline void
+      fillValueBlock(double       * values,
+		     int            leadingDimension,
+		     const double * pointData,
+		     int            pointDimension)
+      {
+
+	const int dimension = pointDimension + 1;
+
+	//
+	// fill identity
+	//
+
+	for (int i = 0; i < dimension; ++i) {
+
+	  double * valuesRow = values + i*leadingDimension;
+
+	  for (int j = 0; j < dimension; ++j)
+	    valuesRow[j] = 0.0;
+
+	  valuesRow[i] = 1.0;
+
+	}
+
+	//
+	// fill function basis values
+	//
+
+	for (int i = 1; i < dimension; ++i)
+	  values[i] = pointData[i - 1];
+
+	return;
+
+      }
+
+      void
+      computeValueBlock(double      * values,
+			int           leadingDimension,
+			const Point & point)
+      {
+
+	fillValueBlock(values,
+		       leadingDimension,
+		       &(point[0]),
+		       point.size());
+
+	return;
+
+      }
+
+      //
+      // same as computeValueBlock() for points of dimension
+      // PointDimension
+      //
+
+      template <int PointDimension>
+      void
+      computeFixedValueBlock(double      * values,
+			     int           leadingDimension,
+			     const Point & point)
+      {
+
+	assert(point.size() == PointDimension);
+
+	fillValueBlock(values,
+		       leadingDimension,
+		       &(point[0]),
+		       PointDimension);
+
+	return;
+
+      }
+
+    }
+
   //
   // construction/destruction
   //
 
   LinearDerivativeRegressionModel::LinearDerivativeRegressionModel()
+    : _valueBlockKernel(computeValueBlock)
   {
 
     return;
@@ -104,6 +189,67 @@ namespace MPTCOUPLER {
 
   }
 
+  //
+  // write the values of the regression model into a buffer
+  //
+
+  void
+  LinearDerivativeRegressionModel::getValueBlock(double      * values,
+						 int           leadingDimension,
+						 const Point & point) const
+  {
+
+    _valueBlockKernel(values,
+		      leadingDimension,
+		      point);
+
+    return;
+
+  }
+
+  //
+  // select the kernel for a point dimension; the fixed-dimension
+  // kernels are instantiated for the point dimensions in common use
+  //
+
+  bool
+  LinearDerivativeRegressionModel::selectFixedDimensionKernels(int pointDimension)
+  {
+
+    switch (pointDimension) {
+
+    case 1:
+      _valueBlockKernel = computeFixedValueBlock<1>;
+      return true;
+
+    case 2:
+      _valueBlockKernel = computeFixedValueBlock<2>;
+      return true;
+
+    case 3:
+      _valueBlockKernel = computeFixedValueBlock<3>;
+      return true;
+
+    case 6:
+      _valueBlockKernel = computeFixedValueBlock<6>;
+      return true;
+
+    case 9:
+      _valueBlockKernel = computeFixedValueBlock<9>;
+      return true;
+
+    case 18:
+      _valueBlockKernel = computeFixedValueBlock<18>;
+      return true;
+
+    default:
+      _valueBlockKernel = computeValueBlock;
+      return false;
+
+    }
+
+  }
+
   //
   // get dimension 
   //
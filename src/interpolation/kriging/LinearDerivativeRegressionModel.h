@@ -54,6 +54,10 @@ namespace MPTCOUPLER {
     
     virtual Matrix    getValues(const Point & point) const;
     virtual Dimension getDimension(const Point & point) const;
+    virtual void      getValueBlock(double      * values,
+				    int           leadingDimension,
+				    const Point & point) const;
+    virtual bool      selectFixedDimensionKernels(int pointDimension);
 
     //
     // Database input/output
@@ -70,6 +74,16 @@ namespace MPTCOUPLER {
     LinearDerivativeRegressionModel(const LinearDerivativeRegressionModel &);
     const LinearDerivativeRegressionModel & operator=(const LinearDerivativeRegressionModel &);
 
+    //
+    // kernel used by getValueBlock()
+    //
+
+    typedef void (*ValueBlockKernel)(double      * values,
+				     int           leadingDimension,
+				     const Point & point);
+
+    ValueBlockKernel _valueBlockKernel;
+
   };
 
 }
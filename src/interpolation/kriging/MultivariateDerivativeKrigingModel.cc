@@ -57,6 +57,7 @@ advertising or product endorsement purposes.
 #include "SecondMoment.h"
 
 #include "toolbox/database/Database.h"
+#include "toolbox/base/ScratchArena.h"
 #include "toolbox/base/Utilities.h"
 
 #include <mtl/mtl.h>
@@ -64,6 +65,7 @@ advertising or product endorsement purposes.
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <iterator>
 #include <limits>
@@ -94,9 +96,87 @@ namespace MPTCOUPLER {
       const std::string regressionModelClassNameKey("regression_model_class_name");
       const std::string correlationModelClassNameKey("correlation_model_class_name");
 
+      //
+      // keys of the optional factored state; the version is bumped
+      // whenever the layout of the factored state or the way it is
+      // computed in build() changes so that stale data get rebuilt
+      //
+
+      const int         factoredStateVersion = 1;
+      const std::string factoredStateVersionKey("factored_state_version");
+      const std::string choleskyVKey("cholesky_v");
+      const std::string absColumnSumsVKey("abs_column_sums_v");
+      const std::string choleskyXVXKey("cholesky_xvx");
+      const std::string regressionDimensionKey("regression_dimension");
+      const std::string matrixInverseVXKey("matrix_inverse_vx");
+      const std::string azKey("az");
+      const std::string bzKey("bz");
+      const std::string sigmaSqrKey("sigma_sqr");
+
+      //
+      // number of bytes held on the heap by model data
+      //
+
+      inline std::size_t
+      getDataMemorySize(double)
+      {
+
+	return 0;
+
+      }
+
+      inline std::size_t
+      getDataMemorySize(const Vector & vector)
+      {
+
+	return vector.size()*sizeof(double);
+
+      }
+
+      inline std::size_t
+      getDataMemorySize(const Matrix & matrix)
+      {
+
+	return matrix.nrows()*matrix.ncols()*sizeof(double);
+
+      }
+
+      template <typename T>
+      std::size_t
+      getDataMemorySize(const std::vector<T> & data)
+      {
+
+	std::size_t memorySize = data.size()*sizeof(T);
+
+	for (typename std::vector<T>::size_type i = 0; i < data.size(); ++i)
+	  memorySize += getDataMemorySize(data[i]);
+
+	return memorySize;
+
+      }
+
+
+      //
+      // diagonal shift regularizing the rows of the correlation matrix
+      // belonging to a point to alleviate possible poor conditioning;
+      // the shift of a point depends only on its position so the rows
+      // of existing points do not change when a point is appended
+      //
+
+      inline double
+      getRegularization(int pointIndex,
+			int valueDimension)
+      {
+
+	return (10.0 + valueDimension*(pointIndex + 1))*
+	  std::numeric_limits<double>::epsilon();
+
+      }
     
       //
-      // construct correlation matrix for all points in the model
+      // construct correlation matrix for all points in the model; the
+      // rows/columns are ordered by point, i.e. the entries for point i
+      // occupy rows i*valueDimension to (i + 1)*valueDimension - 1
       //   
     
       Matrix 
@@ -113,6 +193,7 @@ namespace MPTCOUPLER {
 
 	assert(_points.empty() == false);
 	assert(_points.size()  == numberPoints);
+	assert(valueDimension  == pointDimension + 1);
 
 	//
 	// instantiate matrix
@@ -122,66 +203,32 @@ namespace MPTCOUPLER {
 		 valueDimension*numberPoints);
 
 	//
-	// iterate over all points
+	// fill in V by columns of blocks; the blocks of column j hold the
+	// correlation between all points and j-point and are written 
+	// directly into V
 	//
 
-	for (int i = 0; i < numberPoints; ++i) {
-
-	  //
-	  // get i-point handle 
-	  //
-
-	  const Point & iPoint = _points[i];
-
-	  //
-	  // iterate over all points again
-	  //
-
-	  for (int j = 0; j < numberPoints; ++j) {
-	  
-	    //
-	    // get j-point handle
-	    //
+	const int size = valueDimension*numberPoints;
 
-	    const Point & jPoint = _points[j];
+	for (int j = 0; j < numberPoints; ++j)
+	  _correlationModel->getValueBlocks(V.data() + j*valueDimension,
+					    size,
+					    _points,
+					    _points[j]);
 
-	    //
-	    // obtain the correlation Matrix from the
-	    // DerivativeCorrelationModel
-	    //
-	  
-	    const Matrix ijCorrelationMatrix = 
-	      _correlationModel->getValue(iPoint,
-					  jPoint);
-
-	    //
-	    // firewall
-	    //
-	  
-	    assert(ijCorrelationMatrix.nrows() == valueDimension);
-	    assert(ijCorrelationMatrix.ncols() == valueDimension);
+	//
+	// regularize
+	//
 
-	    //
-	    // insert the ijCorrelationMatrix entries into V
-	    //
+	for (int i = 0; i < numberPoints; ++i) {
 
-	    for (int k = 0; k < valueDimension; ++k)
-	      for (int l = 0; l < valueDimension; ++l)
-		V[i + k*numberPoints][j + l*numberPoints] = 
-		  ijCorrelationMatrix[k][l];
+	  const double regularization = getRegularization(i,
+							  valueDimension);
 
-	  }
+	  for (int k = 0; k < valueDimension; ++k)
+	    V[i*valueDimension + k][i*valueDimension + k] += regularization;
 	
 	}
-
-	//
-	// regularize the correlation matrix to alleviate possible poor
-	// conditioning
-	//
-
-	for (int i = 0; i < valueDimension*numberPoints; ++i)
-	  V[i][i] += (10.0 + valueDimension*numberPoints)*
-	    std::numeric_limits<double>::epsilon();
       
 	return V;
 
@@ -262,7 +309,7 @@ namespace MPTCOUPLER {
 
 	  for (int i = 0; i < regressionModelDimensionInt; ++i)
 	    for (int j = 0; j < regressionModelDimensionInt; ++j)
-	      X[currentPoint + i*numberPoints][j] = 
+	      X[currentPoint*regressionModelDimensionInt + i][j] = 
 		regressionModelValues[i][j];
 
 	}
@@ -271,97 +318,6 @@ namespace MPTCOUPLER {
 
       }
 
-      //
-      // compute matrix A =
-      // Inverse[Transpose[X].VInverse.X].Transpose[X].VInverse
-      //
-    
-      Matrix
-      computeMatrixA(Matrix       & _matrixInverseXVX,
-		     const Matrix & _matrixX,
-		     const Matrix & _matrixInverseV)
-      {
-
-	//
-	// firewalls
-	//
-
-	assert(_matrixX.nrows() == _matrixInverseV.nrows()); // X^T VInverse
-	assert(_matrixInverseV.ncols() == _matrixX.nrows());
-
-	//
-	// compute X^T VInverse
-	//
-
-	const Matrix tranposeXinverseV = mult(_matrixX,
-					      _matrixInverseV,
-					      true,
-					      false);
-
-	//
-	// compute X^T VInverse X
-	//
-
-	const Matrix tranposeXinverseVX = mult(tranposeXinverseV,
-					       _matrixX);
-
-	//
-	// compute X^T VInverse X inverse
-	//
-
-	std::pair<Matrix, bool> inverseData = inverse(tranposeXinverseVX);
-
-	assert(inverseData.second == true);
-	_matrixInverseXVX = inverseData.first;
-	
-
-	//
-	// compute (X^T VInverse X inverse)^(-1) X^T VInverse
-	//
-      
-	return mult(mult(_matrixInverseXVX,
-			 _matrixX,
-			 false,
-			 true),
-		    _matrixInverseV);
-
-      }
-
-      //
-      // compute matrix B
-      //
-
-      Matrix 
-      computeMatrixB(const Matrix & _matrixInverseV,
-		     const Matrix & _matrixX,
-		     const Matrix & A)
-      {
-
-	//
-	// firewalls
-	//
-
-	assert(_matrixX.ncols() == A.nrows());
-	assert(_matrixInverseV.ncols() == _matrixX.nrows());
-
-	//
-	// compute X A
-	//
-
-	const Matrix XA = mult(_matrixX,
-			       A);
-      
-	assert(XA.nrows() == XA.ncols());
-
-	//
-	//
-	//
-
-	return mult(_matrixInverseV,
-		    identity(XA.nrows()) - XA);
-
-      }
-
       //
       // reload values into Z
       //
@@ -417,7 +373,7 @@ namespace MPTCOUPLER {
 	    //
 
 	    for (Value::size_type i = 0; i < value.size(); ++i)
-	      Z[iValue][currentPoint + i*numberPoints] = value[i];
+	      Z[iValue][currentPoint*valueDimension + i] = value[i];
 
 	  }
 	
@@ -427,107 +383,6 @@ namespace MPTCOUPLER {
 
       }
 
-      //
-      // compute _AZ and _BZ
-      //
-
-      std::pair<std::vector<Vector>, std::vector<Vector> >
-      computeAZBZPair(const std::vector<Vector> & Z,
-		      const Matrix              & A,
-		      const Matrix              & B)
-      {
-      
-	//
-	// allocate space for _AZ and _BZ
-	//
-      
-	std::vector<Vector> _AZ;
-	std::vector<Vector> _BZ;
-
-	//
-	// iterate through Z
-	//
-
-	std::vector<Vector>::const_iterator zIter;
-	const std::vector<Vector>::const_iterator zEnd = Z.end();
-
-	for (zIter  = Z.begin(); zIter != zEnd; ++zIter) {
-
-	  //
-	  // get handle to part of Z coresponding to value
-	  //
-
-	  const Vector & zValue = *zIter;
-
-	  //
-	  // multiply and store
-	  //
-
-	  _AZ.push_back(mult(A, zValue));
-	  _BZ.push_back(mult(B, zValue));
-
-	}
-
-	//
-	//
-	//
-
-	return std::make_pair(_AZ, _BZ);
-
-      }
-    
-      //
-      // compute variance
-      //
-
-      std::vector<double >
-      computeVariance(const std::vector<Vector> & _AZ,
-		      const std::vector<Vector> & Z,
-		      const Matrix              & _matrixX,
-		      const Matrix              & _matrixInverseV,
-		      int                         numberPoints,
-		      int                         numberPerPointValues)
-      {
-
-	//
-	// allocate sigmaSqr
-	//
-
-	std::vector<double> sigmaSqr;
-	sigmaSqr.reserve(Z.size());
-
-	//
-	// iterate over all values
-	//
-
-	for (int iValue = 0; iValue < numberPerPointValues; ++iValue) {
-	
-	  //
-	  // compute Z - X.A.Z
-	  //
-	
-	  const Vector diffZ = Z[iValue] - mult(_matrixX,
-						_AZ[iValue]);
-	
-	  //
-	  // compute VInverse.(Z - X.A.Z)
-	  //
-	
-	  const Vector vInverseDiffZ = mult(_matrixInverseV,
-					    diffZ);
-	
-	  //
-	  // compute (scaled) dot product of diffZ and vInverseDiffZ
-	  //
-	
-	  sigmaSqr.push_back(dot(diffZ, vInverseDiffZ)/numberPoints);
-
-	}
-
-	return sigmaSqr;
-	
-      }
-
       //
       // compute the value of CorrelationModel at a point
       //
@@ -559,42 +414,34 @@ namespace MPTCOUPLER {
 		 valueDimension);
 
 	//
-	// iterate over points
+	// fill in correlation between all points and point
 	//
 
-	std::vector<Point>::const_iterator pointsIter;
-	std::vector<Point>::const_iterator pointsEnd = _points.end();
-	int currentPoint = 0;
+	_correlationModel->getValueBlocks(r.data(),
+					  valueDimension,
+					  _points,
+					  point);
 
-	for (pointsIter  = _points.begin();
-	     pointsIter != pointsEnd;
-	     ++pointsIter, ++currentPoint) {
-	
-	  //
-	  // get handle to point
-	  //
+	return  r;
 
-	  const Point & modelPoint = *pointsIter;
-	
-	  //
-	  // obtain correlation Matrix from DerivativeCorrelationModel
-	  //
+      }
 
-	  const Matrix correlationMatrix = 
-	    _correlationModel->getValue(modelPoint,
-					point);
+      //
+      // compute the sums of absolute values of the entries in each
+      // column of a matrix; the 1-norm is the largest of them
+      //
 
-	  //
-	  // insert data into r
-	  //
+      std::vector<double>
+      computeAbsColumnSums(const Matrix & matrix)
+      {
 
-	  for (int i = 0; i < valueDimension; ++i)
-	    for (int j = 0; j < valueDimension; ++j)
-	      r[currentPoint + i*numberPoints][j] = correlationMatrix[i][j];
+	std::vector<double> absColumnSums(matrix.ncols(), 0.0);
 
-	}
+	for (int i = 0; i < matrix.nrows(); ++i)
+	  for (int j = 0; j < matrix.ncols(); ++j)
+	    absColumnSums[j] += std::fabs(matrix[i][j]);
 
-	return  r;
+	return absColumnSums;
 
       }
 
@@ -744,181 +591,195 @@ namespace MPTCOUPLER {
       }
 
       //
-      // pack a contents of a matrix into a vector container
+      // evaluate the regression model and the correlation between the
+      // model points and point into caller-provided buffers; Xs is
+      // valueDimension x regressionDimension and r is 
+      // (numberPoints*valueDimension) x valueDimension, both stored
+      // by rows
       //
 
       inline void
-      packMatrix(std::vector<double> & packedContainer,
-		 const Matrix        & matrix)
+      evaluateModelData(double                        * Xs,
+			double                        * r,
+			const Point                   & point,
+			const std::vector<Point>      & _points,
+			const RegressionModelPointer  & _regressionModel,
+			const CorrelationModelPointer & _correlationModel,
+			int                             valueDimension,
+			int                             regressionDimension)
       {
 
-	const int numberColumns = matrix.ncols();
-	const int numberRows    = matrix.nrows(); 
-	
-	const double * data = matrix.data();
-	
-	//
-	// store order
-	//
-
-	packedContainer.push_back((double)numberRows);
-	packedContainer.push_back((double)numberColumns);
-
-	//
-	//
-	//
+	_regressionModel->getValueBlock(Xs,
+					regressionDimension,
+					point);
 
-	packedContainer.insert(packedContainer.end(),
-			       &(data[0]),
-			       &(data[numberRows*numberColumns]));
-	
-	//
-	//
-	//
+	_correlationModel->getValueBlocks(r,
+					  valueDimension,
+					  _points,
+					  point);
 
 	return;
 
       }
 
       //
-      // unpack Matrix
+      // compute interpolated value Xs.aZ + r^T.bZ
       //
 
-      inline Matrix
-      unpackMatrix(const std::vector<double> & packedContainer,
-		   int                       & currentOffset)
+      inline void
+      computeValue(double       * value,
+		   const double * Xs,
+		   const double * r,
+		   const Vector & aZ,
+		   const Vector & bZ,
+		   int            valueDimension,
+		   int            regressionDimension,
+		   int            size)
       {
 
-	//
-	// get order
-	//
+	const double * aZData = &(aZ[0]);
+	const double * bZData = &(bZ[0]);
 
-	const int numberRows    = (int)packedContainer[currentOffset++];
-	const int numberColumns = (int)packedContainer[currentOffset++];
+	for (int i = 0; i < valueDimension; ++i) {
 
-	//
-	// instantiate matrix
-	//
+	  const double * XsRow = Xs + i*regressionDimension;
 
-	Matrix matrix(numberRows,
-		      numberColumns);
-	
-	//
-	// fill in 
-	//
+	  double regressionPart = 0.0;
 
-	const int numberData = numberRows*numberColumns;
+	  for (int j = 0; j < regressionDimension; ++j)
+	    regressionPart += XsRow[j]*aZData[j];
 
-	std::copy(&(packedContainer[currentOffset]),
-		  &(packedContainer[currentOffset + numberData]),
-		  matrix.data());
-	
-	currentOffset += numberData;
+	  double correlationPart = 0.0;
 
-	//
-	//
-	//
-	
-	return matrix;
+	  for (int k = 0; k < size; ++k)
+	    correlationPart += r[k*valueDimension + i]*bZData[k];
+
+	  value[i] = regressionPart + correlationPart;
+
+	}
+
+	return;
 
       }
-		   
-            
+
       //
-      // pack std::vector<Vector>
+      // compute the part of the mean squared error that does not
+      // depend on the value; the error for a given value is obtained
+      // by scaling with the corresponding sigma^2; temporaries are
+      // drawn from the scratch arena of the calling thread
       //
 
-      inline void
-      packVectorVector(std::vector<double>       & packedContainer,
-		       const std::vector<Vector> & vectorVector)
+      void
+      computeUnscaledMeanSquaredError(double                        * errorVector,
+				      const Point                   & point,
+				      const double                  * Xs,
+				      const double                  * r,
+				      const CorrelationModelPointer & _correlationModel,
+				      const std::vector<double>     & _choleskyV,
+				      const std::vector<double>     & _choleskyXVX,
+				      const Matrix                  & _matrixInverseVX,
+				      int                             valueDimension,
+				      int                             size)
       {
 
-	std::vector<Vector>::const_iterator vectorVectorIter;
-	std::vector<Vector>::const_iterator vectorVectorEnd = 
-	  vectorVector.end();
-	
-	packedContainer.push_back(vectorVector.size());
-
-	for (vectorVectorIter  = vectorVector.begin();
-	     vectorVectorIter != vectorVectorEnd;
-	     ++vectorVectorIter) {
-
-	  //
-	  // store size
-	  //
-	  
-	  packedContainer.push_back((*vectorVectorIter).size());
+	const int regressionDimension = _matrixInverseVX.ncols();
 
-	  //
-	  // store data
-	  //
+	toolbox::ScratchArena & arena = 
+	  toolbox::ScratchArena::getThreadArena();
+	toolbox::ScratchArena::Scope scratchScope(arena);
 
-	  packedContainer.insert(packedContainer.end(),
-				 (*vectorVectorIter).begin(),
-				 (*vectorVectorIter).end());
-	}
+	double * u                  = 
+	  arena.allocate<double>(valueDimension*regressionDimension);
+	double * inverseLrTranspose = 
+	  arena.allocate<double>(valueDimension*size);
+	double * sigma              = 
+	  arena.allocate<double>(valueDimension*valueDimension);
 
 	//
-	//
+	// compute  u = Xs0 - Transpose[r].VInverse.X
 	//
 
-	return;
+	const double * inverseVX = _matrixInverseVX.data();
 
-      }
+	for (int i = 0; i < valueDimension; ++i)
+	  for (int j = 0; j < regressionDimension; ++j) {
 
-      //
-      // unpack std::vector<Vector>
-      //
+	    double rInverseVX = 0.0;
 
-      inline std::vector<Vector>
-      unpackVectorVector(const std::vector<double> & packedContainer,
-			 int                       & currentOffset)
-      {
+	    for (int k = 0; k < size; ++k)
+	      rInverseVX += r[k*valueDimension + i]*
+		inverseVX[k*regressionDimension + j];
+
+	    u[i*regressionDimension + j] = 
+	      Xs[i*regressionDimension + j] - rInverseVX;
+
+	  }
 
 	//
-	// extract std::vector<Vector> size
+	// get self-correlation
 	//
 
-	const int vectorVectorSize = (int)packedContainer[currentOffset++];
+	_correlationModel->getValueBlock(sigma,
+					 valueDimension,
+					 point,
+					 point);
 
 	//
-	// instantiate container
+	// compute L^{-1} r for all columns of r at once; the
+	// contribution r^T V^{-1} r for a value is the squared norm
+	// of the corresponding column
 	//
 
-	std::vector<Vector> vectorVector;
-	vectorVector.reserve(vectorVectorSize);
+	for (int i = 0; i < valueDimension; ++i)
+	  for (int k = 0; k < size; ++k)
+	    inverseLrTranspose[i*size + k] = r[k*valueDimension + i];
+
+	solvePackedLowerTriangular(_choleskyV,
+				   inverseLrTranspose,
+				   valueDimension,
+				   false);
 
 	//
-	// iterate over all std::vector<Vector> entries
+	// similarly, u (X^T V^{-1} X)^{-1} u^T is obtained from 
+	// K^{-1} u^T with K the factor of X^T V^{-1} X
 	//
 
-	for (int i = 0; i < vectorVectorSize; ++i) {
+	solvePackedLowerTriangular(_choleskyXVX,
+				   u,
+				   valueDimension,
+				   false);
 
-	  //
-	  // get size
-	  //
-	  
-	  const int vectorSize = (int)packedContainer[currentOffset++];
+	//
+	// compute the error estimate
+	//
+
+	for (int i = 0; i < valueDimension; ++i) {
 
 	  //
-	  // instantiate Vector
+	  // initialize with the self correlation term
 	  //
 
-	  const Vector vector(vectorSize,
-			      &(packedContainer[currentOffset]));
-
-	  
-	  currentOffset += vectorSize;
+	  errorVector[i] = sigma[i*valueDimension + i];
 
 	  //
-	  // insert vector into vectorVector
+	  // add u.(XVX)^-1.u^T contribution
 	  //
 
-	  vectorVector.push_back(vector);
+	  for (int j = 0; j < regressionDimension; ++j)
+	    errorVector[i] += u[i*regressionDimension + j]*
+	      u[i*regressionDimension + j];
+	
+	  //
+	  // add r^T V^-1 r contribution
+	  //
+	
+	  for (int k = 0; k < size; ++k)
+	    errorVector[i] -= inverseLrTranspose[i*size + k]*
+	      inverseLrTranspose[i*size + k];
 
 	}
 
-	return vectorVector;
+	return;
 
       }
 
@@ -928,8 +789,10 @@ namespace MPTCOUPLER {
     // construction/destruction
     //
     MultivariateDerivativeKrigingModel::MultivariateDerivativeKrigingModel(const RegressionModelPointer & regressionModel,
-									   const CorrelationModelPointer & correlationModel)
+									   const CorrelationModelPointer & correlationModel,
+									   bool storeFactoredState)
       :  _isValid(false),
+	 _storeFactoredState(storeFactoredState),
 	 _regressionModel(regressionModel),
 	 _correlationModel(correlationModel)
     {
@@ -1001,6 +864,7 @@ namespace MPTCOUPLER {
 	//
 
 	_points.push_back(point);
+	addCenterPoint(point);
 	_values.push_back(values);
 
 	//
@@ -1013,48 +877,127 @@ namespace MPTCOUPLER {
       
 	//
 	// this gets executed when the model already exists and a new point is
-	// to be inserted
+	// to be inserted; the correlation matrix of the extended model is
 	//
-      
+	//     | V   C |            | L    0   |
+	//     | C^T D |  with factor | W^T  L22 |
 	//
-	// construct correlation matrix for all points in the model
+	// where W = L^{-1} C and L22 L22^T = D - W^T W; only the
+	// correlation between the new point and the model points is
+	// computed
 	//
-    
-	std::vector<Point> pointsCopy(_points.begin(),
-				      _points.end());
-	pointsCopy.push_back(point);
 
-	const Matrix V = createCorrelationMatrix(pointsCopy,
-						 _correlationModel,
-						 getPointDimension(),
-						 getValueDimension(),
-						 pointsCopy.size());
+	const int valueDimension = getValueDimension();
+	const int numberPoints   = getNumberPoints();
+	const int oldSize        = numberPoints*valueDimension;
+	const int newSize        = oldSize + valueDimension;
 
 	//
-	// compute the inverse of V
+	// compute C and D
 	//
-    
-	std::pair<Matrix, bool> inverseData = inverse(V);
 
-	if (!inverseData.second) {
+	const Matrix C = computeCorrelation(_points,
+					    point,
+					    _correlationModel,
+					    valueDimension);
+
+	Matrix D(valueDimension,
+		 valueDimension);
+
+	_correlationModel->getValueBlock(D.data(),
+					 valueDimension,
+					 point,
+					 point);
+
+	const double regularization = getRegularization(numberPoints,
+							valueDimension);
+
+	for (int i = 0; i < valueDimension; ++i)
+	  D[i][i] += regularization;
+
+	//
+	// compute W^T and the Schur complement D - W^T W
+	//
+
+	Matrix WTranspose = transpose(C);
+
+	solvePackedLowerTriangular(_choleskyV,
+				   WTranspose,
+				   false);
+
+	const Matrix schurComplement = D - mult(WTranspose,
+						WTranspose,
+						false,
+						true);
+
+	//
+	// factor the Schur complement; failure means that the extended
+	// correlation matrix is not positive definite
+	//
+
+	const std::pair<Matrix, bool> choleskyData = cholesky(schurComplement);
+
+	if (!choleskyData.second) {
 
-	   std::cout << "Inverse failed, point will not be inserted." << std::endl;
+	   std::cout << "Cholesky factorization failed, point will not be inserted." << std::endl;
 	   
 	   return false;
 
 	}
-	const Matrix matrixInverseV = inverseData.first;
+
+	const Matrix & L22 = choleskyData.first;
+
+	//
+	// assemble the factor of the extended correlation matrix; with
+	// the factor packed by rows this amounts to appending the rows
+	// of [W^T L22]
+	//
+
+	std::vector<double> choleskyV;
+	choleskyV.reserve(newSize*(newSize + 1)/2);
+
+	choleskyV.insert(choleskyV.end(),
+			 _choleskyV.begin(),
+			 _choleskyV.end());
+
+	for (int i = 0; i < valueDimension; ++i) {
+
+	  for (int j = 0; j < oldSize; ++j)
+	    choleskyV.push_back(WTranspose[i][j]);
+
+	  for (int j = 0; j <= i; ++j)
+	    choleskyV.push_back(L22[i][j]);
+
+	}
 
 	//
-	// get the condition number for V 
+	// update the column sums of V to get its 1-norm
 	//
 
-	const double vConditionNumber = 
-	  mtl::one_norm(V)*mtl::one_norm(matrixInverseV);
+	std::vector<double> absColumnSumsV(_absColumnSumsV);
+	absColumnSumsV.resize(newSize, 0.0);
+
+	for (int i = 0; i < oldSize; ++i)
+	  for (int j = 0; j < valueDimension; ++j) {
+	    absColumnSumsV[i]           += std::fabs(C[i][j]);
+	    absColumnSumsV[oldSize + j] += std::fabs(C[i][j]);
+	  }
+
+	for (int i = 0; i < valueDimension; ++i)
+	  for (int j = 0; j < valueDimension; ++j)
+	    absColumnSumsV[oldSize + j] += std::fabs(D[i][j]);
+
+	const double normV = *std::max_element(absColumnSumsV.begin(),
+					       absColumnSumsV.end());
+
+	//
+	// get the condition number for V from the factor
+	//
 
 	const double maxConditionNumber = 1.0e10;
 	
-	if (vConditionNumber > maxConditionNumber) {
+	if (choleskyReciprocalCondition(choleskyV,
+					normV)*maxConditionNumber < 1.0) {
 
 // 	  std::cout << "Condition number: " 
 // 		    << vConditionNumber  << " "
@@ -1072,13 +1015,17 @@ namespace MPTCOUPLER {
 	//
 
 	_points.push_back(point);
+	addCenterPoint(point);
 	_values.push_back(values);
 
+	_choleskyV.swap(choleskyV);
+	_absColumnSumsV.swap(absColumnSumsV);
+
 	//
-	// re-build the model
+	// re-build the model from the extended factor
 	//
 
-	build();
+	buildFromFactor();
 
       }
 
@@ -1195,6 +1142,27 @@ namespace MPTCOUPLER {
 
     }
 
+    //
+    // estimate memory held by the model
+    //
+
+    std::size_t
+    MultivariateDerivativeKrigingModel::getMemorySize() const
+    {
+
+      return sizeof(*this) +
+	getDataMemorySize(_points) +
+	getDataMemorySize(_values) +
+	getDataMemorySize(_choleskyV) +
+	getDataMemorySize(_absColumnSumsV) +
+	getDataMemorySize(_choleskyXVX) +
+	getDataMemorySize(_matrixInverseVX) +
+	getDataMemorySize(_AZ) +
+	getDataMemorySize(_BZ) +
+	getDataMemorySize(_sigmaSqr);
+
+    }
+
 
     //
     // build the model using accumulated points
@@ -1211,7 +1179,6 @@ namespace MPTCOUPLER {
       const int pointDimension = getPointDimension();
       const int valueDimension = getValueDimension();
       const int numberPoints   = getNumberPoints();
-      const int numberValues   = getNumberValues();
 
       //
       // firewall
@@ -1219,10 +1186,6 @@ namespace MPTCOUPLER {
 
       assert(_points.size() == _values.size());
 
-      //
-      // generate value-independent data
-      //
-    
       //
       // construct correlation matrix for all points in the model
       //
@@ -1234,119 +1197,387 @@ namespace MPTCOUPLER {
 					       numberPoints);
 
       //
-      // compute the inverse of V
+      // compute the Cholesky factor of V
+      //
+    
+      const std::pair<Matrix, bool> choleskyData = cholesky(V);
+
+      assert(choleskyData.second == true);
+      _choleskyV = packLowerTriangular(choleskyData.first);
+
+      //
+      // store column sums of V for the estimate of its condition
+      // number when the model is extended
+      //
+
+      _absColumnSumsV = computeAbsColumnSums(V);
+
+      //
+      // compute the remaining data from the factor
+      //
+
+      buildFromFactor();
+
+      //
+      //
+      // 
+
+      return;
+
+    }
+
+    //
+    // build the model from the Cholesky factor of the correlation
+    // matrix; all inverses are applied by triangular solves
+    //
+  
+    void 
+    MultivariateDerivativeKrigingModel::buildFromFactor()
+    {
+    
+      //
+      // get dimensions
+      //
+
+      const int pointDimension = getPointDimension();
+      const int valueDimension = getValueDimension();
+      const int numberPoints   = getNumberPoints();
+      const int numberValues   = getNumberValues();
+      const int size           = numberPoints*valueDimension;
+
+      //
+      // firewall
+      //
+
+      assert(_choleskyV.size() == size*(size + 1)/2);
+
+      //
+      // generate value-independent data
+      //
+    
+      //
+      // get values of RegressionModel at all points
+      //
+    
+      const Matrix X = getRegressionModelValues(_points,
+						_regressionModel,
+						pointDimension,
+						valueDimension,
+						numberPoints);
+
+      //
+      // compute (L^{-1} X)^T and X^T V^{-1} X = (L^{-1} X)^T (L^{-1} X)
+      //
+
+      Matrix inverseLXTranspose = transpose(X);
+
+      solvePackedLowerTriangular(_choleskyV,
+				 inverseLXTranspose,
+				 false);
+
+      const Matrix XVX = mult(inverseLXTranspose,
+			      inverseLXTranspose,
+			      false,
+			      true);
+
+      //
+      // factor X^T V^{-1} X
+      //
+
+      const std::pair<Matrix, bool> choleskyXVXData = cholesky(XVX);
+
+      assert(choleskyXVXData.second == true);
+
+      _choleskyXVX = packLowerTriangular(choleskyXVXData.first);
+
+      //
+      // compute V^{-1} X = L^{-T} (L^{-1} X)
+      //
+
+      solvePackedLowerTriangular(_choleskyV,
+				 inverseLXTranspose,
+				 true);
+
+      _matrixInverseVX = transpose(inverseLXTranspose);
+
+      //
+      // compute all value dependent data
+      //
+    
+      //
+      // compute reloaded data
+      //
+
+      const std::vector<Vector> Z = reloadValues(_values,
+						 pointDimension,
+						 valueDimension,
+						 numberPoints,
+						 numberValues);
+    
+      //
+      // compute _AZ = (X^T V^{-1} X)^{-1} X^T V^{-1} Z, 
+      // _BZ = V^{-1} (Z - X AZ) and the variance 
+      // (Z - X AZ)^T V^{-1} (Z - X AZ)/size
+      //
+
+      _AZ.clear();
+      _BZ.clear();
+      _sigmaSqr.clear();
+
+      for (int iValue = 0; iValue < numberValues; ++iValue) {
+
+	const Vector & zValue = Z[iValue];
+
+	Vector aZ = mult(_matrixInverseVX,
+			 zValue,
+			 true);
+
+	solvePackedLowerTriangular(_choleskyXVX,
+				   aZ,
+				   false);
+	solvePackedLowerTriangular(_choleskyXVX,
+				   aZ,
+				   true);
+
+	const Vector diffZ = zValue - mult(X,
+					   aZ);
+
+	Vector bZ(size,
+		  &(diffZ[0]));
+
+	solvePackedLowerTriangular(_choleskyV,
+				   bZ,
+				   false);
+	solvePackedLowerTriangular(_choleskyV,
+				   bZ,
+				   true);
+
+	_AZ.push_back(aZ);
+	_BZ.push_back(bZ);
+	_sigmaSqr.push_back(dot(diffZ, bZ)/size);
+
+      }
+    
+      //
+      // make model valid
+      //
+
+      _isValid = true;
+
+      //
+      //
+      // 
+
+      return;
+
+    }
+
+    //
+    // interpolate value at a point
+    //
+
+    Value
+    MultivariateDerivativeKrigingModel::interpolate(int           valueId,
+						    const Point & point) const
+    {
+
+      //
+      // firewalls
+      //
+
+      assert(_isValid == true);
+
+      //
+      // get dimensions
+      //
+
+      const int valueDimension      = getValueDimension();
+      const int regressionDimension = _matrixInverseVX.ncols();
+      const int size                = getNumberPoints()*valueDimension;
+
+      //
+      // evaluate RegressionModel and CorrelationModel at point
+      //
+
+      toolbox::ScratchArena & arena = 
+	toolbox::ScratchArena::getThreadArena();
+      toolbox::ScratchArena::Scope scratchScope(arena);
+
+      double * Xs = arena.allocate<double>(valueDimension*regressionDimension);
+      double * r  = arena.allocate<double>(size*valueDimension);
+
+      evaluateModelData(Xs,
+			r,
+			point,
+			_points,
+			_regressionModel,
+			_correlationModel,
+			valueDimension,
+			regressionDimension);
+
+      //
+      // compute interpolant value at point
+      //
+
+      Vector interpolatedValueVector(valueDimension);
+
+      computeValue(&(interpolatedValueVector[0]),
+		   Xs,
+		   r,
+		   _AZ[valueId],
+		   _BZ[valueId],
+		   valueDimension,
+		   regressionDimension,
+		   size);
+
+      //
+      // 
+      //
+
+      return interpolatedValueVector;
+
+    }
+
+    //
+    // get (estimated) interpolation error
+    //
+
+    Value
+    MultivariateDerivativeKrigingModel::getMeanSquaredError(int           valueId,
+							    const Point & point) const
+    {
+
+      //
+      // firewalls
       //
-    
-      std::pair<Matrix, bool> inverseData = inverse(V);
 
-      assert(inverseData.second == true);
-      _matrixInverseV = inverseData.first;
+      assert(_isValid == true);
 
       //
-      // get the condition number for V 
+      // get the size of Value; since we include the value of the
+      // function as well as the gradient the size should equal to the
+      // space dimension plus 1
       //
 
-//       std::cout << "Condition number: " 
-// 		<< mtl::one_norm(V)*mtl::one_norm(_matrixInverseV) 
-// 		<< std::endl;
-    
-      //
-      // get values of RegressionModel at all points
-      //
-    
-      _matrixX = getRegressionModelValues(_points,
-					  _regressionModel,
-					  pointDimension,
-					  valueDimension,
-					  numberPoints);
+      const int valueDimension = getValueDimension();
 
       //
-      // compute V^{-1} X 
+      // compute the error estimate
       //
 
-      _matrixInverseVX = mult(_matrixInverseV,
-			      _matrixX);
+      Vector errorVector(valueDimension);
+
+      computeMeanSquaredErrors(&(errorVector[0]),
+			       point,
+			       &(_sigmaSqr[valueId]),
+			       1);
 
       //
-      // compute matrix A
+      //
       //
 
-      const Matrix A = computeMatrixA(_matrixInverseXVX,
-				      _matrixX,
-				      _matrixInverseV);
+      return errorVector;
 
-      //
-      // compute matrix B
-      //
+    }  
 
-      const Matrix B = computeMatrixB(_matrixInverseV,
-				      _matrixX,
-				      A);
+    //
+    // interpolate all values at a point; the regression and correlation
+    // data are shared by all values
+    //
+
+    std::vector<Value>
+    MultivariateDerivativeKrigingModel::interpolateAll(const Point & point) const
+    {
 
       //
-      // compute all value dependent data
-      //
-    
-      //
-      // compute reloaded data
+      // get dimensions
       //
 
-      const std::vector<Vector> Z = reloadValues(_values,
-						 pointDimension,
-						 valueDimension,
-						 numberPoints,
-						 numberValues);
-    
+      const int valueDimension = getValueDimension();
+      const int numberValues   = getNumberValues();
+
       //
-      // compute _AZ and _BZ
+      // compute interpolant values at point
       //
 
-      std::pair<std::vector<Vector>, std::vector<Vector> > aZbZPair = 
-	computeAZBZPair(Z,
-			A,
-			B);
+      toolbox::ScratchArena & arena = 
+	toolbox::ScratchArena::getThreadArena();
+      toolbox::ScratchArena::Scope scratchScope(arena);
+
+      double * allValues = arena.allocate<double>(numberValues*valueDimension);
+
+      interpolateAll(allValues,
+		     point);
+
+      std::vector<Value> values;
+      values.reserve(numberValues);
 
-      _AZ = aZbZPair.first;
-      _BZ = aZbZPair.second;
+      for (int valueId = 0; valueId < numberValues; ++valueId)
+	values.push_back(Value(valueDimension,
+			       allValues + valueId*valueDimension));
 
       //
-      // compute variance
+      // 
       //
 
-      _sigmaSqr = computeVariance(_AZ,
-				  Z,
-				  _matrixX,
-				  _matrixInverseV,
-				  numberPoints*valueDimension,
-				  numberValues);
-    
+      return values;
+
+    }
+
+    //
+    // get (estimated) interpolation error of all values at a point;
+    // the errors differ only by the sigma^2 factor so the expensive
+    // part is computed once
+    //
+
+    std::vector<Value>
+    MultivariateDerivativeKrigingModel::getMeanSquaredErrorAll(const Point & point) const
+    {
+
       //
-      // make model valid
+      // get dimensions
       //
 
-      _isValid = true;
+      const int valueDimension = getValueDimension();
+      const int numberValues   = getNumberValues();
 
       //
-      // update time record
+      // compute the error estimates
       //
 
-      _timeRecorder.update();
+      toolbox::ScratchArena & arena = 
+	toolbox::ScratchArena::getThreadArena();
+      toolbox::ScratchArena::Scope scratchScope(arena);
+
+      double * allErrors = arena.allocate<double>(numberValues*valueDimension);
+
+      getMeanSquaredErrorAll(allErrors,
+			     point);
+
+      std::vector<Value> errors;
+      errors.reserve(numberValues);
+
+      for (int valueId = 0; valueId < numberValues; ++valueId)
+	errors.push_back(Value(valueDimension,
+			       allErrors + valueId*valueDimension));
 
       //
       //
-      // 
+      //
 
-      return;
+      return errors;
 
     }
 
     //
-    // interpolate value at a point
+    // interpolate all values at a point into a buffer; all
+    // temporaries are drawn from the scratch arena of the calling
+    // thread
     //
 
-    Value
-    MultivariateDerivativeKrigingModel::interpolate(int           valueId,
-						    const Point & point) const
+    void
+    MultivariateDerivativeKrigingModel::interpolateAll(double      * values,
+						       const Point & point) const
     {
 
       //
@@ -1359,158 +1590,152 @@ namespace MPTCOUPLER {
       // get dimensions
       //
 
-      const int valueDimension = getValueDimension();
-
-      //
-      // evaluate RegressionModel at point
-      //
-
-      const Matrix Xs = _regressionModel->getValues(point);
+      const int valueDimension      = getValueDimension();
+      const int numberValues        = getNumberValues();
+      const int regressionDimension = _matrixInverseVX.ncols();
+      const int size                = getNumberPoints()*valueDimension;
 
       //
-      // compute CorrelationModel at point
+      // evaluate RegressionModel and CorrelationModel at point
       //
 
-      const Matrix r = computeCorrelation(_points,
-					  point,
-					  _correlationModel,
-					  valueDimension);
+      toolbox::ScratchArena & arena = 
+	toolbox::ScratchArena::getThreadArena();
+      toolbox::ScratchArena::Scope scratchScope(arena);
 
-      //
-      // compute interpolant value at point
-      //
+      double * Xs = arena.allocate<double>(valueDimension*regressionDimension);
+      double * r  = arena.allocate<double>(size*valueDimension);
 
-      const Vector interpolatedValueVector = 
-	mult(Xs, _AZ[valueId]) + mult(r, _BZ[valueId], true);
+      evaluateModelData(Xs,
+			r,
+			point,
+			_points,
+			_regressionModel,
+			_correlationModel,
+			valueDimension,
+			regressionDimension);
 
       //
-      // update timer record
+      // compute interpolant values at point
       //
 
-      _timeRecorder.update();
+      for (int valueId = 0; valueId < numberValues; ++valueId)
+	computeValue(values + valueId*valueDimension,
+		     Xs,
+		     r,
+		     _AZ[valueId],
+		     _BZ[valueId],
+		     valueDimension,
+		     regressionDimension,
+		     size);
 
       //
       // 
       //
 
-      return interpolatedValueVector;
+      return;
 
     }
 
     //
-    // get (estimated) interpolation error
+    // get (estimated) interpolation error of all values at a point into
+    // a buffer
     //
 
-    Value
-    MultivariateDerivativeKrigingModel::getMeanSquaredError(int           valueId,
-							    const Point & point) const
+    void
+    MultivariateDerivativeKrigingModel::getMeanSquaredErrorAll(double      * errors,
+							       const Point & point) const
     {
 
-      //
-      // firewalls
-      //
+      computeMeanSquaredErrors(errors,
+			       point,
+			       &(_sigmaSqr[0]),
+			       getNumberValues());
 
-      assert(_isValid == true);
+      return;
 
-      //
-      // get the size of Value; since we include the value of the
-      // function as well as the gradient the size should equal to the
-      // space dimension plus 1
-      //
+    }
 
-      const int valueDimension = getValueDimension();
+    //
+    // compute the mean squared errors for numberValues values with
+    // given sigma^2 factors; all temporaries are drawn from the
+    // scratch arena of the calling thread
+    //
+
+    void
+    MultivariateDerivativeKrigingModel::computeMeanSquaredErrors(double       * errors,
+								 const Point  & point,
+								 const double * sigmaSqr,
+								 int            numberValues) const
+    {
 
       //
-      // evaluate RegressionModel at point
+      // firewalls
       //
 
-      const Matrix Xs = _regressionModel->getValues(point);
+      assert(_isValid == true);
 
       //
-      // compute CorrelationModel at point
+      // get dimensions
       //
 
-      const Matrix r = computeCorrelation(_points,
-					  point,
-					  _correlationModel,
-					  valueDimension);
+      const int valueDimension      = getValueDimension();
+      const int regressionDimension = _matrixInverseVX.ncols();
+      const int size                = getNumberPoints()*valueDimension;
 
       //
-      // compute  u = Xs0 - Transpose[r].VInverse.X
+      // evaluate RegressionModel and CorrelationModel at point
       //
 
-      const Matrix u = Xs - mult(r,
-				 _matrixInverseVX,
-				 true,
-				 false);
+      toolbox::ScratchArena & arena = 
+	toolbox::ScratchArena::getThreadArena();
+      toolbox::ScratchArena::Scope scratchScope(arena);
 
-      //
-      // get self-correlation
-      //
+      double * Xs          = 
+	arena.allocate<double>(valueDimension*regressionDimension);
+      double * r           = arena.allocate<double>(size*valueDimension);
+      double * errorVector = arena.allocate<double>(valueDimension);
 
-      const Matrix sigma = _correlationModel->getValue(point,
-						       point);
+      evaluateModelData(Xs,
+			r,
+			point,
+			_points,
+			_regressionModel,
+			_correlationModel,
+			valueDimension,
+			regressionDimension);
 
       //
       // compute the error estimate
       //
 
-      Vector uRow(u.ncols());
-      Vector rColumn(r.nrows());
-      Vector errorVector(valueDimension);
-      
-      for (int i = 0; i < valueDimension; ++i) {
-
-	//
-	// initialize with the self correlation term
-	//
-
-	errorVector[i] = sigma[i][i];
-
-	//
-	// add u.(XVX)^-1.u^T contribution
-	//
-
-	getRow(uRow,
-	       u,
-	       i);
-	       
-	errorVector[i] += dot(uRow, 
-			      mult(_matrixInverseXVX, uRow));
-	
-	//
-	// add r^T V^-1 r contribution
-	//
-	
-	getColumn(rColumn,
-		  r,
-		  i);
-	
-	errorVector[i] -= dot(rColumn,
-			      mult(_matrixInverseV, rColumn));
-
-	//
-	// apply self-correlation
-	//
-
-	errorVector[i] *= _sigmaSqr[valueId];
-
-      }
+      computeUnscaledMeanSquaredError(errorVector,
+				      point,
+				      Xs,
+				      r,
+				      _correlationModel,
+				      _choleskyV,
+				      _choleskyXVX,
+				      _matrixInverseVX,
+				      valueDimension,
+				      size);
 
       //
-      // update timer record
+      // apply self-correlation for each value
       //
 
-      _timeRecorder.update();
-
+      for (int valueId = 0; valueId < numberValues; ++valueId)
+	for (int i = 0; i < valueDimension; ++i)
+	  errors[valueId*valueDimension + i] = 
+	    errorVector[i]*sigmaSqr[valueId];
 
       //
       //
       //
 
-      return errorVector;
+      return;
 
-    }  
+    }
 
     //
     // divide the current DerivativeKrigingModel to create two smaller
@@ -1550,7 +1775,8 @@ namespace MPTCOUPLER {
       //
 
       MultivariateDerivativeKrigingModel childKrigingModel(_regressionModel,
-							   _correlationModel);
+							   _correlationModel,
+							   _storeFactoredState);
 
       //
       // iterate over all points; the equation of the plane splitting
@@ -1606,6 +1832,7 @@ namespace MPTCOUPLER {
 
       _points = points;
       _values = values;
+      resetCenter();
       build();
 
       //
@@ -1623,8 +1850,9 @@ namespace MPTCOUPLER {
     }
 
     //
-    // output object data to database; store only point-value pairs and
-    // rely in the getFromDatabase() to properly build the model
+    // output object data to database; store point-value pairs and,
+    // unless disabled, the factored state so that getFromDatabase()
+    // can restore the model without rebuilding it
     //
 
     void
@@ -1724,6 +1952,13 @@ namespace MPTCOUPLER {
 		   _correlationModel->getClassName());
 
       _correlationModel->putToDatabase(db);
+
+      //
+      // store factored state
+      //
+
+      if (_storeFactoredState == true)
+	putFactoredStateToDatabase(db);
 	
       //
       //
@@ -1733,6 +1968,145 @@ namespace MPTCOUPLER {
 
     }
 
+    //
+    // output the factored state to database; _AZ and _BZ are stored
+    // value after value in a single array each
+    //
+
+    void
+    MultivariateDerivativeKrigingModel::putFactoredStateToDatabase(toolbox::Database & db) const
+    {
+
+      const int regressionDimension = _matrixInverseVX.ncols();
+
+      db.putInteger(factoredStateVersionKey, factoredStateVersion);
+
+      db.putDoubleArray(choleskyVKey, _choleskyV);
+      db.putDoubleArray(absColumnSumsVKey, _absColumnSumsV);
+      db.putDoubleArray(choleskyXVXKey, _choleskyXVX);
+
+      db.putInteger(regressionDimensionKey, regressionDimension);
+      db.putDoubleArray(matrixInverseVXKey,
+			_matrixInverseVX.data(),
+			_matrixInverseVX.nrows()*regressionDimension);
+
+      std::vector<double> allAZData;
+      std::vector<double> allBZData;
+
+      for (std::vector<Vector>::size_type i = 0; i < _AZ.size(); ++i) {
+
+	allAZData.insert(allAZData.end(),
+			 _AZ[i].begin(),
+			 _AZ[i].end());
+	allBZData.insert(allBZData.end(),
+			 _BZ[i].begin(),
+			 _BZ[i].end());
+
+      }
+
+      db.putDoubleArray(azKey, allAZData);
+      db.putDoubleArray(bzKey, allBZData);
+      db.putDoubleArray(sigmaSqrKey, _sigmaSqr);
+
+      //
+      //
+      //
+
+      return;
+
+    }
+
+    //
+    // restore the factored state from database; return false, leaving
+    // the factored state untouched, if the database holds no factored
+    // state, a stale version of it or one inconsistent with the points
+    // and values of the model
+    //
+
+    bool
+    MultivariateDerivativeKrigingModel::getFactoredStateFromDatabase(toolbox::Database & db)
+    {
+
+      if (_points.empty() == true ||
+	  db.keyExists(factoredStateVersionKey) == false ||
+	  db.getInteger(factoredStateVersionKey) != factoredStateVersion)
+	return false;
+
+      //
+      // expected sizes
+      //
+
+      const int numberValues        = getNumberValues();
+      const int size                = getNumberPoints()*getValueDimension();
+      const int regressionDimension = db.getInteger(regressionDimensionKey);
+
+      if (regressionDimension != 
+	  _regressionModel->getDimension(_points.front()).second())
+	return false;
+
+      //
+      // read the arrays
+      //
+
+      std::vector<double> choleskyV;
+      std::vector<double> absColumnSumsV;
+      std::vector<double> choleskyXVX;
+      std::vector<double> allInverseVXData;
+      std::vector<double> allAZData;
+      std::vector<double> allBZData;
+      std::vector<double> sigmaSqr;
+
+      db.getDoubleArray(choleskyVKey, choleskyV);
+      db.getDoubleArray(absColumnSumsVKey, absColumnSumsV);
+      db.getDoubleArray(choleskyXVXKey, choleskyXVX);
+      db.getDoubleArray(matrixInverseVXKey, allInverseVXData);
+      db.getDoubleArray(azKey, allAZData);
+      db.getDoubleArray(bzKey, allBZData);
+      db.getDoubleArray(sigmaSqrKey, sigmaSqr);
+
+      if (choleskyV.size() != size*(size + 1)/2 ||
+	  absColumnSumsV.size() != size ||
+	  choleskyXVX.size() != regressionDimension*(regressionDimension + 1)/2 ||
+	  allInverseVXData.size() != size*regressionDimension ||
+	  allAZData.size() != numberValues*regressionDimension ||
+	  allBZData.size() != numberValues*size ||
+	  sigmaSqr.size() != numberValues)
+	return false;
+
+      //
+      // install the factored state
+      //
+
+      _choleskyV.swap(choleskyV);
+      _absColumnSumsV.swap(absColumnSumsV);
+      _choleskyXVX.swap(choleskyXVX);
+      _sigmaSqr.swap(sigmaSqr);
+
+      _matrixInverseVX = Matrix(size, regressionDimension);
+      std::copy(allInverseVXData.begin(),
+		allInverseVXData.end(),
+		_matrixInverseVX.data());
+
+      _AZ.clear();
+      _BZ.clear();
+
+      for (int iValue = 0; iValue < numberValues; ++iValue) {
+
+	_AZ.push_back(Vector(regressionDimension,
+			     &(allAZData[iValue*regressionDimension])));
+	_BZ.push_back(Vector(size,
+			     &(allBZData[iValue*size])));
+
+      }
+
+      //
+      //
+      //
+
+      return true;
+
+    }
+
     //
     // fill in the object from Database
     //
@@ -1796,6 +2170,7 @@ namespace MPTCOUPLER {
 		    &(allPointData[i*pointDimension]));
 	
 	_points.push_back(point);
+	addCenterPoint(point);
 	
 	//
 	// get values coresponding to point data
@@ -1870,10 +2245,23 @@ namespace MPTCOUPLER {
       _correlationModel->getFromDatabase(db);
 
       //
-      // rebuild model
+      // select kernels specialized for the point dimension, if any
       //
 
-      build();
+      _regressionModel->selectFixedDimensionKernels(getPointDimension());
+      _correlationModel->selectFixedDimensionKernels(getPointDimension());
+
+      //
+      // restore the factored state if present and current; rebuild
+      // the model otherwise
+      //
+
+      if (getFactoredStateFromDatabase(db) == true) {
+
+	_isValid = true;
+
+      } else
+	build();
 
       //
       //
@@ -1946,56 +2334,25 @@ namespace MPTCOUPLER {
       }
 
       //
-      // _matrixX
-      //
-
-      packMatrix(packedContainer,
-		 _matrixX);
-      
-      //
-      // _matrixInverseV
-      //
-      
-      packMatrix(packedContainer,
-		 _matrixInverseV);
-
-      //
-      // _matrixInverseXVX
-      //
-
-      packMatrix(packedContainer,
-		 _matrixInverseXVX);
-      
-      //
-      // _matrixInverseVX
-      //
-
-      packMatrix(packedContainer,
-		 _matrixInverseVX);
-
-      //
-      // _AZ
+      // _choleskyV; the remaining value-independent and all
+      // value-dependent data are derived from the factor in unpack()
       //
 
-      packVectorVector(packedContainer,
-		       _AZ);
-      
-      //
-      // _BZ
-      //
+      packedContainer.push_back(_choleskyV.size());
 
-      packVectorVector(packedContainer,
-		       _BZ);
+      packedContainer.insert(packedContainer.end(),
+			     _choleskyV.begin(),
+			     _choleskyV.end());
 
       //
-      // _sigmaSqr
+      // _absColumnSumsV
       //
 
-      packedContainer.push_back(_sigmaSqr.size());
+      packedContainer.push_back(_absColumnSumsV.size());
       
       packedContainer.insert(packedContainer.end(),
-			     _sigmaSqr.begin(),
-			     _sigmaSqr.end());
+			     _absColumnSumsV.begin(),
+			     _absColumnSumsV.end());
 
       //
       // regression model
@@ -2059,6 +2416,7 @@ namespace MPTCOUPLER {
 
       _points.clear();
       _values.clear();
+      resetCenter();
 
       _points.reserve(numberPoints);
       _points.reserve(numberPoints);
@@ -2083,6 +2441,7 @@ namespace MPTCOUPLER {
 	//
 
 	_points.push_back(point);
+	addCenterPoint(point);
 
 	//
 	// instantiate values
@@ -2119,58 +2478,28 @@ namespace MPTCOUPLER {
       }
 	
       //
-      // unpack _matrixX
-      //
-      
-      _matrixX = unpackMatrix(packedContainer,
-			      currentOffset);
-
-      //
-      // unpack _matrixInverseV
-      //
-
-      _matrixInverseV = unpackMatrix(packedContainer,
-				     currentOffset);
-
-      //
-      // unpack _matrixInverseXVX
-      //
-
-      _matrixInverseXVX = unpackMatrix(packedContainer,
-				       currentOffset);
-
-      //
-      // unpack _matrixInverseVX
-      //
-
-      _matrixInverseVX = unpackMatrix(packedContainer,
-				      currentOffset);
-
-      //
-      // unpack _AZ
+      // unpack _choleskyV
       //
 
-      _AZ = unpackVectorVector(packedContainer,
-			       currentOffset);
+      const int choleskyVSize = (int)packedContainer[currentOffset++];
 
-      //
-      // unpack _BZ
-      //
+      _choleskyV = 
+	std::vector<double>(&(packedContainer[currentOffset]),
+			    &(packedContainer[currentOffset + choleskyVSize]));
 
-      _BZ = unpackVectorVector(packedContainer,
-			       currentOffset);
+      currentOffset += choleskyVSize;
 
       //
-      // unpack _sigmaSqr
+      // unpack _absColumnSumsV
       //
 
-      const int sigmaSqrSize = (int)packedContainer[currentOffset++];
+      const int absColumnSumsVSize = (int)packedContainer[currentOffset++];
 
-      _sigmaSqr = 
+      _absColumnSumsV = 
 	std::vector<double>(&(packedContainer[currentOffset]),
-			    &(packedContainer[currentOffset + sigmaSqrSize]));
+			    &(packedContainer[currentOffset + absColumnSumsVSize]));
 
-      currentOffset += sigmaSqrSize;
+      currentOffset += absColumnSumsVSize;
 
       //
       // unpack regression model
@@ -2200,12 +2529,18 @@ namespace MPTCOUPLER {
 	DerivativeCorrelationModelFactory().build(correlationClassId,
 						  thetas);
 
+      //
+      // select kernels specialized for the point dimension, if any
+      //
+
+      _regressionModel->selectFixedDimensionKernels(getPointDimension());
+      _correlationModel->selectFixedDimensionKernels(getPointDimension());
 
       //
-      // make valid
+      // compute the derived data; this makes the model valid
       //
 
-      _isValid = true;
+      buildFromFactor();
 
       //
       //
@@ -2262,14 +2597,20 @@ namespace MPTCOUPLER {
       // arrays
       //
 
-      outputStream << "matrixX: " << std::endl;
-      outputStream << krigingModel._matrixX << std::endl;
+      outputStream << "choleskyV: " << std::endl;
+      for (std::vector<double>::size_type i = 0; 
+	   i < krigingModel._choleskyV.size(); ++i)
+	outputStream << krigingModel._choleskyV[i] << " ";
+      outputStream << std::endl;
 
-      outputStream << "matrixInverseV: " << std::endl;
-      outputStream << krigingModel._matrixInverseV << std::endl;
+      outputStream << "choleskyXVX: " << std::endl;
+      for (std::vector<double>::size_type i = 0; 
+	   i < krigingModel._choleskyXVX.size(); ++i)
+	outputStream << krigingModel._choleskyXVX[i] << " ";
+      outputStream << std::endl;
 
-      outputStream << "matrixInverseXVX: " << std::endl;
-      outputStream << krigingModel._matrixInverseXVX << std::endl;
+      outputStream << "matrixInverseVX: " << std::endl;
+      outputStream << krigingModel._matrixInverseVX << std::endl;
 
       //
       // firewalls
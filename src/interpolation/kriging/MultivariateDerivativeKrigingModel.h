@@ -98,8 +98,16 @@ namespace MPTCOUPLER {
       // construction
       //
 
+      /*!
+       * @param storeFactoredState If true, putToDatabase() stores the
+       *        factored state of the model along with its points and
+       *        values so that getFromDatabase() can restore the model
+       *        without rebuilding it.
+       */
+
       MultivariateDerivativeKrigingModel(const RegressionModelPointer  & regressionModel,
-					 const CorrelationModelPointer & correlationModel);
+					 const CorrelationModelPointer & correlationModel,
+					 bool storeFactoredState = true);
       ~MultivariateDerivativeKrigingModel();
 
       //
@@ -200,6 +208,12 @@ namespace MPTCOUPLER {
        */
 
       virtual bool isValid() const;
+
+      //
+      // estimate memory held by the model
+      //
+
+      virtual std::size_t getMemorySize() const;
        
       //
       // interpolate value at a point
@@ -215,6 +229,32 @@ namespace MPTCOUPLER {
       virtual Value getMeanSquaredError(int           valueId, 
 					const Point & point) const;
 
+      //
+      // interpolate all values at a point
+      //
+
+      virtual std::vector<Value> interpolateAll(const Point & point) const;
+
+      //
+      // estimate error of all values at a point
+      //
+
+      virtual std::vector<Value> getMeanSquaredErrorAll(const Point & point) const;
+
+      //
+      // interpolate all values at a point into a buffer
+      //
+
+      virtual void interpolateAll(double      * values,
+				  const Point & point) const;
+
+      //
+      // estimate error of all values at a point into a buffer
+      //
+
+      virtual void getMeanSquaredErrorAll(double      * errors,
+					  const Point & point) const;
+
       //
       // divide the current model to create two smaller models
       //
@@ -254,6 +294,33 @@ namespace MPTCOUPLER {
 
       void build();
 
+      //
+      // build the model from the Cholesky factor of the correlation
+      // matrix; all other value-independent and value-dependent data
+      // are derived from the factor
+      //
+
+      void buildFromFactor();
+
+      //
+      // store/restore the factored state, i.e. all data computed by
+      // build(); restoring fails if the stored state is missing, of
+      // a different version or does not match the points and values
+      //
+
+      void putFactoredStateToDatabase(toolbox::Database & db) const;
+      bool getFactoredStateFromDatabase(toolbox::Database & db);
+
+      //
+      // compute the mean squared errors at a point for numberValues
+      // values given their sigma^2 factors
+      //
+
+      void computeMeanSquaredErrors(double       * errors,
+				    const Point  & point,
+				    const double * sigmaSqr,
+				    int            numberValues) const;
+
       //
       // data
       //
@@ -262,6 +329,7 @@ namespace MPTCOUPLER {
 
     private:
       bool                                                    _isValid;
+      bool                                                    _storeFactoredState;
     
       //
       // points and values
@@ -271,12 +339,13 @@ namespace MPTCOUPLER {
       std::vector<std::vector<Value> >                        _values;
     
       //
-      // value-independent data
+      // value-independent data; Cholesky factors are lower triangular
+      // and packed by rows
       //
 
-      Matrix                                                  _matrixX;
-      Matrix                                                  _matrixInverseV;
-      Matrix                                                  _matrixInverseXVX;
+      std::vector<double>                                     _choleskyV;
+      std::vector<double>                                     _absColumnSumsV;
+      std::vector<double>                                     _choleskyXVX;
       Matrix                                                  _matrixInverseVX;
 
       //
@@ -64,10 +64,12 @@ namespace MPTCOUPLER {
     //
 
     MultivariateDerivativeKrigingModelFactory::MultivariateDerivativeKrigingModelFactory(const RegressionModelPointer  & regressionModel,
-								     const CorrelationModelPointer & correlationModel) :
+								     const CorrelationModelPointer & correlationModel,
+								     bool storeFactoredState) :
       InterpolationModelFactory("MPTCOUPLER::krigalg::MultivariateDerivativeKrigingModel"),
       _regressionModel(regressionModel),
-      _correlationModel(correlationModel)
+      _correlationModel(correlationModel),
+      _storeFactoredState(storeFactoredState)
     {
 
       return;
@@ -94,10 +96,28 @@ namespace MPTCOUPLER {
     {
 
       return MultivariateDerivativeKrigingModelPtr(new  MultivariateDerivativeKrigingModel(_regressionModel,
-											   _correlationModel));
+											   _correlationModel,
+											   _storeFactoredState));
       
     }
 
+    //
+    // select kernels specialized for a point dimension
+    //
+
+    bool
+    MultivariateDerivativeKrigingModelFactory::selectFixedDimensionKernels(int pointDimension)
+    {
+
+      const bool regressionSelected = 
+	_regressionModel->selectFixedDimensionKernels(pointDimension);
+      const bool correlationSelected = 
+	_correlationModel->selectFixedDimensionKernels(pointDimension);
+
+      return regressionSelected && correlationSelected;
+
+    }
+
   }
 }
 
@@ -75,10 +75,13 @@ namespace MPTCOUPLER {
        * 
        * @param regressionModel A pointer to a regression model to be used.
        * @param correlationModel A pointer to a crorrelation model to be used.
+       * @param storeFactoredState If true, the models built store their
+       *        factored state in the database.
        */
 
       MultivariateDerivativeKrigingModelFactory(const RegressionModelPointer  & regressionModel,
-						const CorrelationModelPointer & correlationModel);
+						const CorrelationModelPointer & correlationModel,
+						bool storeFactoredState = true);
 
       /*!
        * @brief Destructor.
@@ -94,6 +97,19 @@ namespace MPTCOUPLER {
       
       virtual InterpolationModelPtr build() const;
 
+      /*!
+       * @brief Select kernels specialized for a point dimension in the
+       * regression and correlation models shared by the models built.
+       *
+       * @param pointDimension Dimension of the points of all models
+       *        built.
+       *
+       * @return true if both models have specialized kernels for the
+       *         point dimension.
+       */
+
+      virtual bool selectFixedDimensionKernels(int pointDimension);
+
       //
       // data
       //
@@ -102,6 +118,7 @@ namespace MPTCOUPLER {
 
       RegressionModelPointer  _regressionModel;
       CorrelationModelPointer _correlationModel;
+      bool                    _storeFactoredState;
 
     };
 
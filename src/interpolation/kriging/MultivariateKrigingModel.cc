@@ -60,6 +60,7 @@ advertising or product endorsement purposes.
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <iterator>
 #include <limits>
@@ -89,6 +90,62 @@ namespace MPTCOUPLER {
       const std::string regressionModelClassNameKey("regression_model_class_name");
       const std::string correlationModelClassNameKey("correlation_model_class_name");
 
+      //
+      // number of bytes held on the heap by model data
+      //
+
+      inline std::size_t
+      getDataMemorySize(double)
+      {
+
+	return 0;
+
+      }
+
+      inline std::size_t
+      getDataMemorySize(const Vector & vector)
+      {
+
+	return vector.size()*sizeof(double);
+
+      }
+
+      inline std::size_t
+      getDataMemorySize(const Matrix & matrix)
+      {
+
+	return matrix.nrows()*matrix.ncols()*sizeof(double);
+
+      }
+
+      template <typename T>
+      std::size_t
+      getDataMemorySize(const std::vector<T> & data)
+      {
+
+	std::size_t memorySize = data.size()*sizeof(T);
+
+	for (typename std::vector<T>::size_type i = 0; i < data.size(); ++i)
+	  memorySize += getDataMemorySize(data[i]);
+
+	return memorySize;
+
+      }
+
+      //
+      // diagonal shift regularizing the row of the correlation matrix
+      // belonging to a point to alleviate possible poor conditioning;
+      // the shift of a point depends only on its position so the rows
+      // of existing points do not change when a point is appended
+      //
+
+      inline double
+      getRegularization(int pointIndex)
+      {
+
+	return (11.0 + pointIndex)*std::numeric_limits<double>::epsilon();
+
+      }
     
       //
       // construct correlation matrix for all points in the model
@@ -151,13 +208,11 @@ namespace MPTCOUPLER {
 	}
 
 	//
-	// regularize the correlation matrix to alleviate possible poor
-	// conditioning
+	// regularize
 	//
 
 	for (int i = 0; i < numberPoints; ++i)
-	  V[i][i] += (10.0 + numberPoints)*
-	    std::numeric_limits<double>::epsilon();
+	  V[i][i] += getRegularization(i);
       
 	return V;
 
@@ -885,60 +940,21 @@ namespace MPTCOUPLER {
       }
       
       //
-      // Check if for the current collection of points their
-      // correlation matrix is well conditioned. Well conditioned
-      // matrix is indicated by true and poorly conditioned matrix by
-      // false.
+      // compute the sums of absolute values of the entries in each
+      // column of a matrix; the 1-norm is the largest of them
       //
 
-      inline bool
-      checkCorrelationMatrixConditionNumber(const Point              & point,
-					    const std::vector<Point> & _points,
-					    CorrelationModelPointer  & _correlationModel,
-					    int pointDimension)
+      std::vector<double>
+      computeAbsColumnSums(const Matrix & matrix)
       {
 
-	//
-	// construct correlation matrix for all points in the model
-	//
-    
-	std::vector<Point> pointsCopy(_points.begin(),
-				      _points.end());
-	pointsCopy.push_back(point);
+	std::vector<double> absColumnSums(matrix.ncols(), 0.0);
 
-	const Matrix V = createCorrelationMatrix(pointsCopy,
-						 _correlationModel,
-						 pointDimension,
-						 pointsCopy.size());
+	for (int i = 0; i < matrix.nrows(); ++i)
+	  for (int j = 0; j < matrix.ncols(); ++j)
+	    absColumnSums[j] += std::fabs(matrix[i][j]);
 
-	//
-	// compute the inverse of V
-	//
-    
-	std::pair<Matrix, bool> inverseData = inverse(V);
-
-	//
-	// should inversion fail return false
-	//
-	if (inverseData.second == false)
-	  return false;
-
-	const Matrix matrixInverseV = inverseData.first;
-
-	//
-	// get the condition number for V 
-	//
-
-	const double vConditionNumber = 
-	  mtl::one_norm(V)*mtl::one_norm(matrixInverseV);
-
-	const double maxConditionNumber = 1.0e10;
-	
-	if (vConditionNumber > maxConditionNumber)
-	  return false;
-
-	
-	return true;
+	return absColumnSums;
 
       }
 
@@ -1091,10 +1107,7 @@ namespace MPTCOUPLER {
 	// check if insertion of a point would cause conditioning problems
 	//
 
-	if (checkCorrelationMatrixConditionNumber(point,
-						  _points,
-						  _correlationModel,
-						  getPointDimension()) == false)
+	if (extendCorrelationFactor(point) == false)
 	  return false;
 	
 	//
@@ -1102,6 +1115,7 @@ namespace MPTCOUPLER {
 	//
 	
 	_points.push_back(point);
+	addCenterPoint(point);
 	_values.push_back(values);
 
 	//
@@ -1117,10 +1131,7 @@ namespace MPTCOUPLER {
 	// to be inserted
 	//
 	
-	if (checkCorrelationMatrixConditionNumber(point,
-						  _points,
-						  _correlationModel,
-						  getPointDimension()) == false)
+	if (extendCorrelationFactor(point) == false)
 	  return false;
 
 
@@ -1129,6 +1140,7 @@ namespace MPTCOUPLER {
 	//
 	
 	_points.push_back(point);
+	addCenterPoint(point);
 	_values.push_back(values);
 	
 	//
@@ -1281,30 +1293,28 @@ namespace MPTCOUPLER {
       _correlationModel->setThetas(std::vector<double>(1, theta));
 #endif 
       //
-      // construct correlation matrix for all points in the model
+      // factor the correlation matrix for all points in the model
+      // unless addPoint() has already extended the factor
       //
-    
-      const Matrix V = createCorrelationMatrix(_points,
-					       _correlationModel,
-					       pointDimension,
-					       numberPoints);
+
+      if (_choleskyV.size() != numberPoints*(numberPoints + 1)/2)
+	factorCorrelationMatrix();
 
       //
-      // compute the inverse of V
+      // compute the inverse of V = L L^T from its factor: X = L^{-T}
+      // solves X L^T = I and V^{-1} = X X^T
       //
-    
-      std::pair<Matrix, bool> inverseData = inverse(V);
 
-      assert(inverseData.second == true);
-      _matrixInverseV = inverseData.first;
+      Matrix inverseLTranspose = identity(numberPoints);
 
-      //
-      // get the condition number for V 
-      //
+      solvePackedLowerTriangular(_choleskyV,
+				 inverseLTranspose,
+				 false);
 
-//       std::cout << "Condition number: " 
-// 		<< mtl::one_norm(V)*mtl::one_norm(_matrixInverseV) 
-// 		<< std::endl;
+      _matrixInverseV = mult(inverseLTranspose,
+			     inverseLTranspose,
+			     false,
+			     true);
     
       //
       // get values of RegressionModel at all points
@@ -1388,6 +1398,157 @@ namespace MPTCOUPLER {
 
     }
 
+    //
+    // factor the correlation matrix for all points in the model and
+    // store the column sums of V for the estimate of its condition
+    // number when the model is extended
+    //
+
+    void
+    MultivariateKrigingModel::factorCorrelationMatrix()
+    {
+
+      const int numberPoints = getNumberPoints();
+
+      _choleskyV.clear();
+      _absColumnSumsV.clear();
+
+      if (numberPoints == 0)
+	return;
+
+      //
+      // construct correlation matrix for all points in the model
+      //
+    
+      const Matrix V = createCorrelationMatrix(_points,
+					       _correlationModel,
+					       getPointDimension(),
+					       numberPoints);
+
+      //
+      // compute the Cholesky factor of V
+      //
+    
+      const std::pair<Matrix, bool> choleskyData = cholesky(V);
+
+      assert(choleskyData.second == true);
+      _choleskyV = packLowerTriangular(choleskyData.first);
+
+      _absColumnSumsV = computeAbsColumnSums(V);
+
+      //
+      //
+      //
+
+      return;
+
+    }
+
+    //
+    // extend the factor of the correlation matrix by a point; the
+    // correlation matrix of the extended model is
+    //
+    //     | V   c |            | L    0 |
+    //     | c^T d |  with factor | w^T  l |
+    //
+    // where w = L^{-1} c and l^2 = d - w^T w, so only the correlation
+    // between the new point and the model points is computed and the
+    // condition number of the extended matrix is estimated from the
+    // factor at O(n^2) cost; the factor is left unchanged if the point
+    // is rejected
+    //
+
+    bool
+    MultivariateKrigingModel::extendCorrelationFactor(const Point & point)
+    {
+
+      const int numberPoints = getNumberPoints();
+
+      if (_choleskyV.size() != numberPoints*(numberPoints + 1)/2)
+	factorCorrelationMatrix();
+
+      //
+      // compute c and d and update the column sums of V to get its
+      // 1-norm
+      //
+
+      Vector w(numberPoints);
+
+      const double d = (_correlationModel->getValue(point,
+						    point))[0][0] +
+	getRegularization(numberPoints);
+
+      std::vector<double> absColumnSumsV(_absColumnSumsV);
+      absColumnSumsV.push_back(std::fabs(d));
+
+      for (int i = 0; i < numberPoints; ++i) {
+
+	w[i] = (_correlationModel->getValue(_points[i],
+					    point))[0][0];
+
+	absColumnSumsV[i]            += std::fabs(w[i]);
+	absColumnSumsV[numberPoints] += std::fabs(w[i]);
+
+      }
+
+      const double normV = *std::max_element(absColumnSumsV.begin(),
+					     absColumnSumsV.end());
+
+      //
+      // compute w and the Schur complement d - w^T w; a non-positive
+      // complement means that the extended correlation matrix is not
+      // positive definite
+      //
+
+      if (numberPoints > 0)
+	solvePackedLowerTriangular(_choleskyV,
+				   w,
+				   false);
+
+      const double schurComplement = d - dot(w, w);
+
+      if (schurComplement <= 0.0)
+	return false;
+
+      //
+      // assemble the factor of the extended correlation matrix; with
+      // the factor packed by rows this amounts to appending the row
+      // [w^T l]
+      //
+
+      std::vector<double> choleskyV;
+      choleskyV.reserve((numberPoints + 1)*(numberPoints + 2)/2);
+
+      choleskyV.insert(choleskyV.end(),
+		       _choleskyV.begin(),
+		       _choleskyV.end());
+
+      for (int i = 0; i < numberPoints; ++i)
+	choleskyV.push_back(w[i]);
+
+      choleskyV.push_back(std::sqrt(schurComplement));
+
+      //
+      // get the condition number for V from the factor
+      //
+
+      const double maxConditionNumber = 1.0e10;
+	
+      if (choleskyReciprocalCondition(choleskyV,
+				      normV)*maxConditionNumber < 1.0)
+	return false;
+
+      _choleskyV.swap(choleskyV);
+      _absColumnSumsV.swap(absColumnSumsV);
+
+      //
+      //
+      //
+
+      return true;
+
+    }
+
     //
     // check if model is valid
     //
@@ -1400,6 +1561,29 @@ namespace MPTCOUPLER {
 
     }
 
+    //
+    // estimate memory held by the model
+    //
+
+    std::size_t
+    MultivariateKrigingModel::getMemorySize() const
+    {
+
+      return sizeof(*this) +
+	getDataMemorySize(_points) +
+	getDataMemorySize(_values) +
+	getDataMemorySize(_choleskyV) +
+	getDataMemorySize(_absColumnSumsV) +
+	getDataMemorySize(_matrixX) +
+	getDataMemorySize(_matrixInverseV) +
+	getDataMemorySize(_matrixInverseXVX) +
+	getDataMemorySize(_matrixInverseVX) +
+	getDataMemorySize(_AZ) +
+	getDataMemorySize(_BZ) +
+	getDataMemorySize(_sigmaSqr);
+
+    }
+
     //
     // interpolate value at a point
     //
@@ -1649,6 +1833,9 @@ namespace MPTCOUPLER {
 
       _points = points;
       _values = values;
+      resetCenter();
+      _choleskyV.clear();
+      _absColumnSumsV.clear();
       build();
 
       //
@@ -1826,6 +2013,7 @@ namespace MPTCOUPLER {
 		    &(allPointData[i*pointDimension]));
 	
 	_points.push_back(point);
+	addCenterPoint(point);
 	
 	//
 	// get values coresponding to point data
@@ -1903,6 +2091,8 @@ namespace MPTCOUPLER {
       // rebuild model
       //
       
+      _choleskyV.clear();
+      _absColumnSumsV.clear();
       build();
 
       //
@@ -2088,6 +2278,9 @@ namespace MPTCOUPLER {
 
       _points.clear();
       _values.clear();
+      resetCenter();
+      _choleskyV.clear();
+      _absColumnSumsV.clear();
 
       _points.reserve(numberPoints);
       _points.reserve(numberPoints);
@@ -2112,6 +2305,7 @@ namespace MPTCOUPLER {
 	//
 
 	_points.push_back(point);
+	addCenterPoint(point);
 
 	//
 	// instantiate values
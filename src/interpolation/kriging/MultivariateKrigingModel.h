@@ -181,6 +181,14 @@ namespace MPTCOUPLER {
 
       virtual bool isValid() const;
 
+      /*!
+       * Estimate the memory held by the model.
+       *
+       * @return number of bytes.
+       */
+
+      virtual std::size_t getMemorySize() const;
+
       /*!
        * Interpolate value at a point.
        *
@@ -240,6 +248,19 @@ namespace MPTCOUPLER {
 
       void build();
 
+      //
+      // factor the correlation matrix of all points in the model
+      //
+
+      void factorCorrelationMatrix();
+
+      //
+      // extend the factor of the correlation matrix by a point unless
+      // this makes the matrix poorly conditioned
+      //
+
+      bool extendCorrelationFactor(const Point & point);
+
       //
       // data
       //
@@ -257,9 +278,12 @@ namespace MPTCOUPLER {
       std::vector<std::vector<Value> >                        _values;
     
       //
-      // value-independent data
+      // value-independent data; the Cholesky factor of the
+      // correlation matrix is lower triangular and packed by rows
       //
 
+      std::vector<double>                                     _choleskyV;
+      std::vector<double>                                     _absColumnSumsV;
       Matrix                                                  _matrixX;
       Matrix                                                  _matrixInverseV;
       Matrix                                                  _matrixInverseXVX;
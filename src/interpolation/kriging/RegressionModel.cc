@@ -79,6 +79,40 @@ namespace MPTCOUPLER {
 
   }
 
+  //
+  // write the values of the regression model into a buffer; generic
+  // implementation copying the result of getValues()
+  //
+
+  void
+  RegressionModel::getValueBlock(double      * values,
+				 int           leadingDimension,
+				 const Point & point) const
+  {
+
+    const Matrix regressionValues = getValues(point);
+
+    for (int i = 0; i < regressionValues.nrows(); ++i)
+      for (int j = 0; j < regressionValues.ncols(); ++j)
+	values[i*leadingDimension + j] = regressionValues[i][j];
+
+    return;
+
+  }
+
+  //
+  // select kernels specialized for a point dimension; there are none
+  // in the generic implementation
+  //
+
+  bool
+  RegressionModel::selectFixedDimensionKernels(int pointDimension)
+  {
+
+    return false;
+
+  }
+
   //
   //  database output
   //
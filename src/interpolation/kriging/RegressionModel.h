@@ -86,6 +86,23 @@ namespace MPTCOUPLER {
 
     virtual Matrix    getValues(const Point & point) const = 0;
     virtual Dimension getDimension(const Point & point) const = 0;
+
+    //
+    // write the values of the regression model into a caller-provided
+    // buffer; row i of the values starts at values[i*leadingDimension]
+    //
+
+    virtual void getValueBlock(double      * values,
+			       int           leadingDimension,
+			       const Point & point) const;
+
+    //
+    // select kernels specialized for points of the given dimension
+    // for getValueBlock(); returns false, and the general kernels
+    // remain in use, if there are none
+    //
+
+    virtual bool selectFixedDimensionKernels(int pointDimension);
     
     //
     // Database input/output
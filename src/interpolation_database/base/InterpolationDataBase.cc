@@ -47,6 +47,9 @@ advertising or product endorsement purposes.
 
 #include "InterpolationDataBase.h"
 
+#include <algorithm>
+#include <cassert>
+
 //
 //
 //
@@ -111,6 +114,85 @@ namespace MPTCOUPLER {
       
     }
 
+    //
+    // Compute interpolated values at a batch of points; the default
+    // implementation simply forwards to interpolate() point by point.
+    //
+
+    std::vector<bool>
+    InterpolationDataBase::interpolateBatch(double            * values,
+					    int               * hints,
+					    const double      * points,
+					    int                 numberPoints,
+					    std::vector<bool> & flags)
+    {
+
+      //
+      // make sure there is enough space in flags
+      //
+
+      assert(static_cast<int>(flags.size()) >= numberPoints*NUMBER_FLAGS);
+
+      std::vector<bool> success(numberPoints, false);
+      std::vector<bool> pointFlags(NUMBER_FLAGS);
+
+      for (int iPoint = 0; iPoint < numberPoints; ++iPoint) {
+
+	success[iPoint] = interpolate(values + iPoint*_valueDimension,
+				      hints[iPoint],
+				      points + iPoint*_pointDimension,
+				      pointFlags);
+
+	std::copy(pointFlags.begin(),
+		  pointFlags.end(),
+		  flags.begin() + iPoint*NUMBER_FLAGS);
+
+      }
+
+      return success;
+
+    }
+
+    //
+    // Insert a batch of point-value pairs; the default implementation
+    // simply forwards to insert() point by point.
+    //
+
+    void
+    InterpolationDataBase::insertBatch(int               * hints,
+				       const double      * points,
+				       const double      * values,
+				       const double      * gradients,
+				       int                 numberPoints,
+				       std::vector<bool> & flags)
+    {
+
+      //
+      // make sure there is enough space in flags
+      //
+
+      assert(static_cast<int>(flags.size()) >= numberPoints*NUMBER_FLAGS);
+
+      std::vector<bool> pointFlags(NUMBER_FLAGS);
+
+      for (int iPoint = 0; iPoint < numberPoints; ++iPoint) {
+
+	insert(hints[iPoint],
+	       points + iPoint*_pointDimension,
+	       values + iPoint*_valueDimension,
+	       gradients + iPoint*_pointDimension*_valueDimension,
+	       pointFlags);
+
+	std::copy(pointFlags.begin(),
+		  pointFlags.end(),
+		  flags.begin() + iPoint*NUMBER_FLAGS);
+
+      }
+
+      return;
+
+    }
+
   }
 }
 
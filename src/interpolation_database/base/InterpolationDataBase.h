@@ -224,8 +224,62 @@ namespace MPTCOUPLER {
 			  int                 numberHints,
 			  bool                forceInsert,
 			  std::vector<bool> & flags) = 0;
-      
-      /*! 
+
+      /*!
+       * Compute interpolated values at a batch of points.
+       *
+       * @param values Pointer for storing the values. Size of at least
+       *               numberPoints*_valueDimension assumed; values for
+       *               point i start at values[i*_valueDimension].
+       * @param hints  Pointer to an array of numberPoints hints, one per
+       *               point. Each hint has the same meaning as in
+       *               interpolate() and may be updated upon return.
+       * @param points Pointer for accessing the point data. Needs to have
+       *               the size of at least numberPoints*_pointDimension.
+       * @param numberPoints Number of points in the batch.
+       * @param flags Handle to a container for storing flags related
+       *              to the inner workings of the interpolation database.
+       *              Needs to have the size of at least
+       *              numberPoints*NUMBER_FLAGS; flags for point i start
+       *              at flags[i*NUMBER_FLAGS].
+       *
+       * @return An STL-vector of numberPoints entries; true if the
+       *         interpolation at the corresponding point was successful,
+       *         false otherwise.
+       */
+      virtual std::vector<bool> interpolateBatch(double            * values,
+						 int               * hints,
+						 const double      * points,
+						 int                 numberPoints,
+						 std::vector<bool> & flags);
+
+      /*!
+       * Insert a batch of point-value pairs into the database.
+       *
+       * @param hints  Pointer to an array of numberPoints hints, one per
+       *               point. Upon return hints[i] contains the hint
+       *               of the model point i has been inserted into.
+       * @param points Pointer to point data. Needs to have the size of
+       *               at least numberPoints*_pointDimension.
+       * @param values Pointer to value data. Needs to have the size of
+       *               at least numberPoints*_valueDimension.
+       * @param gradients Pointer to gradient data. Needs to have the size
+       *                  of at least
+       *                  numberPoints*_pointDimension*_valueDimension.
+       * @param numberPoints Number of points in the batch.
+       * @param flags Handle to a container for storing flags related
+       *              to the inner workings of the interpolation database.
+       *              Needs to have the size of at least
+       *              numberPoints*NUMBER_FLAGS.
+       */
+      virtual void insertBatch(int               * hints,
+			       const double      * points,
+			       const double      * values,
+			       const double      * gradients,
+			       int                 numberPoints,
+			       std::vector<bool> & flags);
+
+      /*!
        * Get the point dimension
        *
        * @return Dimensionality of the point space.
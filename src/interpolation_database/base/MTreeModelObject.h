@@ -59,6 +59,12 @@ namespace MPTCOUPLER {
        * here.
        */
       ostream & print(ostream & stream) const;
+
+      /*!
+       * @brief Concrete virtual method to return number of bytes of
+       * memory held by the object and its model.
+       */
+      size_t getMemorySize() const;
       
       /*!
        * @brief Get a copy of the model object.
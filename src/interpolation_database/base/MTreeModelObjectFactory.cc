@@ -15,6 +15,8 @@
 #include "kriging/DerivativeRegressionModelFactory.h"
 #include "kriging/MultivariateDerivativeKrigingModel.h"
 
+#include <cassert>
+
 namespace MPTCOUPLER {
   namespace krigcpl {
 
@@ -73,5 +75,37 @@ namespace MPTCOUPLER {
       return mtreedb::MTreeObjectPtr(krigingModelObjectPtr);
     }
 
+    //
+    // Allocate generic interpolation model; the model factory supplies
+    // a model of the concrete class, which is then filled from the
+    // database
+    //
+
+    template<>
+    mtreedb::MTreeObjectPtr 
+    MTreeModelObjectFactory<krigalg::InterpolationModel>::allocateObject(toolbox::Database& db) const
+    {
+
+      //
+      // firewall
+      //
+
+      assert(_modelFactory);
+
+      //
+      // instantiate new model and read its contents from database
+      //
+
+      krigalg::InterpolationModelPtr modelPtr = _modelFactory->build();
+
+      modelPtr->getFromDatabase(db);
+
+      //
+      // return MTreeObjectPtr
+      // 
+
+      return mtreedb::MTreeObjectPtr(new MTreeKrigingModelObject(modelPtr));
+    }
+
   }
 }
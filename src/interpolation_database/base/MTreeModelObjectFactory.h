@@ -15,6 +15,7 @@
 #endif
 
 #include "kriging/MultivariateDerivativeKrigingModel.h"
+#include "base/InterpolationModelFactory.h"
 
 #include <mtreedb/MTreeObject.h>
 #include <mtreedb/MTreeObjectFactory.h>
@@ -34,9 +35,15 @@ namespace MPTCOUPLER {
       
       /*!
        * @brief Constructor.
+       *
+       * @param modelFactory Factory of the models read from the 
+       *                     database; used only by the factory of 
+       *                     generic interpolation models, which cannot
+       *                     otherwise tell the concrete model class.
        */
 
-      MTreeModelObjectFactory();
+      explicit MTreeModelObjectFactory(const krigalg::InterpolationModelFactoryPointer & modelFactory = 
+				       krigalg::InterpolationModelFactoryPointer());
       
       /*!
        * @brief Destructor
@@ -59,6 +66,8 @@ namespace MPTCOUPLER {
       MTreeModelObjectFactory(const MTreeModelObjectFactory&);
       void operator=(const MTreeModelObjectFactory&);
 
+      krigalg::InterpolationModelFactoryPointer _modelFactory;
+
     };
 
     //
@@ -66,6 +75,8 @@ namespace MPTCOUPLER {
     //
     template<> mtreedb::MTreeObjectPtr 
       MTreeModelObjectFactory<krigalg::MultivariateDerivativeKrigingModel>::allocateObject(toolbox::Database& db) const;
+    template<> mtreedb::MTreeObjectPtr 
+      MTreeModelObjectFactory<krigalg::InterpolationModel>::allocateObject(toolbox::Database& db) const;
 
   }
 }
@@ -99,6 +99,18 @@ public:
     */
    void getFromDatabase(toolbox::Database& db);
 
+   /*!
+    * Return number of coordinates of the response point.  The distance
+    * between response points is the Euclidean distance between their 
+    * coordinates.
+    */
+   int getNumberCoordinates() const;
+
+   /*!
+    * Return pointer to contiguous coordinates of the response point.
+    */
+   const double* getCoordinates() const;
+
    /*!
     * Print response point object data to the specified output stream.
     */
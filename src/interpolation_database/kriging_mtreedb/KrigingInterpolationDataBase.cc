@@ -57,7 +57,10 @@ advertising or product endorsement purposes.
 #include <mtreedb/MTreeNode.h>
 #include <mtreedb/MTreeObject.h>
 #include <mtreedb/MTreeObjectFactory.h>
+#include <mtreedb/VPTree.h>
 
+#include <toolbox/base/MemoryUtilities.h>
+#include <toolbox/base/ScratchArena.h>
 #include <toolbox/database/HDFDatabase.h>
 
 #include <mtl/mtl.h>
@@ -79,6 +82,7 @@ advertising or product endorsement purposes.
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <memory>
 #include <functional>
 
 #ifndef DEBUG
@@ -106,6 +110,114 @@ namespace MPTCOUPLER {
       //
       typedef MTreeModelObjectFactory<InterpolationModel> MTreeKrigingModelObjectFactory;
 
+      //
+      // add the heap allocations made by the calling thread during
+      // the lifetime of the object to a counter; nothing is counted
+      // unless compiled with COUNT_HEAP_ALLOCATIONS. Only the
+      // outermost of nested counters counts so that lookups calling
+      // other lookups are counted once.
+      //
+
+      thread_local int heapAllocationCounterDepth = 0;
+
+      class HeapAllocationCounter {
+
+      public:
+	explicit HeapAllocationCounter(std::atomic<long> & total)
+	  : _total(total),
+	    _start(heapAllocationCounterDepth++ == 0 ?
+		   toolbox::MemoryUtilities::getNumberHeapAllocations() : -1)
+	{
+	  return;
+	}
+
+	~HeapAllocationCounter()
+	{
+	  --heapAllocationCounterDepth;
+	  if (_start >= 0)
+	    _total.fetch_add(toolbox::MemoryUtilities::getNumberHeapAllocations() - _start,
+			     std::memory_order_relaxed);
+	  return;
+	}
+
+      private:
+	HeapAllocationCounter(const HeapAllocationCounter &);
+	void operator=(const HeapAllocationCounter &);
+
+	std::atomic<long> & _total;
+	const long          _start;
+
+      };
+
+      //
+      // get the query point of the calling thread set to the given
+      // coordinates; the point is reused by lookups so that it is
+      // allocated once per thread and point dimension. It holds the
+      // coordinates until the next call on the same thread.
+      //
+
+      const ResponsePoint &
+      getThreadQueryPoint(int            pointDimension,
+			  const double * point)
+      {
+
+	static thread_local std::unique_ptr<ResponsePoint> queryPoint;
+
+	if (queryPoint == NULL ||
+	    static_cast<int>(queryPoint->size()) != pointDimension)
+	  queryPoint.reset(new ResponsePoint(pointDimension));
+
+	for (int i = 0; i < pointDimension; ++i)
+	  (*queryPoint)[i] = point[i];
+
+	return *queryPoint;
+
+      }
+
+      //
+      // search results container of the calling thread reused by the
+      // model searches of lookups so that its storage is allocated
+      // once per thread; the results are dropped when the object goes
+      // out of scope so that they do not keep models in
+      // memory. Containers of the same thread may not be in use at
+      // the same time.
+      //
+
+      class ThreadSearchResults {
+
+      public:
+	ThreadSearchResults()
+	  : _searchResults(getContainer())
+	{
+	  assert(_searchResults.empty());
+	  return;
+	}
+
+	~ThreadSearchResults()
+	{
+	  _searchResults.clear();
+	  return;
+	}
+
+	std::vector<MTreeSearchResult> & get()
+	{
+	  return _searchResults;
+	}
+
+      private:
+	ThreadSearchResults(const ThreadSearchResults &);
+	void operator=(const ThreadSearchResults &);
+
+	static std::vector<MTreeSearchResult> & getContainer()
+	{
+	  static thread_local std::vector<MTreeSearchResult> searchResults;
+	  return searchResults;
+	}
+
+	std::vector<MTreeSearchResult> & _searchResults;
+
+      };
+
       struct KrigingModelChooser : 
 	std::unary_function<MPTCOUPLER::mtreedb::MTreeObjectPtr, bool> {
 	
@@ -134,13 +246,13 @@ namespace MPTCOUPLER {
 	  const int krigingModelId = mTreeObject.getObjectId();
 
 	  //
-	  // get kriging model time
+	  // get epoch of last kriging model access
 	  //
 
 	  const TimeRecorder modelTime = krigingModelPointer->getTime();
 
 	  //
-	  // get current time
+	  // get current epoch
 	  //
 
 	  const TimeRecorder currentTime;
@@ -149,7 +261,7 @@ namespace MPTCOUPLER {
 	  // compute difference
 	  //
 
-	  const int timeDiff = currentTime.diff(modelTime);
+	  const long timeDiff = currentTime.diff(modelTime);
 
 	  //
 	  // firewall on timeDiff
@@ -175,6 +287,106 @@ namespace MPTCOUPLER {
 
       };
 
+      //
+      // kriging model in memory considered for eviction
+      //
+
+      struct ResidentModel {
+	int         modelId;
+	long        age;
+	std::size_t memorySize;
+      };
+
+      //
+      // least recently used models first; models last accessed in the
+      // same epoch in order of creation
+      //
+
+      struct LeastRecentlyUsed {
+
+	bool operator()(const ResidentModel & lhs,
+			const ResidentModel & rhs) const
+	{
+
+	  if (lhs.age != rhs.age)
+	    return lhs.age > rhs.age;
+
+	  return lhs.modelId < rhs.modelId;
+
+	}
+
+      };
+
+      //
+      // predicate recording the kriging models it is applied to; it
+      // chooses none of them
+      //
+
+      struct ResidentModelCollector {
+	
+	ResidentModelCollector(std::vector<ResidentModel> & residentModels) 
+	  : _residentModels(&residentModels)
+	{
+	  return;
+	}
+
+	bool operator()(MPTCOUPLER::mtreedb::MTreeObjectPtr objectPtr) const
+	{
+
+	  const MTreeKrigingModelObject & mTreeObject = 
+	    dynamic_cast<const MTreeKrigingModelObject &>(*objectPtr);
+
+	  ResidentModel residentModel;
+	  residentModel.modelId    = mTreeObject.getObjectId();
+	  residentModel.age        = 
+	    _currentTime.diff(mTreeObject.getModel()->getTime());
+	  residentModel.memorySize = mTreeObject.getMemorySize();
+
+	  _residentModels->push_back(residentModel);
+
+	  return false;
+
+	}
+
+	std::vector<ResidentModel> * _residentModels;
+	TimeRecorder                 _currentTime;
+
+      };
+
+      //
+      // predicate choosing the kriging models with ids in a sorted
+      // list
+      //
+
+      struct ModelIdChooser {
+	
+	ModelIdChooser(const std::vector<int> & modelIds) 
+	  : _modelIds(modelIds)
+	{
+	  return;
+	}
+
+	bool operator()(MPTCOUPLER::mtreedb::MTreeObjectPtr objectPtr) const
+	{
+
+	  return std::binary_search(_modelIds.begin(),
+				    _modelIds.end(),
+				    objectPtr->getObjectId());
+
+	}
+
+	const std::vector<int> & _modelIds;
+
+      };
+
+      //
+      // percentage of the model memory budget the models in memory
+      // are reduced to once they exceed the budget; the slack keeps
+      // every insertion from triggering an eviction
+      //
+
+      const int modelEvictionTargetPercent = 90;
+
 #if 0
       class MTreeKrigingModelObjectFactory : public MTreeObjectFactory
       {
@@ -269,7 +481,7 @@ namespace MPTCOUPLER {
 
       std::pair<int, InterpolationModelPtr>
       findClosestCoKrigingModel(const ResponsePoint & point,
-				MTree               & krigingModels,
+				MetricIndex         & krigingModels,
 				double                maxQueryPointModelDistance)
       {
 
@@ -283,11 +495,21 @@ namespace MPTCOUPLER {
 	// query tree for the closest model
 	//
 
-	std::vector<MTreeSearchResult> searchResults;
+	ThreadSearchResults threadSearchResults;
+	std::vector<MTreeSearchResult> & searchResults = 
+	  threadSearchResults.get();
 	
+	//
+	// results share the query point and the tree points rather than
+	// copying them; they are cleared when threadSearchResults goes
+	// out of scope, before the query point can be reused
+	//
+
 	krigingModels.searchKNN(searchResults,
 				point,
-				1);
+				1,
+				false,
+				true);
 
 
 	//
@@ -365,21 +587,31 @@ namespace MPTCOUPLER {
       }
 
       //
-      // compute kriging error at a point; the issue here is that if the
-      // kriging model contains a single point then the error will
-      // naturally be computed as zero; if this is the case we will try to
-      // estimate the error wrt a constant function
+      // compute kriging error at a point for all values; the issue
+      // here is that if the kriging model contains a single point then
+      // the error will naturally be computed as zero; if this is the
+      // case we will try to estimate the error wrt a constant function;
+      // errors needs to have the size of at least the number of values
+      // of the model; temporaries are drawn from the scratch arena of
+      // the calling thread
       //
 
-      double
-      compKrigingError(const InterpolationModel & krigingModel,
-		       const Point              & queryPoint,
-		       int                        valueId,
-		       double                     meanErrorFactor)
+      void
+      compKrigingErrors(double                   * errors,
+			const InterpolationModel & krigingModel,
+			const Point              & queryPoint,
+			double                     meanErrorFactor)
       {
 
 	const int numberPoints = krigingModel.getNumberPoints();
 
+	//
+	// evaluating the model does not record accesses, so record the
+	// access of the candidate here
+	//
+
+	krigingModel.recordAccess();
+
 	//
 	// firewalls
 	//
@@ -394,6 +626,13 @@ namespace MPTCOUPLER {
 	const int minNumberPoints = krigingModel.hasGradient() ? 1 : 
 	  2*(krigingModel.getPointDimension() + 1) - 1;
 
+	const int numberValues   = krigingModel.getNumberValues();
+	const int valueDimension = krigingModel.getValueDimension();
+
+	toolbox::ScratchArena & arena = 
+	  toolbox::ScratchArena::getThreadArena();
+	toolbox::ScratchArena::Scope scratchScope(arena);
+
 	//
 	// compute the error if the kriging model contains a single point;
 	// otherwise, simply return the kriging prediction
@@ -402,46 +641,50 @@ namespace MPTCOUPLER {
 	if (numberPoints <= minNumberPoints ) {
 
 	  //
-	  // get the kriging estimate at query point
+	  // get the kriging estimates at query point and at the origin
+	  // of the kriging model
 	  //
 
-	  const Value queryValue = krigingModel.interpolate(valueId,
-							    queryPoint);
-      
-	  //
-	  // get all points in the model; there should really only be
-	  // ONE if we have gradient information
-	  //
-      
+	  double * queryValues  = 
+	    arena.allocate<double>(numberValues*valueDimension);
+	  double * originValues = 
+	    arena.allocate<double>(numberValues*valueDimension);
+
+	  krigingModel.interpolateAll(queryValues,
+				      queryPoint);
+
 	  const std::vector<Point> & points = krigingModel.getPoints();
 	  assert( krigingModel.hasGradient() ? (points.size() == 1) : true );
 
-	  //
-	  // get the kriging estimate at the origin of the kriging model
-	  //
-
-	  const Value originValue = 
-	    krigingModel.interpolate(valueId,
-				     points.front());
+	  krigingModel.interpolateAll(originValues,
+				      points.front());
 
 	  //
 	  // compute the error as the difference between the value at the
 	  // queryPoint and origin point
 	  //
-      
-	  return (queryValue[0] - originValue[0])*
-	    (queryValue[0] - originValue[0]);
 
+	  for (int i = 0; i < numberValues; ++i) {
+	    const double difference = queryValues[i*valueDimension] - 
+	      originValues[i*valueDimension];
+	    errors[i] = difference*difference;
+	  }
 
-	} else 
-	  return meanErrorFactor*meanErrorFactor*
-	    krigingModel.getMeanSquaredError(valueId, queryPoint)[0];
+	} else {
 
-	//
-	// can never be reached
-	//
-    
-	return 0.0;
+	  double * meanSquaredErrors = 
+	    arena.allocate<double>(numberValues*valueDimension);
+
+	  krigingModel.getMeanSquaredErrorAll(meanSquaredErrors,
+					      queryPoint);
+
+	  for (int i = 0; i < numberValues; ++i)
+	    errors[i] = meanErrorFactor*meanErrorFactor*
+	      meanSquaredErrors[i*valueDimension];
+
+	}
+
+	return;
     
       }
 
@@ -459,28 +702,35 @@ namespace MPTCOUPLER {
 
 	double maxError = 0.0;
 
+	//
+	// compute the error estimates
+	//
+
+	assert(krigingModel->getNumberValues() == valueDimension);
+
+	toolbox::ScratchArena & arena = 
+	  toolbox::ScratchArena::getThreadArena();
+	toolbox::ScratchArena::Scope scratchScope(arena);
+
+	double * errorEstimates = arena.allocate<double>(valueDimension);
+
+	compKrigingErrors(errorEstimates,
+			  *krigingModel, 
+			  queryPoint,
+			  _meanErrorFactor);
+
 	//
 	// iterate over values
 	//
 
 	for (int iValue = 0; iValue < valueDimension; ++iValue) {
 	  
-	  //
-	  // compute the error estimate
-	  //
-		  
-	  const double errorEstimate = 
-	    compKrigingError(*krigingModel, 
-			     queryPoint,
-			     iValue,
-			     _meanErrorFactor);
-	  
 	  //
 	  // save error
 	  //
 
 	  maxError = std::max(maxError,
-			      errorEstimate);
+			      errorEstimates[iValue]);
 
 
 	}
@@ -502,27 +752,34 @@ namespace MPTCOUPLER {
 
 	double maxError = 0.0;
 
+	//
+	// compute the error estimates
+	//
+
+	assert(krigingModel->getNumberValues() == valueDimension);
+
+	toolbox::ScratchArena & arena = 
+	  toolbox::ScratchArena::getThreadArena();
+	toolbox::ScratchArena::Scope scratchScope(arena);
+
+	double * errorEstimates = arena.allocate<double>(valueDimension);
+
+	compKrigingErrors(errorEstimates,
+			  *krigingModel, 
+			  queryPoint,
+			  _meanErrorFactor);
+
 	//
 	// iterate over values
 	//
 
 	for (int iValue = 0; iValue < valueDimension; ++iValue) {
 	  
-	  //
-	  // compute the error estimate
-	  //
-		  
-	  const double errorEstimate = 
-	    compKrigingError(*krigingModel, 
-			     queryPoint,
-			     iValue,
-			     _meanErrorFactor);
-	  
 	  //
 	  // save error
 	  //
 
-	  maxError += errorEstimate;
+	  maxError += errorEstimates[iValue];
 
 	}
 
@@ -560,7 +817,7 @@ namespace MPTCOUPLER {
       std::pair<int, InterpolationModelPtr>
       findBestCoKrigingModel(bool                & canInterpolateFlag,
 			     const ResponsePoint & point,
-			     MTree               & krigingModels,
+			     MetricIndex         & krigingModels,
 			     double                tolerance,
 			     double                meanErrorFactor,
 			     double                maxQueryPointModelDistance,
@@ -574,11 +831,15 @@ namespace MPTCOUPLER {
 	// query the tree for the maxNumberSearchModels closest models
 	//
 
-	std::vector<MTreeSearchResult> searchResults;
+	ThreadSearchResults threadSearchResults;
+	std::vector<MTreeSearchResult> & searchResults = 
+	  threadSearchResults.get();
 	
 	krigingModels.searchKNN(searchResults,
 				point,
-				maxNumberSearchModels);
+				maxNumberSearchModels,
+				false,
+				true);
 
 	//
 	// short-circuit if an empty kriging models list encountered
@@ -674,7 +935,7 @@ namespace MPTCOUPLER {
       std::pair<int, InterpolationModelPtr>
       findBestCoKrigingModelv1(bool                & canInterpolateFlag,
 			       const ResponsePoint & point,
-			       MTree               & krigingModels,
+			       MetricIndex         & krigingModels,
 			       double                tolerance,
 			       const InterpolationModelFactoryPointer & _modelFactory,
 			       double                meanErrorFactor,
@@ -690,11 +951,15 @@ namespace MPTCOUPLER {
 	// query the tree for the maxNumberSearchModels closest models
 	//
 
-	std::vector<MTreeSearchResult> searchResults;
+	ThreadSearchResults threadSearchResults;
+	std::vector<MTreeSearchResult> & searchResults = 
+	  threadSearchResults.get();
 	
 	krigingModels.searchKNN(searchResults,
 				point,
-				maxNumberSearchModels);
+				maxNumberSearchModels,
+				false,
+				true);
 
 	//
 	// short-circuit if an empty kriging models list encountered
@@ -838,7 +1103,7 @@ namespace MPTCOUPLER {
       std::pair<int, InterpolationModelPtr>
       findBestCoKrigingModelv2(bool                & canInterpolateFlag,
 			       const ResponsePoint & point,
-			       MTree               & krigingModels,
+			       MetricIndex         & krigingModels,
 			       const InterpolationModelFactoryPointer & _modelFactory,
 			       double                tolerance,
 			       double                meanErrorFactor,
@@ -854,11 +1119,15 @@ namespace MPTCOUPLER {
 	// query the tree for the maxNumberSearchModels closest models
 	//
 
-	std::vector<MTreeSearchResult> searchResults;
+	ThreadSearchResults threadSearchResults;
+	std::vector<MTreeSearchResult> & searchResults = 
+	  threadSearchResults.get();
 	
 	krigingModels.searchKNN(searchResults,
 				point,
-				maxNumberSearchModels);
+				maxNumberSearchModels,
+				false,
+				true);
 
 	//
 	// short-circuit if an empty kriging models list encountered
@@ -1013,16 +1282,50 @@ namespace MPTCOUPLER {
 
       }
 
+      //
+      // order search results by the distance from the query point to
+      // the support of the model, i.e. the distance to the model
+      // center less the model extent; ties are broken by position in
+      // the container of search results, which keeps results with
+      // equal support distances in order of distance to the model
+      // center without the buffer a stable sort allocates
+      //
+
+      struct SupportDistanceLess {
+
+	static double 
+	supportDistance(const MTreeSearchResult & result)
+	{
+	  return std::max(0.0, 
+			  result.getDistanceToQueryPoint() - 
+			  result.getDataObjectRadius());
+	}
+
+	bool operator()(const MTreeSearchResult * a,
+			const MTreeSearchResult * b) const
+	{
+	  const double aDistance = supportDistance(*a);
+	  const double bDistance = supportDistance(*b);
+	  return aDistance < bDistance ||
+	    (aDistance == bDistance && a < b);
+	}
+
+      };
+
       std::pair<int, InterpolationModelPtr>
       findBestCoKrigingModel(bool                & canInterpolateFlag,
 			     const ResponsePoint & point,
-			     MTree               & krigingModels,
+			     MetricIndex         & krigingModels,
 			     double                tolerance,
 			     double                meanErrorFactor,
 			     double                maxQueryPointModelDistance,
 			     int                   maxNumberSearchModels,
 			     int                   maxKrigingModelSize,
-			     int                   valueDimension)
+			     int                   valueDimension,
+			     double                searchErrorFactor,
+			     int                   maxSearchDistanceCount,
+			     std::atomic<int>    & numberSearches,
+			     std::atomic<int>    & numberSearchHits)
       {
 
 	typedef std::list<MTreeSearchResult> SearchResultContainer;
@@ -1037,15 +1340,26 @@ namespace MPTCOUPLER {
 
 	canInterpolateFlag = false;
 
+	numberSearches.fetch_add(1, std::memory_order_relaxed);
+
 	//
-	// query the tree for the maxNumberSearchModels closest models
+	// query the tree for the maxNumberSearchModels closest models;
+	// the candidates only need to be close since each one is
+	// subjected to the error check below, so the search may be
+	// approximate
 	//
 
-	std::vector<MTreeSearchResult> searchResults; // SearchResultContainer searchResults;
+	ThreadSearchResults threadSearchResults;
+	std::vector<MTreeSearchResult> & searchResults = 
+	  threadSearchResults.get();
 
-	krigingModels.searchKNN(searchResults,
-				point,
-				maxNumberSearchModels);
+	krigingModels.searchKNNApproximate(searchResults,
+					   point,
+					   maxNumberSearchModels,
+					   searchErrorFactor,
+					   maxSearchDistanceCount,
+					   false,
+					   true);
 	// krigingModels.searchRange(searchResults,
 	// 			  point,
 	// 			  maxQueryPointModelDistance);
@@ -1076,22 +1390,42 @@ namespace MPTCOUPLER {
 	// std::map<double, std::pair<int, InterpolationModelPtr> >
 	//   krigingModelRanking;
 
-	std::vector<MTreeSearchResult>::const_iterator searchResultsIter;
-	const std::vector<MTreeSearchResult>::const_iterator 
-	  searchResultsEnd = searchResults.end();
-	// SearchResultContainer::const_iterator searchResultsIter;
-	// const SearchResultContainer::const_iterator searchResultsEnd =
-	//   searchResults.end();
+	//
+	// check the candidates in order of distance to their supports;
+	// models that already cover the query point come first and are
+	// the most likely to pass the error check
+	//
 
-	for (searchResultsIter  = searchResults.begin();
-	     searchResultsIter != searchResultsEnd;
-	     ++searchResultsIter) {
+	toolbox::ScratchArena::Scope 
+	  scratchScope(toolbox::ScratchArena::getThreadArena());
+
+	typedef std::vector<const MTreeSearchResult *,
+	  toolbox::ScratchAllocator<const MTreeSearchResult *> > CandidateContainer;
+
+	CandidateContainer candidates;
+	candidates.reserve(searchResults.size());
+
+	for (std::vector<MTreeSearchResult>::size_type i = 0; 
+	     i < searchResults.size(); ++i)
+	  candidates.push_back(&(searchResults[i]));
+
+	std::sort(candidates.begin(),
+		  candidates.end(),
+		  SupportDistanceLess());
+
+	CandidateContainer::const_iterator candidatesIter;
+	const CandidateContainer::const_iterator 
+	  candidatesEnd = candidates.end();
+
+	for (candidatesIter  = candidates.begin();
+	     candidatesIter != candidatesEnd;
+	     ++candidatesIter) {
 
 	  //
 	  // get handle to search result
 	  //
 
-	  const MTreeSearchResult & searchResult = *searchResultsIter;
+	  const MTreeSearchResult & searchResult = **candidatesIter;
 
 	  //
 	  // get handle to object
@@ -1114,13 +1448,12 @@ namespace MPTCOUPLER {
 	    continue;
 
 	  //
-	  // skip if too far away; as results come back closest-first, we know
-	  // all of the other results are too far away as well, so can break
-	  // could probably 
+	  // skip if too far away; candidates are not ordered by distance 
+	  // to the model center so the remaining ones still need checking
 	  //
 
 	  if (searchResult.getDistanceToQueryPoint() > maxQueryPointModelDistance)
-	     break;
+	     continue;
 
 	  //
 	  // compute error predicted by mTreeObject
@@ -1140,6 +1473,7 @@ namespace MPTCOUPLER {
 #endif // HAVE_PKG_libprof
 
 	    canInterpolateFlag = true;
+	    numberSearchHits.fetch_add(1, std::memory_order_relaxed);
 	    return std::make_pair(mTreeObject.getObjectId(),
 				  krigingModel);
 
@@ -1201,37 +1535,42 @@ namespace MPTCOUPLER {
 
 	const double toleranceSqr = _tolerance*_tolerance;
 	
-	for (int iValue = 0; iValue < valueDimension; ++iValue) {
-	  
-	  //
-	  // compute the error estimate
-	  //
+	//
+	// compute the error estimates
+	//
 	
-	  
 #ifdef HAVE_PKG_libprof
 	  
-	  ProfileBegin("errEst");
+	ProfileBegin("errEst");
 	  
 #endif // HAVE_PKG_libprof
 	  
-	  const double errorEstimate = 
-	    compKrigingError(*krigingModel, 
-			     queryPoint,
-			     iValue,
-			     _meanErrorFactor);
+	assert(krigingModel->getNumberValues() == valueDimension);
+
+	toolbox::ScratchArena & arena = 
+	  toolbox::ScratchArena::getThreadArena();
+	toolbox::ScratchArena::Scope scratchScope(arena);
+
+	double * errorEstimates = arena.allocate<double>(valueDimension);
+
+	compKrigingErrors(errorEstimates,
+			  *krigingModel, 
+			  queryPoint,
+			  _meanErrorFactor);
 	  
 #ifdef HAVE_PKG_libprof
 	  
-	  ProfileEnd("errEst");
+	ProfileEnd("errEst");
 	  
 #endif // HAVE_PKG_libprof
+
+	//
+	// check the errorEstimates against the tolerance; if any 
+	// estimate is greater than tolerance simpoy return failure
+	//
 	  
-	  //
-	  // check the errorEstimate against the tolerance; if the 
-	  // estimate is greater than tolerance simpoy return failure
-	  //
-	  
-	  if ( errorEstimate > toleranceSqr) {
+	for (int iValue = 0; iValue < valueDimension; ++iValue)
+	  if ( errorEstimates[iValue] > toleranceSqr) {
 	    
 	    return false;
 	    
@@ -1239,41 +1578,37 @@ namespace MPTCOUPLER {
 
 #ifdef HAVE_PKG_libprof
 
-	  ProfileBegin("interpolate");
+	ProfileBegin("interpolate");
 	  
 #endif // HAVE_PKG_libprof
 	  
-	  //
-	  // compute the value
-	  //
-	  
-	  const Value valueEstimate = 
-	    krigingModel->interpolate(iValue,
-				      queryPoint);
+	//
+	// compute the values
+	//
 	  
-	  //
-	  // put the value of the function into value (valueEstimate
-	  // contains the value of the function follwed by the gradient;
-	  // here we are interested only in the value of the function so
-	  // the gradient is simply discarded).
-	  //
+	const int modelValueDimension = krigingModel->getValueDimension();
 
-	  value[iValue] = valueEstimate[0];
+	double * valueEstimates = 
+	  arena.allocate<double>(valueDimension*modelValueDimension);
+
+	krigingModel->interpolateAll(valueEstimates,
+				     queryPoint);
 	  
-	  // 	std::cout << "value id: " << iValue 
-	  // 		  << " error estimate: " << sqrt(errorEstimate) 
-	  // 		  << std::endl;
-	  // 	std::cout << "value id: " << iValue 
-	  // 		  << " value estimate: " << valueEstimate[0]
-	  // 		  << std::endl;
+	//
+	// put the value of the function into value (valueEstimate
+	// contains the value of the function follwed by the gradient;
+	// here we are interested only in the value of the function so
+	// the gradient is simply discarded).
+	//
+
+	for (int iValue = 0; iValue < valueDimension; ++iValue)
+	  value[iValue] = valueEstimates[iValue*modelValueDimension];
 
 #ifdef HAVE_PKG_libprof
 	  
-	  ProfileEnd("interpolate");
+	ProfileEnd("interpolate");
 	  
 #endif // HAVE_PKG_libprof
-	  
-	}
 	
 	//
 	//
@@ -1306,36 +1641,38 @@ namespace MPTCOUPLER {
 
 	const double toleranceSqr = _tolerance*_tolerance;
 
-	for (int iValue = 0; iValue < valueDimension; ++iValue) {
-
 #ifdef HAVE_PKG_libprof
 
-	  ProfileBegin("errEst");
+	ProfileBegin("errEst");
 	
 #endif // HAVE_PKG_libprof
 	
-	  //
-	  // compute the error estimate
-	  //
-	
-	  const double errorEstimate = 
-	    compKrigingError(*krigingModel, 
-			     queryPoint,
-			     iValue,
-			     _meanErrorFactor);
+	assert(krigingModel->getNumberValues() == valueDimension);
+
+	toolbox::ScratchArena & arena = 
+	  toolbox::ScratchArena::getThreadArena();
+	toolbox::ScratchArena::Scope scratchScope(arena);
+
+	double * errorEstimates = arena.allocate<double>(valueDimension);
+
+	compKrigingErrors(errorEstimates,
+			  *krigingModel, 
+			  queryPoint,
+			  _meanErrorFactor);
 
 #ifdef HAVE_PKG_libprof
 
-	  ProfileEnd("errEst");
+	ProfileEnd("errEst");
 
 #endif // HAVE_PKG_libprof
 
-	  //
-	  // check the errorEstimate against the tolerance; if the 
-	  // estimate is greater than tolerance simpoy return failure
-	  //
+	//
+	// check the errorEstimates against the tolerance; if any 
+	// estimate is greater than tolerance simpoy return failure
+	//
 
-	  if ( errorEstimate > toleranceSqr) {
+	for (int iValue = 0; iValue < valueDimension; ++iValue)
+	  if ( errorEstimates[iValue] > toleranceSqr) {
 
 	    return false;
 
@@ -1343,23 +1680,32 @@ namespace MPTCOUPLER {
 
 #ifdef HAVE_PKG_libprof
 
-	  ProfileBegin("interpolate");
+	ProfileBegin("interpolate");
 
 #endif // HAVE_PKG_libprof
 
-	  //
-	  // compute the value
-	  //
+	//
+	// compute the values
+	//
 
-	  const Value valueEstimate = 
-	    krigingModel->interpolate(iValue,
-				      queryPoint);
+	const int modelValueDimension = krigingModel->getValueDimension();
+
+	double * valueEstimates = 
+	  arena.allocate<double>(valueDimension*modelValueDimension);
+
+	krigingModel->interpolateAll(valueEstimates,
+				     queryPoint);
+
+	for (int iValue = 0; iValue < valueDimension; ++iValue) {
 
 	  //
 	  // put the value of the function into value (valueEstimate
 	  // contains the value of the function follwed by the gradient;
 	  //
 
+	  const double * valueEstimate = 
+	    valueEstimates + iValue*modelValueDimension;
+
 	  value[iValue] = valueEstimate[0];
 
 	  //
@@ -1368,16 +1714,15 @@ namespace MPTCOUPLER {
 	  
 	  for (int i = 0; i < pointDimension; ++i)
 	    gradient[i*valueDimension + iValue] = valueEstimate[1 + i];
-	  
+
+	}
 
 #ifdef HAVE_PKG_libprof
 	  
-	  ProfileEnd("interpolate");
+	ProfileEnd("interpolate");
 
 #endif // HAVE_PKG_libprof
 
-	}
-
 	return true;
 
       }
@@ -1403,16 +1748,26 @@ namespace MPTCOUPLER {
 #endif // HAVE_PKG_libprof
 
 
+	//
+	// compute the values
+	//
+
+	assert(krigingModel->getNumberValues() == valueDimension);
+
+	toolbox::ScratchArena & arena = 
+	  toolbox::ScratchArena::getThreadArena();
+	toolbox::ScratchArena::Scope scratchScope(arena);
+
+	const int modelValueDimension = krigingModel->getValueDimension();
+
+	double * valueEstimates = 
+	  arena.allocate<double>(valueDimension*modelValueDimension);
+
+	krigingModel->interpolateAll(valueEstimates,
+				     queryPoint);
+
 	for (int iValue = 0; iValue < valueDimension; ++iValue) {
 
-	  //
-	  // compute the value
-	  //
-	  
-	  const Value valueEstimate = 
-	    krigingModel->interpolate(iValue,
-				      queryPoint);
-	  
 	  //
 	  // put the value of the function into value (valueEstimate
 	  // contains the value of the function follwed by the gradient;
@@ -1420,7 +1775,7 @@ namespace MPTCOUPLER {
 	  // the gradient is simply discarded).
 	  //
 
-	  value[iValue] = valueEstimate[0];
+	  value[iValue] = valueEstimates[iValue*modelValueDimension];
 
 	  
 	}
@@ -1461,21 +1816,30 @@ namespace MPTCOUPLER {
 	//
 	//
 
-	for (int iValue = 0; iValue < valueDimension; ++iValue) {
+	assert(krigingModel->getNumberValues() == valueDimension);
 
-	  //
-	  // compute the value
-	  //
+	toolbox::ScratchArena & arena = 
+	  toolbox::ScratchArena::getThreadArena();
+	toolbox::ScratchArena::Scope scratchScope(arena);
 
-	  const Value valueEstimate = 
-	    krigingModel->interpolate(iValue,
-				      queryPoint);
+	const int modelValueDimension = krigingModel->getValueDimension();
+
+	double * valueEstimates = 
+	  arena.allocate<double>(valueDimension*modelValueDimension);
+
+	krigingModel->interpolateAll(valueEstimates,
+				     queryPoint);
+
+	for (int iValue = 0; iValue < valueDimension; ++iValue) {
 
 	  //
 	  // put the value of the function into value (valueEstimate
 	  // contains the value of the function follwed by the gradient;
 	  //
 
+	  const double * valueEstimate = 
+	    valueEstimates + iValue*modelValueDimension;
+
 	  value[iValue] = valueEstimate[0];
 
 	  //
@@ -1598,7 +1962,7 @@ namespace MPTCOUPLER {
       //
 
       void
-      addNewModel(MTree                   & _krigingModelDB,
+      addNewModel(MetricIndex             & _krigingModelDB,
 		  const InterpolationModelFactoryPointer & _modelFactory,
 		  int          & objectId,
 		  const double * pointData,
@@ -1669,79 +2033,278 @@ namespace MPTCOUPLER {
       }
 
       //
-      // compute center of mass for a kriging model
+      // get center of mass for a kriging model; the model keeps it up
+      // to date as points are added
       //
 
-      Point
+      const Point &
       getModelCenterMass(const InterpolationModel & krigingModel)
       {
 
 	//
-	// get all points in the model
+	// firewall
 	//
 
-	const std::vector<Point> & points = krigingModel.getPoints();
-    
+	assert(krigingModel.getNumberPoints() > 0);
+
+	return krigingModel.getCenterMass();
+
+      }
+
+      //
+      // get the extent of a kriging model, i.e. the largest distance
+      // from its center of mass to a point in the model
+      //
+
+      double
+      getModelRadius(const InterpolationModel & krigingModel)
+      {
+
+	return std::sqrt(krigingModel.getRadiusSqr());
+
+      }
+
+      //
+      // squared distance between a point and a model center; avoids
+      // the temporary of Point subtraction on the hint paths
+      //
+
+      double
+      getDistanceSqr(const Point & point,
+		     const Point & center)
+      {
+
+	const int dimension = center.size();
+
+	double distanceSqr = 0.0;
+
+	for (int i = 0; i < dimension; ++i) {
+	  const double diff = point[i] - center[i];
+	  distanceSqr += diff*diff;
+	}
+
+	return distanceSqr;
+
+      }
+
+      //
+      // move an updated kriging model in the database to its current
+      // center of mass and reset its radius to the current model
+      // extent; objectId is unchanged
+      //
+
+      void
+      updateModelPosition(MetricIndex           & _krigingModelDB,
+			  int                     objectId,
+			  InterpolationModelPtr   krigingModel,
+			  int                     pointDimension)
+      {
+
 	//
-	// firewall
+	// compute the center of mass for the updated model
 	//
 
-	assert(points.empty() == false);
+	const Point & centerMass = getModelCenterMass(*krigingModel);
+
+	const double radius = getModelRadius(*krigingModel);
 
 	//
-	// instantiate center od mass
+	// record the access of the updated model
 	//
 
-	Point centerMass(points.front().size(),
-			 0.0);
+	krigingModel->recordAccess();
 
 	//
-	// iterate over all points
+	// move the kriging model to its new center; the model itself
+	// has been updated in place so the object id stays valid
 	//
-    
-	std::vector<Point>::const_iterator pointsIter;
-	std::vector<Point>::const_iterator pointsEnd = points.end();
-    
-	for (pointsIter  = points.begin();
-	     pointsIter != pointsEnd;
-	     ++pointsIter) {
+
+	const ResponsePoint centerMassRP(pointDimension,
+					 &(centerMass[0]));
+
+	_krigingModelDB.updateObjectPoint(objectId,
+					  centerMassRP,
+					  radius);
+
+	return;
+
+      }
+
+      //
+      // search the database for a kriging model suitable for
+      // interpolation at queryPoint and interpolate if one is found;
+      // hint is set to the id of the model found
+      //
+
+      bool
+      searchAndInterpolate(double              * value,
+			   int                 & hint,
+			   const ResponsePoint & queryPoint,
+			   MetricIndex         & krigingModelDB,
+			   double                tolerance,
+			   double                meanErrorFactor,
+			   double                maxQueryPointModelDistance,
+			   int                   maxNumberSearchModels,
+			   int                   maxKrigingModelSize,
+			   int                   valueDimension,
+			   double                searchErrorFactor,
+			   int                   maxSearchDistanceCount,
+			   std::atomic<int>    & numberSearches,
+			   std::atomic<int>    & numberSearchHits)
+      {
+
+	if (maxNumberSearchModels == 1) {
+
+#ifdef HAVE_PKG_libprof
+
+	  ProfileBegin("interpClosest");
+
+#endif // HAVE_PKG_libprof
+
+	  const std::pair<int, InterpolationModelPtr> 
+	    closestKrigingModelData = findClosestCoKrigingModel(queryPoint,
+								krigingModelDB,
+								maxQueryPointModelDistance);
       
+	  InterpolationModelPtr closestKrigingModel = 
+	    closestKrigingModelData.second;
+	  hint = closestKrigingModelData.first;
+
 	  //
-	  // get Point handle
+	  // if no kriging model is available return
 	  //
-      
-	  const Point & point = *pointsIter;
-      
+
+	  if (hint == MTreeObject::getUndefinedId() || 
+	      closestKrigingModel->isValid() == false) {
+
+#ifdef HAVE_PKG_libprof
+
+	    ProfileEnd("interpClosest");
+
+#endif // HAVE_PKG_libprof
+
+	    return false;
+
+	  }
+
 	  //
-	  // accumulate 
+	  // estimate error for all values from the kriging models
 	  //
       
-	  centerMass += static_cast<Vector>(point);
+	  const bool interpolationSuccess =  
+	    checkErrorAndInterpolate(value,
+				     closestKrigingModel,
+				     queryPoint,
+				     valueDimension,
+				     tolerance,
+				     meanErrorFactor);
+
+#ifdef HAVE_PKG_libprof
+
+	  ProfileEnd("interpClosest");
+
+#endif // HAVE_PKG_libprof
+
+	  return interpolationSuccess;
 
 	}
-    
+
+#ifdef HAVE_PKG_libprof
+
+	ProfileBegin("interpBest");
+
+#endif // HAVE_PKG_libprof
+
 	//
-	// scale
+	// search more than one kriging model
 	//
-    
-	mtl::scale(centerMass, 
-		   1.0/points.size());
+
+	bool canInterpolateFlag;
+
+	const std::pair<int, InterpolationModelPtr> 
+	  bestKrigingModelData = findBestCoKrigingModel(canInterpolateFlag,
+							queryPoint,
+							krigingModelDB,
+							tolerance,
+							meanErrorFactor,
+							maxQueryPointModelDistance,
+							maxNumberSearchModels,
+							maxKrigingModelSize,
+							valueDimension,
+							searchErrorFactor,
+							maxSearchDistanceCount,
+							numberSearches,
+							numberSearchHits);
 	
+	InterpolationModelPtr bestKrigingModel = 
+	  bestKrigingModelData.second;
+	hint = bestKrigingModelData.first;
+
+	//
+	// if no kriging model is available return
 	//
+
+	if (canInterpolateFlag == false) {
+
+#ifdef HAVE_PKG_libprof
+
+	  ProfileEnd("interpBest");
+
+#endif // HAVE_PKG_libprof
+
+	  return false;
+
+	}
+
 	//
+	// interpolate using the best kriging model available
 	//
-    
-	return centerMass;
+
+	MPTCOUPLER::krigcpl::interpolate(value,
+					 bestKrigingModel,
+					 queryPoint,
+					 valueDimension);
+
+#ifdef HAVE_PKG_libprof
+
+	ProfileEnd("interpBest");
+
+#endif // HAVE_PKG_libprof
+
+	return true;
 
       }
 
+      //
+      // order batch entries by hint, and entries with equal hints by
+      // position
+      //
+
+      struct HintLess {
+
+	HintLess(const int * hints) 
+	  : _hints(hints)
+	{
+	  return;
+	}
+
+	bool operator()(int i, int j) const
+	{
+	  return _hints[i] < _hints[j] ||
+	    (_hints[i] == _hints[j] && i < j);
+	}
+
+	const int * _hints;
+
+      };
+
       //
       // print kriging point statistics
       //
 
       inline void
       outputKrigingModelStats(std::ostream          & outputStream,
-			      const mtreedb::MTree  & _krigingModelDB,
+			      const mtreedb::MetricIndex & _krigingModelDB,
 			      int                     maxKrigingModelSize)
       {
 	
@@ -1838,7 +2401,7 @@ namespace MPTCOUPLER {
       //
 
       std::pair<int, int>
-      initializeModelDBFromFile(mtreedb::MTree    & _krigingModelDB,
+      initializeModelDBFromFile(mtreedb::MetricIndex & _krigingModelDB,
 				const InterpolationModelFactoryPointer & _modelFactory,
 				const std::string & directoryName,
 				const std::string & prefix)
@@ -1869,6 +2432,19 @@ namespace MPTCOUPLER {
 
 	int totalNumberPoints = 0;
 
+	//
+	// models, centers and extents are collected first and loaded
+	// into the tree at once
+	//
+
+	std::vector<mtreedb::MTreeObjectPtr> mTreeObjects;
+	std::vector<mtreedb::MTreePointPtr>  modelCenters;
+	std::vector<double>                  modelRadii;
+
+	mTreeObjects.reserve(numberObjects);
+	modelCenters.reserve(numberObjects);
+	modelRadii.reserve(numberObjects);
+
 	//
 	// iterate over all files and read kriging models
 	//
@@ -1967,29 +2543,27 @@ namespace MPTCOUPLER {
 	    // get the center of the kriging model
 	    //
 
-	    Point krigingModelCenter = getModelCenterMass(*krigingModelPtr);
+	    const Point & krigingModelCenter = 
+	      getModelCenterMass(*krigingModelPtr);
+
+	    const double krigingModelRadius = 
+	      getModelRadius(*krigingModelPtr);
 
 	    //
 	    // copy krigingModelCenter into ResponsePoint
 	    //
 
-	    const ResponsePoint point(krigingModelCenter.size(),
-				      &(krigingModelCenter[0]));
-
+	    modelCenters.push_back(mtreedb::MTreePointPtr(
+	      new ResponsePoint(krigingModelCenter.size(),
+				&(krigingModelCenter[0]))));
+	    modelRadii.push_back(krigingModelRadius);
 	    
 	    //
 	    // instantiate MTreeKrigingModelObject
 	    //
 	    
-	    MTreeKrigingModelObject mTreeObject(krigingModelPtr);
-	    
-	    //
-	    // insert model
-	    //
-
-	    _krigingModelDB.insertObject(mTreeObject,
-					 point,
-					 0.0);
+	    mTreeObjects.push_back(mtreedb::MTreeObjectPtr(
+	      new MTreeKrigingModelObject(krigingModelPtr)));
 
 	  }
 
@@ -2001,6 +2575,14 @@ namespace MPTCOUPLER {
 
 	}
 
+	//
+	// build the tree from all models
+	//
+
+	_krigingModelDB.bulkLoad(mTreeObjects,
+				 modelCenters,
+				 modelRadii);
+
 	//
 	// cleanup
 	//
@@ -2137,8 +2719,94 @@ namespace MPTCOUPLER {
 	
       }
 
+      //
+      // create the index structure of the kriging model database; an
+      // MTree keeps the data files of the models it swaps out in the
+      // given directory
+      //
+
+      mtreedb::MetricIndexPtr
+      createModelIndex(KrigingInterpolationDataBase::ModelIndexType modelIndexType,
+		       const std::string & mtreeDirectoryName,
+		       const InterpolationModelFactoryPointer & modelFactory)
+      {
+
+	if (modelIndexType == KrigingInterpolationDataBase::VPTREE_MODEL_INDEX)
+	  return mtreedb::MetricIndexPtr(new mtreedb::VPTree("kriging_model_database"));
+
+	mtreedb::MTree * krigingModelTree = 
+	  new mtreedb::MTree("kriging_model_database",
+			     &(std::cout),
+			     false);
+
+	const mtreedb::MTreeDataStore::ObjectStoreType objectStoreType = 
+	  (modelIndexType == KrigingInterpolationDataBase::MTREE_SEGMENT_MODEL_INDEX) ?
+	  mtreedb::MTreeDataStore::SEGMENT_FILE_OBJECT_STORE :
+	  mtreedb::MTreeDataStore::HDF_FILE_OBJECT_STORE;
+
+	krigingModelTree->initializeCreate(mtreeDirectoryName + "/" 
+					   "kriging_model_database",
+					   "krigcpl",
+					   *(new MTreeKrigingModelObjectFactory(modelFactory)),
+					   objectStoreType);
+      
+	krigingModelTree->setMaxNodeEntries(12);
+
+	return mtreedb::MetricIndexPtr(krigingModelTree);
+
+      }
+
     }
 
+    //
+    // Check the model memory budget at the end of a lookup. Lookups
+    // may read models back from disk with shared access to the model
+    // database; if one did and the models in memory now exceed the
+    // budget, the budget is enforced with exclusive access once the
+    // lookup has released its shared access.
+    //
+
+    class KrigingInterpolationDataBase::LookupBudgetCheck {
+
+    public:
+      explicit LookupBudgetCheck(const KrigingInterpolationDataBase & dataBase)
+	: _dataBase(dataBase),
+	  _pageInCount(getPageInCount(dataBase))
+      {
+	return;
+      }
+
+      ~LookupBudgetCheck()
+      {
+
+	if (_dataBase._modelMemoryBudget == 0 ||
+	    getPageInCount(_dataBase) == _pageInCount ||
+	    _dataBase.getResidentModelBytes() <= _dataBase._modelMemoryBudget)
+	  return;
+
+	toolbox::WriteLockGuard modelDBLock(_dataBase.getModelDBLock());
+
+	_dataBase.enforceModelMemoryBudget();
+
+	return;
+
+      }
+
+    private:
+      LookupBudgetCheck(const LookupBudgetCheck &);
+      void operator=(const LookupBudgetCheck &);
+
+      static int getPageInCount(const KrigingInterpolationDataBase & dataBase)
+      {
+	return dataBase._krigingModelTree == NULL ? 0 :
+	  dataBase._krigingModelTree->getTotalObjectPageInCount();
+      }
+
+      const KrigingInterpolationDataBase & _dataBase;
+      const int _pageInCount;
+
+    };
+
     //
     // construction/destruction
     //
@@ -2153,7 +2821,8 @@ namespace MPTCOUPLER {
 							       double tolerance,
 							       double maxQueryPointModelDistance,
 							       int    agingThreshold,
-							       const std::string & mtreeDirectoryName)
+							       const std::string & mtreeDirectoryName,
+							       ModelIndexType modelIndexType)
       : InterpolationDataBase(pointDimension,
 			      valueDimension),
 	_modelFactory(modelFactory),
@@ -2163,25 +2832,34 @@ namespace MPTCOUPLER {
 	_meanErrorFactor(meanErrorFactor),
 	_tolerance(tolerance),
 	_maxQueryPointModelDistance(maxQueryPointModelDistance),
-	_krigingModelDB("kriging_model_database",
-			&(std::cout),
-			false),
+	_modelSearchErrorFactor(1.0),
+	_maxModelSearchDistanceCount(0),
+	_krigingModelDB(createModelIndex(modelIndexType,
+					 mtreeDirectoryName,
+					 modelFactory)),
+	_krigingModelTree(dynamic_cast<mtreedb::MTree *>(_krigingModelDB.get())),
 	_numberKrigingModels(0),
 	_numberPointValuePairs(0),
-	_agingThreshold(agingThreshold)
+	_numberModelSearches(0),
+	_numberModelSearchHits(0),
+	_numberHintCacheHits(0),
+	_numberHintCacheMisses(0),
+	_numberLookupHeapAllocations(0),
+	_agingThreshold(agingThreshold),
+	_concurrentAccess(false),
+	_backgroundModelIO(false),
+	_modelMemoryBudget(0),
+	_numberModelEvictions(0)
     {
 
       //
-      // construct kriging model tree database
+      // select the kernels specialized for the point dimension of the
+      // database, if there are any; the models fall back to the
+      // general kernels otherwise
       //
 
-      _krigingModelDB.initializeCreate(mtreeDirectoryName + "/" 
-				       "kriging_model_database",
-				       "krigcpl",
-				       *(new MTreeKrigingModelObjectFactory));
-      
-      _krigingModelDB.setMaxNodeEntries(12);
-     
+      _modelFactory->selectFixedDimensionKernels(pointDimension);
+
       return;
       
     }
@@ -2197,7 +2875,8 @@ namespace MPTCOUPLER {
 							       double maxQueryPointModelDistance,
 							       int    agingThreshold,
 							       const std::string & mtreeDirectoryName,
-							       const std::string & fileName)
+							       const std::string & fileName,
+							       ModelIndexType modelIndexType)
       : InterpolationDataBase(pointDimension,
 			      valueDimension,
 			      fileName),
@@ -2208,28 +2887,36 @@ namespace MPTCOUPLER {
 	_meanErrorFactor(meanErrorFactor),
 	_tolerance(tolerance),
 	_maxQueryPointModelDistance(maxQueryPointModelDistance),
-	_krigingModelDB("kriging_model_database",
-			&(std::cout),
-			false),
+	_modelSearchErrorFactor(1.0),
+	_maxModelSearchDistanceCount(0),
+	_krigingModelDB(createModelIndex(modelIndexType,
+					 mtreeDirectoryName,
+					 modelFactory)),
+	_krigingModelTree(dynamic_cast<mtreedb::MTree *>(_krigingModelDB.get())),
 	_numberKrigingModels(0),
 	_numberPointValuePairs(0),
-	_agingThreshold(agingThreshold)
+	_numberModelSearches(0),
+	_numberModelSearchHits(0),
+	_numberHintCacheHits(0),
+	_numberHintCacheMisses(0),
+	_numberLookupHeapAllocations(0),
+	_agingThreshold(agingThreshold),
+	_concurrentAccess(false),
+	_backgroundModelIO(false),
+	_modelMemoryBudget(0),
+	_numberModelEvictions(0)
     {
 
       //
-      // construct kriging model tree database
+      // select the kernels specialized for the point dimension of the
+      // database, if there are any; the models fall back to the
+      // general kernels otherwise
       //
 
-      _krigingModelDB.initializeCreate(mtreeDirectoryName + "/" 
-				       "kriging_model_database",
-				       "krigcpl",
-				       *(new MTreeKrigingModelObjectFactory));
-
-      _krigingModelDB.setMaxNodeEntries(12);
-
+      _modelFactory->selectFixedDimensionKernels(pointDimension);
 
       const std::pair<int, int> kriginigModelsStats =
-	initializeModelDBFromFile(_krigingModelDB,
+	initializeModelDBFromFile(*_krigingModelDB,
 				  _modelFactory,
 				  mtreeDirectoryName,
 				  fileName);
@@ -2237,7 +2924,7 @@ namespace MPTCOUPLER {
       _numberKrigingModels   += kriginigModelsStats.first;
       _numberPointValuePairs += kriginigModelsStats.second;
 
-//       _krigingModelDB.initializeOpen(fileName,
+//       _krigingModelDB->initializeOpen(fileName,
 //  				     "krigcpl",
 //  				     *(new MTreeKrigingModelObjectFactory));
       
@@ -2267,6 +2954,30 @@ namespace MPTCOUPLER {
 					      std::vector<bool> & flags )
     {
 
+      //
+      // enforce the model memory budget once the lookup is done
+      //
+
+      LookupBudgetCheck lookupBudgetCheck(*this);
+
+      //
+      // count heap allocations of the lookup
+      //
+
+      HeapAllocationCounter heapAllocationCounter(_numberLookupHeapAllocations);
+
+      //
+      // lookups share access to the model database
+      //
+
+      toolbox::ReadLockGuard modelDBLock(getModelDBLock());
+
+      //
+      // every lookup advances the access epoch
+      //
+
+      TimeRecorder::advance();
+
       //
       // make sure there is enough space in flags 
       //
@@ -2289,11 +3000,12 @@ namespace MPTCOUPLER {
       const int valueDimension = getValueDimension();
 
       //
-      // instatiate point object from point data
+      // set the query point of the calling thread from point data
       //
 
-      const ResponsePoint queryPoint(pointDimension,
-				     point);
+      const ResponsePoint & queryPoint = 
+	getThreadQueryPoint(pointDimension,
+			    point);
       
 
       //
@@ -2304,7 +3016,8 @@ namespace MPTCOUPLER {
 	  hint != MTreeObject::getUndefinedId()) {
 	
 	const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
-	  _krigingModelDB.getObject(hint);
+	  _krigingModelDB->getObject(hint,
+				     false);
 
 	if (mTreeObjectPtr == NULL) {
 
@@ -2326,10 +3039,9 @@ namespace MPTCOUPLER {
 	    //
 	    // check the distance between hintKrigingModel and point
 	    //
-	    const Point modelCenter = getModelCenterMass(*hintKrigingModel);
-	    const Vector pointRelativePosition = queryPoint - modelCenter;
-	    const double distanceSqr = krigalg::dot(pointRelativePosition,
-						    pointRelativePosition);
+	    const double distanceSqr = 
+	      getDistanceSqr(queryPoint,
+			     getModelCenterMass(*hintKrigingModel));
 
 	    if (distanceSqr > 
 		_maxQueryPointModelDistance*_maxQueryPointModelDistance) {
@@ -2362,153 +3074,54 @@ namespace MPTCOUPLER {
       // Find closest kriging model.
       //
 
+      return searchAndInterpolate(value,
+				  hint,
+				  queryPoint,
+				  *_krigingModelDB,
+				  _tolerance,
+				  _meanErrorFactor,
+				  _maxQueryPointModelDistance,
+				  _maxNumberSearchModels,
+				  _maxKrigingModelSize,
+				  valueDimension,
+				  _modelSearchErrorFactor,
+				  _maxModelSearchDistanceCount,
+				  _numberModelSearches,
+				  _numberModelSearchHits);
 
-      if (_maxNumberSearchModels == 1) {
-
-#ifdef HAVE_PKG_libprof
-
-	ProfileBegin("interpClosest");
-
-#endif // HAVE_PKG_libprof
-
-
-	const std::pair<int, InterpolationModelPtr> 
-	  closestKrigingModelData = findClosestCoKrigingModel(queryPoint,
-							      _krigingModelDB,
-							      _maxQueryPointModelDistance);
-      
-	InterpolationModelPtr closestKrigingModel = 
-	  closestKrigingModelData.second;
-	hint = closestKrigingModelData.first;
-
-	//
-	// if no kriging model is available return
-	//
-
-	if (hint == MTreeObject::getUndefinedId() || 
-	    closestKrigingModel->isValid() == false) {
-
-#ifdef HAVE_PKG_libprof
-
-	  ProfileEnd("interpClosest");
-
-#endif // HAVE_PKG_libprof
-
-	  return false;
-
-	}
-
-	//
-	// estimate error for all values from the kriging models
-	//
-      
-	const bool interpolationSuccess =  
-	  checkErrorAndInterpolate(value,
-				   closestKrigingModel,
-				   queryPoint,
-				   valueDimension,
-				   _tolerance,
-				   _meanErrorFactor);
-
-#ifdef HAVE_PKG_libprof
-
-	ProfileEnd("interpClosest");
-
-#endif // HAVE_PKG_libprof
-
-	return interpolationSuccess;
-
-      } else {
-
-#ifdef HAVE_PKG_libprof
-
-	ProfileBegin("interpBest");
-
-#endif // HAVE_PKG_libprof
-
-	//
-	// search more than one kriging model
-	//
-
-	bool canInterpolateFlag;
-
-	const std::pair<int, InterpolationModelPtr> 
-	  bestKrigingModelData = findBestCoKrigingModel(canInterpolateFlag,
-							queryPoint,
-							_krigingModelDB,
-							_tolerance,
-							_meanErrorFactor,
-							_maxQueryPointModelDistance,
-							_maxNumberSearchModels,
-							_maxKrigingModelSize,
-							valueDimension);
-	
-	InterpolationModelPtr bestKrigingModel = 
-	  bestKrigingModelData.second;
-	hint = bestKrigingModelData.first;
-
-	//
-	// if no kriging model is available return
-	//
-
-	if (canInterpolateFlag == false) {
-
-#ifdef HAVE_PKG_libprof
-
-	  ProfileEnd("interpBest");
-
-#endif // HAVE_PKG_libprof
-
-	  return false;
-
-	}
-
-// 	if (hint == MTreeObject::getUndefinedId())
-// 	  return false;
-	
-	//
-	// interpolate using the best kriging model available
-	//
-
-	MPTCOUPLER::krigcpl::interpolate(value,
-					 bestKrigingModel,
-					 queryPoint,
-					 valueDimension);
+    }
 
-// 	return checkErrorAndInterpolate(value,
-// 					bestKrigingModel,
-// 					queryPoint,
-// 					valueDimension,
-// 					_tolerance,
-// 					_meanErrorFactor);
+    bool 
+    KrigingInterpolationDataBase::interpolate(double            * value,
+					      double            * gradient,
+					      int               & hint,
+					      const double      * point,
+					      std::vector<bool> & flags)
+    {
 
-#ifdef HAVE_PKG_libprof
+      //
+      // enforce the model memory budget once the lookup is done
+      //
 
-	ProfileEnd("interpBest");
+      LookupBudgetCheck lookupBudgetCheck(*this);
 
-#endif // HAVE_PKG_libprof
+      //
+      // count heap allocations of the lookup
+      //
 
-	return true;
-	
-      }
+      HeapAllocationCounter heapAllocationCounter(_numberLookupHeapAllocations);
 
       //
-      // this should never be reached
+      // lookups share access to the model database
       //
 
-      assert(false);
-
-      return false;
+      toolbox::ReadLockGuard modelDBLock(getModelDBLock());
 
-    }
+      //
+      // every lookup advances the access epoch
+      //
 
-    bool 
-    KrigingInterpolationDataBase::interpolate(double            * value,
-					      double            * gradient,
-					      int               & hint,
-					      const double      * point,
-					      std::vector<bool> & flags)
-    {
+      TimeRecorder::advance();
 
       //
       // make sure there is enough space in flags 
@@ -2531,11 +3144,12 @@ namespace MPTCOUPLER {
       const int valueDimension = getValueDimension();
 
       //
-      // instatiate point object from point data
+      // set the query point of the calling thread from point data
       //
 
-      const ResponsePoint queryPoint(pointDimension,
-				     point);
+      const ResponsePoint & queryPoint = 
+	getThreadQueryPoint(pointDimension,
+			    point);
 
       //
       // try hint (if valid)
@@ -2545,7 +3159,8 @@ namespace MPTCOUPLER {
 	  hint != MTreeObject::getUndefinedId()) {
 	
 	const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
-	  _krigingModelDB.getObject(hint); 
+	  _krigingModelDB->getObject(hint,
+				     false);
 
 	if (mTreeObjectPtr == NULL) {
 
@@ -2561,10 +3176,9 @@ namespace MPTCOUPLER {
 	  //
 	  // check the distance between hintKrigingModel and point
 	  //
-	  const Point modelCenter = getModelCenterMass(*hintKrigingModel);
-	  const Vector pointRelativePosition = queryPoint - modelCenter;
-	  const double distanceSqr = krigalg::dot(pointRelativePosition,
-	  					    pointRelativePosition);
+	  const double distanceSqr = 
+	    getDistanceSqr(queryPoint,
+			   getModelCenterMass(*hintKrigingModel));
 
 	  if (distanceSqr > 
 	  	_maxQueryPointModelDistance*_maxQueryPointModelDistance) {
@@ -2609,7 +3223,7 @@ namespace MPTCOUPLER {
 
 	const std::pair<int, InterpolationModelPtr> 
 	  closestKrigingModelData = findClosestCoKrigingModel(queryPoint,
-							      _krigingModelDB,
+							      *_krigingModelDB,
 							      _maxQueryPointModelDistance);
       
 	InterpolationModelPtr closestKrigingModel = 
@@ -2671,13 +3285,17 @@ namespace MPTCOUPLER {
 	const std::pair<int, InterpolationModelPtr> 
 	  bestKrigingModelData = findBestCoKrigingModel(canInterpolateFlag,
 							queryPoint,
-							_krigingModelDB,
+							*_krigingModelDB,
 							_tolerance,
 							_meanErrorFactor,
 							_maxQueryPointModelDistance,
 							_maxNumberSearchModels,
 							_maxKrigingModelSize,
-							valueDimension);
+							valueDimension,
+							_modelSearchErrorFactor,
+							_maxModelSearchDistanceCount,
+							_numberModelSearches,
+							_numberModelSearchHits);
 	
 	InterpolationModelPtr bestKrigingModel = 
 	  bestKrigingModelData.second;
@@ -2755,6 +3373,30 @@ namespace MPTCOUPLER {
 					      const double       * point,
 					      std::vector<bool>  & flags)
     {
+
+      //
+      // enforce the model memory budget once the lookup is done
+      //
+
+      LookupBudgetCheck lookupBudgetCheck(*this);
+
+      //
+      // count heap allocations of the lookup
+      //
+
+      HeapAllocationCounter heapAllocationCounter(_numberLookupHeapAllocations);
+
+      //
+      // lookups share access to the model database
+      //
+
+      toolbox::ReadLockGuard modelDBLock(getModelDBLock());
+
+      //
+      // every lookup advances the access epoch
+      //
+
+      TimeRecorder::advance();
 #if DEBUG
        std::cout << "foobar" << std::endl;
 #endif       
@@ -2786,26 +3428,33 @@ namespace MPTCOUPLER {
       assert(oVIndexForMin < valueDimension);
 
       //
-      // instatiate point object from point data
+      // set the query point of the calling thread from point data
       //
 
-      const ResponsePoint queryPoint(pointDimension,
-				     point);
+      const ResponsePoint & queryPoint = 
+	getThreadQueryPoint(pointDimension,
+			    point);
       
       //
       // check the list of hints to see if any models there is
-      // suitable
+      // suitable; interpolated values are kept in the scratch arena
+      // of the calling thread
       //
       
+      toolbox::ScratchArena::Scope 
+	scratchScope(toolbox::ScratchArena::getThreadArena());
+
       double minOVal;
-      std::vector<double> interpolatedValue(valueDimension);
+      std::vector<double, toolbox::ScratchAllocator<double> > 
+	interpolatedValue(valueDimension);
 
       for (int iHint = 0; iHint < numberHints; ++iHint) {
 
 	if (hintList[iHint] != MTreeObject::getUndefinedId()) {
 	
 	  const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
-	    _krigingModelDB.getObject(hintList[iHint]);
+	    _krigingModelDB->getObject(hintList[iHint],
+				       false);
 	  
 	  if (mTreeObjectPtr == NULL) {
 
@@ -2893,7 +3542,7 @@ namespace MPTCOUPLER {
 	const std::pair<int, InterpolationModelPtr> 
 	  closestKrigingModelData =
 	  findClosestCoKrigingModel(queryPoint,
-				    _krigingModelDB,
+				    *_krigingModelDB,
 				    _maxQueryPointModelDistance);
       
 	InterpolationModelPtr closestKrigingModel = 
@@ -2956,13 +3605,17 @@ namespace MPTCOUPLER {
 	const std::pair<int, InterpolationModelPtr> 
 	  bestKrigingModelData = findBestCoKrigingModel(canInterpolateFlag,
 							queryPoint,
-							_krigingModelDB,
+							*_krigingModelDB,
 							_tolerance,
 							_meanErrorFactor,
 							_maxQueryPointModelDistance,
 							_maxNumberSearchModels,
 							_maxKrigingModelSize,
-							valueDimension);
+							valueDimension,
+							_modelSearchErrorFactor,
+							_maxModelSearchDistanceCount,
+							_numberModelSearches,
+							_numberModelSearchHits);
 	
 	InterpolationModelPtr bestKrigingModel = bestKrigingModelData.second;
 	hintUsed = bestKrigingModelData.first;
@@ -3049,6 +3702,30 @@ namespace MPTCOUPLER {
 					      const double       * point,
 					      std::vector<bool>  & flags)
     {
+
+      //
+      // enforce the model memory budget once the lookup is done
+      //
+
+      LookupBudgetCheck lookupBudgetCheck(*this);
+
+      //
+      // count heap allocations of the lookup
+      //
+
+      HeapAllocationCounter heapAllocationCounter(_numberLookupHeapAllocations);
+
+      //
+      // lookups share access to the model database
+      //
+
+      toolbox::ReadLockGuard modelDBLock(getModelDBLock());
+
+      //
+      // every lookup advances the access epoch
+      //
+
+      TimeRecorder::advance();
 #if DEBUG
       std::cout << "foobar" << std::endl;
 #endif       
@@ -3080,28 +3757,35 @@ namespace MPTCOUPLER {
       assert(oVIndexForMin < valueDimension);
 
       //
-      // instatiate point object from point data
+      // set the query point of the calling thread from point data
       //
 
-      const ResponsePoint queryPoint(pointDimension,
-				     point);
+      const ResponsePoint & queryPoint = 
+	getThreadQueryPoint(pointDimension,
+			    point);
       
       //
       // check the list of hints to see if any models there is
-      // suitable
+      // suitable; interpolated values and gradients are kept in the
+      // scratch arena of the calling thread
       //
       
+      toolbox::ScratchArena::Scope 
+	scratchScope(toolbox::ScratchArena::getThreadArena());
+
       double minOVal;
-      std::vector<double> interpolatedValue(valueDimension);
-      std::vector<double> interpolatedGradient(valueDimension*
-					       pointDimension);
+      std::vector<double, toolbox::ScratchAllocator<double> > 
+	interpolatedValue(valueDimension);
+      std::vector<double, toolbox::ScratchAllocator<double> > 
+	interpolatedGradient(valueDimension*pointDimension);
 
       for (int iHint = 0; iHint < numberHints; ++iHint) {
 
 	if (hintList[iHint] != MTreeObject::getUndefinedId()) {
 	
 	  const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
-	    _krigingModelDB.getObject(hintList[iHint]);
+	    _krigingModelDB->getObject(hintList[iHint],
+				       false);
 	  
 	  if (mTreeObjectPtr == NULL) {
 
@@ -3199,7 +3883,7 @@ namespace MPTCOUPLER {
 	const std::pair<int, InterpolationModelPtr> 
 	  closestKrigingModelData =
 	  findClosestCoKrigingModel(queryPoint,
-				    _krigingModelDB,
+				    *_krigingModelDB,
 				    _maxQueryPointModelDistance);
       
 	InterpolationModelPtr closestKrigingModel = 
@@ -3264,13 +3948,17 @@ namespace MPTCOUPLER {
 	const std::pair<int, InterpolationModelPtr>
 	  bestKrigingModelData = findBestCoKrigingModel(canInterpolateFlag,
 							queryPoint,
-							_krigingModelDB,
+							*_krigingModelDB,
 							_tolerance,
 							_meanErrorFactor,
 							_maxQueryPointModelDistance,
 							_maxNumberSearchModels,
 							_maxKrigingModelSize,
-							valueDimension);
+							valueDimension,
+							_modelSearchErrorFactor,
+							_maxModelSearchDistanceCount,
+							_numberModelSearches,
+							_numberModelSearchHits);
 	
 	InterpolationModelPtr bestKrigingModel = 
 	  bestKrigingModelData.second;
@@ -3359,6 +4047,24 @@ namespace MPTCOUPLER {
 					 std::vector<bool> & flags)
     {
 
+      //
+      // modifications need exclusive access to the model database
+      //
+
+      toolbox::WriteLockGuard modelDBLock(getModelDBLock());
+
+      //
+      // every inserted point advances the access epoch
+      //
+
+      TimeRecorder::advance();
+
+      //
+      // make room for the models touched below
+      //
+
+      enforceModelMemoryBudget();
+
       //
       // 
       // make sure there is enough space in flags 
@@ -3403,7 +4109,7 @@ namespace MPTCOUPLER {
 	// create and add new model
 	//
 
-	addNewModel(_krigingModelDB,
+	addNewModel(*_krigingModelDB,
 		    _modelFactory,
 		    hint, 
 		    point,
@@ -3425,7 +4131,7 @@ namespace MPTCOUPLER {
 	//
 
 	mtreedb::MTreeObjectPtr mTreeObjectPtr = 
-	  _krigingModelDB.getObject(hint);
+	  _krigingModelDB->getObject(hint);
 	MTreeKrigingModelObject & mTreeObject = 
 	  dynamic_cast<MTreeKrigingModelObject &>(*mTreeObjectPtr);
 	InterpolationModelPtr krigingModel = mTreeObject.getModel();
@@ -3438,7 +4144,7 @@ namespace MPTCOUPLER {
 
 	if (krigingModel->getNumberPoints() == _maxKrigingModelSize) {
 
-	  addNewModel(_krigingModelDB,
+	  addNewModel(*_krigingModelDB,
 		      _modelFactory,
 		      hint, 
 		      point,
@@ -3495,36 +4201,21 @@ namespace MPTCOUPLER {
 	  if (addPointSuccess == true) {
 	    
 	    //
-	    // compute the center of mass for the updated model
-	    //
-	    
-	    const Point centerMass = getModelCenterMass(*krigingModel);
-	    // std::cout << "new center: " << centerMass << std::endl;
-	    //
-	    // remove old kriging model from the database
-	    //
-	    
-	    _krigingModelDB.deleteObject(hint);
-	    
-	    //
-	    // insert updated kriging model into database
+	    // move the updated model to its new center of mass
 	    //
 	    
-	    const ResponsePoint centerMassRP(pointDimension,
-					     &(centerMass[0]));
-	    
-	    MTreeKrigingModelObject mTreeObject(krigingModel);
-	    
-	    _krigingModelDB.insertObject(mTreeObject,
-					 centerMassRP,
-					 0.0);
+	    updateModelPosition(*_krigingModelDB,
+				hint,
+				krigingModel,
+				pointDimension);
+
 	  } else {
 
 	    //
 	    // point insertion failed-add new model
 	    //
 
-	    addNewModel(_krigingModelDB,
+	    addNewModel(*_krigingModelDB,
 			_modelFactory,
 			hint, 
 			point,
@@ -3579,6 +4270,24 @@ namespace MPTCOUPLER {
 					 bool                forceInsert,
 					 std::vector<bool> & flags)
     {
+
+      //
+      // modifications need exclusive access to the model database
+      //
+
+      toolbox::WriteLockGuard modelDBLock(getModelDBLock());
+
+      //
+      // every inserted point advances the access epoch
+      //
+
+      TimeRecorder::advance();
+
+      //
+      // make room for the models touched below
+      //
+
+      enforceModelMemoryBudget();
 #if DEBUG
        std::cout << "foobar" << std::endl;
 #endif
@@ -3622,7 +4331,7 @@ namespace MPTCOUPLER {
 
       if (forceInsert == true) {
 
-	addNewModel(_krigingModelDB,
+	addNewModel(*_krigingModelDB,
 		    _modelFactory,
 		    hintUsed, 
 		    point,
@@ -3670,7 +4379,7 @@ namespace MPTCOUPLER {
 	  //
 
 	  mtreedb::MTreeObjectPtr mTreeObjectPtr = 
-	    _krigingModelDB.getObject(currentHint);
+	    _krigingModelDB->getObject(currentHint);
 	  MTreeKrigingModelObject & mTreeObject = 
 	    dynamic_cast<MTreeKrigingModelObject &>(*mTreeObjectPtr);
 	  InterpolationModelPtr krigingModel = mTreeObject.getModel();
@@ -3717,29 +4426,13 @@ namespace MPTCOUPLER {
 	    if (addPointSuccess == true) {
 	    
 	      //
-	      // compute the center of mass for the updated model
-	      //
-	    
-	      const Point centerMass = getModelCenterMass(*krigingModel);
-	      // std::cout << "new center: " << centerMass << std::endl;
-	      //
-	      // remove old kriging model from the database
+	      // move the updated model to its new center of mass
 	      //
 	    
-	      _krigingModelDB.deleteObject(currentHint);
-	    
-	      //
-	      // insert updated kriging model into database
-	      //
-	    
-	      const ResponsePoint centerMassRP(pointDimension,
-					       &(centerMass[0]));
-	    
-	      MTreeKrigingModelObject mTreeObject(krigingModel);
-	    
-	      _krigingModelDB.insertObject(mTreeObject,
-					   centerMassRP,
-					   0.0);
+	      updateModelPosition(*_krigingModelDB,
+				  currentHint,
+				  krigingModel,
+				  pointDimension);
 	      
 	      //
 	      // record currentHint in hintUsed
@@ -3767,7 +4460,7 @@ namespace MPTCOUPLER {
       // point-value pair could be added-crate new model
       //
       
-      addNewModel(_krigingModelDB,
+      addNewModel(*_krigingModelDB,
 		  _modelFactory,
 		  hintUsed, 
 		  point,
@@ -3797,151 +4490,1095 @@ namespace MPTCOUPLER {
     }
 
     //
-    // get the number of statistcs 
+    // Compute interpolated values at a batch of points.
     //
 
-    int
-    KrigingInterpolationDataBase::getNumberStatistics() const
+    std::vector<bool>
+    KrigingInterpolationDataBase::interpolateBatch(double            * values,
+						   int               * hints,
+						   const double      * points,
+						   int                 numberPoints,
+						   std::vector<bool> & flags)
     {
 
-      return 2;
+      //
+      // enforce the model memory budget once the lookup is done
+      //
 
-    }
+      LookupBudgetCheck lookupBudgetCheck(*this);
 
-    //
-    // Write performance stats
-    //
+      //
+      // count heap allocations of the lookup
+      //
 
-    void
-    KrigingInterpolationDataBase::getStatistics(double * stats,
-						int      size) const
-    {
+      HeapAllocationCounter heapAllocationCounter(_numberLookupHeapAllocations);
 
       //
-      //
+      // lookups share access to the model database
       //
 
-      switch(size) {
+      toolbox::ReadLockGuard modelDBLock(getModelDBLock());
 
-      case 0:
-	
-	break;
+      //
+      // every looked up point advances the access epoch
+      //
 
-      case 1:
-	stats[0] = _numberKrigingModels;
-	break;
+      TimeRecorder::advance(numberPoints);
 
-      default:
-	stats[0] = _numberKrigingModels;
-	stats[1] = _numberPointValuePairs;
-	break;
+      //
+      // make sure there is enough space in flags 
+      //
 
-      }
+      assert(static_cast<int>(flags.size()) >= numberPoints*NUMBER_FLAGS);
 
       //
-      //
+      // initialize flags container
       //
 
-      return;
+      std::fill(flags.begin(),
+		flags.end(),
+		false);
+
+      std::vector<bool> success(numberPoints, false);
+
+      //
+      // shortcuts to frequently accesses data
+      //
+
+      const int pointDimension = getPointDimension();
+      const int valueDimension = getValueDimension();
+
+      //
+      // order points by hint so that points sharing a hint are
+      // processed together; points within each group keep their
+      // order. The order is kept in the scratch arena of the calling
+      // thread.
+      //
+
+      toolbox::ScratchArena::Scope 
+	scratchScope(toolbox::ScratchArena::getThreadArena());
+
+      std::vector<int, toolbox::ScratchAllocator<int> > 
+	pointOrder(numberPoints);
+
+      for (int iPoint = 0; iPoint < numberPoints; ++iPoint)
+	pointOrder[iPoint] = iPoint;
+
+      std::sort(pointOrder.begin(),
+		pointOrder.end(),
+		HintLess(hints));
+
+      //
+      // iterate over groups of points sharing a hint
+      //
+
+      int groupBegin = 0;
+
+      while (groupBegin < numberPoints) {
+
+	const int groupHint = hints[pointOrder[groupBegin]];
+
+	int groupEnd = groupBegin + 1;
+
+	while (groupEnd < numberPoints &&
+	       hints[pointOrder[groupEnd]] == groupHint)
+	  ++groupEnd;
+
+	//
+	// get the hint model and its center of mass once for the
+	// whole group
+	//
+
+	bool lostHint = false;
+	InterpolationModelPtr hintKrigingModel;
+	const Point * modelCenter = NULL;
+
+	if (_useHint &&
+	    groupHint != MTreeObject::getUndefinedId()) {
+
+	  const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
+	    _krigingModelDB->getObject(groupHint,
+				       false);
+
+	  if (mTreeObjectPtr == NULL) {
+
+	    lostHint = true;
+
+	  } else {
+
+	    const MTreeKrigingModelObject & mTreeObject = 
+	      dynamic_cast<const MTreeKrigingModelObject &>(*mTreeObjectPtr);
+
+	    if (mTreeObject.getModel()->isValid() == true) {
+	      
+	      hintKrigingModel = mTreeObject.getModel();
+	      modelCenter      = &(getModelCenterMass(*hintKrigingModel));
+
+	    }
+
+	  }
+
+	}
+
+	//
+	// process points in the group
+	//
+
+	for (int iOrder = groupBegin; iOrder < groupEnd; ++iOrder) {
+
+	  const int iPoint = pointOrder[iOrder];
+
+	  double * value = values + iPoint*valueDimension;
+	  const double * point = points + iPoint*pointDimension;
+	  const int flagsOffset = iPoint*NUMBER_FLAGS;
+
+	  const ResponsePoint & queryPoint = 
+	    getThreadQueryPoint(pointDimension,
+				point);
+
+	  if (lostHint == true) {
+
+	    flags[flagsOffset + LOST_HINT_FLAG] = true;
+
+	  } else if (hintKrigingModel) {
+
+	    //
+	    // check the distance between hintKrigingModel and point
+	    //
+
+	    const double distanceSqr = getDistanceSqr(queryPoint,
+						      *modelCenter);
+
+	    if (distanceSqr > 
+		_maxQueryPointModelDistance*_maxQueryPointModelDistance) {
+
+	      flags[flagsOffset + LOST_HINT_FLAG] = true;
+
+	    } else if (checkErrorAndInterpolate(value,
+						hintKrigingModel,
+						queryPoint,
+						valueDimension,
+						_tolerance,
+						_meanErrorFactor) == true) {
+
+	      flags[flagsOffset + USED_HINT_FLAG] = true;
+	      success[iPoint] = true;
+	      continue;
+
+	    }
+
+	  }
+
+	  //
+	  // hint model did not produce a valid interpolation; search
+	  // the database
+	  //
+
+	  success[iPoint] = searchAndInterpolate(value,
+						 hints[iPoint],
+						 queryPoint,
+						 *_krigingModelDB,
+						 _tolerance,
+						 _meanErrorFactor,
+						 _maxQueryPointModelDistance,
+						 _maxNumberSearchModels,
+						 _maxKrigingModelSize,
+						 valueDimension,
+						 _modelSearchErrorFactor,
+						 _maxModelSearchDistanceCount,
+						 _numberModelSearches,
+						 _numberModelSearchHits);
+
+	}
+
+	groupBegin = groupEnd;
+
+      }
+
+      return success;
+
+    }
+
+    //
+    // Insert a batch of point-value pairs into the database.
+    //
+
+    void
+    KrigingInterpolationDataBase::insertBatch(int               * hints,
+					      const double      * points,
+					      const double      * values,
+					      const double      * gradients,
+					      int                 numberPoints,
+					      std::vector<bool> & flags)
+    {
+
+      //
+      // modifications need exclusive access to the model database
+      //
+
+      toolbox::WriteLockGuard modelDBLock(getModelDBLock());
+
+      //
+      // every inserted point advances the access epoch
+      //
+
+      TimeRecorder::advance(numberPoints);
+
+      //
+      // make room for the models touched below
+      //
+
+      enforceModelMemoryBudget();
+
+      //
+      // make sure there is enough space in flags 
+      //
+
+      assert(static_cast<int>(flags.size()) >= numberPoints*NUMBER_FLAGS);
+
+      //
+      // initialize flags container
+      //
+
+      std::fill(flags.begin(),
+		flags.end(),
+		false);
+
+#ifdef HAVE_PKG_libprof
+
+      ProfileBegin("insertBatch");
+
+#endif // HAVE_PKG_libprof
+
+      //
+      // shortcuts to frequently accessed data
+      //
+
+      const int pointDimension = getPointDimension();
+      const int valueDimension = getValueDimension();
+
+      //
+      // order points by hint; see interpolateBatch()
+      //
+
+      std::vector<int> pointOrder(numberPoints);
+
+      for (int iPoint = 0; iPoint < numberPoints; ++iPoint)
+	pointOrder[iPoint] = iPoint;
+
+      std::stable_sort(pointOrder.begin(),
+		       pointOrder.end(),
+		       HintLess(hints));
+
+      //
+      // iterate over groups of points sharing a hint
+      //
+
+      int groupBegin = 0;
+
+      while (groupBegin < numberPoints) {
+
+	const int groupHint = hints[pointOrder[groupBegin]];
+
+	int groupEnd = groupBegin + 1;
+
+	while (groupEnd < numberPoints &&
+	       hints[pointOrder[groupEnd]] == groupHint)
+	  ++groupEnd;
+
+	//
+	// the model currently receiving points, its id and the
+	// points assigned to it; the model is re-inserted into the
+	// database only when the group moves on to another model
+	//
+
+	int modelId = groupHint;
+	InterpolationModelPtr krigingModel;
+	bool modelUpdated = false;
+	std::vector<int> modelPoints;
+
+	if (modelId != MTreeObject::getUndefinedId()) {
+
+	  const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
+	    _krigingModelDB->getObject(modelId);
+
+	  if (mTreeObjectPtr == NULL) {
+
+	    //
+	    // every point of the group passed the lost hint
+	    //
+
+	    for (int iOrder = groupBegin; iOrder < groupEnd; ++iOrder)
+	      flags[pointOrder[iOrder]*NUMBER_FLAGS + LOST_HINT_FLAG] = true;
+
+	    modelId = MTreeObject::getUndefinedId();
+
+	  } else {
+
+	    const MTreeKrigingModelObject & mTreeObject = 
+	      dynamic_cast<const MTreeKrigingModelObject &>(*mTreeObjectPtr);
+	    krigingModel = mTreeObject.getModel();
+
+	  }
+
+	}
+
+	for (int iOrder = groupBegin; iOrder < groupEnd; ++iOrder) {
+
+	  const int iPoint = pointOrder[iOrder];
+
+	  const double * point    = points + iPoint*pointDimension;
+	  const double * value    = values + iPoint*valueDimension;
+	  const double * gradient = 
+	    gradients + iPoint*pointDimension*valueDimension;
+	  const int flagsOffset = iPoint*NUMBER_FLAGS;
+
+	  //
+	  // update number of point/value pairs
+	  //
+
+	  ++_numberPointValuePairs;
+
+	  //
+	  // try to add the point/value pair to the current model
+	  //
+
+	  bool addPointSuccess = false;
+
+	  if (krigingModel) {
+
+	    if (krigingModel->getNumberPoints() == _maxKrigingModelSize) {
+
+	      flags[flagsOffset + MODEL_SIZE_LIMIT_FLAG] = true;
+
+	    } else {
+
+	      std::vector<Value> pointValue;
+
+	      if (krigingModel->hasGradient() == true) 
+		pointValue = copyValueData(value,
+					   gradient,
+					   pointDimension,
+					   valueDimension);
+	      else
+		pointValue = copyValueData(value,
+					   pointDimension,
+					   valueDimension);
+
+	      const Point pointObject(pointDimension,
+				      point);
+
+	      addPointSuccess = krigingModel->addPoint(pointObject,
+						       pointValue);
+
+	      if (addPointSuccess == false)
+		flags[flagsOffset + MODEL_INSERT_LIMIT_FLAG] = true;
+
+	    }
+
+	  }
+
+	  if (addPointSuccess == true) {
+
+	    modelUpdated = true;
+	    modelPoints.push_back(iPoint);
+	    continue;
+
+	  }
+
+	  //
+	  // point could not be added; re-insert the current model if
+	  // it has been updated and start a new model
+	  //
+
+	  if (modelUpdated == true) 
+	    updateModelPosition(*_krigingModelDB,
+				modelId,
+				krigingModel,
+				pointDimension);
+
+	  for (std::vector<int>::size_type i = 0; i < modelPoints.size(); ++i)
+	    hints[modelPoints[i]] = modelId;
+
+	  addNewModel(*_krigingModelDB,
+		      _modelFactory,
+		      modelId, 
+		      point,
+		      value,
+		      gradient,
+		      pointDimension,
+		      valueDimension);
+
+	  //
+	  // update number of kriging models
+	  //
+
+	  ++_numberKrigingModels;
+
+	  //
+	  // get a handle to the new model so that the remaining points
+	  // in the group can be added to it
+	  //
+
+	  const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
+	    _krigingModelDB->getObject(modelId);
+	  const MTreeKrigingModelObject & mTreeObject = 
+	    dynamic_cast<const MTreeKrigingModelObject &>(*mTreeObjectPtr);
+
+	  krigingModel = mTreeObject.getModel();
+	  modelUpdated = false;
+	  modelPoints.assign(1, iPoint);
+
+	}
+
+	//
+	// re-insert the last model of the group if it has been updated
+	//
+
+	if (modelUpdated == true) 
+	  updateModelPosition(*_krigingModelDB,
+			      modelId,
+			      krigingModel,
+			      pointDimension);
+
+	for (std::vector<int>::size_type i = 0; i < modelPoints.size(); ++i)
+	  hints[modelPoints[i]] = modelId;
+
+	groupBegin = groupEnd;
+
+      }
+
+#ifdef HAVE_PKG_libprof
+
+      ProfileEnd("insertBatch");
+
+#endif // HAVE_PKG_libprof      
+
+      return;
+
+    }
+
+    //
+    // get the number of statistcs 
+    //
+
+    int
+    KrigingInterpolationDataBase::getNumberStatistics() const
+    {
+
+      return 13;
+
+    }
+
+    //
+    // Write performance stats
+    //
+
+    void
+    KrigingInterpolationDataBase::getStatistics(double * stats,
+						int      size) const
+    {
+
+      //
+      // model counters are updated by insertions; search counters
+      // are atomic
+      //
+
+      toolbox::ReadLockGuard modelDBLock(getModelDBLock());
+
+      const double allStats[] = {
+	static_cast<double>(_numberKrigingModels),
+	static_cast<double>(_numberPointValuePairs),
+	static_cast<double>(_numberModelSearches.load(std::memory_order_relaxed)),
+	static_cast<double>(_numberModelSearchHits.load(std::memory_order_relaxed)),
+	static_cast<double>(_krigingModelDB->getTotalKNNSearchDistanceCount()),
+	static_cast<double>(_numberHintCacheHits.load(std::memory_order_relaxed)),
+	static_cast<double>(_numberHintCacheMisses.load(std::memory_order_relaxed)),
+	static_cast<double>(_krigingModelTree != NULL ?
+			    _krigingModelTree->getBackgroundIOQueueDepth() : 0),
+	static_cast<double>(_krigingModelTree != NULL ?
+			    _krigingModelTree->getTotalBackgroundIOBytes() : 0),
+	_krigingModelTree != NULL ?
+	_krigingModelTree->getTotalBackgroundIOStallTime() : 0.0,
+	static_cast<double>(getResidentModelBytes()),
+	static_cast<double>(_numberModelEvictions),
+	toolbox::MemoryUtilities::getNumberHeapAllocations() < 0 ? -1.0 :
+	static_cast<double>(_numberLookupHeapAllocations.load(std::memory_order_relaxed))
+      };
+
+      const int numberStats = std::min(std::max(size, 0),
+				       getNumberStatistics());
+
+      std::copy(allStats,
+		allStats + numberStats,
+		stats);
+
+      //
+      //
+      //
+
+      return;
+
+    }
+
+    //
+    // Provide short descriptions of statistic data
+    //
+
+    std::vector<std::string>
+    KrigingInterpolationDataBase::getStatisticsNames() const
+    {
+
+      std::vector<std::string> names;
+      
+      names.push_back("Number of kriging models");
+      names.push_back("Number of point/value pairs");
+      names.push_back("Number of candidate model searches");
+      names.push_back("Number of successful candidate model searches");
+      names.push_back("Number of distance computations in kNN model searches");
+      names.push_back("Number of hint cache hits");
+      names.push_back("Number of hint cache misses");
+      names.push_back("Background model I/O queue depth");
+      names.push_back("Bytes moved by background model I/O");
+      names.push_back("Background model I/O stall time (s)");
+      names.push_back("Bytes held by kriging models in memory");
+      names.push_back("Number of kriging models evicted");
+      names.push_back("Number of heap allocations in lookups (-1 if not counted)");
+
+      return names;
+
+    }
+
+    //
+    // output kriging model database stats
+    //
+
+    void
+    KrigingInterpolationDataBase::printDBStats(std::ostream & outputStream)
+    {
+
+      //
+      // get number of statistics
+      //
+
+      const int numberStats = getNumberStatistics();
+      
+      //
+      // get stats
+      //
+
+      std::vector<double> stats(numberStats);
+
+      getStatistics(&(stats[0]),
+		    numberStats);
+
+
+      //
+      // get descriptions of statistics
+      //
+
+      const std::vector<std::string> statStrings = getStatisticsNames();
+      assert(static_cast<int>(statStrings.size()) == numberStats);
+
+      //
+      // level statistics are recomputed in the tree below so take
+      // exclusive access; getStatistics() above holds the lock on its own
+      //
+
+      toolbox::WriteLockGuard modelDBLock(getModelDBLock());
+      
+      //
+      // output stats and description
+      //
+
+      for (int i = 0; i < numberStats; ++i)
+	outputStream << statStrings[i] <<  " " << stats[i] << std::endl;
+
+      //
+      // output kriging model stats
+      //
+
+      outputKrigingModelStats(outputStream,
+			      *_krigingModelDB,
+			      _maxKrigingModelSize);
+      
+      //
+      // output mtree db stats and positions of all kriging models;
+      // both rely on the MTree level statistics
+      //
+
+      if (_krigingModelTree != NULL) {
+
+	outputMTreeStats(outputStream,
+			 *_krigingModelTree);
+
+	outputKrigingModelPositionData("kriging_model_centers.txt",
+				       *_krigingModelTree);
+
+      }
+
+      //
+      //
+      //
+
+      return;
+
+    }
+
+    //
+    // Swap out some objects to save memory
+    //
+
+    void
+    KrigingInterpolationDataBase::swapOutObjects() const
+    {
+
+      //
+      // modifications need exclusive access to the model database
+      //
+
+      toolbox::WriteLockGuard modelDBLock(getModelDBLock());
+
+      writeObjects(KrigingModelChooser(_agingThreshold));
+
+      enforceModelMemoryBudget();
+
+      return;
+
+    }
+
+    //
+    // Enable/disable locking for concurrent access
+    //
+
+    void
+    KrigingInterpolationDataBase::setConcurrentAccess(bool concurrentAccess)
+    {
+
+      _concurrentAccess = concurrentAccess;
+
+      return;
+
+    }
+
+    bool
+    KrigingInterpolationDataBase::getConcurrentAccess() const
+    {
+
+      return _concurrentAccess;
+
+    }
+
+    //
+    // Enable/disable background model I/O; only the MTree index with a
+    // segment file store supports it
+    //
+
+    bool
+    KrigingInterpolationDataBase::setBackgroundModelIO(bool backgroundModelIO)
+    {
+
+      if (_krigingModelTree == NULL)
+	return false;
+
+      if (backgroundModelIO)
+	_backgroundModelIO = _krigingModelTree->startBackgroundIO();
+      else {
+	_krigingModelTree->stopBackgroundIO();
+	_backgroundModelIO = false;
+      }
+
+      return _backgroundModelIO;
+
+    }
+
+    bool
+    KrigingInterpolationDataBase::getBackgroundModelIO() const
+    {
+
+      return _backgroundModelIO;
 
     }
 
     //
-    // Provide short descriptions of statistic data
+    // Set/get the model memory budget and the memory held by models;
+    // only the MTree index pages models out of memory
     //
 
-    std::vector<std::string>
-    KrigingInterpolationDataBase::getStatisticsNames() const
+    bool
+    KrigingInterpolationDataBase::setModelMemoryBudget(std::size_t budget)
     {
 
-      std::vector<std::string> names;
-      
-      names.push_back("Number of kriging models");
-      names.push_back("Number of point/value pairs");
+      _modelMemoryBudget = budget;
 
-      return names;
+      return _krigingModelTree != NULL;
+
+    }
+
+    std::size_t
+    KrigingInterpolationDataBase::getModelMemoryBudget() const
+    {
+
+      return _modelMemoryBudget;
+
+    }
+
+    std::size_t
+    KrigingInterpolationDataBase::getResidentModelBytes() const
+    {
+
+      if (_krigingModelTree == NULL)
+	return 0;
+
+      return _krigingModelTree->getResidentObjectBytes();
+
+    }
+
+    std::size_t
+    KrigingInterpolationDataBase::getModelResidentBytes(int modelId) const
+    {
+
+      if (_krigingModelTree == NULL)
+	return 0;
+
+      return _krigingModelTree->getObjectMemorySize(modelId);
 
     }
 
     //
-    // output kriging model database stats
+    // Swap out least recently used models beyond the memory budget
     //
 
     void
-    KrigingInterpolationDataBase::printDBStats(std::ostream & outputStream)
+    KrigingInterpolationDataBase::enforceModelMemoryBudget() const
     {
 
+      if (_modelMemoryBudget == 0 ||
+	  getResidentModelBytes() <= _modelMemoryBudget)
+	return;
+
       //
-      // get number of statistics
+      // collect the models in memory; models with background writes
+      // pending are skipped and so count as swapped out
       //
 
-      const int numberStats = getNumberStatistics();
-      
+      std::vector<ResidentModel> residentModels;
+
+      writeObjects(ResidentModelCollector(residentModels));
+
+      std::size_t residentBytes = 0;
+
+      for (std::vector<ResidentModel>::size_type i = 0;
+	   i < residentModels.size(); 
+	   ++i)
+	residentBytes += residentModels[i].memorySize;
+
       //
-      // get stats
+      // choose least recently used models until the remaining ones
+      // fit the eviction target
       //
 
-      std::vector<double> stats(numberStats);
+      const std::size_t targetBytes = 
+	_modelMemoryBudget/100*modelEvictionTargetPercent;
 
-      getStatistics(&(stats[0]),
-		    numberStats);
+      std::sort(residentModels.begin(),
+		residentModels.end(),
+		LeastRecentlyUsed());
+
+      std::vector<int> evictedModelIds;
+
+      for (std::vector<ResidentModel>::size_type i = 0;
+	   i < residentModels.size() && residentBytes > targetBytes; 
+	   ++i) {
 
+	evictedModelIds.push_back(residentModels[i].modelId);
+	residentBytes -= residentModels[i].memorySize;
+
+      }
+
+      if (evictedModelIds.empty())
+	return;
 
       //
-      // get descriptions of statistics
+      // swap out chosen models
       //
 
-      const std::vector<std::string> statStrings = getStatisticsNames();
-      assert(static_cast<int>(statStrings.size()) == numberStats);
-      
+      std::sort(evictedModelIds.begin(),
+		evictedModelIds.end());
+
+      writeObjects(ModelIdChooser(evictedModelIds));
+
+      _numberModelEvictions += evictedModelIds.size();
+
+      return;
+
+    }
+
+    //
+    // Set up approximate candidate model searches
+    //
+
+    void
+    KrigingInterpolationDataBase::setApproximateModelSearch(double errorFactor,
+							    int    maxDistanceCount)
+    {
+
+      _modelSearchErrorFactor      = std::max(1.0, errorFactor);
+      _maxModelSearchDistanceCount = maxDistanceCount;
+
+      return;
+
+    }
+
+    double
+    KrigingInterpolationDataBase::getModelSearchErrorFactor() const
+    {
+
+      return _modelSearchErrorFactor;
+
+    }
+
+    int
+    KrigingInterpolationDataBase::getMaxModelSearchDistanceCount() const
+    {
+
+      return _maxModelSearchDistanceCount;
+
+    }
+
+    //
+    // Lock guarding the model database; NULL disables locking
+    //
+
+    toolbox::ReadWriteLock *
+    KrigingInterpolationDataBase::getModelDBLock() const
+    {
+
+      return _concurrentAccess ? &_modelDBLock : NULL;
+
+    }
+
+    //
+    // Compute interpolated value at a point using a hint cache.
+    //
+
+    bool
+    KrigingInterpolationDataBase::interpolate(double            * value,
+					      ModelHintCache    & hintCache,
+					      int               & hint,
+					      const double      * point,
+					      std::vector<bool> & flags)
+    {
+
+      return interpolateWithHintCache(value,
+				      NULL,
+				      hintCache,
+				      hint,
+				      point,
+				      flags);
+
+    }
+
+    bool
+    KrigingInterpolationDataBase::interpolate(double            * value,
+					      double            * gradient,
+					      ModelHintCache    & hintCache,
+					      int               & hint,
+					      const double      * point,
+					      std::vector<bool> & flags)
+    {
+
+      return interpolateWithHintCache(value,
+				      gradient,
+				      hintCache,
+				      hint,
+				      point,
+				      flags);
+
+    }
+
+    //
+    // Try the models of a hint cache in order of recency; search the
+    // database if none of them can interpolate
+    //
+
+    bool
+    KrigingInterpolationDataBase::interpolateWithHintCache(double            * value,
+							   double            * gradient,
+							   ModelHintCache    & hintCache,
+							   int               & hint,
+							   const double      * point,
+							   std::vector<bool> & flags)
+    {
+
       //
-      // output stats and description
+      // enforce the model memory budget once the lookup is done
       //
 
-      for (int i = 0; i < numberStats; ++i)
-	outputStream << statStrings[i] <<  " " << stats[i] << std::endl;
+      LookupBudgetCheck lookupBudgetCheck(*this);
 
       //
-      // output kriging model stats
+      // count heap allocations of the lookup
       //
 
-      outputKrigingModelStats(outputStream,
-			      _krigingModelDB,
-			      _maxKrigingModelSize);
-      
+      HeapAllocationCounter heapAllocationCounter(_numberLookupHeapAllocations);
+
       //
-      // output mtree db stats
+      // make sure there is enough space in flags 
       //
 
-      outputMTreeStats(outputStream,
-		       _krigingModelDB);
+      assert(flags.size() >= NUMBER_FLAGS);
+
+      std::fill(flags.begin(),
+		flags.end(),
+		false);
+
+      const int pointDimension = getPointDimension();
+      const int valueDimension = getValueDimension();
+
+      bool lostHint = false;
+
+      if (_useHint == true) {
+
+	//
+	// lookups share access to the model database
+	//
+
+	toolbox::ReadLockGuard modelDBLock(getModelDBLock());
+
+	const ResponsePoint & queryPoint = 
+	  getThreadQueryPoint(pointDimension,
+			      point);
+
+	const double maxDistanceSqr = 
+	  _maxQueryPointModelDistance*_maxQueryPointModelDistance;
+
+	int iEntry = 0;
+
+	while (iEntry < hintCache.getSize()) {
+
+	  //
+	  // skip models too far away; the cached center spares
+	  // retrieving the model
+	  //
+
+	  if (getDistanceSqr(queryPoint,
+			     hintCache.getModelCenter(iEntry)) > maxDistanceSqr) {
+	    ++iEntry;
+	    continue;
+	  }
+
+	  //
+	  // drop models no longer in the database
+	  //
+
+	  const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
+	    _krigingModelDB->getObject(hintCache.getModelId(iEntry),
+				       false);
+
+	  if (mTreeObjectPtr == NULL) {
+	    lostHint = true;
+	    hintCache.remove(iEntry);
+	    continue;
+	  }
+
+	  const MTreeKrigingModelObject & mTreeObject = 
+	    dynamic_cast<const MTreeKrigingModelObject &>(*mTreeObjectPtr);
+	  const InterpolationModelPtr hintKrigingModel = 
+	    mTreeObject.getModel();
+
+	  if (hintKrigingModel->isValid() == true) {
+
+	    const bool hintModelSuccess = (gradient == NULL) ?
+	      checkErrorAndInterpolate(value,
+				       hintKrigingModel,
+				       queryPoint,
+				       valueDimension,
+				       _tolerance,
+				       _meanErrorFactor) :
+	      checkErrorAndInterpolate(value,
+				       gradient,
+				       hintKrigingModel,
+				       queryPoint,
+				       pointDimension,
+				       valueDimension,
+				       _tolerance,
+				       _meanErrorFactor);
+
+	    if (hintModelSuccess == true) {
+
+	      //
+	      // a hit is a lookup; a miss advances the access epoch in
+	      // the database search below
+	      //
+
+	      TimeRecorder::advance();
+
+	      hint = hintCache.getModelId(iEntry);
+	      hintCache.touch(iEntry);
+	      flags[LOST_HINT_FLAG] = lostHint;
+	      flags[USED_HINT_FLAG] = true;
+	      _numberHintCacheHits.fetch_add(1, std::memory_order_relaxed);
+	      return true;
+	    }
+
+	  }
+
+	  ++iEntry;
+
+	}
+
+	_numberHintCacheMisses.fetch_add(1, std::memory_order_relaxed);
+
+      }
 
       //
-      // output positions of all kriging models
+      // search the database; the search takes its own lock
       //
 
-      outputKrigingModelPositionData("kriging_model_centers.txt",
-				     _krigingModelDB);
+      hint = MTreeObject::getUndefinedId();
+
+      const bool interpolationSuccess = (gradient == NULL) ?
+	interpolate(value,
+		    hint,
+		    point,
+		    flags) :
+	interpolate(value,
+		    gradient,
+		    hint,
+		    point,
+		    flags);
+
+      if (lostHint == true)
+	flags[LOST_HINT_FLAG] = true;
 
       //
-      //
+      // cache the model found
       //
 
-      return;
+      if (_useHint == true &&
+	  interpolationSuccess == true &&
+	  hint != MTreeObject::getUndefinedId()) {
 
-    }
+	toolbox::ReadLockGuard modelDBLock(getModelDBLock());
 
-    //
-    // Swap out some objects to save memory
-    //
+	const mtreedb::MTreeObjectPtr mTreeObjectPtr = 
+	  _krigingModelDB->getObject(hint,
+				     false);
 
-    void
-    KrigingInterpolationDataBase::swapOutObjects() const
-    {
+	if (mTreeObjectPtr != NULL) {
 
-      _krigingModelDB.writeObjects(KrigingModelChooser(_agingThreshold));
+	  const MTreeKrigingModelObject & mTreeObject = 
+	    dynamic_cast<const MTreeKrigingModelObject &>(*mTreeObjectPtr);
 
-      return;
+	  hintCache.insert(hint,
+			   getModelCenterMass(*(mTreeObject.getModel())));
+
+	}
+
+      }
+
+      return interpolationSuccess;
 
     }
 
@@ -3954,6 +5591,24 @@ namespace MPTCOUPLER {
 						   const double * point)
     {
 
+      //
+      // enforce the model memory budget once the lookup is done
+      //
+
+      LookupBudgetCheck lookupBudgetCheck(*this);
+
+      //
+      // lookups share access to the model database
+      //
+
+      toolbox::ReadLockGuard modelDBLock(getModelDBLock());
+
+      //
+      // every lookup advances the access epoch
+      //
+
+      TimeRecorder::advance();
+
       //
       // shortcuts to frequently accesses data
       //
@@ -3973,7 +5628,7 @@ namespace MPTCOUPLER {
       
       std::vector<MTreeSearchResult> searchResults;
       
-      _krigingModelDB.searchKNN(searchResults,
+      _krigingModelDB->searchKNN(searchResults,
 				queryPoint,
 				numberModels);
       
@@ -4039,6 +5694,24 @@ namespace MPTCOUPLER {
 						   const double * point)
     {
 
+      //
+      // enforce the model memory budget once the lookup is done
+      //
+
+      LookupBudgetCheck lookupBudgetCheck(*this);
+
+      //
+      // lookups share access to the model database
+      //
+
+      toolbox::ReadLockGuard modelDBLock(getModelDBLock());
+
+      //
+      // every lookup advances the access epoch
+      //
+
+      TimeRecorder::advance();
+
       //
       // shortcuts to frequently accesses data
       //
@@ -4058,7 +5731,7 @@ namespace MPTCOUPLER {
       
       std::list<MTreeSearchResult> searchResults;
       
-      _krigingModelDB.searchRange(searchResults,
+      _krigingModelDB->searchRange(searchResults,
 				  queryPoint,
 				  radius);
       
@@ -38,6 +38,15 @@
 #include "mtreedb/MTree.h"
 #endif // included_mtreedb_MTree
 
+#ifndef included_krigcpl_ModelHintCache_h
+#include "kriging_mtreedb/ModelHintCache.h"
+#endif
+
+#ifndef included_toolbox_ReadWriteLock
+#include "toolbox/parallel/ReadWriteLock.h"
+#endif
+
+#include <atomic>
 #include <vector>
 #include <utility>
 
@@ -47,6 +56,11 @@ namespace MPTCOUPLER {
     /*!
      * @brief Concrete implementation of the InterpolationDataBase class using
      * kriging as the interpolation model
+     *
+     * On construction the model factory is asked to select kernels
+     * specialized for the point dimension of the database (see
+     * krigalg::InterpolationModelFactory::selectFixedDimensionKernels());
+     * point dimensions without such kernels use the general ones.
      */
 
     class KrigingInterpolationDataBase :
@@ -54,6 +68,19 @@ namespace MPTCOUPLER {
 
     public:
 
+      /*!
+       * Index structures available for the kriging model database. 
+       * The MTree pages kriging models to disk (see swapOutObjects()) 
+       * and provides the tree statistics printed by printDBStats(); 
+       * MTREE_MODEL_INDEX pages models to HDF5 files, while 
+       * MTREE_SEGMENT_MODEL_INDEX appends them to scratch segment 
+       * files (see mtreedb::MTreeDataStore) and needs no HDF5. The 
+       * VPTree keeps all models in memory.
+       */
+      enum ModelIndexType { MTREE_MODEL_INDEX,
+			    VPTREE_MODEL_INDEX,
+			    MTREE_SEGMENT_MODEL_INDEX };
+
       /*!
        * Construction.
        * 
@@ -75,9 +102,14 @@ namespace MPTCOUPLER {
        * @param maxQueryPointModelDistance The maximum distance between the 
        *                                   query point and the model for which
        *                                   interpolation is still attempted. 
-       * @param agingThreshold Time threshold for object aging.
+       * @param agingThreshold Threshold for object aging; models not
+       *                       accessed within this many lookups or
+       *                       inserted points are swapped out by
+       *                       swapOutObjects().
        * @param mtreeDirectoryName Name of the directory to use for storage
        *                           of disk MTree data.
+       * @param modelIndexType Index structure of the kriging model 
+       *                       database.
        */
       KrigingInterpolationDataBase(int    pointDimension,
 				   int    valueDimension,
@@ -89,7 +121,8 @@ namespace MPTCOUPLER {
 				   double tolerance,
 				   double maxQueryPointModelDistance,
 				   int    agingThreshold,
-				   const std::string & mtreeDirectoryName);
+				   const std::string & mtreeDirectoryName,
+				   ModelIndexType modelIndexType = MTREE_MODEL_INDEX);
       /*!
        * Construction.
        * 
@@ -111,10 +144,15 @@ namespace MPTCOUPLER {
        * @param maxQueryPointModelDistance The maximum distance between the 
        *                                   query point and the model for which
        *                                   interpolation is still attempted.
-       * @param agingThreshold Time threshold for object aging.
+       * @param agingThreshold Threshold for object aging; models not
+       *                       accessed within this many lookups or
+       *                       inserted points are swapped out by
+       *                       swapOutObjects().
        * @param mtreeDirectoryName Name of the directory to use for storage
        *                           of disk MTree data.
        * @param fileName File name to be used for seeding the database.
+       * @param modelIndexType Index structure of the kriging model 
+       *                       database.
        */
       KrigingInterpolationDataBase(int    pointDimension,
 				   int    valueDimension,
@@ -127,7 +165,8 @@ namespace MPTCOUPLER {
 				   double maxQueryPointModelDistance,
 				   int    agingThreshold,
 				   const std::string & mtreeDirectoryName,
-				   const std::string & fileName);
+				   const std::string & fileName,
+				   ModelIndexType modelIndexType = MTREE_MODEL_INDEX);
       
       
       /*!
@@ -245,6 +284,67 @@ namespace MPTCOUPLER {
 			       const double       * point,
 			       std::vector<bool>  & flags);
 
+      /*!
+       * Compute interpolated value at a point using a cache of hints.
+       *
+       * The models in hintCache are tried in order of recency before
+       * the database is searched; a model found by the search is
+       * added to the cache if it produces the interpolated value.
+       * Models whose cached centers are farther from the point than
+       * maxQueryPointModelDistance are skipped and models no longer in
+       * the database are removed from the cache. The cache is not
+       * used unless useHint was set at construction.
+       *
+       * @param value Pointer for storing the value. Size of at least
+       *              _valueDimension assumed.
+       * @param hintCache Reference to the hint cache of the caller
+       *                  stream. Updated upon return.
+       * @param hint Reference to integer id of the model used or, if
+       *             the interpolation fails, of the model found by the
+       *             search (as with the integer hint version, for use
+       *             with insert()).
+       * @param point Pointer for accesing the point. Needs to have the size
+       *              of at least _pointDimension.
+       * @param flags Handle to a container for storing flags related
+       *              to the inner workings of the interpolation database.
+       *
+       * @return true if the interpolation successful; false otherwise. 
+       */
+      bool interpolate(double            * value,
+		       ModelHintCache    & hintCache,
+		       int               & hint,
+		       const double      * point,
+		       std::vector<bool> & flags);
+
+      /*!
+       * Compute interpolated value and gradient at a point using a
+       * cache of hints. See the value-only version for the use of the
+       * cache.
+       *
+       * @param value Pointer for storing the value. Size of at least
+       *              _valueDimension assumed.
+       * @param gradient Pointer for storing gradient of the value wrt.
+       *                 point evaluated at the point.
+       * @param hintCache Reference to the hint cache of the caller
+       *                  stream. Updated upon return.
+       * @param hint Reference to integer id of the model used or, if
+       *             the interpolation fails, of the model found by the
+       *             search (as with the integer hint version, for use
+       *             with insert()).
+       * @param point Pointer for accesing the point. Needs to have the size
+       *              of at least _pointDimension.
+       * @param flags Handle to a container for storing flags related
+       *              to the inner workings of the interpolation database.
+       *
+       * @return true if the interpolation successful; false otherwise. 
+       */
+      bool interpolate(double            * value,
+		       double            * gradient,
+		       ModelHintCache    & hintCache,
+		       int               & hint,
+		       const double      * point,
+		       std::vector<bool> & flags);
+
       /*!
        * Insert the point-value pair into the database.
        *
@@ -287,6 +387,53 @@ namespace MPTCOUPLER {
 			  int                 numberHints,
 			  bool                forceInsert,
 			  std::vector<bool> & flags);
+
+      /*!
+       * Compute interpolated values at a batch of points. Points are
+       * grouped by hint so that the hint model is retrieved from the
+       * database and its center of mass computed only once per group.
+       *
+       * @param values Pointer for storing the values. Size of at least
+       *               numberPoints*_valueDimension assumed.
+       * @param hints  Pointer to an array of numberPoints hints.
+       * @param points Pointer for accessing the point data. Needs to have
+       *               the size of at least numberPoints*_pointDimension.
+       * @param numberPoints Number of points in the batch.
+       * @param flags Handle to a container for storing flags; needs to
+       *              have the size of at least numberPoints*NUMBER_FLAGS.
+       *
+       * @return An STL-vector of per-point success flags.
+       */
+      virtual std::vector<bool> interpolateBatch(double            * values,
+						 int               * hints,
+						 const double      * points,
+						 int                 numberPoints,
+						 std::vector<bool> & flags);
+
+      /*!
+       * Insert a batch of point-value pairs into the database. Points
+       * sharing a hint are added to the same kriging model and the
+       * model is re-inserted into the database once per group rather
+       * than once per point.
+       *
+       * @param hints  Pointer to an array of numberPoints hints.
+       * @param points Pointer to point data. Needs to have the size of
+       *               at least numberPoints*_pointDimension.
+       * @param values Pointer to value data. Needs to have the size of
+       *               at least numberPoints*_valueDimension.
+       * @param gradients Pointer to gradient data. Needs to have the size
+       *                  of at least
+       *                  numberPoints*_pointDimension*_valueDimension.
+       * @param numberPoints Number of points in the batch.
+       * @param flags Handle to a container for storing flags; needs to
+       *              have the size of at least numberPoints*NUMBER_FLAGS.
+       */
+      virtual void insertBatch(int               * hints,
+			       const double      * points,
+			       const double      * values,
+			       const double      * gradients,
+			       int                 numberPoints,
+			       std::vector<bool> & flags);
       
       /*!
        * Get the number of performance statistic data collected
@@ -323,19 +470,162 @@ namespace MPTCOUPLER {
        * Output object given predicate.
        *
        * @param predicate Unary predicate to test for objects.
+       * @return false if the index structure of the database keeps 
+       *         all models in memory.
        */
       template<typename DataPredicate>
       bool writeObjects(const DataPredicate & predicate) const
       {
-	return _krigingModelDB.writeObjects(predicate);
+	if (_krigingModelTree == NULL)
+	  return false;
+
+	return _krigingModelTree->writeObjects(predicate);
       }
 
       /*!
-       * Swap out some objects in order to free up memory
+       * Swap out some objects in order to free up memory: models not
+       * accessed within the aging threshold and, if a model memory
+       * budget is set, the least recently used models beyond the
+       * budget (see setModelMemoryBudget()). With background model
+       * I/O enabled the models are written by a background thread and
+       * the call returns once they are queued; see
+       * setBackgroundModelIO().
        */
 
       virtual void swapOutObjects() const;
 
+      /*!
+       * Enable or disable concurrent access mode. When enabled, any
+       * number of threads may call the interpolate methods,
+       * interpolateBatch() and getKrigingModels() at the same time;
+       * insert(), insertBatch(), swapOutObjects() and printDBStats()
+       * take exclusive access to the database and wait for lookups in
+       * progress to complete. Disabled by default, in which case no
+       * locking is performed and the caller is responsible for
+       * serializing access.
+       *
+       * The mode should only be changed while no other thread is
+       * accessing the database.
+       *
+       * @param concurrentAccess true to enable locking.
+       */
+      void setConcurrentAccess(bool concurrentAccess);
+
+      /*!
+       * Check whether concurrent access mode is enabled.
+       *
+       * @return true if concurrent access mode is enabled.
+       */
+      bool getConcurrentAccess() const;
+
+      /*!
+       * Enable or disable background model I/O. When enabled, models
+       * swapped out by swapOutObjects() are written to disk by a
+       * background thread, and models on disk that are found by
+       * candidate model searches are read ahead in parallel while
+       * earlier candidates are checked. Only the MTREE_SEGMENT_MODEL_INDEX
+       * model index supports background I/O. Disabled by default.
+       *
+       * The mode should only be changed while no other thread is
+       * accessing the database.
+       *
+       * @param backgroundModelIO true to enable background I/O.
+       *
+       * @return true if background model I/O is enabled.
+       */
+      bool setBackgroundModelIO(bool backgroundModelIO);
+
+      /*!
+       * Check whether background model I/O is enabled.
+       *
+       * @return true if background model I/O is enabled.
+       */
+      bool getBackgroundModelIO() const;
+
+      /*!
+       * Set a budget on the memory held by the kriging models in
+       * memory. Whenever the models in memory exceed the budget, the
+       * least recently used models are swapped out until the remaining
+       * ones take up at most 90% of the budget. The budget is checked
+       * before each insertion, by swapOutObjects() and at the end of
+       * each lookup that read models back from disk. Models
+       * with background writes pending count as swapped out. Model
+       * memory is estimated by InterpolationModel::getMemorySize().
+       *
+       * The budget should only be changed while no other thread is
+       * accessing the database.
+       *
+       * @param budget Budget in bytes; 0 (the default) for no budget.
+       *
+       * @return false if the model index keeps all models in memory,
+       *         in which case the budget is ignored.
+       */
+      bool setModelMemoryBudget(std::size_t budget);
+
+      /*!
+       * Get the model memory budget.
+       *
+       * @return Budget in bytes; 0 if there is no budget.
+       */
+      std::size_t getModelMemoryBudget() const;
+
+      /*!
+       * Get the memory held by the kriging models in memory.
+       *
+       * @return Number of bytes; 0 if the model index keeps all models
+       *         in memory and does not account for them.
+       */
+      std::size_t getResidentModelBytes() const;
+
+      /*!
+       * Get the memory held by a kriging model.
+       *
+       * @param modelId Model id.
+       *
+       * @return Number of bytes; 0 if the model is not in memory or
+       *         the model index does not account for it.
+       */
+      std::size_t getModelResidentBytes(int modelId) const;
+
+      /*!
+       * Set up approximate searches for the candidate models checked
+       * when more than one model is searched for interpolation. The
+       * index then returns models whose distances from the query
+       * point exceed those of the exact nearest models by at most
+       * errorFactor, and stops searching once it has computed
+       * maxDistanceCount distances if maxDistanceCount is
+       * positive. Since each candidate is still subject to the error
+       * check, approximation may only lower the fraction of
+       * successful searches; see getStatistics(). By default
+       * (errorFactor 1, maxDistanceCount 0) searches are exact.
+       *
+       * The settings should only be changed while no other thread is
+       * accessing the database.
+       *
+       * @param errorFactor      Bound (>= 1) on the relative distance
+       *                         error of the candidate models.
+       * @param maxDistanceCount Maximum number of distance computations
+       *                         per search; no limit if <= 0.
+       */
+      void setApproximateModelSearch(double errorFactor,
+				     int    maxDistanceCount);
+
+      /*!
+       * Get the error factor of candidate model searches.
+       *
+       * @return Error factor; 1 for exact searches.
+       */
+      double getModelSearchErrorFactor() const;
+
+      /*!
+       * Get the maximum number of distance computations of candidate
+       * model searches.
+       *
+       * @return Maximum number of distance computations; <= 0 if 
+       *         unlimited.
+       */
+      int getMaxModelSearchDistanceCount() const;
+
       /*!
        * Perform a query for k-closest interpolants.
        *
@@ -371,6 +661,38 @@ namespace MPTCOUPLER {
       KrigingInterpolationDataBase(const KrigingInterpolationDataBase &);
       const KrigingInterpolationDataBase & operator=(const KrigingInterpolationDataBase&);
 
+      //
+      // lock to use for the model database; NULL unless concurrent 
+      // access mode is enabled
+      //
+      toolbox::ReadWriteLock * getModelDBLock() const;
+
+      //
+      // swap out least recently used models while the models in
+      // memory exceed the model memory budget; called with exclusive
+      // access to the model database
+      //
+      void enforceModelMemoryBudget() const;
+
+      //
+      // enforces the model memory budget with exclusive access after a
+      // lookup that read models back from disk; declared first in each
+      // lookup so that it runs once the lookup released its shared
+      // access
+      //
+      class LookupBudgetCheck;
+
+      //
+      // implementation of the interpolate methods using a hint cache;
+      // gradient is NULL if not requested
+      //
+      bool interpolateWithHintCache(double            * value,
+				    double            * gradient,
+				    ModelHintCache    & hintCache,
+				    int               & hint,
+				    const double      * point,
+				    std::vector<bool> & flags);
+
       //
       // data
       //
@@ -387,7 +709,17 @@ namespace MPTCOUPLER {
       double _meanErrorFactor;
       double _tolerance;
       double _maxQueryPointModelDistance;
-      mtreedb::MTree _krigingModelDB;
+      double _modelSearchErrorFactor;
+      int    _maxModelSearchDistanceCount;
+
+      //
+      // index of kriging models; _krigingModelTree refers to the same
+      // index if it is an MTree and is NULL otherwise
+      //
+
+      mtreedb::MetricIndexPtr _krigingModelDB;
+      mtreedb::MTree *        _krigingModelTree;
+
       
       //
       // various statistics
@@ -397,13 +729,59 @@ namespace MPTCOUPLER {
       int _numberPointValuePairs;
 
       //
-      // kriging model aging threshold in seconds. kriging models that
-      // have not been access in the last threshold seconds will be
-      // moved to a disk.
+      // number of candidate model searches and of those that found a
+      // model suitable for interpolation; updated by concurrent
+      // lookups
+      //
+
+      std::atomic<int> _numberModelSearches;
+      std::atomic<int> _numberModelSearchHits;
+
+      //
+      // number of interpolations using a hint cache that were and
+      // were not served by a cached model
+      //
+
+      std::atomic<int> _numberHintCacheHits;
+      std::atomic<int> _numberHintCacheMisses;
+
+      //
+      // number of heap allocations made by lookups; only counted if
+      // compiled with COUNT_HEAP_ALLOCATIONS
+      //
+
+      std::atomic<long> _numberLookupHeapAllocations;
+
+      //
+      // kriging model aging threshold in epochs of the logical clock
+      // of TimeRecorder, which advances once per lookup or inserted
+      // point. kriging models that have not been accessed in the last
+      // threshold epochs will be moved to a disk.
       //
 
       int _agingThreshold;
 
+      //
+      // reader/writer lock for concurrent access mode
+      //
+
+      mutable toolbox::ReadWriteLock _modelDBLock;
+      bool                           _concurrentAccess;
+
+      //
+      // background model I/O mode
+      //
+
+      bool _backgroundModelIO;
+
+      //
+      // budget in bytes on the memory of models in memory (0 if
+      // none) and number of models swapped out to meet it
+      //
+
+      std::size_t _modelMemoryBudget;
+      mutable int _numberModelEvictions;
+
     };
 
   }
@@ -0,0 +1,237 @@
+// DO-NOT-DELETE revisionify.begin() 
+/*
+Copyright (c) 2007-2008 Lawrence Livermore National Security LLC
+
+This file is part of the mdef package (version 0.1) and is free software: 
+you can redistribute it and/or modify it under the terms of the GNU
+Lesser General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+                              DISCLAIMER
+
+This work was prepared as an account of work sponsored by an agency of
+the United States Government. Neither the United States Government nor
+Lawrence Livermore National Security, LLC nor any of their employees,
+makes any warranty, express or implied, or assumes any liability or
+responsibility for the accuracy, completeness, or usefulness of any
+information, apparatus, product, or process disclosed, or represents
+that its use would not infringe privately-owned rights. Reference
+herein to any specific commercial products, process, or service by
+trade name, trademark, manufacturer or otherwise does not necessarily
+constitute or imply its endorsement, recommendation, or favoring by
+the United States Government or Lawrence Livermore National Security,
+LLC. The views and opinions of authors expressed herein do not
+necessarily state or reflect those of the United States Government or
+Lawrence Livermore National Security, LLC, and shall not be used for
+advertising or product endorsement purposes.
+*/
+// DO-NOT-DELETE revisionify.end() 
+//
+// File:        ModelHintCache.cc
+// Package:     MPTCOUPLER kriging coupler
+// 
+// Revision:    $Revision$
+// Modified:    $Date$
+// Description: Cache of recently successful kriging model hints.
+//
+
+#include "ModelHintCache.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace MPTCOUPLER {
+  namespace krigcpl {
+
+    //
+    // construction
+    //
+
+    ModelHintCache::ModelHintCache(int capacity)
+      : _capacity(capacity)
+    {
+
+      assert(capacity > 0);
+
+      _entries.reserve(capacity);
+
+      return;
+
+    }
+
+    //
+    // destruction
+    //
+
+    ModelHintCache::~ModelHintCache()
+    {
+
+      return;
+
+    }
+
+    //
+    // get capacity
+    //
+
+    int
+    ModelHintCache::getCapacity() const
+    {
+
+      return _capacity;
+
+    }
+
+    //
+    // get number of cached models
+    //
+
+    int
+    ModelHintCache::getSize() const
+    {
+
+      return _entries.size();
+
+    }
+
+    //
+    // get model id
+    //
+
+    int
+    ModelHintCache::getModelId(int i) const
+    {
+
+      return _entries[i].modelId;
+
+    }
+
+    //
+    // get model center
+    //
+
+    const krigalg::Point &
+    ModelHintCache::getModelCenter(int i) const
+    {
+
+      return _entries[i].modelCenter;
+
+    }
+
+    //
+    // move model to the front
+    //
+
+    void
+    ModelHintCache::touch(int i)
+    {
+
+      assert(i >= 0 && i < static_cast<int>(_entries.size()));
+
+      std::rotate(_entries.begin(),
+		  _entries.begin() + i,
+		  _entries.begin() + i + 1);
+
+      return;
+
+    }
+
+    //
+    // insert model at the front
+    //
+
+    void
+    ModelHintCache::insert(int                    modelId,
+			   const krigalg::Point & modelCenter)
+    {
+
+      //
+      // reuse the entry of a cached model; otherwise append an entry
+      // or reuse that of the least recently used model
+      //
+
+      int i = 0;
+
+      while (i < static_cast<int>(_entries.size()) &&
+	     _entries[i].modelId != modelId)
+	++i;
+
+      if (i == static_cast<int>(_entries.size())) {
+
+	if (i < _capacity) {
+	  _entries.push_back(Entry());
+	} else {
+	  i = _capacity - 1;
+	}
+
+      }
+
+      //
+      // Point copies share their coordinates; keep a private copy so
+      // the caller may reuse modelCenter. The coordinates of a reused
+      // entry are overwritten in place so that a full cache does not
+      // allocate.
+      //
+
+      _entries[i].modelId = modelId;
+
+      if (_entries[i].modelCenter.size() == modelCenter.size()) {
+
+	for (int j = 0; j < static_cast<int>(modelCenter.size()); ++j)
+	  _entries[i].modelCenter[j] = modelCenter[j];
+
+      } else {
+
+	_entries[i].modelCenter = krigalg::Point(modelCenter.size(),
+						 modelCenter.data());
+
+      }
+
+      touch(i);
+
+      return;
+
+    }
+
+    //
+    // remove model
+    //
+
+    void
+    ModelHintCache::remove(int i)
+    {
+
+      assert(i >= 0 && i < static_cast<int>(_entries.size()));
+
+      _entries.erase(_entries.begin() + i);
+
+      return;
+
+    }
+
+    //
+    // remove all models
+    //
+
+    void
+    ModelHintCache::clear()
+    {
+
+      _entries.clear();
+
+      return;
+
+    }
+
+  }
+}
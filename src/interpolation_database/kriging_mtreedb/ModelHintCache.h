@@ -0,0 +1,140 @@
+//
+// File:        ModelHintCache.h
+// Package:     MPTCOUPLER kriging coupler
+//
+// Revision:    $Revision$
+// Modified:    $Date$
+// Description: Cache of recently successful kriging model hints.
+//
+
+#ifndef included_krigcpl_ModelHintCache_h
+#define included_krigcpl_ModelHintCache_h
+
+#ifndef included_MPTCOUPLER_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_krigalg_Point
+#include "base/Point.h"
+#endif
+
+#include <vector>
+
+namespace MPTCOUPLER {
+  namespace krigcpl {
+
+    /*!
+     * @brief Cache of the ids of the kriging models that most recently
+     * produced successful interpolations for a single caller stream
+     * (e.g. a material point), together with the model centers.
+     *
+     * A ModelHintCache generalizes the integer hint of
+     * KrigingInterpolationDataBase::interpolate() to a small working
+     * set of models: the cached models are tried in order of recency
+     * before the database is searched. The cache is owned by the
+     * caller and must not be shared between threads. Model centers are
+     * recorded when a model enters the cache and are used only to
+     * discard models too far from the query point, so they need not
+     * follow later changes of the models.
+     */
+
+    class ModelHintCache {
+
+    public:
+
+      /*!
+       * Construction.
+       *
+       * @param capacity Maximum number of cached models; at least one.
+       */
+      explicit ModelHintCache(int capacity);
+
+      /*!
+       * Destruction.
+       */
+      ~ModelHintCache();
+
+      /*!
+       * Get the maximum number of cached models.
+       *
+       * @return Capacity of the cache.
+       */
+      int getCapacity() const;
+
+      /*!
+       * Get the number of cached models.
+       *
+       * @return Number of cached models.
+       */
+      int getSize() const;
+
+      /*!
+       * Get the id of a cached model. Models are ordered from the most
+       * to the least recently used.
+       *
+       * @param i Position of the model in the cache.
+       *
+       * @return Model id.
+       */
+      int getModelId(int i) const;
+
+      /*!
+       * Get the center of a cached model.
+       *
+       * @param i Position of the model in the cache.
+       *
+       * @return Model center recorded when the model entered the
+       *         cache.
+       */
+      const krigalg::Point & getModelCenter(int i) const;
+
+      /*!
+       * Mark a cached model as the most recently used one.
+       *
+       * @param i Position of the model in the cache.
+       */
+      void touch(int i);
+
+      /*!
+       * Insert a model as the most recently used one. The center of a
+       * model already in the cache is replaced; otherwise the least
+       * recently used model is evicted from a full cache.
+       *
+       * @param modelId Model id.
+       * @param modelCenter Model center.
+       */
+      void insert(int                    modelId,
+		  const krigalg::Point & modelCenter);
+
+      /*!
+       * Remove a model from the cache.
+       *
+       * @param i Position of the model in the cache.
+       */
+      void remove(int i);
+
+      /*!
+       * Remove all models from the cache.
+       */
+      void clear();
+
+    private:
+
+      //
+      // cached model; most recently used first
+      //
+
+      struct Entry {
+	int            modelId;
+	krigalg::Point modelCenter;
+      };
+
+      int                _capacity;
+      std::vector<Entry> _entries;
+
+    };
+
+  }
+}
+
+#endif // included_krigcpl_ModelHintCache_h
@@ -123,6 +123,9 @@ void dgbmv_(char*, int*, int*, int*, int*, double*, double*, int*,
 void dtrsv_(char* uplo, char* trans, char* diag, int* n, double *da, 
 	    int* lda, double *dx, int* incx);
 
+void dtpsv_(const char* uplo, const char* trans, const char* diag,
+	    const int* n, const double *dap, double *dx, const int* incx);
+
 /*---------------------------------------------------------
     Level 3 BLAS
 -----------------------------------------------------------*/
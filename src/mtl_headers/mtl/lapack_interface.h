@@ -370,6 +370,17 @@ void cgesvd_(const char& jobu, const char& jobvt, const int& m, const int& n,
 	       int & info);     
  
  
+ void dpotrf_(const char & uplo, const int & n, double da[],
+	      const int & lda, int & info);
+
+ void dppcon_(const char & uplo, const int & n, const double dap[],
+	      const double & danorm, double & drcond,
+	      double dwork[], int iwork[], int & info);
+
+ void dtptrs_(const char & uplo, const char & trans, const char & diag,
+	      const int & n, const int & nrhs, const double dap[],
+	      double db[], const int & ldb, int & info);
+
  void dgemm_(const char *, const char*,
 	     const int* cols, const int* rows, const int* mids, 
 	     const double* a, const double* B, const int* ldb,
@@ -58,6 +58,9 @@ advertising or product endorsement purposes.
 
 #include <stdio.h>
 #include <stdlib.h>
+#ifdef COUNT_HEAP_ALLOCATIONS
+#include <new>
+#endif
 #ifdef HAVE_TAU
 #include <malloc.h>
 #endif
@@ -70,6 +73,67 @@ TAU_PROFILE_STMT(TauUserEvent ue("memory use"))
 #endif
 #endif
 
+#ifdef COUNT_HEAP_ALLOCATIONS
+/*
+*************************************************************************
+*                                                                       *
+* Replacements of the global allocation functions counting the calls   *
+* made by each thread.  The counter has no constructor so it may be     *
+* used during static initialization.                                    *
+*                                                                       *
+*************************************************************************
+*/
+
+static thread_local long s_number_heap_allocations = 0;
+
+void* operator new(std::size_t number_bytes)
+{
+   ++s_number_heap_allocations;
+   void* block = malloc(number_bytes > 0 ? number_bytes : 1);
+   if (block == NULL) {
+      throw std::bad_alloc();
+   }
+   return(block);
+}
+
+void* operator new[](std::size_t number_bytes)
+{
+   return(::operator new(number_bytes));
+}
+
+void* operator new(std::size_t number_bytes, const std::nothrow_t&) throw()
+{
+   ++s_number_heap_allocations;
+   return(malloc(number_bytes > 0 ? number_bytes : 1));
+}
+
+void* operator new[](std::size_t number_bytes, const std::nothrow_t& tag) 
+   throw()
+{
+   return(::operator new(number_bytes, tag));
+}
+
+void operator delete(void* block) throw()
+{
+   free(block);
+}
+
+void operator delete[](void* block) throw()
+{
+   free(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) throw()
+{
+   free(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) throw()
+{
+   free(block);
+}
+#endif
+
 
 namespace MPTCOUPLER {
    namespace toolbox {
@@ -208,6 +272,23 @@ void MemoryUtilities::printMaxMemory(ostream& os)
 
 }
 
+/*
+*************************************************************************
+*                                                                       *
+* Returns the number of heap allocations made by the calling thread,    *
+* or -1 if the allocation functions are not instrumented.               *
+*                                                                       *
+*************************************************************************
+*/
+long MemoryUtilities::getNumberHeapAllocations()
+{
+#ifdef COUNT_HEAP_ALLOCATIONS
+   return(s_number_heap_allocations);
+#else
+   return(-1);
+#endif
+}
+
 
 }
 }
@@ -64,6 +64,16 @@ struct MemoryUtilities
     * supplied output stream.
     */
    static void printMaxMemory(ostream& os);
+
+   /*!
+    * Return number of calls to the global operator new made by the 
+    * calling thread so far.  Counting requires MPTCOUPLER to be compiled
+    * with COUNT_HEAP_ALLOCATIONS defined, which replaces the global 
+    * allocation and deallocation functions.  Otherwise the method 
+    * returns -1.  Differences of the count taken around an operation
+    * give the number of heap allocations made by the operation.
+    */
+   static long getNumberHeapAllocations();
    
 private:
 
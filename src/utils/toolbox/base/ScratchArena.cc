@@ -0,0 +1,124 @@
+// DO-NOT-DELETE revisionify.begin() 
+/*
+Copyright (c) 2007-2008 Lawrence Livermore National Security LLC
+
+This file is part of the mdef package (version 0.1) and is free software: 
+you can redistribute it and/or modify it under the terms of the GNU
+Lesser General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+                              DISCLAIMER
+
+This work was prepared as an account of work sponsored by an agency of
+the United States Government. Neither the United States Government nor
+Lawrence Livermore National Security, LLC nor any of their employees,
+makes any warranty, express or implied, or assumes any liability or
+responsibility for the accuracy, completeness, or usefulness of any
+information, apparatus, product, or process disclosed, or represents
+that its use would not infringe privately-owned rights. Reference
+herein to any specific commercial products, process, or service by
+trade name, trademark, manufacturer or otherwise does not necessarily
+constitute or imply its endorsement, recommendation, or favoring by
+the United States Government or Lawrence Livermore National Security,
+LLC. The views and opinions of authors expressed herein do not
+necessarily state or reflect those of the United States Government or
+Lawrence Livermore National Security, LLC, and shall not be used for
+advertising or product endorsement purposes.
+*/
+// DO-NOT-DELETE revisionify.end() 
+//
+// File:  ScratchArena.cc
+// Package:  MPTCOUPLER toolbox
+// 
+// 
+// 
+// Description:  Per-thread scratch memory for short-lived temporaries
+//
+
+#include "toolbox/base/ScratchArena.h"
+
+#ifdef DEBUG_NO_INLINE
+#include "toolbox/base/ScratchArena.I"
+#endif
+
+namespace MPTCOUPLER {
+   namespace toolbox {
+
+/*
+ * Size of the first chunk; later chunks double in size.
+ */
+static const size_t s_initial_chunk_size = 64 * 1024;
+
+ScratchArena::ScratchArena()
+:
+   d_current_chunk(0),
+   d_current_offset(0)
+{
+}
+
+ScratchArena::~ScratchArena()
+{
+   for (size_t ic = 0; ic < d_chunks.size(); ++ic) {
+      delete [] d_chunks[ic].d_data;
+   }
+}
+
+size_t ScratchArena::getCapacity() const
+{
+   size_t capacity = 0;
+   for (size_t ic = 0; ic < d_chunks.size(); ++ic) {
+      capacity += d_chunks[ic].d_size;
+   }
+   return( capacity );
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Advance to the first of the remaining chunks that is large enough.   *
+* The space left in skipped chunks is unused until the enclosing scope  *
+* is released.  If no chunk is large enough a new one, at least twice   *
+* as large as the last one, is appended.                                *
+*                                                                       *
+*************************************************************************
+*/
+
+void ScratchArena::advanceChunk(size_t number_bytes)
+{
+   size_t ic = ( d_current_chunk < d_chunks.size() ) ? d_current_chunk + 1 
+                                                     : d_chunks.size();
+   while ( ic < d_chunks.size() && d_chunks[ic].d_size < number_bytes ) {
+      ++ic;
+   }
+
+   if ( ic >= d_chunks.size() ) {
+      size_t chunk_size = d_chunks.empty() ? s_initial_chunk_size
+                                           : 2 * d_chunks.back().d_size;
+      while ( chunk_size < number_bytes ) {
+         chunk_size *= 2;
+      }
+
+      Chunk chunk;
+      chunk.d_data = new char[chunk_size];
+      chunk.d_size = chunk_size;
+      d_chunks.push_back(chunk);
+
+      ic = d_chunks.size() - 1;
+   }
+
+   d_current_chunk  = ic;
+   d_current_offset = 0;
+}
+
+}
+}
@@ -0,0 +1,177 @@
+//
+// File:  ScratchArena.h
+// Package:  MPTCOUPLER toolbox
+// 
+// 
+// 
+// Description:  Per-thread scratch memory for short-lived temporaries
+//
+
+#ifndef included_toolbox_ScratchArena
+#define included_toolbox_ScratchArena
+
+#ifndef included_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_cstddef
+#define included_cstddef
+#include <cstddef>
+#endif
+
+#ifndef included_vector
+#define included_vector
+#include <vector>
+using namespace std;
+#endif
+
+namespace MPTCOUPLER {
+   namespace toolbox {
+
+/*!
+ * @brief ScratchArena is a stack-like memory pool for temporaries
+ * that live for the duration of a single operation, e.g., a database
+ * lookup.  Each thread owns one arena, obtained by getThreadArena(),
+ * so no locking is involved.
+ *
+ * Memory is handed out by bumping an offset into a list of chunks and
+ * is reclaimed in bulk when a Scope object goes out of scope; 
+ * individual allocations are never freed.  Chunks are kept for reuse,
+ * so once an arena has grown to the high-water mark of an operation,
+ * repeating the operation does not touch the heap; see 
+ * MemoryUtilities::getNumberHeapAllocations() for verifying this.
+ *
+ * The ScratchAllocator class adapts the arena of the calling thread to
+ * the STL allocator interface.  Containers using it must be destroyed
+ * within the enclosing Scope and on the thread that created them.
+ */
+
+class ScratchArena
+{
+public:
+   /*!
+    * @brief Scope records the state of an arena in its constructor and
+    * releases everything allocated since then in its destructor.  
+    * Scopes nest.
+    */
+   class Scope
+   {
+   public:
+      /*!
+       * Record current state of given arena.
+       */
+      explicit Scope(ScratchArena& arena);
+
+      /*!
+       * Release memory allocated from the arena since construction.
+       */
+      ~Scope();
+
+   private:
+      // The following are not implemented
+      Scope(const Scope&);
+      void operator=(const Scope&);
+
+      ScratchArena& d_arena;
+      size_t        d_chunk;
+      size_t        d_offset;
+   };
+
+   /*!
+    * Return the arena of the calling thread.
+    */
+   static ScratchArena& getThreadArena();
+
+   /*!
+    * Ctor creates an empty arena; no memory is allocated until first
+    * use.
+    */
+   ScratchArena();
+
+   /*!
+    * Dtor returns all chunks to the heap.
+    */
+   ~ScratchArena();
+
+   /*!
+    * Return pointer to an uninitialized block of given number of bytes,
+    * suitably aligned for any fundamental type.
+    */
+   void* allocate(size_t number_bytes);
+
+   /*!
+    * Return pointer to uninitialized storage for given number of
+    * objects of type TYPE.
+    */
+   template <class TYPE>
+   TYPE* allocate(size_t number_objects);
+
+   /*!
+    * Return total number of bytes held by the arena.
+    */
+   size_t getCapacity() const;
+
+private:
+   // The following are not implemented
+   ScratchArena(const ScratchArena&);
+   void operator=(const ScratchArena&);
+
+   /*
+    * Move to the next chunk able to hold given number of bytes, 
+    * allocating it from the heap if needed.
+    */
+   void advanceChunk(size_t number_bytes);
+
+   struct Chunk {
+      char*  d_data;
+      size_t d_size;
+   };
+
+   vector<Chunk> d_chunks;
+   size_t        d_current_chunk;
+   size_t        d_current_offset;
+};
+
+/*!
+ * @brief ScratchAllocator is an STL allocator drawing memory from the
+ * ScratchArena of the calling thread.  Deallocation is a no-op; the
+ * memory is reclaimed by the enclosing ScratchArena::Scope.
+ */
+
+template <class TYPE>
+class ScratchAllocator
+{
+public:
+   typedef TYPE value_type;
+
+   ScratchAllocator() {}
+
+   template <class OTHER>
+   ScratchAllocator(const ScratchAllocator<OTHER>&) {}
+
+   TYPE* allocate(size_t number_objects);
+
+   void deallocate(TYPE*, size_t) {}
+};
+
+template <class TYPE, class OTHER>
+inline
+bool operator==(const ScratchAllocator<TYPE>&, const ScratchAllocator<OTHER>&)
+{
+   return(true);
+}
+
+template <class TYPE, class OTHER>
+inline
+bool operator!=(const ScratchAllocator<TYPE>&, const ScratchAllocator<OTHER>&)
+{
+   return(false);
+}
+
+}
+}
+
+#ifndef DEBUG_NO_INLINE
+#include "toolbox/base/ScratchArena.I"
+#endif
+#endif
@@ -0,0 +1,857 @@
+// DO-NOT-DELETE revisionify.begin() 
+/*
+Copyright (c) 2007-2008 Lawrence Livermore National Security LLC
+
+This file is part of the mdef package (version 0.1) and is free software: 
+you can redistribute it and/or modify it under the terms of the GNU
+Lesser General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+                              DISCLAIMER
+
+This work was prepared as an account of work sponsored by an agency of
+the United States Government. Neither the United States Government nor
+Lawrence Livermore National Security, LLC nor any of their employees,
+makes any warranty, express or implied, or assumes any liability or
+responsibility for the accuracy, completeness, or usefulness of any
+information, apparatus, product, or process disclosed, or represents
+that its use would not infringe privately-owned rights. Reference
+herein to any specific commercial products, process, or service by
+trade name, trademark, manufacturer or otherwise does not necessarily
+constitute or imply its endorsement, recommendation, or favoring by
+the United States Government or Lawrence Livermore National Security,
+LLC. The views and opinions of authors expressed herein do not
+necessarily state or reflect those of the United States Government or
+Lawrence Livermore National Security, LLC, and shall not be used for
+advertising or product endorsement purposes.
+*/
+// DO-NOT-DELETE revisionify.end() 
+//
+// File:        MemoryDatabase.cc
+// Package:     MPTCOUPLER toolbox
+// 
+// 
+// 
+// Description: A database structure that stores data in memory.
+//
+
+#include "toolbox/database/MemoryDatabase.h"
+
+#include "toolbox/base/Utilities.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#ifdef DEBUG_CHECK_ASSERTIONS
+#ifndef included_cassert
+#define included_cassert
+#include <cassert>
+#endif
+#endif
+
+namespace MPTCOUPLER {
+   namespace toolbox {
+
+/*
+*************************************************************************
+*                                                                       *
+* Helper functions appending values to and reading values from a        *
+* binary image.  Reads check against the end of the image and return    *
+* false if the image is too short.                                      *
+*                                                                       *
+*************************************************************************
+*/
+
+namespace {
+
+inline void appendBytes(vector<char>& buffer,
+                        const void* bytes,
+                        size_t size)
+{
+   const char* first = static_cast<const char*>(bytes);
+   buffer.insert(buffer.end(), first, first + size);
+}
+
+inline void appendInteger(vector<char>& buffer,
+                          int value)
+{
+   appendBytes(buffer, &value, sizeof(int));
+}
+
+inline bool readBytes(const char*& data,
+                      const char* end,
+                      void* bytes,
+                      size_t size)
+{
+   if ( static_cast<size_t>(end - data) < size ) {
+      return(false);
+   }
+   memcpy(bytes, data, size);
+   data += size;
+   return(true);
+}
+
+inline bool readInteger(const char*& data,
+                        const char* end,
+                        int& value)
+{
+   return( readBytes(data, end, &value, sizeof(int)) );
+}
+
+inline bool readString(const char*& data,
+                       const char* end,
+                       string& value)
+{
+   int length = 0;
+   if ( !readInteger(data, end, length) ||
+        (length < 0) ||
+        (end - data < length) ) {
+      return(false);
+   }
+   value.assign(data, length);
+   data += length;
+   return(true);
+}
+
+inline void appendString(vector<char>& buffer,
+                         const string& value)
+{
+   appendInteger(buffer, value.size());
+   appendBytes(buffer, value.data(), value.size());
+}
+
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Ctor and dtor.                                                        *
+*                                                                       *
+*************************************************************************
+*/
+
+MemoryDatabase::MemoryDatabase(const string& name)
+: d_database_name(name)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(!name.empty());
+#endif
+}
+
+MemoryDatabase::~MemoryDatabase()
+{
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Return true if key exists in database and false otherwise; return     *
+* all keys in database.                                                 *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::keyExists(const string& key)
+{
+   return( d_entries.find(key) != d_entries.end() );
+}
+
+void MemoryDatabase::getAllKeys(vector<string>& keys)
+{
+   keys.clear();
+   keys.reserve(d_entries.size());
+   for (EntryMap::const_iterator ie = d_entries.begin(); 
+        ie != d_entries.end(); ++ie) {
+      keys.push_back(ie->first);
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Get size of array entry; one for scalars and zero for subdatabases    *
+* and missing keys.                                                     *
+*                                                                       *
+*************************************************************************
+*/
+
+int MemoryDatabase::getArraySize(const string& key)
+{
+   EntryMap::const_iterator ie = d_entries.find(key);
+   if ( (ie == d_entries.end()) || 
+        (ie->second.d_type == DATABASE_ENTRY) ) {
+      return(0);
+   }
+   return(ie->second.d_num_elements);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Subdatabase entries.                                                  *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::isDatabase(const string& key)
+{
+   return( isEntryType(key, DATABASE_ENTRY) );
+}
+
+DatabasePtr MemoryDatabase::putDatabase(const string& key)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(!key.empty());
+#endif
+   Entry& entry = d_entries[key];
+   entry.d_type = DATABASE_ENTRY;
+   entry.d_num_elements = 0;
+   entry.d_data.clear();
+   entry.d_image_data = NULL;
+   entry.d_strings.clear();
+   entry.d_database.reset( new MemoryDatabase(key) );
+   return(entry.d_database);
+}
+
+DatabasePtr MemoryDatabase::getDatabase(const string& key)
+{
+   return( findEntry(key, DATABASE_ENTRY, 
+                     "getDatabase()").d_database );
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Boolean entries; each value is held as a single byte.                 *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::isBool(const string& key)
+{
+   return( isEntryType(key, BOOL_ENTRY) );
+}
+
+void MemoryDatabase::putBool(const string& key, bool data)
+{
+   putBoolArray(key, &data, 1);
+}
+
+void MemoryDatabase::putBoolArray(
+   const string& key, const bool* const data, const int nelements)
+{
+   vector<char> bytes(nelements);
+   for (int i = 0; i < nelements; ++i) {
+      bytes[i] = ( data[i] ? 1 : 0 );
+   }
+   putEntry(key, BOOL_ENTRY, nelements ? &bytes[0] : (char*)NULL, nelements);
+}
+
+void MemoryDatabase::putBoolArray(
+   const string& key, const vector<bool>& data)
+{
+   vector<char> bytes(data.size());
+   for (unsigned int i = 0; i < data.size(); ++i) {
+      bytes[i] = ( data[i] ? 1 : 0 );
+   }
+   putEntry(key, BOOL_ENTRY, 
+            bytes.empty() ? (char*)NULL : &bytes[0], bytes.size());
+}
+
+bool MemoryDatabase::getBool(const string& key)
+{
+   bool data;
+   getBoolArray(key, &data, 1);
+   return(data);
+}
+
+void MemoryDatabase::getBoolArray(const string& key, vector<bool>& data)
+{
+   const Entry& entry = findEntry(key, BOOL_ENTRY, "getBoolArray()");
+   const char* entry_data = getEntryData(entry);
+   data.resize(entry.d_num_elements);
+   for (int i = 0; i < entry.d_num_elements; ++i) {
+      data[i] = ( entry_data[i] != 0 );
+   }
+}
+
+void MemoryDatabase::getBoolArray(
+   const string& key, bool* data, const int nelements)
+{
+   const Entry& entry = findEntry(key, BOOL_ENTRY, "getBoolArray()");
+   if ( entry.d_num_elements != nelements ) {
+      TBOX_ERROR("MemoryDatabase::getBoolArray() error in database "
+                 << d_database_name
+                 << "\n    Incorrect array size = " << nelements
+                 << " specified for key = " << key
+                 << " with array size = " << entry.d_num_elements << endl);
+   }
+   const char* entry_data = getEntryData(entry);
+   for (int i = 0; i < nelements; ++i) {
+      data[i] = ( entry_data[i] != 0 );
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Character entries.                                                    *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::isChar(const string& key)
+{
+   return( isEntryType(key, CHAR_ENTRY) );
+}
+
+void MemoryDatabase::putChar(const string& key, char data)
+{
+   putEntry(key, CHAR_ENTRY, &data, 1);
+}
+
+void MemoryDatabase::putCharArray(
+   const string& key, const char* const data, const int nelements)
+{
+   putEntry(key, CHAR_ENTRY, data, nelements);
+}
+
+void MemoryDatabase::putCharArray(
+   const string& key, const vector<char>& data)
+{
+   putEntry(key, CHAR_ENTRY, 
+            data.empty() ? (char*)NULL : &data[0], data.size());
+}
+
+char MemoryDatabase::getChar(const string& key)
+{
+   char data;
+   getEntry(key, CHAR_ENTRY, &data, 1, "getChar()");
+   return(data);
+}
+
+void MemoryDatabase::getCharArray(
+   const string& key, char* data, const int nelements)
+{
+   getEntry(key, CHAR_ENTRY, data, nelements, "getCharArray()");
+}
+
+void MemoryDatabase::getCharArray(const string& key, vector<char>& data)
+{
+   getEntry(key, CHAR_ENTRY, data, "getCharArray()");
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Double entries.                                                       *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::isDouble(const string& key)
+{
+   return( isEntryType(key, DOUBLE_ENTRY) );
+}
+
+void MemoryDatabase::putDouble(const string& key, double data)
+{
+   putEntry(key, DOUBLE_ENTRY, &data, 1);
+}
+
+void MemoryDatabase::putDoubleArray(
+   const string& key, const double* const data, const int nelements)
+{
+   putEntry(key, DOUBLE_ENTRY, data, nelements);
+}
+
+void MemoryDatabase::putDoubleArray(
+   const string& key, const vector<double>& data)
+{
+   putEntry(key, DOUBLE_ENTRY, 
+            data.empty() ? (double*)NULL : &data[0], data.size());
+}
+
+double MemoryDatabase::getDouble(const string& key)
+{
+   double data;
+   getEntry(key, DOUBLE_ENTRY, &data, 1, "getDouble()");
+   return(data);
+}
+
+void MemoryDatabase::getDoubleArray(const string& key, vector<double>& data)
+{
+   getEntry(key, DOUBLE_ENTRY, data, "getDoubleArray()");
+}
+
+void MemoryDatabase::getDoubleArray(
+   const string& key, double* data, const int nelements)
+{
+   getEntry(key, DOUBLE_ENTRY, data, nelements, "getDoubleArray()");
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Float entries.                                                        *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::isFloat(const string& key)
+{
+   return( isEntryType(key, FLOAT_ENTRY) );
+}
+
+void MemoryDatabase::putFloat(const string& key, float data)
+{
+   putEntry(key, FLOAT_ENTRY, &data, 1);
+}
+
+void MemoryDatabase::putFloatArray(
+   const string& key, const float* const data, const int nelements)
+{
+   putEntry(key, FLOAT_ENTRY, data, nelements);
+}
+
+void MemoryDatabase::putFloatArray(
+   const string& key, const vector<float>& data)
+{
+   putEntry(key, FLOAT_ENTRY, 
+            data.empty() ? (float*)NULL : &data[0], data.size());
+}
+
+float MemoryDatabase::getFloat(const string& key)
+{
+   float data;
+   getEntry(key, FLOAT_ENTRY, &data, 1, "getFloat()");
+   return(data);
+}
+
+void MemoryDatabase::getFloatArray(const string& key, vector<float>& data)
+{
+   getEntry(key, FLOAT_ENTRY, data, "getFloatArray()");
+}
+
+void MemoryDatabase::getFloatArray(
+   const string& key, float* data, const int nelements)
+{
+   getEntry(key, FLOAT_ENTRY, data, nelements, "getFloatArray()");
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Integer entries.                                                      *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::isInteger(const string& key)
+{
+   return( isEntryType(key, INTEGER_ENTRY) );
+}
+
+void MemoryDatabase::putInteger(const string& key, int data)
+{
+   putEntry(key, INTEGER_ENTRY, &data, 1);
+}
+
+void MemoryDatabase::putIntegerArray(
+   const string& key, const int* const data, const int nelements)
+{
+   putEntry(key, INTEGER_ENTRY, data, nelements);
+}
+
+void MemoryDatabase::putIntegerArray(
+   const string& key, const vector<int>& data)
+{
+   putEntry(key, INTEGER_ENTRY, 
+            data.empty() ? (int*)NULL : &data[0], data.size());
+}
+
+int MemoryDatabase::getInteger(const string& key)
+{
+   int data;
+   getEntry(key, INTEGER_ENTRY, &data, 1, "getInteger()");
+   return(data);
+}
+
+void MemoryDatabase::getIntegerArray(const string& key, vector<int>& data)
+{
+   getEntry(key, INTEGER_ENTRY, data, "getIntegerArray()");
+}
+
+void MemoryDatabase::getIntegerArray(
+   const string& key, int* data, const int nelements)
+{
+   getEntry(key, INTEGER_ENTRY, data, nelements, "getIntegerArray()");
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* String entries; strings are held in d_strings rather than as bytes.   *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::isString(const string& key)
+{
+   return( isEntryType(key, STRING_ENTRY) );
+}
+
+void MemoryDatabase::putString(const string& key, const string& data)
+{
+   putStringArray(key, &data, 1);
+}
+
+void MemoryDatabase::putStringArray(
+   const string& key, const string* const data, const int nelements)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(!key.empty());
+   assert(nelements >= 0);
+#endif
+   Entry& entry = d_entries[key];
+   entry.d_type = STRING_ENTRY;
+   entry.d_num_elements = nelements;
+   entry.d_data.clear();
+   entry.d_image_data = NULL;
+   entry.d_strings.assign(data, data + nelements);
+   entry.d_database.reset();
+}
+
+void MemoryDatabase::putStringArray(
+   const string& key, const vector<string>& data)
+{
+   putStringArray(key, 
+                  data.empty() ? (string*)NULL : &data[0], data.size());
+}
+
+string MemoryDatabase::getString(const string& key)
+{
+   string data;
+   getStringArray(key, &data, 1);
+   return(data);
+}
+
+void MemoryDatabase::getStringArray(const string& key, vector<string>& data)
+{
+   data = findEntry(key, STRING_ENTRY, "getStringArray()").d_strings;
+}
+
+void MemoryDatabase::getStringArray(
+   const string& key, string* data, const int nelements)
+{
+   const Entry& entry = findEntry(key, STRING_ENTRY, "getStringArray()");
+   if ( entry.d_num_elements != nelements ) {
+      TBOX_ERROR("MemoryDatabase::getStringArray() error in database "
+                 << d_database_name
+                 << "\n    Incorrect array size = " << nelements
+                 << " specified for key = " << key
+                 << " with array size = " << entry.d_num_elements << endl);
+   }
+   std::copy(entry.d_strings.begin(), entry.d_strings.end(), data);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Print contents of database to given output stream.                    *
+*                                                                       *
+*************************************************************************
+*/
+
+void MemoryDatabase::printClassData(ostream& os)
+{
+   if (d_entries.empty()) {
+      os << "Database named `"<< d_database_name 
+         << "' has zero keys..." << endl;
+   } else {
+      os << "Printing contents of database named `" 
+         << d_database_name << "'..." << endl;
+   }
+
+   static const char* const type_names[] = 
+      { "database", "boolean", "char", "double", 
+        "float", "integer", "string" };
+
+   for (EntryMap::const_iterator ie = d_entries.begin(); 
+        ie != d_entries.end(); ++ie) {
+      const Entry& entry = ie->second;
+      os << "   Data entry `"<< ie->first << "' is a " 
+         << type_names[entry.d_type];
+      if (entry.d_type != DATABASE_ENTRY) {
+         os << ( (entry.d_num_elements == 1) ? " scalar" : " array" );
+      }
+      os << endl;
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Write binary image of database to buffer.  The image of a database    *
+* is the number of entries followed by each entry: key, type, number    *
+* of elements and data.  Numeric data are raw bytes, strings are        *
+* preceded by their length and subdatabases are nested images.          *
+*                                                                       *
+*************************************************************************
+*/
+
+void MemoryDatabase::serialize(vector<char>& buffer) const
+{
+   appendInteger(buffer, d_entries.size());
+
+   for (EntryMap::const_iterator ie = d_entries.begin(); 
+        ie != d_entries.end(); ++ie) {
+
+      const Entry& entry = ie->second;
+
+      appendString(buffer, ie->first);
+      appendInteger(buffer, entry.d_type);
+      appendInteger(buffer, entry.d_num_elements);
+
+      switch (entry.d_type) {
+         case DATABASE_ENTRY: {
+            entry.d_database->serialize(buffer);
+            break;
+         }
+         case STRING_ENTRY: {
+            for (int i = 0; i < entry.d_num_elements; ++i) {
+               appendString(buffer, entry.d_strings[i]);
+            }
+            break;
+         }
+         default: {
+            appendBytes(buffer, 
+                        getEntryData(entry),
+                        getElementSize(entry.d_type) * 
+                        entry.d_num_elements);
+         }
+      }
+
+   }
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Read binary image of database from buffer, either copying its data    *
+* into the database or attaching the database to the image.             *
+*                                                                       *
+*************************************************************************
+*/
+
+bool MemoryDatabase::deserialize(const char* data, size_t size)
+{
+   return( readImage(data, size, false) );
+}
+
+bool MemoryDatabase::attach(const char* data, size_t size)
+{
+   return( readImage(data, size, true) );
+}
+
+bool MemoryDatabase::readImage(const char* data, 
+                               size_t size, 
+                               bool attach_data)
+{
+   const char* end = data + size;
+
+   bool read_successful = 
+      deserializeEntries(data, end, attach_data) && (data == end);
+
+   if ( !read_successful ) {
+      d_entries.clear();
+   }
+
+   return(read_successful);
+}
+
+bool MemoryDatabase::deserializeEntries(const char*& data, 
+                                        const char* end,
+                                        bool attach_data)
+{
+   d_entries.clear();
+
+   int num_entries = 0;
+   if ( !readInteger(data, end, num_entries) || (num_entries < 0) ) {
+      return(false);
+   }
+
+   for (int ientry = 0; ientry < num_entries; ++ientry) {
+
+      string key;
+      int type = 0;
+      int nelements = 0;
+      if ( !readString(data, end, key) ||
+           !readInteger(data, end, type) ||
+           !readInteger(data, end, nelements) ||
+           (type < DATABASE_ENTRY) || (type > STRING_ENTRY) ||
+           (nelements < 0) ) {
+         return(false);
+      }
+
+      Entry& entry = d_entries[key];
+      entry.d_type = static_cast<EntryType>(type);
+      entry.d_num_elements = nelements;
+      entry.d_image_data = NULL;
+
+      switch (entry.d_type) {
+         case DATABASE_ENTRY: {
+            entry.d_database.reset( new MemoryDatabase(key) );
+            if ( !entry.d_database->deserializeEntries(data, 
+                                                       end, 
+                                                       attach_data) ) {
+               return(false);
+            }
+            break;
+         }
+         case STRING_ENTRY: {
+            entry.d_strings.resize(nelements);
+            for (int i = 0; i < nelements; ++i) {
+               if ( !readString(data, end, entry.d_strings[i]) ) {
+                  return(false);
+               }
+            }
+            break;
+         }
+         default: {
+            const size_t num_bytes = 
+               getElementSize(entry.d_type) * nelements;
+            if ( static_cast<size_t>(end - data) < num_bytes ) {
+               return(false);
+            }
+            if ( attach_data ) {
+               entry.d_image_data = data;
+            } else {
+               entry.d_data.assign(data, data + num_bytes);
+            }
+            data += num_bytes;
+         }
+      }
+
+   }
+
+   return(true);
+}
+
+/*
+*************************************************************************
+*                                                                       *
+* Private helpers storing and retrieving typed entries.                 *
+*                                                                       *
+*************************************************************************
+*/
+
+template<typename TYPE>
+void MemoryDatabase::putEntry(const string& key,
+                              EntryType type,
+                              const TYPE* data,
+                              int nelements)
+{
+#ifdef DEBUG_CHECK_ASSERTIONS
+   assert(!key.empty());
+   assert(nelements >= 0);
+#endif
+   Entry& entry = d_entries[key];
+   entry.d_type = type;
+   entry.d_num_elements = nelements;
+   const char* bytes = reinterpret_cast<const char*>(data);
+   entry.d_data.assign(bytes, bytes + nelements * sizeof(TYPE));
+   entry.d_image_data = NULL;
+   entry.d_strings.clear();
+   entry.d_database.reset();
+}
+
+template<typename TYPE>
+void MemoryDatabase::getEntry(const string& key,
+                              EntryType type,
+                              TYPE* data,
+                              int nelements,
+                              const char* method_name)
+{
+   const Entry& entry = findEntry(key, type, method_name);
+   if ( entry.d_num_elements != nelements ) {
+      TBOX_ERROR("MemoryDatabase::" << method_name 
+                 << " error in database " << d_database_name
+                 << "\n    Incorrect array size = " << nelements
+                 << " specified for key = " << key
+                 << " with array size = " << entry.d_num_elements << endl);
+   }
+   if ( nelements > 0 ) {
+      memcpy(data, getEntryData(entry), nelements * sizeof(TYPE));
+   }
+}
+
+template<typename TYPE>
+void MemoryDatabase::getEntry(const string& key,
+                              EntryType type,
+                              vector<TYPE>& data,
+                              const char* method_name)
+{
+   const Entry& entry = findEntry(key, type, method_name);
+   data.resize(entry.d_num_elements);
+   if ( entry.d_num_elements > 0 ) {
+      memcpy(&data[0], getEntryData(entry), 
+             entry.d_num_elements * sizeof(TYPE));
+   }
+}
+
+const MemoryDatabase::Entry& 
+MemoryDatabase::findEntry(const string& key,
+                          EntryType type,
+                          const char* method_name) const
+{
+   EntryMap::const_iterator ie = d_entries.find(key);
+   if ( (ie == d_entries.end()) || (ie->second.d_type != type) ) {
+      TBOX_ERROR("MemoryDatabase::" << method_name 
+                 << " error in database " << d_database_name
+                 << "\n    Key = " << key 
+                 << " is not of the requested type." << endl);
+   }
+   return(ie->second);
+}
+
+const char* MemoryDatabase::getEntryData(const Entry& entry)
+{
+   if ( entry.d_image_data != NULL ) {
+      return(entry.d_image_data);
+   }
+   return( entry.d_data.empty() ? (const char*)NULL : &entry.d_data[0] );
+}
+
+size_t MemoryDatabase::getElementSize(EntryType type)
+{
+   switch (type) {
+      case BOOL_ENTRY:
+      case CHAR_ENTRY:    return(sizeof(char));
+      case DOUBLE_ENTRY:  return(sizeof(double));
+      case FLOAT_ENTRY:   return(sizeof(float));
+      case INTEGER_ENTRY: return(sizeof(int));
+      default:            return(0);
+   }
+}
+
+bool MemoryDatabase::isEntryType(const string& key,
+                                 EntryType type) const
+{
+   EntryMap::const_iterator ie = d_entries.find(key);
+   return( (ie != d_entries.end()) && (ie->second.d_type == type) );
+}
+
+}
+}
@@ -0,0 +1,726 @@
+//
+// File:        MemoryDatabase.h
+// Package:     MPTCOUPLER toolbox
+// 
+// 
+// 
+// Description: A database structure that stores data in memory.
+//
+ 
+#ifndef included_toolbox_MemoryDatabase
+#define included_toolbox_MemoryDatabase
+ 
+#ifndef included_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_toolbox_Database
+#include "toolbox/database/Database.h"
+#endif
+
+#ifndef included_map
+#define included_map
+#include <map>
+using namespace std;
+#endif
+
+namespace MPTCOUPLER {
+   namespace toolbox {
+ 
+class MemoryDatabase;
+typedef std::shared_ptr<MemoryDatabase> MemoryDatabasePtr;
+ 
+/*!
+ * @brief MemoryDatabase implements the interface of the Database
+ * class to hold data in memory and to convert it to and from a flat 
+ * binary image.
+ *
+ * The binary image produced by serialize() holds the complete hierarchy
+ * of the database, including all subdatabases, and may be written to
+ * any byte-oriented storage.  A database filled from an image with 
+ * deserialize() is indistinguishable from the one that produced it.
+ * Alternatively, attach() reads an image in place: numeric and character
+ * data are not copied but left in the image, e.g. a memory-mapped file,
+ * and copied from there only when retrieved.
+ * The image uses the byte order and type sizes of the host, so it is 
+ * meant for scratch storage read back by the same executable (e.g., 
+ * objects swapped out of memory) rather than for data exchange.  
+ * Unlike HDFDatabase, the class does not depend on HDF5.
+ *
+ * Error reporting is done using the MPTCOUPLER error reporting macros.
+ *
+ * @see toolbox::Database
+ * @see toolbox::HDFDatabase
+ */
+
+class MemoryDatabase : public Database
+{
+public:
+   /*!
+    * The memory database constructor creates an empty database with the
+    * specified name.
+    * 
+    * When assertion checking is active, the name string must be non-empty.
+    */
+   MemoryDatabase(const string& name);
+
+   /*!
+    * The database destructor deletes all entries of the database.
+    */
+   virtual ~MemoryDatabase();
+
+   /*!
+    * Check whether key exists in database.
+    *  
+    * @return boolean true if the specified key exists in the database 
+    * and false otherwise.
+    *
+    * @param key Key name to lookup.
+    */
+   virtual bool keyExists(const string& key);
+ 
+   /*!
+    * Retrieve vector of all keys in the database.
+    */
+   virtual void getAllKeys(vector<string>& keys);
+ 
+   /*!
+    * Return the size of the array associated with the key.  If the key is
+    * associated with a scalar value, then one is returned.  If the key
+    * does not exist, then zero is returned.
+    *
+    * @param key Key name in database.
+    */
+   virtual int getArraySize(const string& key);
+
+   /*!
+    * Check whether the specified key represents a database entry. 
+    *  
+    * @return boolean true if the key is associated with a database
+    * entry; otherwise false.
+    *
+    * @param key Key name in database.
+    */
+   virtual bool isDatabase(const string& key);
+ 
+   /*!
+    * Create a new database with the specified key name and return
+    * a smart pointer to it.  If the key already exists in the database,
+    * then the old key record is deleted and the new one is silently
+    * created in its place.
+    *
+    * @param key Key name in database.
+    */
+   virtual DatabasePtr putDatabase(const string& key);
+ 
+   /*!
+    * Get a pointer to the database with the specified key name.  If the
+    * specified key does not exist in the database or it is not a database,
+    * then an error message is printed and the program exits.
+    *
+    * @param key Key name in database.
+    */
+   virtual DatabasePtr getDatabase(const string& key);
+
+   /*!
+    * Return whether the specified key represents a boolean entry.  If
+    * the key does not exist, then false is returned.
+    *
+    * @param key Key name in database.
+    */
+   virtual bool isBool(const string& key);
+ 
+   /*!
+    * Create a boolean scalar entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key Key name in database.
+    * @param data Value to put into database.
+    */
+   virtual void putBool(const string& key, bool data);
+ 
+   /*!
+    * Create a boolean array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first boolean data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void putBoolArray(
+      const string& key, const bool* const data, const int nelements);
+
+   /*!
+    * Create a boolean array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key  Key name in database.
+    * @param data Const reference to vector with bool data to put in database.
+    */
+   virtual void putBoolArray(
+      const string& key, const vector<bool>& data);
+ 
+   /*!
+    * Get a boolean scalar entry in the database with the specified key name.
+    * If the specified key does not exist in the database or is not a
+    * boolean scalar, then an error message is printed and the program
+    * exits.
+    *
+    * @param key Key name in database.
+    */
+   virtual bool getBool(const string& key);
+
+   /*!
+    * Get a boolean array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a boolean array, then an error message is printed and
+    * the program exits.
+    *
+    * @param key Key name in database.
+    * @param data Reference to vector in which to place bool data.
+    */
+   virtual void getBoolArray(const string& key, vector<bool>& data);
+ 
+   /*!
+    * Get a boolean array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a boolean array, then an error message is printed and
+    * the program exits.  The specified number of elements must match
+    * exactly the number of elements in the array in the database.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first boolean data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void getBoolArray(
+      const string& key, bool* data, const int nelements);
+
+   /*!
+    * Return whether the specified key represents a character entry.  If
+    * the key does not exist, then false is returned.
+    *
+    * @param key Key name in database.
+    */
+   virtual bool isChar(const string& key);
+ 
+   /*!
+    * Create a character scalar entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key Key name in database.
+    * @param data Value to put into database.
+    */
+   virtual void putChar(const string& key, char data);
+ 
+   /*!
+    * Create a character array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first char data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void putCharArray(
+      const string& key, const char* const data, const int nelements);
+ 
+   /*!
+    * Create a character array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key  Key name in database.
+    * @param data Const reference to char vector with data to put in database.
+    */
+   virtual void putCharArray(
+      const string& key, const vector<char>& data);
+ 
+   /*!
+    * Get a character entry in the database with the specified key name.
+    * If the specified key does not exist in the database or is not an
+    * character scalar, then an error message is printed and the program
+    * exits.
+    *
+    * @param key Key name in database.
+    */
+   virtual char getChar(const string& key);
+
+   /*!
+    * Get a character array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a character array, then an error message is printed and
+    * the program exits.  The specified number of elements must match
+    * exactly the number of elements in the array in the database.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first char data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void getCharArray(
+      const string& key, char* data, const int nelements);
+ 
+   /*!
+    * Get a character array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a character array, then an error message is printed and
+    * the program exits.
+    *
+    * @param key Key name in database.
+    * @param data Reference to vector in which to place char data.
+    */
+   virtual void getCharArray(const string& key, vector<char>& data);
+
+   /*!
+    * Return whether the specified key represents a double entry.  If
+    * the key does not exist, then false is returned.
+    *
+    * @param key Key name in database.
+    */
+   virtual bool isDouble(const string& key);
+ 
+   /*!
+    * Create a double scalar entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key Key name in database.
+    * @param data Value to put into database.
+    */
+   virtual void putDouble(const string& key, double data);
+ 
+   /*!
+    * Create a double array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first double data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void putDoubleArray(
+      const string& key, const double* const data, const int nelements);
+ 
+   /*!
+    * Create a double array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key  Key name in database.
+    * @param data Const reference to double vector with data to put in database.
+    */
+   virtual void putDoubleArray(
+      const string& key, const vector<double>& data);
+ 
+   /*!
+    * Get a double scalar entry in the database with the specified key name.
+    * If the specified key does not exist in the database or is not a
+    * double scalar, then an error message is printed and the program
+    * exits.
+    *
+    * @param key Key name in database.
+    */
+   virtual double getDouble(const string& key);
+
+   /*!
+    * Get a double array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a double array, then an error message is printed and
+    * the program exits.
+    *
+    * @param key Key name in database.
+    * @param data Reference to vector in which to place double data.
+    */
+   virtual void getDoubleArray(const string& key, vector<double>& data);
+ 
+   /*!
+    * Get a double array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a double array, then an error message is printed and
+    * the program exits.  The specified number of elements must match
+    * exactly the number of elements in the array in the database.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first double data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void getDoubleArray(
+      const string& key, double* data, const int nelements);
+
+   /*!
+    * Return whether the specified key represents a float entry.  If
+    * the key does not exist, then false is returned.
+    *
+    * @param key Key name in database.
+    */
+   virtual bool isFloat(const string& key);
+ 
+   /*!
+    * Create a float scalar entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key Key name in database.
+    * @param data Value to put into database.
+    */
+   virtual void putFloat(const string& key, float data);
+ 
+   /*!
+    * Create a float array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first float data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void putFloatArray(
+      const string& key, const float* const data, const int nelements);
+ 
+   /*!
+    * Create a float array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key  Key name in database.
+    * @param data Const reference to vector with float data to put in database.
+    */
+   virtual void putFloatArray(
+      const string& key, const vector<float>& data);
+ 
+   /*!
+    * Get a float scalar entry in the database with the specified key name.
+    * If the specified key does not exist in the database or is not a
+    * float scalar, then an error message is printed and the program
+    * exits.
+    *
+    * @param key Key name in database.
+    */
+   virtual float getFloat(const string& key);
+
+   /*!
+    * Get a float array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a float array, then an error message is printed and
+    * the program exits.
+    *
+    * @param key Key name in database.
+    * @param data Reference to vector in which to place float data.
+    */
+   virtual void getFloatArray(const string& key, vector<float>& data);
+ 
+   /*!
+    * Get a float array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a float array, then an error message is printed and
+    * the program exits.  The specified number of elements must match
+    * exactly the number of elements in the array in the database.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first float data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void getFloatArray(
+      const string& key, float* data, const int nelements);
+
+   /*!
+    * Return whether the specified key represents a integer entry.  If
+    * the key does not exist, then false is returned.
+    *
+    * @param key Key name in database.
+    */
+   virtual bool isInteger(const string& key);
+ 
+   /*!
+    * Create a integer scalar entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key Key name in database.
+    * @param data Value to put into database.
+    */
+   virtual void putInteger(const string& key, int data);
+ 
+   /*!
+    * Create a integer array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first integer data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void putIntegerArray(
+      const string& key, const int* const data, const int nelements);
+ 
+   /*!
+    * Create a integer array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key  Key name in database.
+    * @param data Const reference to integer vector with data to put in database.
+    */
+   virtual void putIntegerArray(
+      const string& key, const vector<int>& data);
+ 
+   /*!
+    * Get a integer scalar entry in the database with the specified key name.
+    * If the specified key does not exist in the database or is not a
+    * integer scalar, then an error message is printed and the program
+    * exits.
+    *
+    * @param key Key name in database.
+    */
+   virtual int getInteger(const string& key);
+
+   /*!
+    * Get a integer array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a integer array, then an error message is printed and
+    * the program exits.
+    *
+    * @param key Key name in database.
+    * @param data Reference to vector in which to place integer data.
+    */
+   virtual void getIntegerArray(const string& key, vector<int>& data);
+ 
+   /*!
+    * Get a integer array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a integer array, then an error message is printed and
+    * the program exits.  The specified number of elements must match
+    * exactly the number of elements in the array in the database.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first integer data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void getIntegerArray(
+      const string& key, int* data, const int nelements);
+
+   /*!
+    * Return whether the specified key represents a string entry.  If
+    * the key does not exist, then false is returned.
+    *
+    * @param key Key name in database.
+    */
+   virtual bool isString(const string& key);
+ 
+   /*!
+    * Create a string scalar entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key Key name in database.
+    * @param data Value to put into database.
+    */
+   virtual void putString(const string& key, const string& data);
+ 
+   /*!
+    * Create a string array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first string data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void putStringArray(
+      const string& key, const string* const data, const int nelements);
+ 
+   /*!
+    * Create a string array entry in the database with the specified
+    * key name.  If the key already exists in the database, then the old
+    * key record is deleted and the new one is silently created in its place.
+    *
+    * @param key  Key name in database.
+    * @param data Const reference to string vector with data to put in database.
+    */
+   virtual void putStringArray(
+      const string& key, const vector<string>& data);
+ 
+   /*!
+    * Get a string scalar entry in the database with the specified key name.
+    * If the specified key does not exist in the database or is not a
+    * string scalar, then an error message is printed and the program
+    * exits.
+    *
+    * @param key Key name in database.
+    */
+   virtual string getString(const string& key);
+
+   /*!
+    * Get a string array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a string array, then an error message is printed and
+    * the program exits.
+    *
+    * @param key Key name in database.
+    * @param data Reference to vector in which to place string data.
+    */
+   virtual void getStringArray(const string& key, vector<string>& data);
+ 
+   /*!
+    * Get a string array entry from the database with the specified key
+    * name.  If the specified key does not exist in the database or
+    * is not a string array, then an error message is printed and
+    * the program exits.  The specified number of elements must match
+    * exactly the number of elements in the array in the database.
+    *
+    * @param key       Key name in database.
+    * @param data      Pointer to first string data value in array.
+    * @param nelements Number of elements to write from array.
+    */
+   virtual void getStringArray(
+      const string& key, string* data, const int nelements);
+
+   /*!
+    * Print contents of current database to the specified output stream.  
+    * If no output stream is specified, then data is written to stream pout.
+    * Note that none of the subdatabases contained in the current database 
+    * will have their contents printed.  To view the contents of any other
+    * database, you must call this print routine for that database. 
+    */
+   virtual void printClassData(ostream& os);
+
+   /*!
+    * Append binary image of the database and all its subdatabases
+    * to the given buffer.
+    *
+    * @param buffer Reference to vector of bytes to which image is 
+    *               appended.
+    */
+   void serialize(vector<char>& buffer) const;
+
+   /*!
+    * Replace contents of the database with those held in a binary 
+    * image produced by serialize().
+    *
+    * @return boolean true if the image was read successfully; otherwise
+    * false, in which case the database is left empty.
+    *
+    * @param data Const pointer to first byte of image.
+    * @param size Number of bytes in image.
+    */
+   bool deserialize(const char* data, size_t size);
+
+   /*!
+    * Replace contents of the database with those held in a binary 
+    * image produced by serialize(), leaving numeric and character data
+    * in the image.  The image must remain valid and unchanged until the 
+    * database and all its subdatabases are destroyed or refilled.  
+    * Entries put into the database after the call are held in memory 
+    * as usual.
+    *
+    * @return boolean true if the image was read successfully; otherwise
+    * false, in which case the database is left empty.
+    *
+    * @param data Const pointer to first byte of image.
+    * @param size Number of bytes in image.
+    */
+   bool attach(const char* data, size_t size);
+
+private:
+   MemoryDatabase(const MemoryDatabase&);   // not implemented
+   void operator=(const MemoryDatabase&);     // not implemented
+
+   /*
+    * Type of database entry; the values are part of the binary image.
+    */
+   enum EntryType { DATABASE_ENTRY = 0,
+                    BOOL_ENTRY     = 1,
+                    CHAR_ENTRY     = 2,
+                    DOUBLE_ENTRY   = 3,
+                    FLOAT_ENTRY    = 4,
+                    INTEGER_ENTRY  = 5,
+                    STRING_ENTRY   = 6 };
+
+   /*
+    * Database entry.  Scalars are stored as arrays of one element.
+    * Numeric and character data are held as raw bytes in d_data 
+    * (booleans as one byte each), or in an attached image pointed to
+    * by d_image_data if it is not null; strings are held in d_strings 
+    * and subdatabases in d_database.  Entries are kept in a map ordered
+    * by key.
+    */
+   struct Entry {
+      EntryType         d_type;
+      int               d_num_elements;
+      vector<char>      d_data;
+      const char*       d_image_data;
+      vector<string>    d_strings;
+      MemoryDatabasePtr d_database;
+   };
+
+   typedef map<string, Entry> EntryMap;
+
+   /*
+    * Private methods to store array of given type under given key 
+    * and to copy it out, checking type and number of elements.  The 
+    * calling method name is used in error messages.
+    */
+   template<typename TYPE>
+   void putEntry(const string& key,
+                 EntryType type,
+                 const TYPE* data,
+                 int nelements);
+
+   template<typename TYPE>
+   void getEntry(const string& key,
+                 EntryType type,
+                 TYPE* data,
+                 int nelements,
+                 const char* method_name);
+
+   template<typename TYPE>
+   void getEntry(const string& key,
+                 EntryType type,
+                 vector<TYPE>& data,
+                 const char* method_name);
+
+   /*
+    * Private method returning entry with given key and type; prints
+    * an error message and exits if there is no such entry.
+    */
+   const Entry& findEntry(const string& key,
+                          EntryType type,
+                          const char* method_name) const;
+
+   /*
+    * Private method returning true if key is associated with entry
+    * of given type.
+    */
+   bool isEntryType(const string& key,
+                    EntryType type) const;
+
+   /*
+    * Private methods returning pointer to raw bytes of entry and size 
+    * in bytes of an element of numeric or character entry type.
+    */
+   static const char* getEntryData(const Entry& entry);
+   static size_t getElementSize(EntryType type);
+
+   /*
+    * Private methods to read binary image of database, copying or 
+    * attaching its data, and to read image from given buffer position,
+    * advancing the position past the image.
+    */
+   bool readImage(const char* data, size_t size, bool attach_data);
+   bool deserializeEntries(const char*& data, 
+                           const char* end,
+                           bool attach_data);
+
+   string   d_database_name;
+   EntryMap d_entries;
+
+};
+
+
+}
+}
+
+#endif
@@ -0,0 +1,132 @@
+//
+// File:  ReadWriteLock.h
+// Package:  MPTCOUPLER toolbox
+// 
+// 
+// 
+// Description:  Reader/writer lock for shared-memory thread parallelism
+//
+
+#ifndef included_toolbox_ReadWriteLock
+#define included_toolbox_ReadWriteLock
+
+#ifndef included_config
+#include "asf_config.h"
+#endif
+
+#ifndef included_pthread
+#define included_pthread
+#include <pthread.h>
+#endif
+
+namespace MPTCOUPLER {
+   namespace toolbox {
+
+/*!
+ * @brief ReadWriteLock is a thin wrapper around a POSIX reader/writer
+ * lock.  Any number of threads may hold the lock for reading at the
+ * same time; a thread holding the lock for writing has exclusive access.
+ * The lock is not recursive.
+ *
+ * The ReadLockGuard and WriteLockGuard classes acquire the lock in their
+ * constructors and release it in their destructors.  Both accept a null
+ * pointer, in which case they do nothing; this allows locking to be
+ * switched off without changing the calling code.
+ */
+
+class ReadWriteLock
+{
+public:
+   /*!
+    * Ctor creates an unlocked lock.
+    */
+   ReadWriteLock();
+
+   /*!
+    * Dtor destroys the lock; the lock must not be held.
+    */
+   ~ReadWriteLock();
+
+   /*!
+    * Acquire the lock for reading (shared access).
+    */
+   void lockRead();
+
+   /*!
+    * Acquire the lock for writing (exclusive access).
+    */
+   void lockWrite();
+
+   /*!
+    * Release the lock held by the calling thread.
+    */
+   void unlock();
+
+private:
+   // The following are not implemented
+   ReadWriteLock(const ReadWriteLock&);
+   void operator=(const ReadWriteLock&);
+
+   pthread_rwlock_t d_lock;
+};
+
+/*!
+ * @brief Holds a ReadWriteLock for reading for the lifetime of the
+ * guard object.
+ */
+
+class ReadLockGuard
+{
+public:
+   /*!
+    * Acquire given lock for reading; no-op if lock is null.
+    */
+   explicit ReadLockGuard(ReadWriteLock* lock);
+
+   /*!
+    * Release the lock.
+    */
+   ~ReadLockGuard();
+
+private:
+   // The following are not implemented
+   ReadLockGuard(const ReadLockGuard&);
+   void operator=(const ReadLockGuard&);
+
+   ReadWriteLock* d_lock;
+};
+
+/*!
+ * @brief Holds a ReadWriteLock for writing for the lifetime of the
+ * guard object.
+ */
+
+class WriteLockGuard
+{
+public:
+   /*!
+    * Acquire given lock for writing; no-op if lock is null.
+    */
+   explicit WriteLockGuard(ReadWriteLock* lock);
+
+   /*!
+    * Release the lock.
+    */
+   ~WriteLockGuard();
+
+private:
+   // The following are not implemented
+   WriteLockGuard(const WriteLockGuard&);
+   void operator=(const WriteLockGuard&);
+
+   ReadWriteLock* d_lock;
+};
+
+
+}
+}
+
+#ifndef DEBUG_NO_INLINE
+#include "toolbox/parallel/ReadWriteLock.I"
+#endif
+#endif